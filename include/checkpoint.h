@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <color_spinor_field.h>
+#include <reference_wrapper_helper.h>
+
+namespace quda
+{
+
+  /**
+     Lightweight checkpoint/restart support for long running solves
+     and multigrid setups.  Snapshots are written as raw per-rank
+     files to the directory given by the QUDA_CHECKPOINT_PATH
+     environment variable; when this is unset checkpointing is
+     disabled.  The number of iterations between snapshots is set
+     with QUDA_CHECKPOINT_INTERVAL (default 100).
+
+     Saving is asynchronous: the fields are copied to host memory on
+     the calling thread, and the file is then written on a background
+     thread while the solver carries on.  Each file is first written
+     to a temporary name and then renamed, so an interrupted write
+     never replaces a valid snapshot.
+   */
+  namespace checkpoint
+  {
+
+    /**
+       @brief Whether checkpointing is enabled, e.g., if
+       QUDA_CHECKPOINT_PATH points to a valid directory
+    */
+    bool enabled();
+
+    /**
+       @brief The number of iterations (or restarts for eigensolvers)
+       between successive snapshots
+    */
+    int interval();
+
+    /**
+       @brief Return a deterministic key for the next checkpoint of a
+       given type.  Keys are formed from the tag and a per-tag
+       invocation counter, so that the n-th solve of a given type maps
+       to the same snapshot when a job is rerun.
+       @param[in] tag The checkpoint type, e.g., "cg", "gcr"
+       @return The key
+    */
+    std::string key(const std::string &tag);
+
+    /**
+       @brief Save a set of fields and associated metadata.  Returns
+       once the fields have been copied to the host; the write to disk
+       is done asynchronously.
+       @param[in] key The checkpoint key
+       @param[in] v The set of fields to save
+       @param[in] meta Metadata (iteration counts, norms, ...)
+    */
+    void save(const std::string &key, cvector_ref<const ColorSpinorField> &v, const std::vector<double> &meta);
+
+    /**
+       @brief Load a set of fields and associated metadata.  The
+       snapshot is only used if it is present and well formed on all
+       ranks.
+       @param[in] key The checkpoint key
+       @param[out] v The set of fields to restore into; may be larger
+       than the number of saved fields
+       @param[out] meta Metadata stored with the fields
+       @return The number of fields restored, or -1 if no valid
+       snapshot exists
+    */
+    int load(const std::string &key, cvector_ref<ColorSpinorField> &v, std::vector<double> &meta);
+
+    /**
+       @brief Remove a checkpoint, e.g., once the solve it protected
+       has completed
+       @param[in] key The checkpoint key
+    */
+    void remove(const std::string &key);
+
+    /**
+       @brief Block until any outstanding asynchronous write has
+       completed
+    */
+    void wait();
+
+    /**
+       @brief Complete any outstanding write and release the staging
+       buffers.  Called from endQuda.
+    */
+    void finalize();
+
+  } // namespace checkpoint
+
+} // namespace quda
@@ -931,6 +931,29 @@ namespace quda
   template <> struct is_field<ColorSpinorField> : std::true_type {
   };
 
+  /**
+     @brief Push a halo precision onto the halo-precision stack.  While
+     it is at the top of the stack, the ghost-only fields returned by
+     ColorSpinorField::create_comms_batch, and hence the halos of all
+     fine-grid operators, are stored in this precision when it is lower
+     than the field precision.  QUDA_INVALID_PRECISION means the halo
+     is stored in the field precision.
+     @param[in] precision The halo precision to apply
+   */
+  void pushHaloPrecision(QudaPrecision precision);
+
+  /**
+     @brief Restore the halo precision that was active prior to the
+     matching pushHaloPrecision call
+   */
+  void popHaloPrecision();
+
+  /**
+     @return The halo precision currently at the top of the
+     halo-precision stack (QUDA_INVALID_PRECISION if empty)
+   */
+  QudaPrecision getHaloPrecision();
+
   /**
      @brief Helper function to resize a std::vector of
      ColorSpinorFields.  This should be favored over using
@@ -1065,6 +1065,24 @@ namespace quda
       GhostNOrder &operator=(const GhostNOrder &) = default;
     };
 
+    /**
+       @brief Return the precision in which the ghost zone of a field
+       stored with precision Float is held.  A ghost precision lower
+       than the field precision selects a compressed halo: single
+       precision for double-precision fields, or a block-floating-point
+       format for half and quarter precision, where each ghost site
+       (spinor) shares a single scale factor and the elements are
+       stored as 16-bit or 8-bit mantissas.
+     */
+    template <typename Float> inline QudaPrecision ghost_storage_precision(const ColorSpinorField &a)
+    {
+      auto precision = a.GhostPrecision();
+      bool compressed = (precision == QUDA_SINGLE_PRECISION || precision == QUDA_HALF_PRECISION
+                         || precision == QUDA_QUARTER_PRECISION)
+        && precision < static_cast<int>(sizeof(Float));
+      return compressed ? precision : static_cast<QudaPrecision>(sizeof(Float));
+    }
+
     template <typename Float, int Ns, int Nc, int N, bool spin_project, bool huge_alloc>
     struct GhostNOrder<Float, Ns, Nc, N, spin_project, huge_alloc, false> {
       static constexpr int length = 2 * Ns * Nc;
@@ -1073,11 +1091,11 @@ namespace quda
       static constexpr int N_ghost = !spin_project ? N : (Ns * Nc) % N == 0 ? N : N / 2;
       static constexpr int M_ghost = length_ghost / N_ghost;
       using Accessor = GhostNOrder<Float, Ns, Nc, N, spin_project, huge_alloc>;
-      using GhostVector = typename VectorType<Float, N_ghost>::type;
       using real = typename mapper<Float>::type;
       using complex = complex<real>;
       using norm_type = float;
       int nParity;
+      QudaPrecision ghost_precision = static_cast<QudaPrecision>(sizeof(Float)); // storage precision of the ghost
       array<int, 4> faceVolumeCB = {};
       mutable array<Float *, 8> ghost = {};
       mutable array<norm_type *, 8> ghost_norm = {};
@@ -1085,7 +1103,8 @@ namespace quda
       GhostNOrder() = default;
       GhostNOrder(const GhostNOrder &) = default;
 
-      GhostNOrder(const ColorSpinorField &a, int nFace = 1, Float **ghost_ = 0) : nParity(a.SiteSubset())
+      GhostNOrder(const ColorSpinorField &a, int nFace = 1, Float **ghost_ = 0) :
+        nParity(a.SiteSubset()), ghost_precision(ghost_storage_precision<Float>(a))
       {
         for (int i = 0; i < 4; i++) { faceVolumeCB[i] = a.SurfaceCB(i) * nFace; }
         resetGhost(ghost_ ? (void **)ghost_ : a.Ghost());
@@ -1101,16 +1120,32 @@ namespace quda
             ghost_norm[2 * dim + dir] = !comm_dim_partitioned(dim) ?
               nullptr :
               reinterpret_cast<norm_type *>(static_cast<char *>(ghost_[2 * dim + dir])
-                                            + nParity * length_ghost * faceVolumeCB[dim] * sizeof(Float));
+                                            + nParity * length_ghost * faceVolumeCB[dim] * ghost_precision);
           }
         }
       }
 
-      __device__ __host__ inline void loadGhost(complex out[length_ghost / 2], int x, int dim, int dir, int parity = 0) const
+      /**
+         @brief Call f with a value of the ghost storage type.  Only
+         the storage types narrower than Float are instantiated.
+       */
+      template <typename F> __device__ __host__ inline void dispatch_ghost(F &&f) const
       {
-        real v[length_ghost];
+        if constexpr (sizeof(Float) > sizeof(float))
+          if (ghost_precision == QUDA_SINGLE_PRECISION) return f(float());
+        if constexpr (sizeof(Float) > sizeof(short))
+          if (ghost_precision == QUDA_HALF_PRECISION) return f(short());
+        if constexpr (sizeof(Float) > sizeof(int8_t))
+          if (ghost_precision == QUDA_QUARTER_PRECISION) return f(int8_t());
+        f(Float());
+      }
+
+      template <typename ghost_t>
+      __device__ __host__ inline void loadGhost(real v[length_ghost], int x, int dim, int dir, int parity) const
+      {
+        using GhostVector = typename VectorType<ghost_t, N_ghost>::type;
         norm_type nrm
-          = isFixed<Float>::value ? vector_load<float>(ghost_norm[2 * dim + dir], parity * faceVolumeCB[dim] + x) : 0.0;
+          = isFixed<ghost_t>::value ? vector_load<float>(ghost_norm[2 * dim + dir], parity * faceVolumeCB[dim] + x) : 0.0;
 
 #pragma unroll
         for (int i = 0; i < M_ghost; i++) {
@@ -1118,24 +1153,24 @@ namespace quda
             ghost[2 * dim + dir], parity * faceVolumeCB[dim] * M_ghost + i * faceVolumeCB[dim] + x);
 #pragma unroll
           for (int j = 0; j < N_ghost; j++)
-            copy_and_scale(v[i * N_ghost + j], reinterpret_cast<Float *>(&vecTmp)[j], nrm);
+            copy_and_scale(v[i * N_ghost + j], reinterpret_cast<ghost_t *>(&vecTmp)[j], nrm);
         }
-
-#pragma unroll
-        for (int i = 0; i < length_ghost / 2; i++) out[i] = complex(v[2 * i + 0], v[2 * i + 1]);
       }
 
-      __device__ __host__ inline void saveGhost(const complex in[length_ghost / 2], int x, int dim, int dir,
-                                                int parity = 0) const
+      __device__ __host__ inline void loadGhost(complex out[length_ghost / 2], int x, int dim, int dir, int parity = 0) const
       {
         real v[length_ghost];
+        dispatch_ghost([&](auto g) { this->template loadGhost<decltype(g)>(v, x, dim, dir, parity); });
+
 #pragma unroll
-        for (int i = 0; i < length_ghost / 2; i++) {
-          v[2 * i + 0] = in[i].real();
-          v[2 * i + 1] = in[i].imag();
-        }
+        for (int i = 0; i < length_ghost / 2; i++) out[i] = complex(v[2 * i + 0], v[2 * i + 1]);
+      }
 
-        if (isFixed<Float>::value) {
+      template <typename ghost_t>
+      __device__ __host__ inline void saveGhost(real v[length_ghost], int x, int dim, int dir, int parity) const
+      {
+        using GhostVector = typename VectorType<ghost_t, N_ghost>::type;
+        if constexpr (isFixed<ghost_t>::value) {
           norm_type max_[length_ghost / 2];
           // two-pass to increase ILP (assumes length divisible by two, e.g. complex-valued)
 #pragma unroll
@@ -1144,9 +1179,9 @@ namespace quda
           norm_type scale = 0.0;
 #pragma unroll
           for (int i = 0; i < length_ghost / 2; i++) scale = fmaxf(max_[i], scale);
-          ghost_norm[2 * dim + dir][parity * faceVolumeCB[dim] + x] = scale * fixedInvMaxValue<Float>::value;
+          ghost_norm[2 * dim + dir][parity * faceVolumeCB[dim] + x] = scale * fixedInvMaxValue<ghost_t>::value;
 
-          real scale_inv = fdividef(fixedMaxValue<Float>::value, scale);
+          real scale_inv = fdividef(fixedMaxValue<ghost_t>::value, scale);
 #pragma unroll
           for (int i = 0; i < length_ghost; i++) v[i] = v[i] * scale_inv;
         }
@@ -1156,12 +1191,25 @@ namespace quda
           GhostVector vecTmp;
           // first do scalar copy converting into storage type
 #pragma unroll
-          for (int j = 0; j < N_ghost; j++) copy_scaled(reinterpret_cast<Float *>(&vecTmp)[j], v[i * N_ghost + j]);
+          for (int j = 0; j < N_ghost; j++) copy_scaled(reinterpret_cast<ghost_t *>(&vecTmp)[j], v[i * N_ghost + j]);
           // second do vectorized copy into memory
           vector_store(ghost[2 * dim + dir], parity * faceVolumeCB[dim] * M_ghost + i * faceVolumeCB[dim] + x, vecTmp);
         }
       }
 
+      __device__ __host__ inline void saveGhost(const complex in[length_ghost / 2], int x, int dim, int dir,
+                                                int parity = 0) const
+      {
+        real v[length_ghost];
+#pragma unroll
+        for (int i = 0; i < length_ghost / 2; i++) {
+          v[2 * i + 0] = in[i].real();
+          v[2 * i + 1] = in[i].imag();
+        }
+
+        dispatch_ghost([&](auto g) { this->template saveGhost<decltype(g)>(v, x, dim, dir, parity); });
+      }
+
       /**
          @brief This accessor routine returns a const
          colorspinor_ghost_wrapper to this object, allowing us to
@@ -1325,6 +1373,7 @@ namespace quda
       using complex = complex<real>;
       using norm_type = float;
       int nParity;
+      QudaPrecision ghost_precision = QUDA_HALF_PRECISION; // storage precision of the ghost
       array<int, 4> faceVolumeCB = {};
       mutable array<Float *, 8> ghost = {};
       mutable array<norm_type *, 8> ghost_norm = {};
@@ -1332,7 +1381,8 @@ namespace quda
       GhostNOrder() = default;
       GhostNOrder(const GhostNOrder &) = default;
 
-      GhostNOrder(const ColorSpinorField &a, int nFace = 1, Float **ghost_ = 0) : nParity(a.SiteSubset())
+      GhostNOrder(const ColorSpinorField &a, int nFace = 1, Float **ghost_ = 0) :
+        nParity(a.SiteSubset()), ghost_precision(ghost_storage_precision<Float>(a))
       {
         for (int i = 0; i < 4; i++) { faceVolumeCB[i] = a.SurfaceCB(i) * nFace; }
         resetGhost(ghost_ ? (void **)ghost_ : a.Ghost());
@@ -1345,6 +1395,11 @@ namespace quda
         for (int dim = 0; dim < 4; dim++) {
           for (int dir = 0; dir < 2; dir++) {
             ghost[2 * dim + dir] = comm_dim_partitioned(dim) ? static_cast<Float *>(ghost_[2 * dim + dir]) : nullptr;
+            // a quarter-precision ghost uses the generic layout with a separate norm array
+            ghost_norm[2 * dim + dir] = !comm_dim_partitioned(dim) || ghost_precision != QUDA_QUARTER_PRECISION ?
+              nullptr :
+              reinterpret_cast<norm_type *>(static_cast<char *>(ghost_[2 * dim + dir])
+                                            + nParity * length_ghost * faceVolumeCB[dim] * ghost_precision);
           }
         }
       }
@@ -1352,6 +1407,21 @@ namespace quda
       __device__ __host__ inline void loadGhost(complex out[length_ghost / 2], int x, int dim, int dir, int parity = 0) const
       {
         real v[length_ghost];
+        if (ghost_precision == QUDA_QUARTER_PRECISION) {
+          using QuarterVector = typename VectorType<int8_t, 2>::type;
+          norm_type nrm = vector_load<float>(ghost_norm[2 * dim + dir], parity * faceVolumeCB[dim] + x);
+#pragma unroll
+          for (int i = 0; i < length_ghost / 2; i++) {
+            QuarterVector vecTmp = vector_load<QuarterVector>(
+              ghost[2 * dim + dir], parity * faceVolumeCB[dim] * length_ghost / 2 + i * faceVolumeCB[dim] + x);
+            copy_and_scale(v[2 * i + 0], reinterpret_cast<int8_t *>(&vecTmp)[0], nrm);
+            copy_and_scale(v[2 * i + 1], reinterpret_cast<int8_t *>(&vecTmp)[1], nrm);
+          }
+#pragma unroll
+          for (int i = 0; i < length_ghost / 2; i++) out[i] = complex(v[2 * i + 0], v[2 * i + 1]);
+          return;
+        }
+
         GhostVector vecTmp = vector_load<GhostVector>(ghost[2 * dim + dir], parity * faceVolumeCB[dim] + x);
 
         // extract the norm
@@ -1384,6 +1454,22 @@ namespace quda
         norm_type scale = 0.0;
 #pragma unroll
         for (int i = 0; i < length_ghost / 2; i++) scale = fmaxf(max_[i], scale);
+
+        if (ghost_precision == QUDA_QUARTER_PRECISION) {
+          using QuarterVector = typename VectorType<int8_t, 2>::type;
+          ghost_norm[2 * dim + dir][parity * faceVolumeCB[dim] + x] = scale * fixedInvMaxValue<int8_t>::value;
+          real scale_inv = fdividef(fixedMaxValue<int8_t>::value, scale);
+#pragma unroll
+          for (int i = 0; i < length_ghost / 2; i++) {
+            QuarterVector vecTmp;
+            copy_scaled(reinterpret_cast<int8_t *>(&vecTmp)[0], v[2 * i + 0] * scale_inv);
+            copy_scaled(reinterpret_cast<int8_t *>(&vecTmp)[1], v[2 * i + 1] * scale_inv);
+            vector_store(ghost[2 * dim + dir], parity * faceVolumeCB[dim] * length_ghost / 2 + i * faceVolumeCB[dim] + x,
+                         vecTmp);
+          }
+          return;
+        }
+
         norm_type nrm = scale * fixedInvMaxValue<Float>::value;
 
         real scale_inv = fdividef(fixedMaxValue<Float>::value, scale);
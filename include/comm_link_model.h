@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array.h>
+
+/**
+   @file comm_link_model.h
+
+   Latency-bandwidth model of the communication links in each
+   partitioned dimension, measured once with a halo-exchange
+   ping-pong.  The dslash policy tuner uses the model to prune
+   candidate policies that cannot win for a given halo size, and to
+   select the dimensions for which the choice between peer-to-peer and
+   host-staged communication is tuned.
+ */
+
+namespace quda
+{
+
+  /**
+     @brief Model of the links of one dimension: a message of b bytes
+     is exchanged with both neighbors in latency + b / bandwidth
+   */
+  struct comm_link_t {
+    bool partitioned = false; /** Whether this dimension communicates */
+    bool p2p = false;         /** Whether any process has peer-to-peer neighbors in this dimension */
+    double latency = 0.0;     /** Exchange latency (secs) */
+    double bandwidth = 0.0;   /** Exchange bandwidth (bytes / sec) */
+  };
+
+  struct comm_link_model_t {
+    array<comm_link_t, 4> link;  /** Links of each dimension */
+    double copy_bandwidth = 0.0; /** Device-host copy bandwidth (bytes / sec) */
+
+    /**
+       @brief Estimated time of a host-staged halo exchange, including
+       the copies between device and host
+       @param[in] dim The dimension
+       @param[in] bytes The message size per direction
+       @return The estimated time (secs)
+     */
+    double time(int dim, size_t bytes) const
+    {
+      if (!link[dim].partitioned || bytes == 0) return 0.0;
+      return link[dim].latency + bytes / link[dim].bandwidth + 2.0 * bytes / copy_bandwidth;
+    }
+
+    /**
+       @brief Whether the halo exchange is latency bound in every
+       communicating dimension
+       @param[in] bytes The message size per direction of each dimension
+     */
+    bool latencyBound(const array<size_t, 4> &bytes) const;
+
+    /**
+       @brief The dimensions for which host-staged communication may
+       beat peer-to-peer.  Peer-to-peer is never slower for a single
+       link, so staging a peer-to-peer dimension can only pay off by
+       overlapping its exchange with that of the slowest inter-node
+       dimension, which requires its staged exchange to be no longer.
+       @param[in] bytes The message size per direction of each dimension
+       @return Bit mask of the dimensions
+     */
+    int p2pTuneDims(const array<size_t, 4> &bytes) const;
+  };
+
+  /**
+     @return Whether the dslash policy tuner uses the link model
+     (QUDA_ENABLE_DSLASH_POLICY_MODEL, default enabled).  When
+     disabled, all policies and all peer-to-peer dimensions are tuned
+     exhaustively.
+   */
+  bool comm_link_model_enabled();
+
+  /**
+     @brief Return the link model, measuring it on the first call.
+     This must be called collectively, and the model is identical on
+     all processes.
+   */
+  const comm_link_model_t &comm_link_model();
+
+} // namespace quda
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <comm_quda.h>
+
+/**
+   @file comm_progress.h
+
+   Optional communication progress thread.  When enabled (see
+   comm_progress_enabled), started message handles are owned by a
+   background thread that repeatedly tests them for completion, so
+   that host-staged messages progress independently of the host
+   thread that posted them.  The host thread only inspects the
+   completion state recorded by the progress thread.
+ */
+
+namespace quda
+{
+
+  struct Communicator;
+
+  /**
+     @brief Statistics accumulated by the progress thread
+   */
+  struct comm_progress_stats_t {
+    size_t messages = 0;    /** Number of messages completed */
+    size_t tests = 0;       /** Number of completion tests performed */
+    double test = 0.0;      /** Time spent testing for completion (secs) */
+    double in_flight = 0.0; /** Summed time from posting to detected completion (secs) */
+    double wait = 0.0;      /** Time the host thread spent blocked in comm_wait (secs) */
+  };
+
+  /**
+     @brief Start a message and hand it to the progress thread
+     @param[in] comm Communicator that owns the message handle
+     @param[in] mh Message handle
+   */
+  void comm_progress_start(Communicator &comm, MsgHandle *mh);
+
+  /**
+     @brief Query whether a message owned by the progress thread has
+     completed.  This does not call into the transport.
+     @param[in] mh Message handle
+     @return Whether the message has completed
+   */
+  int comm_progress_query(MsgHandle *mh);
+
+  /**
+     @brief Block until a message owned by the progress thread has completed
+     @param[in] mh Message handle
+   */
+  void comm_progress_wait(MsgHandle *mh);
+
+  /**
+     @brief Release a message handle, waiting for it first if it is in flight
+     @param[in] comm Communicator that owns the message handle
+     @param[in,out] mh Message handle, set to nullptr on return
+   */
+  void comm_progress_free(Communicator &comm, MsgHandle *&mh);
+
+  /**
+     @return The statistics accumulated by the progress thread
+   */
+  comm_progress_stats_t comm_progress_stats();
+
+  /**
+     @brief Stop the progress thread and report its statistics
+   */
+  void comm_progress_finalize();
+
+} // namespace quda
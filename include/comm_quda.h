@@ -328,6 +328,15 @@ namespace quda
   */
   void comm_enable_peer2peer(bool enable);
 
+  /**
+     @brief Enable / disable peer-to-peer communication in a single
+     dimension, in addition to the global setting: used by the dslash
+     policy tuner to select peer-to-peer per dimension
+     @param[in] dim Dimension (0-3)
+     @param[in] enable Boolean flag to enable / disable peer-to-peer communication
+  */
+  void comm_enable_peer2peer(int dim, bool enable);
+
   /**
      Query if intra-node (non-peer-to-peer) communication is enabled
      in a given dimension and direction
@@ -361,6 +370,19 @@ namespace quda
    */
   bool comm_zero_copy_enabled();
 
+  /**
+     @brief Return if the communication progress thread has been
+     enabled.  When enabled, started message handles are handed to a
+     background thread that drives them to completion, so that
+     host-staged halo exchanges progress while the host is busy
+     launching work; comm_query and comm_wait then only inspect the
+     completion flags set by that thread.  This is enabled with the
+     environment variable QUDA_ENABLE_COMMS_PROGRESS=1 and requires a
+     thread-safe transport (MPI_THREAD_MULTIPLE).
+     @return Return if the communication progress thread is enabled
+   */
+  bool comm_progress_enabled();
+
   /**
      @brief Query if NVSHMEM communication is enabled (global setting)
   */
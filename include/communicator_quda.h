@@ -316,7 +316,13 @@ namespace quda
 
     bool enable_p2p = true;
 
-    bool comm_peer2peer_enabled(int dir, int dim) { return enable_p2p ? peer2peer_enabled[dir][dim] : false; }
+    /** per-dimension enable, used by the dslash policy tuner */
+    bool enable_p2p_dim[4] = {true, true, true, true};
+
+    bool comm_peer2peer_enabled(int dir, int dim)
+    {
+      return enable_p2p && enable_p2p_dim[dim] ? peer2peer_enabled[dir][dim] : false;
+    }
 
     bool init = false;
     bool p2p_global = false;
@@ -339,6 +345,8 @@ namespace quda
 
     void comm_enable_peer2peer(bool enable) { enable_p2p = enable; }
 
+    void comm_enable_peer2peer(int dim, bool enable) { enable_p2p_dim[dim] = enable; }
+
     bool enable_intranode = true;
 
     bool comm_intranode_enabled(int dir, int dim) { return enable_intranode ? intranode_enabled[dir][dim] : false; }
@@ -514,6 +522,26 @@ namespace quda
     return zero_copy_enabled;
   }
 
+  bool comm_progress_enabled()
+  {
+    static bool progress_enabled = false;
+#ifdef MULTI_GPU
+    static bool progress_init = false;
+    if (!progress_init) {
+      char *enable_progress_env = getenv("QUDA_ENABLE_COMMS_PROGRESS");
+      if (enable_progress_env && strcmp(enable_progress_env, "1") == 0) {
+        if (comm_thread_multiple()) {
+          progress_enabled = true;
+        } else {
+          warningQuda("QUDA_ENABLE_COMMS_PROGRESS=1 requires a thread-safe transport (MPI_THREAD_MULTIPLE), disabling");
+        }
+      }
+      progress_init = true;
+    }
+#endif
+    return progress_enabled;
+  }
+
   bool comm_nvshmem_enabled()
   {
 #if (defined MULTI_GPU) && (defined NVSHMEM_COMMS)
@@ -747,6 +775,13 @@ namespace quda
 
   int comm_query(MsgHandle *mh);
 
+  /**
+     @brief Whether the transport supports concurrent calls from
+     multiple threads, which is required by the communication progress
+     thread (see comm_progress_enabled)
+  */
+  bool comm_thread_multiple();
+
   template <typename T> T deterministic_reduce(T *array, int n)
   {
     std::sort(array, array + n); // sort reduction into ascending order for deterministic reduction
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <memory>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <dirac_quda.h>
+
+/**
+   @file deep_halo.h
+
+   Communication-avoiding application of repeated operators.  A
+   deep-halo field is a ColorSpinorField that is extended by R sites
+   in each partitioned dimension, in the same way as the extended
+   gauge fields (see createExtendedGauge).  After a single exchange of
+   depth R, an operator with a stencil of s hops can be applied k =
+   R / s times in succession with communication disabled: each
+   application invalidates a further s layers of the halo, while the
+   interior remains exact.  The redundant computation on the halo
+   trades against k - 1 halo exchanges.
+ */
+
+namespace quda
+{
+
+  /**
+     @brief Exchange the halo region of a set of extended fields.  On
+     return the outer R[d] layers in each partitioned dimension d are
+     filled with the corresponding interior layers of the neighboring
+     processes, including the corner regions.
+     @param[in,out] v The extended fields
+     @param[in] R The halo depth in each dimension
+   */
+  void exchangeExtendedGhost(cvector_ref<ColorSpinorField> &v, const lat_dim_t &R);
+
+  /**
+     @brief Applies up to depth consecutive operator applications to
+     extended fields between halo exchanges.  The operator is
+     rebuilt on an extended copy of the gauge field with
+     communication disabled.
+   */
+  class DeepHalo
+  {
+    int depth;                         /** Number of applications per halo exchange */
+    lat_dim_t R = {};                  /** Halo depth in each dimension */
+    std::unique_ptr<GaugeField> gauge; /** Extended gauge field */
+    std::unique_ptr<Dirac> dirac;      /** Dirac operator on the extended lattice */
+    std::unique_ptr<DiracMatrix> ext;  /** Operator on the extended lattice */
+
+  public:
+    /**
+       @brief Constructor for the deep-halo operator
+       @param[in] mat The operator we are applying
+       @param[in] depth The number of consecutive applications per halo exchange
+     */
+    DeepHalo(const DiracMatrix &mat, int depth);
+
+    /**
+       @return Whether the deep-halo application is supported for this
+       operator: only operators whose stencil depends solely on the
+       gauge field are supported
+     */
+    static bool supported(const DiracMatrix &mat);
+
+    /**
+       @return The number of operator applications per halo exchange
+     */
+    int Depth() const { return depth; }
+
+    /**
+       @return The halo depth in each dimension
+     */
+    const lat_dim_t &HaloDepth() const { return R; }
+
+    /**
+       @return The parameters for an extended field matching the
+       given field
+       @param[in] field The field on the original lattice
+     */
+    ColorSpinorParam extendedParam(const ColorSpinorField &field) const;
+
+    /**
+       @brief Copy fields into the interior of extended fields.  The
+       halo is not filled: this is deferred to exchange so that
+       several sets of fields can share one exchange.
+       @param[out] out The extended fields
+       @param[in] in The fields on the original lattice
+     */
+    void extend(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const;
+
+    /**
+       @brief Refresh the halo of extended fields
+       @param[in,out] v The extended fields
+     */
+    void exchange(cvector_ref<ColorSpinorField> &v) const { exchangeExtendedGhost(v, R); }
+
+    /**
+       @brief Copy the interior of extended fields back to the original lattice
+       @param[out] out The fields on the original lattice
+       @param[in] in The extended fields
+     */
+    void extract(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const;
+
+    /**
+       @brief Apply the operator to extended fields without
+       communication.  The result is exact on the interior and the
+       inner (R - s) layers of the halo of the input.
+       @param[out] out The extended output fields
+       @param[in] in The extended input fields
+     */
+    void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const
+    {
+      (*ext)(out, in);
+    }
+  };
+
+} // namespace quda
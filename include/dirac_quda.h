@@ -55,7 +55,7 @@ namespace quda {
 
     array<int, QUDA_MAX_DIM> commDim; // whether to do comms or not
 
-    QudaPrecision halo_precision; // only does something for DiracCoarse at present
+    QudaPrecision halo_precision; // precision of the halo exchange (QUDA_INVALID_PRECISION means the field precision)
 
     // for multigrid only
     Transfer *transfer;
@@ -174,7 +174,7 @@ namespace quda {
     bool symmetric;
     mutable QudaDagType dagger; // mutable to simplify implementation of Mdag
     QudaDiracType type;
-    mutable QudaPrecision halo_precision; // only does something for DiracCoarse at present
+    mutable QudaPrecision halo_precision; // precision of the halo exchange (QUDA_INVALID_PRECISION means the field precision)
 
     mutable array<int, QUDA_MAX_DIM> commDim; // whether do comms or not
 
@@ -466,6 +466,11 @@ namespace quda {
      */
     static QudaDslashType dirac_to_dslash_type(QudaDiracType);
 
+    /**
+       @return The gauge field the operator is built on
+    */
+    GaugeField *getGaugeField() const { return gauge; }
+
     /**
         @brief Return the one-hop field for staggered operators for MG setup
 
@@ -2325,6 +2330,16 @@ public:
 
     const Dirac *Expose() const { return dirac; }
 
+    /**
+       @brief Return the halo precision to push onto the halo-precision
+       stack when applying the operator (see pushHaloPrecision).
+       Coarse operators apply their halo precision directly.
+    */
+    QudaPrecision haloPrecision() const
+    {
+      return dirac->isCoarse() ? QUDA_INVALID_PRECISION : dirac->HaloPrecision();
+    }
+
     //! Shift term added onto operator (M/M^dag M/M M^dag + shift)
     double shift;
   };
@@ -2343,7 +2358,9 @@ public:
      */
     void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const override
     {
+      pushHaloPrecision(haloPrecision());
       dirac->M(out, in);
+      popHaloPrecision();
       if (shift != 0.0) blas::axpy(shift, in, out);
     }
 
@@ -2364,7 +2381,9 @@ public:
      */
     void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const override
     {
+      pushHaloPrecision(haloPrecision());
       dirac->MdagM(out, in);
+      popHaloPrecision();
       if (shift != 0.0) blas::axpy(shift, in, out);
     }
 
@@ -2391,7 +2410,9 @@ public:
      */
     void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const override
     {
+      pushHaloPrecision(haloPrecision());
       dirac->MdagMLocal(out, in);
+      popHaloPrecision();
     }
 
     int getStencilSteps() const override
@@ -2415,7 +2436,9 @@ public:
      */
     void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const override
     {
+      pushHaloPrecision(haloPrecision());
       dirac->MMdag(out, in);
+      popHaloPrecision();
       if (shift != 0.0) blas::axpy(shift, in, out);
     }
 
@@ -2441,7 +2464,9 @@ public:
      */
     void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const override
     {
+      pushHaloPrecision(haloPrecision());
       dirac->Mdag(out, in);
+      popHaloPrecision();
       if (shift != 0.0) blas::axpy(shift, in, out);
     }
 
@@ -2565,7 +2590,9 @@ public:
      */
     void operator()(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const override
     {
+      pushHaloPrecision(haloPrecision());
       dirac->M(out, in);
+      popHaloPrecision();
       if (shift != 0.0) blas::axpy(shift, in, out);
       applyGamma5(out);
     }
@@ -66,6 +66,12 @@ namespace quda
 
       if (arg.xpay) strcat(aux_base, ",xpay");
       if (arg.dagger) strcat(aux_base, ",dagger");
+      if (halo.GhostPrecision() != halo.Precision()) {
+        strcat(aux_base, ",halo_prec=");
+        char halo_str[4];
+        u32toa(halo_str, halo.GhostPrecision());
+        strcat(aux_base, halo_str);
+      }
       setRHSstring(aux_base, in.size());
       strcat(aux_base, ",n_rhs_tile=");
       char tile_str[16];
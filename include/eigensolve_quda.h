@@ -5,6 +5,8 @@
 #include <timer.h>
 #include <dirac_quda.h>
 #include <color_spinor_field.h>
+#include <transfer.h>
+#include <deep_halo.h>
 #include <eigen_helper.h>
 
 namespace quda
@@ -58,6 +60,18 @@ namespace quda
 
     QudaPrecision save_prec = QUDA_INVALID_PRECISION;
 
+    // Local coherence representation of a compressed deflation space
+    std::vector<ColorSpinorField> coherent_basis = {}; /** Block-local basis vectors (full fields) */
+    std::vector<ColorSpinorField> coherent_evecs = {}; /** Per-block coefficients of each eigenvector */
+    std::unique_ptr<Transfer> coherent_transfer;       /** Maps between the eigenvectors and their coefficients */
+
+    // Host-resident deflation space streamed through the device
+    std::vector<quda_ptr> host_evecs = {};          /** Pinned host copies of the eigenvectors */
+    std::vector<ColorSpinorField> host_stage[2] = {}; /** Double-buffered device staging fields for one tile */
+
+    // Communication-avoiding application of the polynomial acceleration
+    std::unique_ptr<DeepHalo> deep_halo; /** Operator on deep-halo fields, if enabled */
+
   public:
     /**
        @brief Constructor for base Eigensolver class
@@ -142,6 +156,31 @@ namespace quda
     */
     void chebyOp(cvector_ref<ColorSpinorField> &out, cvector_ref <const ColorSpinorField> &in);
 
+    /**
+       @brief Apply a scaled Chebyshev polynomial of the operator that
+       damps the interval [a, b] and amplifies the spectrum below a
+       @param[out] out Output spinors
+       @param[in] in Input spinors
+       @param[in] degree Degree of the polynomial
+       @param[in] a Lower end of the damped interval
+       @param[in] b Upper end of the damped interval
+    */
+    void chebyFilter(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in, int degree, double a,
+                     double b);
+
+    /**
+       @brief Apply the terms of degree two and higher of the scaled
+       Chebyshev polynomial on deep-halo fields, exchanging the halo
+       once every deep_halo->Depth() operator applications
+       @param[in,out] out On entry the degree-one term, on exit the filtered spinors
+       @param[in] in Input spinors
+       @param[in] degree Degree of the polynomial
+       @param[in] a Lower end of the damped interval
+       @param[in] b Upper end of the damped interval
+    */
+    void chebyFilterDeepHalo(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in, int degree,
+                             double a, double b);
+
     /**
        @brief Estimate the spectral radius of the operator for the max value of the
        Chebyshev polynomial
@@ -165,8 +204,9 @@ namespace quda
       @param[in] v Vector space
       @param[in] i Ortho block size for Hybrid MGS (1 = modified, j-1 = classical, 1 < i < j-1 = hybrid)
       @param[in] j Use vectors v[0:j-1]
+      @param[in] start Vectors v[0:start-1] are assumed to be orthonormal already
    */
-    void orthonormalizeHMGS(std::vector<ColorSpinorField> &v, int i, int j);
+    void orthonormalizeHMGS(std::vector<ColorSpinorField> &v, int i, int j, int start = 0);
 
     /**
        @brief Check orthonormality of input vector space v
@@ -191,6 +231,15 @@ namespace quda
     void rotateVecs(std::vector<ColorSpinorField> &kSpace, const std::vector<T> &rot_array, int offset, int dim,
                     int keep, int locked);
 
+    /**
+       @brief Whether the Ritz rotation of the given vectors can be
+       done with rotateVecsGEMM: this must be requested with
+       use_gemm_rotate, the vectors must not be block-float, and for
+       device vectors the native BLAS library must be available.
+       @param[in] v A vector from the space we are rotating
+    */
+    bool useGEMMRotate(const ColorSpinorField &v) const;
+
     /**
        @brief Permute the vector space using the permutation matrix.
        @param[in/out] kSpace The current Krylov space
@@ -239,6 +288,34 @@ namespace quda
                  cvector_ref<const ColorSpinorField> &evecs, const std::vector<Complex> &evals,
                  bool accumulate = false) const;
 
+    /**
+       @brief Deflate a set of source vectors with the local coherence
+       representation of the eigenspace.  The projection and
+       accumulation are done on the per-block coefficients, and the
+       result is reconstructed with a single prolongation.
+       @param[in,out] sol The resulting deflated vector set
+       @param[in] src The source vector set we are deflating
+       @param[in] evals The eigenvalues to use in deflation
+       @param[in] accumulate Whether to preserve the sol vector content prior to accumulating
+    */
+    void deflateCoherent(cvector_ref<ColorSpinorField> &sol, cvector_ref<const ColorSpinorField> &src,
+                         const std::vector<Complex> &evals, bool accumulate = false) const;
+
+    /**
+       @brief Deflate a set of source vectors with a host-resident
+       eigenspace.  Tiles of deflation_tile_size vectors are copied to
+       the device on a separate stream while the previous tile is
+       being applied, and the inner products and axpys of each tile
+       are accumulated into the result.
+       @param[in,out] sol The resulting deflated vector set
+       @param[in] src The source vector set we are deflating
+       @param[in] evals The eigenvalues or singular values to use in deflation
+       @param[in] svd Whether the space holds left and right singular vectors
+       @param[in] accumulate Whether to preserve the sol vector content prior to accumulating
+    */
+    void deflateStreamed(cvector_ref<ColorSpinorField> &sol, cvector_ref<const ColorSpinorField> &src,
+                         const std::vector<Complex> &evals, bool svd, bool accumulate = false) const;
+
     /**
        @brief Deflate a set of source vectors with a set of left and
        right singular vectors
@@ -252,6 +329,45 @@ namespace quda
                     cvector_ref<const ColorSpinorField> &evecs, const std::vector<Complex> &evals,
                     bool accumulate = false) const;
 
+    /**
+       @brief Compress a computed deflation space according to the
+       deflation_prec and deflation_coherence_n_vec parameters.  The
+       vectors are first converted to deflation_prec, with the
+       deflation kernels promoting them on the fly.  If local
+       coherence is requested, the lowest deflation_coherence_n_vec
+       eigenvectors are block orthogonalized to form a block-local
+       basis, the remaining space is replaced by its coefficients
+       with respect to this basis, and subsequent calls to deflate
+       reconstruct the eigenvectors implicitly.
+       @param[in,out] evecs The deflation space.  On return this
+       holds the converted vectors, or is empty if the space is now
+       held in its local coherence representation.
+    */
+    void compressDeflationSpace(std::vector<ColorSpinorField> &evecs);
+
+    /**
+       @brief Whether the deflation space is held in its local
+       coherence representation
+    */
+    bool coherentDeflation() const { return coherent_transfer != nullptr; }
+
+    /**
+       @brief Move a deflation space to pinned host memory if
+       requested by the deflation_location parameter.  Subsequent
+       calls to deflate and deflateSVD stream the eigenvectors back
+       through a double-buffered device staging area, tile by tile.
+       The staging area is allocated here, once for all subsequent
+       deflations.
+       @param[in,out] evecs The deflation space, which is empty on
+       return if it was moved to the host
+    */
+    void offloadDeflationSpace(std::vector<ColorSpinorField> &evecs);
+
+    /**
+       @brief Whether the deflation space is held in host memory
+    */
+    bool streamedDeflation() const { return !host_evecs.empty(); }
+
     /**
        @brief Computes Left/Right SVD from pre computed Right/Left
        @param[in] evecs Computed eigenvectors of NormOp
@@ -341,6 +457,12 @@ namespace quda
     std::vector<double> alpha = {};
     std::vector<double> beta = {};
 
+    /** Arrow matrices at least this large use the structured Ritz solver */
+    static constexpr int structured_ritz_min_dim = 256;
+
+    /** Whether the current Ritz matrix came from the structured solver */
+    bool structured_ritz = false;
+
   public:
     /**
        @brief Constructor for Thick Restarted Eigensolver class
@@ -375,7 +497,10 @@ namespace quda
     void reorder(std::vector<ColorSpinorField> &kSpace);
 
     /**
-       @brief Get the eigendecomposition from the arrow matrix
+       @brief Get the eigendecomposition from the arrow matrix.  Large
+       matrices use a structured solver that exploits the
+       arrow-plus-tridiagonal shape: O(dim^2) work in total, threaded
+       over the Ritz pairs, rather than a dense O(dim^3) eigensolve.
     */
     void eigensolveFromArrowMat();
 
@@ -636,6 +761,127 @@ namespace quda
                  const QudaEigSpectrumType spec_type);
   };
 
+  /**
+     @brief Chebyshev filtered subspace iteration.  Rather than
+     extending a Krylov space one vector at a time, the entire search
+     space of n_kr vectors is passed through a Chebyshev filter that
+     damps the unwanted part of the spectrum, followed by a block
+     Rayleigh-Ritz projection.  The filter is applied block_size
+     vectors at a time, so large search spaces saturate the multi-RHS
+     operator.  This is suited to computing many (hundreds to
+     thousands of) low modes of a positive semi-definite operator,
+     e.g., the normal operator or the Laplacian.
+
+     The upper bound of the filter interval is estimated once with
+     checkChebyOpMax, and the lower bound is set after every sweep to
+     the largest Ritz value in the search space.  Leading Ritz pairs
+     that satisfy the tolerance are locked and drop out of subsequent
+     filtering.  The degree of the filter is given by poly_deg.
+  */
+  class ChebFilteredSubspace : public EigenSolver
+  {
+    std::vector<double> ritz = {}; /** Ritz values of the search space */
+    double filter_min = 0.0;       /** Lower bound of the damped interval */
+
+  public:
+    /**
+       @brief Constructor for Chebyshev filtered subspace eigensolver class
+       @param eig_param The eigensolver parameters
+       @param mat The operator to solve
+    */
+    ChebFilteredSubspace(const DiracMatrix &mat, QudaEigParam *eig_param);
+
+    /**
+       @return Whether the solver is only for Hermitian systems
+    */
+    virtual bool hermitian() override { return true; } /** Subspace iteration is only for Hermitian systems */
+
+    /**
+       @brief Compute eigenpairs
+       @param[in] kSpace Search space vectors
+       @param[in] evals Computed eigenvalues
+    */
+    void operator()(std::vector<ColorSpinorField> &kSpace, std::vector<Complex> &evals) override;
+
+    /**
+       @brief Apply the Chebyshev filter to the unlocked vectors of the
+       search space, block_size vectors at a time
+       @param[in,out] kSpace The search space
+       @param[in] degree The degree of the filter
+    */
+    void filter(std::vector<ColorSpinorField> &kSpace, int degree);
+
+    /**
+       @brief Rayleigh-Ritz projection of the operator onto the
+       unlocked vectors of the (orthonormal) search space.  The
+       vectors are rotated into the Ritz vectors, ordered by
+       increasing Ritz value.
+       @param[in,out] kSpace The search space
+    */
+    void rayleighRitz(std::vector<ColorSpinorField> &kSpace);
+
+    /**
+       @brief Compute the residua of the leading unlocked Ritz pairs
+       and lock those that have converged.  Since pairs are locked in
+       order, this stops at the first batch with an unconverged pair.
+       @param[in,out] kSpace The search space
+       @return The number of newly locked pairs
+    */
+    int lockConverged(std::vector<ColorSpinorField> &kSpace);
+  };
+
+  /**
+     @brief Rotate a set of vectors in place with a site-blocked GEMM,
+     v_j <- sum_i v_i rot_array[i * keep + j] for j < keep.  For each
+     block of sites, the block of each of the dim vectors is gathered
+     into the columns of a matrix in a single kernel, multiplied by
+     the rotation matrix with the native (or host) BLAS library, and
+     the keep resulting columns are scattered back.  Since every block
+     is read before it is written, no Krylov-sized temporary is
+     needed.  The vectors must be single or double precision.
+     @param[in,out] v The vectors to rotate
+     @param[in] rot_array The rotation matrix (row major, dim x keep)
+     @param[in] dim The number of rows in the rotation array
+     @param[in] keep The number of columns in the rotation array
+     @param[in] workspace The workspace size in units of vectors.
+     The blocks are no smaller than 4096 sites, so the workspace may
+     exceed this for short vectors.
+  */
+  void rotateVecsGEMM(cvector_ref<ColorSpinorField> &v, const std::vector<Complex> &rot_array, int dim, int keep,
+                      int workspace);
+
+  /**
+     @brief Structured O(n^2) eigensolver for the symmetric
+     arrow-plus-tridiagonal matrix of a thick restart: a diagonal
+     block of size m coupled to row m through the arrow, followed by a
+     tridiagonal block.  The eigenvalues are found by bisection and
+     the eigenvectors by inverse iteration.  Vectors of eigenvalues
+     that are close but not degenerate are only orthogonal to
+     O(eps * norm / gap), see orthonormalizeRitzClusters.
+     @param[in] d The diagonal, of length n
+     @param[in] e e[i] = A(i, m) for i < m, and A(i, i + 1) for m <= i < n - 1
+     @param[in] m The position of the arrow
+     @param[out] w The eigenvalues in ascending order
+     @param[out] V The eigenvectors, with V[n * j + i] holding component
+     i of eigenvector j
+  */
+  void arrowEigensolve(const std::vector<double> &d, const std::vector<double> &e, int m, std::vector<double> &w,
+                       std::vector<double> &V);
+
+  /**
+     @brief Orthonormalize the leading Ritz vectors within each
+     cluster of close Ritz values (closer than 1e-3 of the spectral
+     norm, following LAPACK dstein).  Inverse iteration leaves
+     vectors whose eigenvalues are separated by a gap g
+     orthogonal only to O(eps * norm / g).
+     @param[in,out] V The Ritz vectors, with V[n * j + i] holding
+     component i of vector j
+     @param[in] w The Ritz values, in monotonic order
+     @param[in] n The vector length
+     @param[in] k The number of leading vectors to orthonormalize
+  */
+  void orthonormalizeRitzClusters(std::vector<double> &V, const double *w, int n, int k);
+
   /**
      arpack_solve()
 
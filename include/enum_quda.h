@@ -136,11 +136,12 @@ typedef enum QudaInverterType_s {
 } QudaInverterType;
 
 typedef enum QudaEigType_s {
-  QUDA_EIG_TR_LANCZOS,     // Thick restarted lanczos solver
-  QUDA_EIG_BLK_TR_LANCZOS, // Block Thick restarted lanczos solver
-  QUDA_EIG_TR_LANCZOS_3D,  // Thick restarted lanczos solver for 3-d systems
-  QUDA_EIG_IR_ARNOLDI,     // Implicitly Restarted Arnoldi solver
-  QUDA_EIG_BLK_IR_ARNOLDI, // Block Implicitly Restarted Arnoldi solver
+  QUDA_EIG_TR_LANCZOS,             // Thick restarted lanczos solver
+  QUDA_EIG_BLK_TR_LANCZOS,         // Block Thick restarted lanczos solver
+  QUDA_EIG_TR_LANCZOS_3D,          // Thick restarted lanczos solver for 3-d systems
+  QUDA_EIG_IR_ARNOLDI,             // Implicitly Restarted Arnoldi solver
+  QUDA_EIG_BLK_IR_ARNOLDI,         // Block Implicitly Restarted Arnoldi solver
+  QUDA_EIG_CHEB_FILTERED_SUBSPACE, // Chebyshev filtered subspace iteration
   QUDA_EIG_INVALID = QUDA_INVALID_ENUM
 } QudaEigType;
 
@@ -183,6 +184,7 @@ typedef enum QudaMultigridCycleType_s {
   QUDA_MG_CYCLE_FCYCLE,
   QUDA_MG_CYCLE_WCYCLE,
   QUDA_MG_CYCLE_RECURSIVE,
+  QUDA_MG_CYCLE_KCYCLE,
   QUDA_MG_CYCLE_INVALID = QUDA_INVALID_ENUM
 } QudaMultigridCycleType;
 
@@ -640,8 +642,24 @@ typedef enum QudaWFlowStepType_s {
   WFLOW_STEP_W1,
   WFLOW_STEP_W2,
   WFLOW_STEP_VT,
+  WFLOW_STEP_W2_EMBEDDED, // W2 step that also forms the embedded second-order update
+  WFLOW_STEP_VT_EMBEDDED, // Vt step that also forms the local error estimate
 } QudaWFlowStepType;
 
+typedef enum QudaFlowScaleType_s {
+  QUDA_FLOW_SCALE_NONE, // flow for the requested number of steps
+  QUDA_FLOW_SCALE_T0,   // stop once t^2 <E> crosses the target
+  QUDA_FLOW_SCALE_W0,   // stop once t d/dt t^2 <E> crosses the target
+  QUDA_FLOW_SCALE_INVALID = QUDA_INVALID_ENUM
+} QudaFlowScaleType;
+
+typedef enum QudaMDIntegrator_s {
+  QUDA_MD_INTEGRATOR_LEAPFROG,       // second-order leapfrog
+  QUDA_MD_INTEGRATOR_OMELYAN,        // second-order minimum-norm (Omelyan) integrator
+  QUDA_MD_INTEGRATOR_FORCE_GRADIENT, // fourth-order force-gradient integrator
+  QUDA_MD_INTEGRATOR_INVALID = QUDA_INVALID_ENUM
+} QudaMDIntegrator;
+
 #ifdef __cplusplus
 }
 #endif
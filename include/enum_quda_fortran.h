@@ -125,6 +125,7 @@
 #define QUDA_EIG_TR_LANCZOS_3D 2  // Thick Restarted Lanczos Solver for 3-d systems
 #define QUDA_EIG_IR_ARNOLDI 3     // Implicitly restarted Arnoldi solver
 #define QUDA_EIG_BLK_IR_ARNOLDI 4 // Block Implicitly restarted Arnoldi solver (not yet implemented)
+#define QUDA_EIG_CHEB_FILTERED_SUBSPACE 5 // Chebyshev filtered subspace iteration
 #define QUDA_EIG_INVALID QUDA_INVALID_ENUM
 
 #define QudaEigSpectrumType integer(4)
@@ -161,6 +162,7 @@
 #define QUDA_MG_CYCLE_FCYCLE 1
 #define QUDA_MG_CYCLE_WCYCLE 2
 #define QUDA_MG_CYCLE_RECURSIVE 3
+#define QUDA_MG_CYCLE_KCYCLE 4
 #define QUDA_MG_CYCLE_INVALID QUDA_INVALID_ENUM
 
 #define QudaSchwarzType integer(4)
@@ -534,6 +536,18 @@
 #define QUDA_GAUGE_SMEAR_SYMANZIK_FLOW 5
 #define QUDA_GAUGE_SMEAR_INVALID QUDA_INVALID_ENUM
 
+#define QudaFlowScaleType integer(4)
+#define QUDA_FLOW_SCALE_NONE 0
+#define QUDA_FLOW_SCALE_T0 1
+#define QUDA_FLOW_SCALE_W0 2
+#define QUDA_FLOW_SCALE_INVALID QUDA_INVALID_ENUM
+
+#define QudaMDIntegrator integer(4)
+#define QUDA_MD_INTEGRATOR_LEAPFROG 0
+#define QUDA_MD_INTEGRATOR_OMELYAN 1
+#define QUDA_MD_INTEGRATOR_FORCE_GRADIENT 2
+#define QUDA_MD_INTEGRATOR_INVALID QUDA_INVALID_ENUM
+
 #define QudaFermionSmearType integer(4)
 #define QUDA_FERMION_SMEAR_TYPE_GAUSSIAN 0
 #define QUDA_FERMION_SMEAR_TYPE_WUPPERTAL 1
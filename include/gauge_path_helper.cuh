@@ -4,6 +4,7 @@
 #include <quda_matrix.h>
 #include <index_helper.cuh>
 #include <kernel.h>
+#include <gauge_path_program.h>
 
 namespace quda {
 
@@ -117,5 +118,69 @@ namespace quda {
     return linkA;
   }
 
+  /**
+     @brief Return element s of a small per-thread array.  The array
+     is only ever indexed with compile-time constants, so that it is
+     kept in registers rather than demoted to local memory as a
+     runtime index would require.
+     @param[in] a The array
+     @param[in] s The runtime index
+  */
+  template <typename T, int N> __device__ __host__ inline T slotLoad(const T (&a)[N], int s)
+  {
+    T r = a[0];
+#pragma unroll
+    for (int k = 1; k < N; k++)
+      if (s == k) r = a[k];
+    return r;
+  }
+
+  /**
+     @brief Set element s of a small per-thread array, indexing it
+     with compile-time constants only (see slotLoad)
+     @param[in,out] a The array
+     @param[in] s The runtime index
+     @param[in] v The value to store
+  */
+  template <typename T, int N> __device__ __host__ inline void slotStore(T (&a)[N], int s, const T &v)
+  {
+#pragma unroll
+    for (int k = 0; k < N; k++)
+      if (s == k) a[k] = v;
+  }
+
+  /**
+     @brief Evaluates a group of a compiled gauge path program (see
+     gauge_path_program.h), passing each product requested by the
+     program to the emit functor
+
+     @param[in] arg Kernel argument, holding the program in arg.prog
+     @param[in] group Group of the program we are evaluating
+     @param[in] x Full index array of the origin (extended coordinates)
+     @param[in] parity Parity of the origin
+     @param[in] emit Functor called as emit(slot, coeff, product)
+  */
+  template <typename Arg, typename F>
+  __device__ __host__ inline void evaluatePathProgram(const Arg &arg, int group, const int x[4], int parity, F &&emit)
+  {
+    using Link = typename Arg::Link;
+    Link prod[path_program::max_slots];
+
+    for (int i = arg.prog.begin[group]; i < arg.prog.begin[group + 1]; i++) {
+      const path_instruction &in = arg.prog.inst[i];
+      if (in.op == path_instruction::link_op) {
+        Link link = arg.u(in.dir, linkIndexShift(x, in.offset, arg.E), parity ^ in.parity);
+        if (in.backwards) link = conj(link);
+        slotStore(prod, in.dst, in.src < 0 ? link : slotLoad(prod, in.src) * link);
+      } else if (in.src < 0) {
+        Link identity;
+        setIdentity(&identity);
+        emit(in.slot, in.coeff, identity);
+      } else {
+        emit(in.slot, in.coeff, slotLoad(prod, in.src));
+      }
+    }
+  }
+
 }
 
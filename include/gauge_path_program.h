@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <array.h>
+
+/**
+   @file gauge_path_program.h
+
+   Compiler for sets of gauge paths.  The paths of each group are
+   merged into a prefix trie, so that a partial product shared by
+   several paths (e.g., the staple segments common to the rectangles
+   and chairs of improved gauge actions) is computed once per site.
+   The trie is flattened into a program of link multiplications whose
+   partial products are held in a small number of slots, which the
+   kernels evaluate site by site.
+ */
+
+namespace quda
+{
+
+  /**
+     @brief An instruction of a compiled gauge path program.  A link
+     instruction multiplies the partial product in slot src by a link
+     and stores the result in slot dst, where src < 0 denotes the
+     identity.  An emit instruction passes the partial product in
+     slot src (the identity if src < 0) with a coefficient to the
+     output slot of the group.
+   */
+  struct path_instruction {
+    enum op_t { link_op, emit_op };
+    double coeff;      /** Emit: summed coefficient of the paths ending here */
+    int op;            /** Instruction type */
+    int src;           /** Slot of the partial product we are extending or emitting */
+    int dst;           /** Link: slot the extended product is stored in */
+    int dir;           /** Link: link direction */
+    int backwards;     /** Link: whether the link is traversed backwards */
+    int parity;        /** Link: parity of the link site relative to the origin */
+    array<int, 4> offset; /** Link: link site relative to the origin */
+    int slot;          /** Emit: output slot */
+  };
+
+  /**
+     @brief A group of paths evaluated by one thread, starting from
+     a common origin and sharing common prefixes
+   */
+  struct path_group {
+    array<int, 4> origin = {};         /** Start of the paths relative to the site */
+    std::vector<std::vector<int>> path; /** Paths, as sequences of directions 0-7 */
+    std::vector<int> slot;              /** Output slot of each path */
+    std::vector<double> coeff;          /** Coefficient of each path */
+  };
+
+  struct path_program {
+    static constexpr int max_slots = 4; /** Maximum number of partial products held per thread */
+    int num_groups = 0;
+    const int *begin = nullptr;                /** Offset of the instructions of each group */
+    const path_instruction *inst = nullptr;    /** The instructions */
+    int n_link = 0;                            /** Number of link instructions */
+    int n_mult = 0;                            /** Number of matrix multiplications */
+    int n_emit = 0;                            /** Number of emit instructions */
+    void *buffer = nullptr;
+
+    /**
+       @brief Compile the paths and copy the program to the device
+       @param[in] groups The groups of paths
+     */
+    path_program(const std::vector<path_group> &groups);
+
+    void free();
+  };
+
+  /**
+     @return Whether common prefixes are shared between paths
+     (QUDA_ENABLE_GAUGE_PATH_SHARING, default enabled).  When disabled
+     each path is evaluated from scratch.
+   */
+  bool gaugePathSharing();
+
+} // namespace quda
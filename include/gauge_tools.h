@@ -161,6 +161,25 @@ namespace quda
   void GFlowStep(GaugeField &out, GaugeField &temp, GaugeField &in, double epsilon, QudaGaugeSmearType smear_type,
                  QudaWFlowStepType step_type);
 
+  /**
+     @brief Apply Wilson Flow steps W1, W2, Vt to the gauge field
+     together with the embedded second-order integrator of
+     https://arxiv.org/abs/1301.4388, returning the distance between
+     the two updates for adaptive step-size control.  As with
+     WFlowStep, the input field is overwritten by the intermediate W2
+     step.
+     @param[out] out Output smeared field
+     @param[in] temp Temp space
+     @param[in] in Input gauge field
+     @param[out] aux Field of the same volume as temp, holding the
+     difference between the third- and second-order updates on exit
+     @param[in] epsilon Step size
+     @param[in] smear_type Wilson (1x1) or Symanzik improved (2x1) staples, else error
+     @return The maximum absolute element of the difference between the updates
+  */
+  double WFlowStepAdaptive(GaugeField &out, GaugeField &temp, GaugeField &in, GaugeField &aux, double epsilon,
+                           QudaGaugeSmearType smear_type);
+
   /**
    * @brief Gauge fixing with overrelaxation with support for single and multi GPU.
    * @param[in,out] data, quda gauge field
@@ -178,7 +197,7 @@ namespace quda
                       const double relax_boost, const double tolerance, const int reunit_interval, const int stopWtheta);
 
   /**
-   * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
+   * @brief Gauge fixing with Steepest descent method with FFTs with support for single and multi GPU.
    * @param[in,out] data, quda gauge field
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
@@ -189,9 +208,11 @@ namespace quda
    * value is zero then the method stops when iteration reachs the
    * maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterion and 1 to use the theta value
+   * @return The gauge functional (x), theta (y) and the change in the
+   * functional over the last step (z) at the end of the gauge fixing
    */
-  void gaugeFixingFFT(GaugeField &data, const int gauge_dir, const int Nsteps, const int verbose_interval,
-                      const double alpha, const int autotune, const double tolerance, const int stopWtheta);
+  double3 gaugeFixingFFT(GaugeField &data, const int gauge_dir, const int Nsteps, const int verbose_interval,
+                         const double alpha, const int autotune, const double tolerance, const int stopWtheta);
 
   /**
      @brief Compute the Fmunu tensor
@@ -69,6 +69,9 @@ namespace quda {
     /**< Whether to user alternative reliable updates (CG only at the moment) */
     bool use_alternative_reliable = false;
 
+    /**< Whether to adapt the reliable update tolerance and sloppy operator precision (CG only at the moment) */
+    bool use_adaptive_reliable = false;
+
     /**< Whether to keep the partial solution accumulator in sloppy precision */
     bool use_sloppy_partial_accumulator = false;
 
@@ -135,6 +138,18 @@ namespace quda {
     /**< The number of iterations performed by the solver */
     int iter = 0;
 
+    /**< Iterations with the sloppy operator applied at the preconditioner precision */
+    int adaptive_iter_low = 0;
+
+    /**< Number of sloppy operator precision switches */
+    int adaptive_switches = 0;
+
+    /**< Reliable update tolerance at the end of the solve */
+    double adaptive_delta = 0.0;
+
+    /**< Largest relative gap between the iterated and true residual at a reliable update */
+    double adaptive_max_gap = 0.0;
+
     /**< The precision used by the QUDA solver */
     QudaPrecision precision = QUDA_INVALID_PRECISION;
 
@@ -245,6 +260,8 @@ namespace quda {
 
     bool global_reduction = true; //! whether to use a global or local (node) reduction for this solver
 
+    bool checkpoint = false; //! whether to periodically checkpoint the solver state (see checkpoint.h)
+
     /** Whether the MG preconditioner (if any) is an instance of MG
         (used internally in MG) or of multigrid_solver (used in the
         interface)*/
@@ -280,6 +297,7 @@ namespace quda {
       compute_null_vector(QUDA_COMPUTE_NULL_VECTOR_NO),
       delta(param.reliable_delta),
       use_alternative_reliable(param.use_alternative_reliable),
+      use_adaptive_reliable(param.use_adaptive_reliable),
       use_sloppy_partial_accumulator(param.use_sloppy_partial_accumulator),
       solution_accumulator_pipeline(param.solution_accumulator_pipeline),
       max_res_increase(param.max_res_increase),
@@ -604,6 +622,14 @@ namespace quda {
     */
     void extendSVDDeflationSpace();
 
+    /**
+       @brief Compress the computed deflation space, and move it to
+       host memory, if a reduced storage precision, local coherence
+       compression or host-resident deflation is requested in the
+       eigensolver parameters
+    */
+    void compressDeflationSpace();
+
     /**
        @brief Injects a deflation space into the solver from the
        vector argument.  Note the input space is reduced to zero size as a
@@ -1519,15 +1545,57 @@ public:
   };
 
   /**
-     @brief Driver for using MinResExt from the context of molecular dynamics
-     @param[out] x Construct solution prediction
-     @param[in] b Source against which we are solving
-     @param[in,out] basis Basis vectors (orthogonalized during the process)
-     @param[in] m Linear operator we are solving against
-     @param[in] hermitian Whether the operator is Hermitian or not
+     @brief Chronological history of past solutions, used to forecast
+     the solution in molecular dynamics with the minimal residual
+     extrapolation of Brower et al.  The solutions are stored at a
+     storage precision that may be lower than that of the operator,
+     together with A p for non-Hermitian operators.  The Gram matrix
+     of the projected system is maintained incrementally: a forecast
+     only recomputes the rows of entries added since the previous
+     one, unless a probe of a valid entry shows that the operator has
+     changed.
    */
-  void chronoExtrapolate(ColorSpinorField &x, const ColorSpinorField &b, std::vector<ColorSpinorField> &basis,
-                         DiracMatrix &m, bool hermitian);
+  class ChronoHistory
+  {
+    std::vector<ColorSpinorField> p; /** Past solutions, newest first */
+    std::vector<ColorSpinorField> q; /** A p, only stored for non-Hermitian operators */
+    std::vector<bool> valid;         /** Whether the Gram matrix row of each entry is current */
+    std::vector<double4> probe;      /** (p, A p), |p|^2 and |A p|^2 when each row was computed */
+    std::vector<Complex> G;          /** Gram matrix, (p_i, A p_j) if Hermitian else (A p_i, A p_j) */
+    bool hermitian = true;           /** Whether the Gram matrix is for a Hermitian operator */
+
+  public:
+    /**
+       @return The number of entries in the history
+     */
+    size_t size() const { return p.size(); }
+
+    /**
+       @brief Release all entries
+     */
+    void clear();
+
+    /**
+       @brief Add solutions to the front of the history, dropping the
+       oldest entries beyond max_dim
+       @param[in] x The solutions
+       @param[in] max_dim Maximum length of the history
+       @param[in] precision Precision the entries are stored in
+       @param[in] replace_last Whether the solutions replace the newest entries
+     */
+    void add(cvector_ref<const ColorSpinorField> &x, int max_dim, QudaPrecision precision, bool replace_last);
+
+    /**
+       @brief Forecast the solutions of A x = b from the history
+       @param[out] x The forecast solutions
+       @param[in] b The sources
+       @param[in] m Linear operator we are solving against
+       @param[in] precision Precision of the operator
+       @param[in] hermitian Whether the operator is Hermitian or not
+     */
+    void extrapolate(cvector_ref<ColorSpinorField> &x, cvector_ref<const ColorSpinorField> &b, const DiracMatrix &m,
+                     QudaPrecision precision, bool hermitian);
+  };
 
   using ColorSpinorFieldSet = ColorSpinorField;
 
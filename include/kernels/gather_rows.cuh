@@ -0,0 +1,44 @@
+#include <complex_quda.h>
+#include <tunable_nd.h>
+
+/**
+   @file The following contains the argument and kernel for gathering a
+   block of rows of a set of vectors into the columns of a matrix, and
+   for scattering them back.
+*/
+
+namespace quda
+{
+
+  template <typename T, bool scatter_> struct GatherRowsArg : kernel_param<> {
+    static constexpr bool scatter = scatter_;
+    T *w;                  // matrix of gathered rows (column major)
+    T *const *v;           // array of the vector pointers
+    unsigned int ld;       // leading dimension of w
+    size_t start;          // first row of the block
+    unsigned int rows;     // number of rows in the block
+
+    GatherRowsArg(T *w, T *const *v, unsigned int ld, size_t start, unsigned int rows, unsigned int n) :
+      kernel_param(dim3(rows * n, 1, 1)), w(w), v(v), ld(ld), start(start), rows(rows)
+    {
+    }
+  };
+
+  template <class Arg> struct GatherRows {
+    const Arg &arg;
+    constexpr GatherRows(const Arg &arg) : arg(arg) { }
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    __device__ __host__ inline void operator()(unsigned int idx)
+    {
+      // consecutive threads access consecutive rows of the same vector
+      auto col = idx / arg.rows;
+      auto row = idx - col * arg.rows;
+      if (Arg::scatter)
+        arg.v[col][arg.start + row] = arg.w[col * arg.ld + row];
+      else
+        arg.w[col * arg.ld + row] = arg.v[col][arg.start + row];
+    }
+  };
+
+} // namespace quda
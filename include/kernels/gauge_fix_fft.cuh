@@ -70,6 +70,135 @@ namespace quda {
     }
   };
 
+  /**
+     Reorderings used by the distributed FFT.  For dimension d the
+     local lexicographical data are reordered into lines along d
+     (LOCAL_TO_LINE), so that for P ranks in dimension d chunk q of
+     the line data holds the lines sent to rank q.  The chunks
+     received from the all-to-all are then reordered into complete
+     global lines (RECV_TO_FFT), and the inverse reorderings undo
+     this after the FFT.
+  */
+  enum FFTReorderType { FFT_LOCAL_TO_LINE, FFT_LINE_TO_LOCAL, FFT_RECV_TO_FFT, FFT_FFT_TO_SEND };
+
+  template <typename Float, FFTReorderType type_> struct GaugeFixFFTReorderArg : kernel_param<> {
+    static constexpr FFTReorderType type = type_;
+    int_fastdiv X[4]; // local grid dimensions
+    int dim;          // dimension being transformed
+    int_fastdiv L;    // local extent in dim
+    int_fastdiv nl;   // number of lines held by each rank after the all-to-all
+    int P;            // number of ranks in dim
+    const complex<Float> *in;
+    complex<Float> *out;
+    GaugeFixFFTReorderArg(const GaugeField &data, int dim, int P, const complex<Float> *in, complex<Float> *out) :
+      kernel_param(dim3(data.Volume(), 1, 1)),
+      dim(dim),
+      L(data.X()[dim]),
+      nl(data.Volume() / (data.X()[dim] * P)),
+      P(P),
+      in(in),
+      out(out)
+    {
+      for (int d = 0; d < 4; d++) X[d] = data.X()[d];
+    }
+  };
+
+  template <typename Arg> struct FFTReorder {
+    const Arg &arg;
+    constexpr FFTReorder(const Arg &arg) : arg(arg) {}
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    __device__ __host__ inline void operator()(int id)
+    {
+      if constexpr (Arg::type == FFT_LOCAL_TO_LINE || Arg::type == FFT_LINE_TO_LOCAL) {
+        // id is the local lexicographical index
+        int x[4];
+        x[0] = id % arg.X[0];
+        x[1] = (id / arg.X[0]) % arg.X[1];
+        x[2] = (id / (arg.X[0] * arg.X[1])) % arg.X[2];
+        x[3] = id / (arg.X[0] * arg.X[1] * arg.X[2]);
+
+        int line = 0;
+        for (int i = 3; i >= 0; i--)
+          if (i != arg.dim) line = line * arg.X[i] + x[i];
+        int id_line = line * arg.L + x[arg.dim];
+
+        if constexpr (Arg::type == FFT_LOCAL_TO_LINE)
+          arg.out[id_line] = arg.in[id];
+        else
+          arg.out[id] = arg.in[id_line];
+      } else {
+        // id = (q * nl + l) * L + k is the index into the all-to-all buffers
+        int k = id % arg.L;
+        int l = (id / arg.L) % arg.nl;
+        int q = id / (arg.L * arg.nl);
+        int id_fft = (l * arg.P + q) * arg.L + k;
+
+        if constexpr (Arg::type == FFT_RECV_TO_FFT)
+          arg.out[id_fft] = arg.in[id];
+        else
+          arg.out[id] = arg.in[id_fft];
+      }
+    }
+  };
+
+  /**
+     @brief Lexicographical index of site x[] on the face orthogonal to mu
+  */
+  template <typename I> __device__ __host__ inline int faceIndexFull(const int x[], const I X[4], int mu)
+  {
+    int idx = 0;
+    for (int i = 3; i >= 0; i--)
+      if (i != mu) idx = idx * X[i] + x[i];
+    return idx;
+  }
+
+  template <typename Float> struct GaugeFixFFTFaceArg : kernel_param<> {
+    int_fastdiv X[4]; // local grid dimensions
+    int mu;
+    int volume;
+    int face;
+    const complex<Float> *delta;
+    complex<Float> *out;
+    GaugeFixFFTFaceArg(const GaugeField &data, int mu, const complex<Float> *delta, complex<Float> *out) :
+      kernel_param(dim3(data.Volume() / data.X()[mu], 1, 1)),
+      mu(mu),
+      volume(data.Volume()),
+      face(data.Volume() / data.X()[mu]),
+      delta(delta),
+      out(out)
+    {
+      for (int d = 0; d < 4; d++) X[d] = data.X()[d];
+    }
+  };
+
+  /**
+     @brief Pack the six independent elements of Delta(x) on the x[mu]
+     = 0 face, which the neighbouring rank in the backwards mu
+     direction needs to apply g(x + mu)
+  */
+  template <typename Arg> struct FFTFacePack {
+    const Arg &arg;
+    constexpr FFTFacePack(const Arg &arg) : arg(arg) {}
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    __device__ __host__ inline void operator()(int f)
+    {
+      int x[4];
+      int r = f;
+      for (int i = 0; i < 4; i++) {
+        if (i == arg.mu) {
+          x[i] = 0;
+        } else {
+          x[i] = r % arg.X[i];
+          r /= arg.X[i];
+        }
+      }
+      int idx = ((x[3] * arg.X[2] + x[2]) * arg.X[1] + x[1]) * arg.X[0] + x[0];
+      for (int c = 0; c < 6; c++) arg.out[f + c * arg.face] = arg.delta[idx + c * arg.volume];
+    }
+  };
+
   template <typename store_t, QudaReconstructType recon>
   struct GaugeFixArg : kernel_param<> {
     using Float = typename mapper<store_t>::type;
@@ -82,14 +211,31 @@ namespace quda {
     complex<Float> *gx;
     Float alpha;
     int volume;
+    bool distributed;          // whether the FFTs are distributed, see set_invpsq
+    int offset[4];             // global coordinate of the local origin
+    int global[4];             // global grid dimensions
+    double global_volume;
+    int commDim[4];            // whether a given dimension is partitioned
+    int faceVolume[4];         // sites on the face orthogonal to each dimension
+    complex<Float> *delta_halo[4]; // Delta(x) on the forwards face, received from the neighbouring rank
 
     GaugeFixArg(GaugeField &data, double alpha) :
       kernel_param(dim3(data.VolumeCB(), 2, 1)),
       data(data),
       alpha(static_cast<Float>(alpha)),
-      volume(data.Volume())
+      volume(data.Volume()),
+      distributed(comm_partitioned()),
+      global_volume(static_cast<double>(data.Volume()) * comm_size())
     {
       for (int dir = 0; dir < 4; ++dir ) X[dir] = data.X()[dir];
+      for (int dir = 0; dir < 4; ++dir) {
+        offset[dir] = comm_coord(dir) * X[dir];
+        global[dir] = comm_dim(dir) * X[dir];
+        commDim[dir] = comm_dim_partitioned(dir);
+        faceVolume[dir] = volume / X[dir];
+        delta_halo[dir] = commDim[dir] ? (complex<Float> *)device_malloc(sizeof(complex<Float>) * faceVolume[dir] * 6) :
+                                         nullptr;
+      }
       invpsq = (Float*)device_malloc(sizeof(Float) * volume);
       delta = (complex<Float>*)device_malloc(sizeof(complex<Float>) * volume * 6);
 #ifdef GAUGEFIXING_DONT_USE_GX
@@ -104,6 +250,8 @@ namespace quda {
       device_free(invpsq);
       device_free(delta);
       device_free(gx);
+      for (int dir = 0; dir < 4; ++dir)
+        if (delta_halo[dir]) device_free(delta_halo[dir]);
     }
   };
 
@@ -117,19 +265,28 @@ namespace quda {
     {
       using Float = typename Arg::Float;
       int id = parity * arg.threads.x + x_cb;
-      int x1 = id / (arg.X[2] * arg.X[3] * arg.X[0]);
-      int x0 = (id / (arg.X[2] * arg.X[3])) % arg.X[0];
-      int x3 = (id / arg.X[2]) % arg.X[3];
-      int x2 = id % arg.X[2];
-      //id  =  x2 + (x3 +  (x0 + x1 * arg.X[0]) * arg.X[3]) * arg.X[2];
-      Float sx = quda::sinpi( (Float)x0 / (Float)arg.X[0]);
-      Float sy = quda::sinpi( (Float)x1 / (Float)arg.X[1]);
-      Float sz = quda::sinpi( (Float)x2 / (Float)arg.X[2]);
-      Float st = quda::sinpi( (Float)x3 / (Float)arg.X[3]);
-      Float sinsq = sx * sx + sy * sy + sz * sz + st * st;
+      int x[4];
+      if (arg.distributed) {
+        // distributed FFTs leave the momenta in the local lexicographical layout
+        x[0] = id % arg.X[0];
+        x[1] = (id / arg.X[0]) % arg.X[1];
+        x[2] = (id / (arg.X[0] * arg.X[1])) % arg.X[2];
+        x[3] = id / (arg.X[0] * arg.X[1] * arg.X[2]);
+      } else {
+        x[1] = id / (arg.X[2] * arg.X[3] * arg.X[0]);
+        x[0] = (id / (arg.X[2] * arg.X[3])) % arg.X[0];
+        x[3] = (id / arg.X[2]) % arg.X[3];
+        x[2] = id % arg.X[2];
+        //id  =  x2 + (x3 +  (x0 + x1 * arg.X[0]) * arg.X[3]) * arg.X[2];
+      }
+      Float sinsq = 0.0;
+      for (int dir = 0; dir < 4; dir++) {
+        Float s = quda::sinpi((Float)(arg.offset[dir] + x[dir]) / (Float)arg.global[dir]);
+        sinsq += s * s;
+      }
       Float prcfact = 0.0;
       //The FFT normalization is done here
-      if (sinsq > 0.00001) prcfact = 4.0 / (sinsq * (Float)(arg.volume));
+      if (sinsq > 0.00001) prcfact = 4.0 / (sinsq * (Float)(arg.global_volume));
       arg.invpsq[id] = prcfact;
     }
   };
@@ -161,6 +318,7 @@ namespace quda {
     complex<real> *delta;
     reduce_t result;
     int volume;
+    int commDim[4]; // whether a given dimension is partitioned
 
     GaugeFixQualityFFTArg(const GaugeField &data, complex<real> *delta) :
       ReduceArg<reduce_t>(dim3(data.VolumeCB(), 2, 1), 1, true), // reset = true
@@ -170,6 +328,7 @@ namespace quda {
       volume(data.Volume())
     {
       for (int dir = 0; dir < 4; dir++) X[dir] = data.X()[dir];
+      for (int dir = 0; dir < 4; dir++) commDim[dir] = comm_dim_partitioned(dir);
     }
 
     double getAction() { return result[0]; }
@@ -203,7 +362,10 @@ namespace quda {
       data[0] = -delta(0, 0).real() - delta(1, 1).real() - delta(2, 2).real();
       //2
       for (int mu = 0; mu < Arg::gauge_dir; mu++) {
-        matrix U = arg.data(mu, linkIndexM1(x, arg.X, mu), 1 - parity);
+        // backwards links across a partitioned boundary are in the ghost zone
+        matrix U = (arg.commDim[mu] && x[mu] == 0) ?
+          matrix(arg.data.Ghost(mu, ghostFaceIndex<0>(x, arg.X, mu, 1), 1 - parity)) :
+          matrix(arg.data(mu, linkIndexM1(x, arg.X, mu), 1 - parity));
         delta += U;
       }
       //18*gauge_dir
@@ -310,14 +472,18 @@ namespace quda {
         matrix g0;
         U = g * U;
         //198
-        idx = linkNormalIndexP1(x, arg.X, mu);
+        // Delta(x + mu) across a partitioned boundary was received from the neighbour
+        const bool halo = arg.commDim[mu] && x[mu] == arg.X[mu] - 1;
+        const complex *delta = halo ? arg.delta_halo[mu] : arg.delta;
+        const int stride = halo ? arg.faceVolume[mu] : arg.volume;
+        idx = halo ? faceIndexFull(x, arg.X, mu) : linkNormalIndexP1(x, arg.X, mu);
         //Read Delta
-        de(0,0) = arg.delta[idx + 0 * arg.volume];
-        de(0,1) = arg.delta[idx + 1 * arg.volume];
-        de(0,2) = arg.delta[idx + 2 * arg.volume];
-        de(1,1) = arg.delta[idx + 3 * arg.volume];
-        de(1,2) = arg.delta[idx + 4 * arg.volume];
-        de(2,2) = arg.delta[idx + 5 * arg.volume];
+        de(0,0) = delta[idx + 0 * stride];
+        de(0,1) = delta[idx + 1 * stride];
+        de(0,2) = delta[idx + 2 * stride];
+        de(1,1) = delta[idx + 3 * stride];
+        de(1,2) = delta[idx + 4 * stride];
+        de(2,2) = delta[idx + 5 * stride];
 
         de(1,0) = complex(-de(0,1).real(), de(0,1).imag());
         de(2,0) = complex(-de(0,2).real(), de(0,2).imag());
@@ -3,7 +3,6 @@
 #include <gauge_field_order.h>
 #include <quda_matrix.h>
 #include <index_helper.cuh>
-#include <thread_array.h>
 #include <kernel.h>
 #include <gauge_path_helper.cuh>
 
@@ -27,14 +26,14 @@ namespace quda {
     int border[4]; // radius of border
 
     real epsilon; // stepsize and any other overall scaling factor
-    const paths<4> p;
+    const path_program prog; // one group of paths per direction
 
-    GaugeForceArg(GaugeField &mom, const GaugeField &u, double epsilon, const paths<4> &p) :
+    GaugeForceArg(GaugeField &mom, const GaugeField &u, double epsilon, const path_program &prog) :
       kernel_param(dim3(mom.VolumeCB(), 2, 4)),
       mom(mom),
       u(u),
       epsilon(epsilon),
-      p(p)
+      prog(prog)
     {
       for (int i = 0; i < 4; i++) {
         X[i] = mom.X()[i];
@@ -44,12 +43,9 @@ namespace quda {
     }
   };
 
-  template <typename Arg> struct GaugeForce : KernelOps<thread_array<int, 4>> {
+  template <typename Arg> struct GaugeForce {
     const Arg &arg;
-    template <typename... OpsArgs>
-    constexpr GaugeForce(const Arg &arg, const OpsArgs &...ops) : KernelOpsT(ops...), arg(arg)
-    {
-    }
+    constexpr GaugeForce(const Arg &arg) : arg(arg) { }
     static constexpr const char *filename() { return KERNEL_FILE; }
 
     __device__ __host__ void operator()(int x_cb, int parity, int dir)
@@ -64,23 +60,10 @@ namespace quda {
       // prod: current matrix product
       // accum: accumulator matrix
       Link link_prod, accum;
-      thread_array<int, 4> dx {*this};
-
-      for (int i=0; i<arg.p.num_paths; i++) {
-        real coeff = arg.p.path_coeff[i];
-        if (coeff == 0) continue;
-
-        const int* path = arg.p.input_path[dir] + i*arg.p.max_length;
-
-        // the gauge path starts pre-shifted, so we need to do the shift + update the parity
-        dx[dir]++;
-        int nbr_oddbit = (parity ^ 1);
-
-        // compute the path
-        link_prod = computeGaugePath(arg, x, nbr_oddbit, path, arg.p.length[i], dx);
 
-        accum = accum + coeff * link_prod;
-      } //i
+      // the paths of each direction start pre-shifted by one site, which is baked into the program
+      evaluatePathProgram(arg, dir, x, parity,
+                          [&](int, double coeff, const Link &prod) { accum = accum + static_cast<real>(coeff) * prod; });
 
       // multiply by U(x)
       link_prod = arg.u(dir, linkIndex(x,arg.E), parity);
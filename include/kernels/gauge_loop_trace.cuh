@@ -4,7 +4,6 @@
 #include <quda_matrix.h>
 #include <index_helper.cuh>
 #include <kernel.h>
-#include <thread_array.h>
 #include <array.h>
 #include <reduce_helper.h>
 #include <reduction_kernel.h>
@@ -17,10 +16,16 @@ namespace quda {
   */
   constexpr unsigned int max_n_batch_block_loop_trace() { return 8; }
 
+  /**
+    @brief Return the number of loops evaluated by each thread, whose
+    common prefixes are shared.
+  */
+  constexpr int loop_trace_group_size() { return 4; }
+
   template <typename store_t, int nColor_, QudaReconstructType recon_>
-  struct GaugeLoopTraceArg : public ReduceArg<array<double, 2>>  {
+  struct GaugeLoopTraceArg : public ReduceArg<array<double, 2 * loop_trace_group_size()>>  {
     using real = typename mapper<store_t>::type;
-    using reduce_t = array<double, 2>;
+    using reduce_t = array<double, 2 * loop_trace_group_size()>;
     static constexpr unsigned int max_n_batch_block = max_n_batch_block_loop_trace();
     static constexpr int nColor = nColor_;
     static constexpr QudaReconstructType recon = recon_;
@@ -36,13 +41,13 @@ namespace quda {
     int E[4]; // the extended volume parameters
     int border[4]; // radius of border
 
-    const paths<1> p;
+    const path_program prog; // one group of loops per batch index
 
-    GaugeLoopTraceArg(const GaugeField &u, double factor, const paths<1> &p) :
-      ReduceArg<reduce_t>(dim3(u.LocalVolumeCB(), 2, p.num_paths), p.num_paths),
+    GaugeLoopTraceArg(const GaugeField &u, double factor, const path_program &prog) :
+      ReduceArg<reduce_t>(dim3(u.LocalVolumeCB(), 2, prog.num_groups), prog.num_groups),
       u(u),
       factor(factor),
-      p(p)
+      prog(prog)
     {
       for (int dir = 0; dir < 4; dir++) {
         border[dir] = u.R()[dir];
@@ -52,42 +57,36 @@ namespace quda {
     }
   };
 
-  template <typename Arg> struct GaugeLoop : plus<typename Arg::reduce_t>, KernelOps<thread_array<int, 4>> {
+  template <typename Arg> struct GaugeLoop : plus<typename Arg::reduce_t> {
     using reduce_t = typename Arg::reduce_t;
     using plus<reduce_t>::operator();
     static constexpr int reduce_block_dim = 2; // x_cb and parity are mapped to x
     const Arg &arg;
-    template <typename... OpsArgs>
-    constexpr GaugeLoop(const Arg &arg, const OpsArgs &...ops) : KernelOpsT(ops...), arg(arg)
-    {
-    }
+    constexpr GaugeLoop(const Arg &arg) : arg(arg) { }
     static constexpr const char *filename() { return KERNEL_FILE; }
 
-    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity, int path_id)
+    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity, int group)
     {
       using Link = typename Arg::Link;
 
-      reduce_t loop_trace{0, 0};
+      reduce_t loop_trace = zero<reduce_t>();
 
       int x[4] = {0, 0, 0, 0};
       getCoords(x, x_cb, arg.X, parity);
       for (int dr=0; dr<4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
 
-      thread_array<int, 4> dx {*this};
-
-      double coeff_loop = arg.factor * arg.p.path_coeff[path_id];
-      if (coeff_loop == 0) return operator()(loop_trace, value);
-
-      const int* path = arg.p.input_path[0] + path_id * arg.p.max_length;
-
-      // compute the path
-      Link link_prod = computeGaugePath(arg, x, parity, path, arg.p.length[path_id], dx);
-
-      // compute trace
-      auto trace = getTrace(link_prod);
-
-      loop_trace[0] = coeff_loop * trace.real();
-      loop_trace[1] = coeff_loop * trace.imag();
+      // compute the loops of this group and their traces
+      evaluatePathProgram(arg, group, x, parity, [&](int slot, double coeff, const Link &prod) {
+        auto trace = getTrace(prod);
+        // compile-time indices keep the accumulator in registers
+#pragma unroll
+        for (int k = 0; k < loop_trace_group_size(); k++) {
+          if (slot == k) {
+            loop_trace[2 * k + 0] += arg.factor * coeff * trace.real();
+            loop_trace[2 * k + 1] += arg.factor * coeff * trace.imag();
+          }
+        }
+      });
 
       return operator()(loop_trace, value);
     }
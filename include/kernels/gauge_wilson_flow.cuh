@@ -24,6 +24,7 @@ namespace quda
 
     Gauge out;
     Matrix temp;
+    Matrix aux; // embedded update and error estimate for adaptive steps
     const Gauge in;
 
     int_fastdiv X[4]; // grid dimensions
@@ -33,10 +34,11 @@ namespace quda
     const real coeff1x1;
     const real coeff2x1;
 
-    GaugeWFlowArg(GaugeField &out, GaugeField &temp, const GaugeField &in, const real epsilon) :
+    GaugeWFlowArg(GaugeField &out, GaugeField &temp, const GaugeField &in, const real epsilon, GaugeField &aux) :
       kernel_param(dim3(in.LocalVolumeCB(), 2, wflow_dim)),
       out(out),
       temp(temp),
+      aux(aux),
       in(in),
       epsilon(epsilon),
       coeff1x1(5.0 / 3.0),
@@ -106,15 +108,33 @@ namespace quda
   {
     using Arg = typename Ftor::Arg;
     const Arg &arg = ftor.arg;
+    using real = typename Arg::real;
     // Compute staples and Z1
-    Link Z1 = static_cast<typename Arg::real>(8.0 / 9.0) * computeStaple(ftor, x, parity, dir);
+    Link Z1 = computeStaple(ftor, x, parity, dir);
     U = arg.in(dir, linkIndex(x, arg.E), parity);
     Z1 *= conj(U);
 
-    // Retrieve Z0, (8/9 Z1 - 17/36 Z0) stored in temp
+    // Retrieve Z0 stored in temp
     Link Z0 = arg.temp(dir, x_cb, parity);
-    Z0 *= static_cast<typename Arg::real>(17.0 / 36.0);
-    Z1 = Z1 - Z0;
+
+    if constexpr (Arg::step_type == WFLOW_STEP_W2_EMBEDDED) {
+      // Embedded second-order update exp(2 Z1 - Z0) W0, see https://arxiv.org/abs/1301.4388.  The input
+      // here is W1 = exp(Z0 / 4) W0, so first recover W0 = exp(-Z0 / 4) W1.
+      Link Zm = static_cast<real>(-1.0 / 4.0) * Z0;
+      Zm *= arg.epsilon;
+      makeAntiHerm(Zm);
+      Zm = complex<real>(0.0, -1.0) * Zm;
+      Link W0 = exponentiate_iQ(Zm) * U;
+
+      Link Z = static_cast<real>(2.0) * Z1 - Z0;
+      Z *= arg.epsilon;
+      makeAntiHerm(Z);
+      Z = complex<real>(0.0, -1.0) * Z;
+      arg.aux(dir, x_cb, parity) = exponentiate_iQ(Z) * W0;
+    }
+
+    // Store (8/9 Z1 - 17/36 Z0) in temp
+    Z1 = static_cast<real>(8.0 / 9.0) * Z1 - static_cast<real>(17.0 / 36.0) * Z0;
     arg.temp(dir, x_cb, parity) = Z1;
     Z1 *= arg.epsilon;
     return Z1;
@@ -162,8 +182,10 @@ namespace quda
       Link U, Z;
       switch (arg.step_type) {
       case WFLOW_STEP_W1: Z = computeW1Step(*this, U, x, parity, x_cb, dir); break;
-      case WFLOW_STEP_W2: Z = computeW2Step(*this, U, x, parity, x_cb, dir); break;
-      case WFLOW_STEP_VT: Z = computeVtStep(*this, U, x, parity, x_cb, dir); break;
+      case WFLOW_STEP_W2:
+      case WFLOW_STEP_W2_EMBEDDED: Z = computeW2Step(*this, U, x, parity, x_cb, dir); break;
+      case WFLOW_STEP_VT:
+      case WFLOW_STEP_VT_EMBEDDED: Z = computeVtStep(*this, U, x, parity, x_cb, dir); break;
       }
 
       // Compute anti-hermitian projection of Z, exponentiate, update U
@@ -171,6 +193,12 @@ namespace quda
       Z = im * Z;
       U = exponentiate_iQ(Z) * U;
       arg.out(dir, linkIndex(x, arg.E), parity) = U;
+
+      // Difference between the third- and second-order updates
+      if constexpr (Arg::step_type == WFLOW_STEP_VT_EMBEDDED) {
+        Link W = arg.aux(dir, x_cb, parity);
+        arg.aux(dir, x_cb, parity) = U - W;
+      }
     }
   };
 
@@ -15,38 +15,57 @@ namespace quda {
     static constexpr int nSpin = 1;
     static constexpr int dim = dim_;
     using F = typename colorspinor_mapper<Float, nSpin, nColor>::type;
+    using Ghost = typename colorspinor::GhostNOrder<Float, nSpin, nColor, colorspinor::getNative<Float>(nSpin), false,
+                                                    false, false>;
     using GU = typename gauge_mapper<Float, QUDA_RECONSTRUCT_NO, 18>::type;
     using GL = typename gauge_mapper<Float, QUDA_RECONSTRUCT_NO, 18>::type;
 
-    GU U;        /** output one-hop field */
-    GL L;        /** output three-hop field */
-    const F inA; /** input vector field */
-    const F inB; /** input vector field */
+    GU U;                      /** output one-hop field */
+    GL L;                      /** output three-hop field */
+    F inA[MAX_MULTI_RHS];      /** input vector fields */
+    F inB[MAX_MULTI_RHS];      /** input vector fields */
+    const Ghost halo;          /** batched halo of the inB fields */
+    const int n_src;           /** number of vector pairs we are summing over */
 
     const int parity;
     int displacement;
     const int nFace;
-    real coeff[2];
+    real coeff[MAX_MULTI_RHS][2]; /** one- and three-hop coefficient of each vector pair */
     int X[4];
     bool partitioned[4];
+    int ghost_stride; /** halo offset between consecutive vectors */
 
-    StaggeredOprodArg(GaugeField &U, GaugeField &L, const ColorSpinorField &inA, const ColorSpinorField &inB,
-                      int parity, int displacement, int nFace, const real coeff[2]) :
-      kernel_param(dim3(dim == -1 ? inB.VolumeCB() : displacement * inB.GhostFaceCB()[dim])),
+    StaggeredOprodArg(GaugeField &U, GaugeField &L, cvector_ref<const ColorSpinorField> &inA,
+                      cvector_ref<const ColorSpinorField> &inB, const ColorSpinorField &halo, int parity,
+                      int displacement, int nFace, const std::vector<array<double, 2>> &coeff) :
+      kernel_param(dim3(dim == -1 ? inB.VolumeCB() : displacement * inB[0].GhostFaceCB()[dim])),
       U(U),
       L(L),
-      inA(inA),
-      inB(inB, nFace),
+      halo(halo, nFace),
+      n_src(inA.size()),
       parity(parity),
       displacement(displacement),
-      nFace(nFace),
-      coeff{coeff[0], coeff[1]}
+      nFace(nFace)
     {
+      if (inA.size() > get_max_multi_rhs())
+        errorQuda("vector set size %lu greater than max size %d", inA.size(), get_max_multi_rhs());
+      for (auto i = 0u; i < inA.size(); i++) {
+        this->inA[i] = inA[i];
+        this->inB[i] = inB[i];
+        this->coeff[i][0] = coeff[i][0];
+        this->coeff[i][1] = coeff[i][1];
+      }
       for (int i = 0; i < 4; ++i) this->X[i] = U.X()[i];
       for (int i = 0; i < 4; ++i) this->partitioned[i] = commDimPartitioned(i) ? true : false;
+      ghost_stride = dim == -1 ? 0 : nFace * inB[0].GhostFaceCB()[dim];
     }
   };
 
+  /**
+     The outer products of all vector pairs are accumulated in
+     registers, so that each link of the output fields is read and
+     written once regardless of the number of terms.
+   */
   template <typename Arg> struct Interior
   {
     const Arg &arg;
@@ -58,29 +77,30 @@ namespace quda {
       using matrix = Matrix<complex<typename Arg::real>, Arg::nColor>;
       using vector = ColorSpinor<typename Arg::real, Arg::nColor, 1>;
 
-      const vector x = arg.inA(x_cb, 0);
-
 #pragma unroll
       for (int dim=0; dim<4; ++dim) {
         int shift[4] = {0,0,0,0};
         shift[dim] = 1;
         const int first_nbr_idx = neighborIndex(x_cb, shift, arg.partitioned, arg.parity, arg.X);
         if (first_nbr_idx >= 0) {
-          const vector y = arg.inB(first_nbr_idx, 0);
-          matrix result = outerProduct(y, x);
-          matrix tempA = arg.U(dim, x_cb, arg.parity);
-          result = tempA + result * arg.coeff[0];
-
+          matrix result = arg.U(dim, x_cb, arg.parity);
+          for (int s = 0; s < arg.n_src; s++) {
+            const vector x = arg.inA[s](x_cb, 0);
+            const vector y = arg.inB[s](first_nbr_idx, 0);
+            result = result + outerProduct(y, x) * arg.coeff[s][0];
+          }
           arg.U(dim, x_cb, arg.parity) = result;
 
           if (arg.nFace == 3) {
             shift[dim] = 3;
             const int third_nbr_idx = neighborIndex(x_cb, shift, arg.partitioned, arg.parity, arg.X);
             if (third_nbr_idx >= 0) {
-              const vector z = arg.inB(third_nbr_idx, 0);
-              matrix result = outerProduct(z, x);
-              matrix tempB = arg.L(dim, x_cb, arg.parity);
-              result = tempB + result * arg.coeff[1];
+              matrix result = arg.L(dim, x_cb, arg.parity);
+              for (int s = 0; s < arg.n_src; s++) {
+                const vector x = arg.inA[s](x_cb, 0);
+                const vector z = arg.inB[s](third_nbr_idx, 0);
+                result = result + outerProduct(z, x) * arg.coeff[s][1];
+              }
               arg.L(dim, x_cb, arg.parity) = result;
             }
           }
@@ -99,26 +119,23 @@ namespace quda {
       using matrix = Matrix<complex<typename Arg::real>, Arg::nColor>;
       using vector = ColorSpinor<typename Arg::real, Arg::nColor, 1>;
 
-      auto coeff = (arg.displacement == 1) ? arg.coeff[0] : arg.coeff[1];
+      const int hop = (arg.displacement == 1) ? 0 : 1;
 
       int x[4];
       coordsFromIndexExterior(x, x_cb, arg.X, Arg::dim, arg.displacement, arg.parity);
       const unsigned int bulk_cb_idx = ((((x[3]*arg.X[2] + x[2])*arg.X[1] + x[1])*arg.X[0] + x[0]) >> 1);
 
-      const vector a = arg.inA(bulk_cb_idx, 0);
-      const vector b = arg.inB.Ghost(Arg::dim, 1, x_cb, 0);
+      matrix result = hop == 0 ? arg.U(Arg::dim, bulk_cb_idx, arg.parity) : arg.L(Arg::dim, bulk_cb_idx, arg.parity);
+      for (int s = 0; s < arg.n_src; s++) {
+        const vector a = arg.inA[s](bulk_cb_idx, 0);
+        const vector b = arg.halo.Ghost(Arg::dim, 1, x_cb + s * arg.ghost_stride, 0);
+        result = result + outerProduct(b, a) * arg.coeff[s][hop];
+      }
 
-      if (arg.displacement == 1) {
-        matrix inmatrix = arg.U(Arg::dim, bulk_cb_idx, arg.parity);
-        matrix result = outerProduct(b, a);
-        result = inmatrix + result * coeff;
+      if (hop == 0)
         arg.U(Arg::dim, bulk_cb_idx, arg.parity) = result;
-      } else {
-        matrix inmatrix = arg.L(Arg::dim, bulk_cb_idx, arg.parity);
-        matrix result = outerProduct(b, a);
-        result = inmatrix + result * coeff;
+      else
         arg.L(Arg::dim, bulk_cb_idx, arg.parity) = result;
-      }
     }
   };
 
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <quda.h>
+#include <gauge_field.h>
+#include <color_spinor_field.h>
+
+/**
+   @file md_action.h
+
+   Molecular-dynamics action acting on the resident gauge and
+   momentum fields.  The action is a sum of monomials, each of which
+   can evaluate its contribution to the Hamiltonian and add its force
+   to a momentum field, so that an entire trajectory can be
+   integrated on the device.
+ */
+
+namespace quda
+{
+
+  /**
+     @brief Gauge monomial defined by a set of force paths, as used by
+     gaugeForce.  The loops of the action are derived from the paths
+     by prefixing each with the link it is the force on.
+   */
+  struct md_gauge_monomial {
+    double beta_nc = 0.0;                  /** Coefficient of the action */
+    int max_length = 0;                    /** Maximum length of any path */
+    std::vector<std::vector<int>> path[4]; /** Force paths for each direction */
+    std::vector<int> length;               /** Length of each force path */
+    std::vector<double> coeff;             /** Coefficient of each force path */
+    std::vector<std::vector<int>> loop;    /** Loops of the action */
+    std::vector<int> loop_length;          /** Length of each loop */
+    std::vector<double> loop_coeff;        /** Coefficient of each loop */
+  };
+
+  /**
+     @brief Clover-Wilson fermion monomial with a rational
+     approximation to a power of the preconditioned normal operator
+   */
+  struct md_fermion_monomial {
+    QudaInvertParam param;   /** Dirac and solver parameters */
+    ColorSpinorField phi;    /** Resident pseudofermion */
+    double residue_0 = 0.0;  /** Constant term of the rational approximation */
+    double multiplicity = 0; /** Power of the clover determinant represented */
+  };
+
+  struct md_action {
+    std::vector<md_gauge_monomial> gauge;
+    std::vector<md_fermion_monomial> fermion;
+
+    GaugeField u_tmp;      /** Scratch field for the gauge-field update */
+    GaugeField u_backup;   /** Gauge field at the start of the last trajectory */
+    GaugeField mom_backup; /** Momentum at the start of the last trajectory */
+
+    md_action(QudaGaugeParam &param);
+
+    /**
+       @brief Evaluate the Hamiltonian
+       @param[out] h The components: the kinetic energy followed by
+       the gauge and fermion monomials
+     */
+    void hamiltonian(double *h);
+
+    /**
+       @brief Add the force of all monomials to a momentum field
+       @param[in,out] mom The momentum field
+       @param[in] dt The step size
+     */
+    void updateP(GaugeField &mom, double dt);
+
+    /**
+       @brief Update the resident gauge field with the resident
+       momentum, U = exp(dt P) U, and refresh the fields derived
+       from it
+       @param[in] dt The step size
+     */
+    void updateU(double dt);
+
+    /**
+       @brief Apply the force-gradient momentum update: the force is
+       evaluated on the displaced field exp(xi F) U, where F is the
+       force on U
+       @param[in] dt The step size of the momentum update
+       @param[in] xi The displacement of the gauge field
+     */
+    void updatePForceGradient(double dt, double xi);
+
+    /**
+       @brief Integrate the equations of motion
+       @param[in] tau Trajectory length
+       @param[in] n_steps Number of steps
+       @param[in] integrator The integrator
+     */
+    void evolve(double tau, int n_steps, QudaMDIntegrator integrator);
+  };
+
+} // namespace quda
@@ -349,6 +349,32 @@ namespace quda {
     /** Parallel hyper-cubic random number generator for generating null-space vectors */
     RNG *rng = nullptr;
 
+    /** Near-null residuals ||D v_k|| / ||v_k|| of the null-space vectors when they were last (re)generated, used as
+        the reference for adaptive refresh */
+    std::vector<double> null_residual;
+
+    /** Key of the checkpoint of the null space, removed when this level is destroyed */
+    std::string null_checkpoint;
+
+    /**
+       @brief Metadata identifying the null space of this level for
+       checkpointing: the metadata version, the setup parameters, and
+       the fine-grid operator parameters and gauge field (its
+       plaquette and volume), so that a snapshot is not reused for a
+       different gauge configuration or quark mass
+       @return The metadata
+    */
+    std::vector<double> nullCheckpointMeta() const;
+
+    /**
+       @brief Whether the metadata of a null-space checkpoint matches
+       the expected metadata
+       @param[in] meta The metadata read from the checkpoint
+       @param[in] expected The expected metadata
+       @return Whether they match
+    */
+    static bool nullCheckpointMatch(const std::vector<double> &meta, const std::vector<double> &expected);
+
     /**
        @brief Helper function called on entry to each MG function
        @param[in] level The level we working on
@@ -432,6 +458,18 @@ namespace quda {
     */
     void destroyCoarseSolver();
 
+    /**
+       @brief Whether the coarse-grid correction is a Krylov solver
+       preconditioned by the coarse MG (recursive and K-cycle, and
+       always for the bottom solve), or the coarse MG cycle applied
+       directly (V-cycle)
+    */
+    bool krylovCoarseSolver() const
+    {
+      return param.cycle_type == QUDA_MG_CYCLE_RECURSIVE || param.cycle_type == QUDA_MG_CYCLE_KCYCLE
+        || param.level == param.Nlevel - 2;
+    }
+
     /**
        @brief Verify the correctness of the MG method, optionally recursively
        starting from the top down.
@@ -468,8 +506,42 @@ namespace quda {
        @brief Generate the null-space vectors
        @param B Generated null-space vectors
        @param refresh Whether we refreshing pre-exising vectors or starting afresh
+       @param active Optional mask of which vectors to relax (default is all)
+    */
+    void generateNullVectors(std::vector<ColorSpinorField> &B, bool refresh = false,
+                             const std::vector<bool> &active = {});
+
+    /**
+       @brief Return the number of null-space vectors that are relaxed
+       together in a single multi-RHS setup solve.  This is
+       n_vec_batch, unless setup_batch_all is set in which case it is
+       all n_vec vectors, split into the fewest equal batches that do
+       not exceed get_max_multi_rhs().
+       @param n_vec Total number of null-space vectors
+       @return The setup batch size
+    */
+    int nullSpaceBatchSize(int n_vec) const;
+
+    /**
+       @brief Compute the near-null residual ||D v_k|| / ||v_k|| of
+       each null-space vector with respect to the current smoothing
+       operator.  This is the quantity the setup solver minimizes, so
+       measures how good a near-null vector each v_k remains.
+       @param B Null-space vectors
+       @return The near-null residual of each vector
+    */
+    std::vector<double> nullSpaceResidual(cvector_ref<const ColorSpinorField> &B);
+
+    /**
+       @brief Adaptively refresh the null-space vectors: only those
+       batches of vectors whose near-null residual has degraded by
+       more than setup_refresh_threshold since they were last
+       generated are re-smoothed.
+       @param B Null-space vectors
+       @return Whether any vectors were updated (and thus the transfer
+       operator must be rebuilt)
     */
-    void generateNullVectors(std::vector<ColorSpinorField> &B, bool refresh = false);
+    bool refreshNullVectors(std::vector<ColorSpinorField> &B);
 
     /**
        @brief Generate lowest eigenvectors
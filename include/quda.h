@@ -152,6 +152,7 @@ extern "C" {
     double reliable_delta; /**< Reliable update tolerance */
     double reliable_delta_refinement; /**< Reliable update tolerance used in post multi-shift solver refinement */
     int use_alternative_reliable; /**< Whether to use alternative reliable updates */
+    int use_adaptive_reliable; /**< Whether to adapt the reliable update tolerance and the sloppy operator precision to the convergence history (CG only) */
     int use_sloppy_partial_accumulator; /**< Whether to keep the partial solution accumuator in sloppy precision */
 
     /**< This parameter determines how often we accumulate into the
@@ -247,6 +248,15 @@ extern "C" {
     QudaPrecision cuda_prec_precondition;  /**< The precision used by the QUDA preconditioner */
     QudaPrecision cuda_prec_eigensolver;   /**< The precision used by the QUDA eigensolver */
 
+    /** The precision of the halo exchange of the QUDA operator.  If
+        lower than the field precision, the halos are compressed: half
+        and quarter precision use a block-floating-point format with
+        one scale factor per site.  QUDA_INVALID_PRECISION means the
+        halo is exchanged in the field precision. */
+    QudaPrecision halo_prec;
+    QudaPrecision halo_prec_sloppy;       /**< The precision of the halo exchange of the QUDA sloppy operator */
+    QudaPrecision halo_prec_precondition; /**< The precision of the halo exchange of the QUDA preconditioner */
+
     QudaDiracFieldOrder dirac_order;       /**< The order of the input and output fermion fields */
 
     QudaGammaBasis gamma_basis;            /**< Gamma basis of the input and output host fields */
@@ -284,6 +294,11 @@ extern "C" {
     double temp;                           /**< The mean temperature of the device for the duration of the solve */
     double clock;                          /**< The mean clock frequency of the device for the duration of the solve */
 
+    int adaptive_iter_low;                 /**< Iterations with the sloppy operator applied at cuda_prec_precondition by the adaptive reliable updates */
+    int adaptive_switches;                 /**< Number of sloppy operator precision switches made by the adaptive reliable updates */
+    double adaptive_delta;                 /**< Reliable update tolerance chosen by the adaptive reliable updates at the end of the solve */
+    double adaptive_max_gap;               /**< Largest relative gap between the iterated and true residual at a reliable update */
+
     /** Number of steps in s-step algorithms */
     int Nsteps;
 
@@ -441,9 +456,12 @@ extern "C" {
     /** The index to indicate which chrono history we are augmenting */
     int chrono_index;
 
-    /** Precision to store the chronological basis in */
+    /** Precision to apply the operator in when forecasting from the chronological basis */
     QudaPrecision chrono_precision;
 
+    /** Precision to store the chronological basis in, at most chrono_precision */
+    QudaPrecision chrono_storage_precision;
+
     /** Which external library to use in the linear solvers (Eigen) */
     QudaExtLibType extlib_type;
 
@@ -489,6 +507,11 @@ extern "C" {
     double a_min;
     double a_max;
 
+    /** Number of consecutive operator applications in the polynomial
+        acceleration that share a single halo exchange of extended
+        depth (0 or 1 disables the deep halo) **/
+    int poly_halo_depth;
+
     /** Whether to preserve the deflation space between solves.  If
         true, the space will be stored in an instance of the
         deflation_space struct, pointed to by preserve_deflation_space */
@@ -555,6 +578,9 @@ extern "C" {
     int max_restarts;
     /** For the Ritz rotation, the maximal number of extra vectors the solver may allocate **/
     int batched_rotate;
+    /** For the Ritz rotation, whether to apply the rotation as a site-blocked GEMM, bounding the workspace by
+        batched_rotate vectors if set **/
+    QudaBoolean use_gemm_rotate;
     /** For block method solvers, the block size **/
     int block_size;
     /** The batch size used when computing eigenvalues **/
@@ -619,6 +645,27 @@ extern "C" {
 
     /** Which external library to use in the deflation operations (Eigen) */
     QudaExtLibType extlib_type;
+
+    /** The precision in which a solver stores its deflation space
+        (QUDA_INVALID_PRECISION keeps the eigensolver precision) */
+    QudaPrecision deflation_prec;
+
+    /** If non-zero, replace the deflation space by this many
+        block-local basis vectors and per-block coefficients for each
+        eigenvector (local coherence compression) */
+    int deflation_coherence_n_vec;
+
+    /** The geometric block size used for local coherence compression */
+    int deflation_coherence_geo_block_size[QUDA_MAX_DIM];
+
+    /** Where solvers keep their deflation space.  With
+        QUDA_CPU_FIELD_LOCATION the eigenvectors are held in pinned
+        host memory and streamed through the device when deflating */
+    QudaFieldLocation deflation_location;
+
+    /** The number of eigenvectors per transfer when streaming a
+        host-resident deflation space */
+    int deflation_tile_size;
     //-------------------------------------------------
   } QudaEigParam;
 
@@ -670,6 +717,25 @@ extern "C" {
     /** Solver batch size to use in the setup phase */
     int n_vec_batch[QUDA_MAX_MG_LEVEL];
 
+    /** Whether to relax all null-space vectors in a single multi-RHS
+        setup solve (up to the maximum multi-RHS size) instead of in
+        batches of n_vec_batch, masking out converged vectors between
+        setup iterations (see setup_mask_tol) and orthonormalizing them
+        as a block */
+    QudaBoolean setup_batch_all[QUDA_MAX_MG_LEVEL];
+
+    /** With setup_batch_all, vectors whose near-null residual
+        ||D v_k|| / ||v_k|| is below this value are masked out of
+        subsequent setup iterations.  This is a property of the vector
+        with respect to the smoothing operator, unlike setup_tol which
+        is the relative residual the setup solver iterates to.  A value
+        <= 0 disables masking. */
+    double setup_mask_tol[QUDA_MAX_MG_LEVEL];
+
+    /** Output: the time in seconds taken by the most recent null-space
+        generation on each level */
+    double null_space_secs[QUDA_MAX_MG_LEVEL];
+
     /** Number of setup iterations */
     int num_setup_iter[QUDA_MAX_MG_LEVEL];
 
@@ -682,6 +748,15 @@ extern "C" {
     /** Maximum number of iterations for refreshing the null-space vectors */
     int setup_maxiter_refresh[QUDA_MAX_MG_LEVEL];
 
+    /** Adaptive refresh threshold: when refreshing the null-space
+        vectors, only re-smooth those batches whose near-null residual
+        ||D v_k|| / ||v_k|| has grown by more than this relative amount
+        since they were last generated, otherwise reuse the existing
+        transfer operator and only rebuild the coarse operator.  A
+        value <= 0 disables adaptive refresh (all vectors are
+        re-smoothed). */
+    double setup_refresh_threshold[QUDA_MAX_MG_LEVEL];
+
     /** Basis to use for CA solver setup */
     QudaCABasis setup_ca_basis[QUDA_MAX_MG_LEVEL];
 
@@ -764,13 +839,20 @@ extern "C" {
     /** The type of smoother solve to do on each grid (e/o preconditioning or not)*/
     QudaSolveType smoother_solve_type[QUDA_MAX_MG_LEVEL];
 
-    /** The type of multigrid cycle to perform at each level */
+    /** The type of multigrid cycle to perform at each level: V-cycle
+        (coarse MG applied directly), recursive (coarse MG wrapped in the
+        coarse_solver), K-cycle (coarse MG wrapped in flexible GCR capped at
+        coarse_solver_maxiter iterations) */
     QudaMultigridCycleType cycle_type[QUDA_MAX_MG_LEVEL];
 
     /** Whether to use global reductions or not for the smoother / solver at each level */
     QudaBoolean global_reduction[QUDA_MAX_MG_LEVEL];
 
-    /** Location where each level should be done */
+    /** Location where each level should be done.  Coarse levels
+        (level > 0) may be placed on the host, in which case MMA must
+        be disabled on that level.  Host levels run synchronously with
+        the device levels, they are not overlapped with the fine-grid
+        smoothing. */
     QudaFieldLocation location[QUDA_MAX_MG_LEVEL];
 
     /** Location where the coarse-operator construction will be computedn */
@@ -873,6 +955,12 @@ extern "C" {
     double t0;                     /**< Starting flow time for Wilson flow */
     int dir_ignore;                /**< The direction to be ignored by the smearing algorithm
                                         A negative value means 3D for APE/STOUT and 4D for OVRIMP_STOUT/HYP */
+    double flow_tol;               /**< Local error tolerance of the adaptive step size Wilson/Symanzik flow integrator;
+                                        zero means a fixed step size epsilon */
+    QudaFlowScaleType scale_type;  /**< Whether to stop the flow once the t0 or w0 scale condition is met */
+    double scale_target;           /**< Target value of t^2 <E> (t0) or t d/dt t^2 <E> (w0), e.g., 0.3 */
+    double scale_t;                /**< Output: the interpolated flow time at which the scale target was crossed, or
+                                        zero if it was not reached */
   } QudaGaugeSmearParam;
 
   typedef struct QudaBLASParam_s {
@@ -1589,6 +1677,35 @@ extern "C" {
                             double** coeff,
                             QudaGaugeParam* param);
 
+  /**
+   * Compute the fermion force for the HISQ quark action and integrate
+   * the momentum, taking the quark fields directly from the resident
+   * multi-shift solutions (invertMultiShiftQuda with
+   * make_resident_solution set) rather than from the host.  The
+   * resident solutions are the even-parity components of the quark
+   * fields, and the odd-parity components are reconstructed on the
+   * device by applying the staggered dslash, as in
+   * computeStaggeredForceQuda.  Quark field i is solution i, and the
+   * naik terms use the last num_naik solutions, matching the ordering
+   * of the quark fields passed to computeHISQForceQuda.
+   * @param momentum        The momentum field we are integrating
+   * @param dt              The stepsize used to integrate the momentum
+   * @param level2_coeff    The coefficients for the second level of smearing in the quark action.
+   * @param fat7_coeff      The coefficients for the first level of smearing (fat7) in the quark action.
+   * @param w_link          Unitarized link variables obtained by applying fat7 smearing and unitarization to the original links.
+   * @param v_link          Fat7 link variables.
+   * @param u_link          SU(3) think link variables.
+   * @param num             The number of quark fields
+   * @param num_naik        The number of naik contributions
+   * @param coeff           The coefficient multiplying the fermion fields in the outer product
+   * @param param           The field parameters.
+   * @param inv_param       The parameters of the multi-shift solve (use_resident_solution must be set)
+   */
+  void computeHISQForceResidentQuda(void *momentum, double dt, const double level2_coeff[6], const double fat7_coeff[6],
+                                    const void *const w_link, const void *const v_link, const void *const u_link,
+                                    int num, int num_naik, double **coeff, QudaGaugeParam *param,
+                                    QudaInvertParam *inv_param);
+
   /**
      @brief Generate Gaussian distributed fields and store in the
      resident gauge field. We create a Gaussian-distributed su(n)
@@ -1614,6 +1731,143 @@ extern "C" {
    */
   void gaussMomQuda(unsigned long long seed, double sigma);
 
+  /**
+   * @brief Create a molecular-dynamics action acting on the resident
+   * gauge field and the resident momentum field, which is created if
+   * it does not exist.  Once its monomials have been registered with
+   * addGaugeMonomialQuda and addCloverMonomialQuda, entire
+   * trajectories run on the device with no host transfers, with only
+   * the components of the Hamiltonian returned.  After each update
+   * of the gauge field the resident sloppy and extended gauge fields
+   * and the resident clover field are refreshed, so the other
+   * interface functions see the evolved field.
+   *
+   * @param param Meta data for the resident gauge field (cuda_prec
+   * must match the resident gauge field, and sets the precision of
+   * the momentum field)
+   * @return Pointer to the action
+   */
+  void *newMDActionQuda(QudaGaugeParam *param);
+
+  /**
+   * @brief Free a molecular-dynamics action
+   * @param action Pointer to the action
+   */
+  void destroyMDActionQuda(void *action);
+
+  /**
+   * @brief Add a gauge monomial to a molecular-dynamics action.  The
+   * paths are given in the form used by computeGaugeForceQuda, where
+   * path i of direction mu starts at x + mu and closes a loop of
+   * length path_length[i] + 1 with the link U_mu(x).  The action is
+   *
+   *   S = -beta_nc sum_x sum_mu sum_i loop_coeff[i] / (path_length[i] + 1) Re Tr[loop]
+   *
+   * which counts each loop once, since it is generated by each of
+   * its links.  The force is that of computeGaugeForceQuda with eb3
+   * = dt * beta_nc, so the plaquette staples with beta_nc = beta / 3
+   * give the Wilson gauge action.
+   *
+   * @param action Pointer to the action
+   * @param input_path_buf[dim][num_paths][path_length] Force paths
+   * @param path_length Length of each path
+   * @param loop_coeff Coefficient of each path
+   * @param num_paths Number of paths
+   * @param max_length Maximum length of any path
+   * @param beta_nc Coefficient of the action
+   */
+  void addGaugeMonomialQuda(void *action, int ***input_path_buf, int *path_length, double *loop_coeff, int num_paths,
+                            int max_length, double beta_nc);
+
+  /**
+   * @brief Add a clover-Wilson fermion monomial to a
+   * molecular-dynamics action.  With the preconditioned operator
+   * M and the rational approximation given by param->offset,
+   * param->residue and param->num_offset, the action is
+   *
+   *   S = residue_0 phi^dag phi + sum_i residue[i] phi^dag (M^dag M + offset[i])^{-1} phi
+   *       - multiplicity Tr log A
+   *
+   * where A is the clover term on the parity eliminated by the
+   * asymmetric even-odd preconditioning.  The shifted systems are
+   * solved as in invertMultiShiftQuda using param, and the force is
+   * that of computeCloverForceQuda with the residues as coefficients.
+   * The pseudofermion is copied to the device once and stays
+   * resident.
+   *
+   * @param action Pointer to the action
+   * @param phi Host pseudofermion, on the parity given by param->matpc_type
+   * @param residue_0 Constant term of the rational approximation
+   * @param multiplicity Power of det A represented by the monomial
+   * (zero if it is accounted for by another monomial)
+   * @param param Dirac and solver parameters: these must describe a
+   * solution of MatPCDagMatPC with asymmetric preconditioning
+   * @return Index of the monomial, for use with updateCloverMonomialQuda
+   */
+  int addCloverMonomialQuda(void *action, void *phi, double residue_0, double multiplicity, QudaInvertParam *param);
+
+  /**
+   * @brief Replace the pseudofermion of a clover-Wilson monomial,
+   * e.g., after the pseudofermion heatbath at the start of a
+   * trajectory
+   *
+   * @param action Pointer to the action
+   * @param monomial Index of the monomial returned by addCloverMonomialQuda
+   * @param phi Host pseudofermion
+   */
+  void updateCloverMonomialQuda(void *action, int monomial, void *phi);
+
+  /**
+   * @brief Evaluate the Hamiltonian of a molecular-dynamics action
+   * on the resident gauge and momentum fields
+   *
+   * @param action Pointer to the action
+   * @param h Array for the components: h[0] is the kinetic energy
+   * (computed as in momActionQuda), followed by the gauge and then
+   * the fermion monomials, each in order of registration
+   */
+  void hamiltonianMDQuda(void *action, double *h);
+
+  /**
+   * @brief Integrate the equations of motion of a
+   * molecular-dynamics action, updating the resident gauge and
+   * momentum fields in place.  A negative trajectory length
+   * integrates backwards in time.
+   *
+   * @param action Pointer to the action
+   * @param tau Trajectory length
+   * @param n_steps Number of integration steps
+   * @param integrator The integrator
+   */
+  void evolveMDQuda(void *action, double tau, int n_steps, QudaMDIntegrator integrator);
+
+  /**
+   * @brief Run a molecular-dynamics trajectory: the resident
+   * momentum is refreshed from a Gaussian distribution, the gauge
+   * and momentum fields are saved for rejectMDQuda, and the
+   * equations of motion are integrated with evolveMDQuda.
+   *
+   * @param action Pointer to the action
+   * @param tau Trajectory length
+   * @param n_steps Number of integration steps
+   * @param integrator The integrator
+   * @param seed The seed used for the momentum refresh
+   * @param h_begin Components of the Hamiltonian at the start of the
+   * trajectory (see hamiltonianMDQuda)
+   * @param h_end Components of the Hamiltonian at the end of the trajectory
+   */
+  void trajectoryMDQuda(void *action, double tau, int n_steps, QudaMDIntegrator integrator, unsigned long long seed,
+                        double *h_begin, double *h_end);
+
+  /**
+   * @brief Reject the last trajectory of a molecular-dynamics action,
+   * restoring the resident gauge and momentum fields to their state
+   * at its start
+   *
+   * @param action Pointer to the action
+   */
+  void rejectMDQuda(void *action);
+
   /**
    * Computes the total, spatial and temporal plaquette averages of the loaded gauge configuration.
    * @param[out] Array for storing the averages (total, spatial, temporal)
@@ -1662,6 +1916,22 @@ extern "C" {
    */
   void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *param, unsigned int n_steps, double alpha);
 
+  /**
+   * Performs Wuppertal smearing on a set of spinors, see
+   * performWuppertalnStep.  The sources are smeared in batches with
+   * multi-RHS kernels, with the upload of the next batch overlapping
+   * with the smearing of the current one.
+   * @param h_out  Array of n_src result spinor fields
+   * @param h_in   Array of n_src input spinor fields
+   * @param n_src  Number of spinor fields
+   * @param param  Contains all metadata regarding host and device
+   *               storage and operator which will be applied to the spinors
+   * @param n_steps Number of steps to apply.
+   * @param alpha  Alpha coefficient for Wuppertal smearing.
+   */
+  void performWuppertalnStepMultiSrc(void **h_out, void **h_in, int n_src, QudaInvertParam *param,
+                                     unsigned int n_steps, double alpha);
+
   /**
    * LEGACY
    * Performs gaussian smearing on a given spinor using the gauge field
@@ -1759,7 +2029,7 @@ extern "C" {
                                 const unsigned int reunit_interval, const unsigned int stopWtheta, QudaGaugeParam *param);
 
   /**
-   * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
+   * @brief Gauge fixing with Steepest descent method with FFTs with support for single and multi GPU.
    * @param[in,out] gauge, gauge field to be fixed
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
@@ -1857,6 +2127,18 @@ extern "C" {
    */
   void performTwoLinkGaussianSmearNStep(void *h_in, QudaQuarkSmearParam *smear_param);
 
+  /**
+   * Performs two-link Gaussian smearing on a set of spinors (for
+   * staggered fermions), see performTwoLinkGaussianSmearNStep.  The
+   * sources are smeared in batches with multi-RHS kernels, with the
+   * upload of the next batch overlapping with the smearing of the
+   * current one.
+   * @param[in,out] h_in Array of n_src input spinor fields to smear
+   * @param[in] n_src Number of spinor fields
+   * @param[in] smear_param   Contains all metadata the operator which will be applied to the spinors
+   */
+  void performTwoLinkGaussianSmearNStepMultiSrc(void **h_in, int n_src, QudaQuarkSmearParam *smear_param);
+
   /**
    * @brief Performs contractions between a set of quark fields and
    * eigenvectors of the 3-d Laplace operator.
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cmath>
+#include <limits>
 #include <color_spinor_field.h>
 #include <blas_quda.h>
 #include <util_quda.h>
+#include <telemetry.h>
 
 namespace quda
 {
@@ -122,6 +125,11 @@ namespace quda
      */
     void update_maxr_deflate(double r2) { maxr_deflate = sqrt(r2); }
 
+    /**
+      @brief Update the reliable update tolerance (thus delta)
+     */
+    void update_delta(double delta_) { delta = delta_; }
+
     /**
       @brief Evaluate whether a reliable update is needed
       @param r2_old the old residual norm squared
@@ -136,8 +144,8 @@ namespace quda
       } else {
         if (rNorm > maxrx) maxrx = rNorm;
         if (rNorm > maxrr) maxrr = rNorm;
-        updateX = (rNorm < params.delta * r0Norm && r0Norm <= maxrx) ? 1 : 0;
-        updateR = ((rNorm < params.delta * maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+        updateX = (rNorm < delta * r0Norm && r0Norm <= maxrx) ? 1 : 0;
+        updateR = ((rNorm < delta * maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
       }
     }
 
@@ -275,10 +283,119 @@ namespace quda
     */
     void reset(double r2)
     {
+      telemetry::reliable_update(r2);
       steps_since_reliable = 0;
       r0Norm = sqrt(r2);
       rUpdate++;
     }
   };
 
+  /**
+    @brief Adaptive mixed-precision policy learned from the convergence history of a solver.  At each reliable update
+      the relative gap between the iterated and the true residual measures the error the sloppy arithmetic has
+      introduced since the previous update:
+      - if the gap exceeds gap_max the sloppy operator moves to the next higher precision, or if it is already at the
+        highest precision the reliable updates are made more frequent;
+      - if the gap, scaled by the ratio of the precision epsilons, would stay well below gap_max at the next lower
+        precision the sloppy operator moves down;
+      - otherwise a small gap makes the reliable updates less frequent.
+   */
+  struct AdaptiveReliable {
+
+    static constexpr double gap_max = 0.1; // largest acceptable relative residual gap
+
+    const std::vector<QudaPrecision> precision; // operator precisions, lowest first
+    std::vector<int> iter;                      // iterations performed at each precision
+    int level;                                  // index of the current precision
+    double delta;                               // current reliable update tolerance
+    const double delta_min;
+    const double delta_max;
+
+    int switches = 0;
+    double max_gap = 0.0;
+
+    /**
+      @brief constructor, starting from the highest precision
+      @param precision the operator precisions available, lowest first
+      @param delta the initial reliable update tolerance
+     */
+    AdaptiveReliable(const std::vector<QudaPrecision> &precision, double delta) :
+      precision(precision),
+      iter(precision.size(), 0),
+      level(precision.size() - 1),
+      delta(delta),
+      delta_min(delta * delta),
+      delta_max(std::max(delta, 0.5))
+    {
+    }
+
+    /**
+      @brief The relative rounding error of a precision
+     */
+    static double epsilon(QudaPrecision prec)
+    {
+      switch (prec) {
+      case QUDA_DOUBLE_PRECISION: return std::numeric_limits<double>::epsilon() / 2.;
+      case QUDA_SINGLE_PRECISION: return std::numeric_limits<float>::epsilon() / 2.;
+      case QUDA_HALF_PRECISION: return std::pow(2., -13);
+      case QUDA_QUARTER_PRECISION: return std::pow(2., -6);
+      default: errorQuda("Invalid precision %d", prec);
+      }
+      return 0.0;
+    }
+
+    /**
+      @brief The precision the sloppy operator is currently applied in
+     */
+    QudaPrecision current() const { return precision[level]; }
+
+    /**
+      @brief Record an iteration at the current precision
+     */
+    void step() { iter[level]++; }
+
+    /**
+      @brief The number of iterations performed below the highest precision
+     */
+    int iter_low() const
+    {
+      int n = 0;
+      for (auto l = 0u; l + 1 < iter.size(); l++) n += iter[l];
+      return n;
+    }
+
+    /**
+      @brief Update the policy at a reliable update
+      @param r_iter the iterated residual norm before the update
+      @param r_true the true residual norm computed at the update
+      @return whether the operator precision changed
+     */
+    bool update(double r_iter, double r_true)
+    {
+      if (r_iter == 0.0) return false;
+      const double gap = std::abs(r_true - r_iter) / r_iter;
+      max_gap = std::max(max_gap, gap);
+
+      const int old_level = level;
+      if (gap > gap_max) {
+        if (level + 1 < static_cast<int>(precision.size()))
+          level++;
+        else
+          delta = std::min(4 * delta, delta_max);
+      } else if (level > 0 && gap * epsilon(precision[level - 1]) / epsilon(precision[level]) < gap_max / 4) {
+        level--;
+      } else if (gap < gap_max / 16) {
+        delta = std::max(delta / 2, delta_min);
+      }
+
+      if (level != old_level) {
+        switches++;
+        logQuda(QUDA_VERBOSE, "Adaptive reliable: gap %e, switching sloppy operator from %d to %d bytes\n", gap,
+                precision[old_level], precision[level]);
+      }
+      logQuda(QUDA_DEBUG_VERBOSE, "Adaptive reliable: gap %e, delta %e\n", gap, delta);
+      return level != old_level;
+    }
+  };
+
 } // namespace quda
@@ -1,6 +1,7 @@
 #pragma once
 #include <gauge_field.h>
 #include <color_spinor_field.h>
+#include <array.h>
 
 namespace quda {
 
@@ -22,4 +23,23 @@ namespace quda {
   */
   void computeStaggeredOprod(GaugeField *out[], ColorSpinorField& in, const double coeff[], int nFace);
 
+  /**
+     @brief Batched variant of computeStaggeredOprod that accumulates
+     the weighted outer products of a set of quark fields, e.g., the
+     terms of a rational approximation,
+
+     out[0][d](x) += sum_i coeff[i][0] (in_i(x+1_d) x conj(in_i(x)))
+     out[1][d](x) += sum_i coeff[i][1] (in_i(x+3_d) x conj(in_i(x)))
+
+     The contributions of all fields are summed before the output
+     fields are updated, and their halos are exchanged together.
+
+     @param[out] out Array of nFace outer-product matrix fields
+     @param[in] in Input quark fields
+     @param[in] coeff One- and three-hop coefficients of each field
+     @param[in] nFace Number of faces (1 or 3)
+  */
+  void computeStaggeredOprod(GaugeField *out[], cvector_ref<const ColorSpinorField> &in,
+                             const std::vector<array<double, 2>> &coeff, int nFace);
+
 } // namespace quda
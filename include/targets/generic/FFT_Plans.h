@@ -2,28 +2,78 @@
 
 #include <quda_internal.h>
 
-// Dummy implementation that does nothing
+// Host implementation of the FFT plan interface, used when the native
+// FFT library of the target is disabled.  Transforms are computed with
+// FFTW if QUDA is built with QUDA_FFTW=ON, else with a built-in
+// multithreaded mixed-radix FFT.  Device-resident data are staged
+// through host memory.
 
-#define FFT_FORWARD 0
+#define FFT_FORWARD -1
 #define FFT_INVERSE 1
 
 namespace quda
 {
 
-  typedef struct {
-    bool isDouble;
-  } FFTPlanHandle;
+  /**
+     @brief Host FFT plan: a batch of contiguous complex-to-complex
+     transforms of rank 1, 2 or 3, with the outer-most dimension first
+     (the same layout as cufftPlanMany with NULL embedding).
+   */
+  struct FFTPlanHandle {
+    int rank = 0;                                     /** Transform rank */
+    int n[3] = {};                                    /** Transform lengths, outer-most first */
+    int batch = 0;                                    /** Number of transforms */
+    QudaPrecision precision = QUDA_INVALID_PRECISION; /** Precision of the transform */
+    void *plan = nullptr;                             /** Backend specific plan data */
+  };
 
-  inline static constexpr bool HaveFFT() { return false; }
+  inline static constexpr bool HaveFFT() { return true; }
 
-  inline void ApplyFFT(FFTPlanHandle &, float2 *, float2 *, int) { errorQuda("FFTs are disabled"); }
+  /**
+   * @brief Perform a single-precision complex-to-complex transform
+   * in the transform direction as specified by direction parameter.
+   * The inverse transform is unnormalized.
+   * @param[in] plan Host FFT plan
+   * @param[in] data_in, pointer to the complex input data (host or device memory) to transform
+   * @param[out] data_out, pointer to the complex output data (host or device memory)
+   * @param[in] direction, the transform direction: FFT_FORWARD or FFT_INVERSE
+   */
+  void ApplyFFT(FFTPlanHandle &plan, float2 *data_in, float2 *data_out, int direction);
 
-  inline void ApplyFFT(FFTPlanHandle &, double2 *, double2 *, int) { errorQuda("FFTs are disabled"); }
+  /**
+   * @brief Perform a double-precision complex-to-complex transform
+   * in the transform direction as specified by direction parameter.
+   * The inverse transform is unnormalized.
+   * @param[in] plan Host FFT plan
+   * @param[in] data_in, pointer to the complex input data (host or device memory) to transform
+   * @param[out] data_out, pointer to the complex output data (host or device memory)
+   * @param[in] direction, the transform direction: FFT_FORWARD or FFT_INVERSE
+   */
+  void ApplyFFT(FFTPlanHandle &plan, double2 *data_in, double2 *data_out, int direction);
 
-  inline void SetPlanFFTMany(FFTPlanHandle &, int4, int, QudaPrecision) { errorQuda("FFTs are disabled"); }
+  /**
+   * @brief Creates a host FFT plan supporting 4D (1D+3D) data layouts for complex-to-complex
+   * @param[out] plan, host FFT plan
+   * @param[in] size, int4 with lattice size dimensions, (.x,.y,.z,.w) -> (Nx, Ny, Nz, Nt)
+   * @param[in] dim, 1 for 1D plan along the temporal direction with batch size Nx*Ny*Nz, 3 for 3D plan along Nx, Ny and
+   * Nz with batch size Nt
+   * @param[in] precision The precision of the computation
+   */
+  void SetPlanFFTMany(FFTPlanHandle &plan, int4 size, int dim, QudaPrecision precision);
 
-  inline void SetPlanFFT2DMany(FFTPlanHandle &, int4, int, QudaPrecision) { errorQuda("FFTs are disabled"); }
+  /**
+   * @brief Creates a host FFT plan supporting 4D (2D+2D) data layouts for complex-to-complex
+   * @param[out] plan, host FFT plan
+   * @param[in] size, int4 with lattice size dimensions, (.x,.y,.z,.w) -> (Nx, Ny, Nz, Nt)
+   * @param[in] dim, 0 for 2D plan in Z-T planes with batch size Nx*Ny, 1 for 2D plan in X-Y planes with batch size Nz*Nt
+   * @param[in] precision The precision of the computation
+   */
+  void SetPlanFFT2DMany(FFTPlanHandle &plan, int4 size, int dim, QudaPrecision precision);
 
-  inline void FFTDestroyPlan(FFTPlanHandle &) { errorQuda("FFTs are disabled"); }
+  /**
+   * @brief Release the resources held by a host FFT plan
+   * @param[in,out] plan, host FFT plan
+   */
+  void FFTDestroyPlan(FFTPlanHandle &plan);
 
 } // namespace quda
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <reference_wrapper_helper.h>
+#include <tune_key.h>
+
+/**
+   @file telemetry.h
+
+   Structured telemetry stream for attributing work to solves.  When
+   enabled with QUDA_ENABLE_TELEMETRY=1, each rank writes a JSON-lines
+   file telemetry_n<rank>.jsonl to QUDA_RESOURCE_PATH containing, in
+   launch order, the scopes formed by the output-prefix stack (e.g.,
+   the multigrid levels, which MG::pushLevel pushes), the solves,
+   their iteration residuals, reliable updates and restarts, and every
+   kernel launch with its tune key, time, flops and bytes.  The kernel
+   time is the execution time cached by the autotuner for its tune
+   key, not a time measured for that launch, so it is an estimate that
+   excludes launch overhead and run-to-run variation.  Every event
+   records the innermost active scope, so kernel time can be
+   attributed to a solve, multigrid level or iteration.  Events are queued on the
+   calling thread and formatted and written by a background thread.
+   The stream can be summarized with tests/telemetry_summary.py.
+ */
+
+namespace quda
+{
+
+  namespace telemetry
+  {
+
+    /**
+       @brief Whether telemetry is enabled (QUDA_ENABLE_TELEMETRY=1,
+       default disabled) and the stream has been opened
+     */
+    bool enabled();
+
+    /**
+       @brief Open the stream and start the writer thread if telemetry
+       is enabled.  If QUDA_RESOURCE_PATH is not defined then
+       telemetry is disabled.
+     */
+    void init();
+
+    /**
+       @brief Close any open scopes, flush the stream and stop the
+       writer thread
+     */
+    void destroy();
+
+    /**
+       @brief Open a scope, nested in the current one
+       @param[in] label The scope label, e.g., the output prefix
+     */
+    void push_scope(const char *label);
+
+    /**
+       @brief Close the innermost scope opened with push_scope,
+       together with any solves still open within it
+     */
+    void pop_scope();
+
+    /**
+       @brief Record the residuals of a solver iteration.  The first
+       call by a given solver instance opens a solve scope; a call by
+       a solver whose solve is open further down the stack closes the
+       solves nested in it.
+       @param[in] solver Identity of the solver instance
+       @param[in] name The solver name
+       @param[in] iter The iteration count
+       @param[in] r2 The residual norms squared
+       @param[in] b2 The source norms squared
+     */
+    void iteration(const void *solver, const char *name, int iter, cvector<double> &r2, cvector<double> &b2);
+
+    /**
+       @brief Record a reliable update in the innermost solve
+       @param[in] r2 The true residual norm squared after the update
+     */
+    void reliable_update(double r2);
+
+    /**
+       @brief Record a restart in the innermost solve
+       @param[in] r2 The residual norms squared at the restart
+     */
+    void restart(cvector<double> &r2);
+
+    /**
+       @brief Record the end of a solve and close its scope
+       @param[in] solver Identity of the solver instance
+       @param[in] iter The iteration count
+       @param[in] r2 The final residual norms squared
+       @param[in] b2 The source norms squared
+     */
+    void solve_end(const void *solver, int iter, cvector<double> &r2, cvector<double> &b2);
+
+    /**
+       @brief Record a kernel launch in the innermost scope
+       @param[in] key The tune key of the kernel
+       @param[in] time The execution time of the kernel cached by the
+       autotuner (not measured for this launch)
+       @param[in] flops The flops of the kernel
+       @param[in] bytes The bytes moved by the kernel
+     */
+    void kernel(const TuneKey &key, float time, long long flops, long long bytes);
+
+  } // namespace telemetry
+
+} // namespace quda
@@ -172,6 +172,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(poly_deg, 0);
   P(a_min, 0.0);
   P(a_max, 0.0);
+  P(poly_halo_depth, 0);
   P(preserve_deflation, QUDA_BOOLEAN_FALSE);
   P(preserve_deflation_space, 0);
   P(preserve_evals, QUDA_BOOLEAN_TRUE);
@@ -186,6 +187,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(n_conv, 0);
   P(n_ev_deflate, -1);
   P(batched_rotate, 0);
+  P(use_gemm_rotate, QUDA_BOOLEAN_FALSE);
   P(tol, 0.0);
   P(qr_tol, 0.0);
   P(check_interval, 0);
@@ -206,6 +208,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(poly_deg, INVALID_INT);
   P(a_min, INVALID_DOUBLE);
   P(a_max, INVALID_DOUBLE);
+  P(poly_halo_depth, INVALID_INT);
   P(preserve_deflation, QUDA_BOOLEAN_INVALID);
   P(preserve_evals, QUDA_BOOLEAN_INVALID);
   P(use_dagger, QUDA_BOOLEAN_INVALID);
@@ -217,6 +220,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(n_conv, INVALID_INT);
   P(n_ev_deflate, INVALID_INT);
   P(batched_rotate, INVALID_INT);
+  P(use_gemm_rotate, QUDA_BOOLEAN_INVALID);
   P(tol, INVALID_DOUBLE);
   P(qr_tol, INVALID_DOUBLE);
   P(check_interval, INVALID_INT);
@@ -257,6 +261,26 @@ void printQudaEigParam(QudaEigParam *param) {
   P(io_parity_inflate, QUDA_BOOLEAN_INVALID);
 #endif
 
+#if defined INIT_PARAM
+  P(deflation_prec, QUDA_INVALID_PRECISION);
+  P(deflation_coherence_n_vec, 0);
+#else
+  P(deflation_coherence_n_vec, INVALID_INT);
+#endif
+
+#ifdef CHECK_PARAM
+  if (param->deflation_coherence_n_vec > 0)
+#endif
+    for (int i = 0; i < 4; i++) P(deflation_coherence_geo_block_size[i], INVALID_INT);
+
+#if defined INIT_PARAM
+  P(deflation_location, QUDA_CUDA_FIELD_LOCATION);
+  P(deflation_tile_size, 16);
+#else
+  P(deflation_location, QUDA_INVALID_FIELD_LOCATION);
+  P(deflation_tile_size, INVALID_INT);
+#endif
+
 #ifdef INIT_PARAM
   return ret;
 #endif
@@ -432,6 +456,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
 
 #ifdef INIT_PARAM
   P(use_alternative_reliable, 0); /**< Default is to not use alternative relative updates, e.g., use delta to determine reliable trigger */
+  P(use_adaptive_reliable, 0); /**< Default is to keep the reliable update tolerance and sloppy precision fixed */
   P(use_sloppy_partial_accumulator, 0); /**< Default is to use a high-precision accumulator (not yet supported in all solvers) */
   P(solution_accumulator_pipeline, 1); /**< Default is solution accumulator depth of 1 */
   P(max_res_increase, 1); /**< Default is to allow one consecutive residual increase */
@@ -441,6 +466,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(heavy_quark_check, 10); /**< Default is to update heavy quark residual after 10 iterations */
  #else
   P(use_alternative_reliable, INVALID_INT);
+  P(use_adaptive_reliable, INVALID_INT);
   P(use_sloppy_partial_accumulator, INVALID_INT);
   P(solution_accumulator_pipeline, INVALID_INT);
   P(max_res_increase, INVALID_INT);
@@ -537,6 +563,13 @@ void printQudaInvertParam(QudaInvertParam *param) {
   if (param->cuda_prec_eigensolver == QUDA_INVALID_PRECISION) param->cuda_prec_eigensolver = param->cuda_prec_sloppy;
 #endif
 
+  // an invalid halo precision means the halo is exchanged in the field precision
+#ifndef CHECK_PARAM
+  P(halo_prec, QUDA_INVALID_PRECISION);
+  P(halo_prec_sloppy, QUDA_INVALID_PRECISION);
+  P(halo_prec_precondition, QUDA_INVALID_PRECISION);
+#endif
+
   // leave the default behaviour to cpu pointers
 #if defined INIT_PARAM
   P(input_location, QUDA_CPU_FIELD_LOCATION);
@@ -681,6 +714,10 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(power, 0.0);
   P(temp, 0.0);
   P(clock, 0.0);
+  P(adaptive_iter_low, 0);
+  P(adaptive_switches, 0);
+  P(adaptive_delta, 0.0);
+  P(adaptive_max_gap, 0.0);
 #elif defined(PRINT_PARAM)
   P(iter, INVALID_INT);
   P(gflops, INVALID_DOUBLE);
@@ -689,6 +726,10 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(power, INVALID_DOUBLE);
   P(temp, INVALID_DOUBLE);
   P(clock, INVALID_DOUBLE);
+  P(adaptive_iter_low, INVALID_INT);
+  P(adaptive_switches, INVALID_INT);
+  P(adaptive_delta, INVALID_DOUBLE);
+  P(adaptive_max_gap, INVALID_DOUBLE);
 #endif
 
 
@@ -742,9 +783,13 @@ void printQudaInvertParam(QudaInvertParam *param) {
 
 #if !defined CHECK_PARAM
   P(chrono_precision, QUDA_INVALID_PRECISION);
+  P(chrono_storage_precision, QUDA_INVALID_PRECISION);
 #else
   // default the chrono precision to using outer precision
   if (param->chrono_precision == QUDA_INVALID_PRECISION) param->chrono_precision = param->cuda_prec;
+  // default the chrono storage precision to the chrono precision
+  if (param->chrono_storage_precision == QUDA_INVALID_PRECISION)
+    param->chrono_storage_precision = param->chrono_precision;
 #endif
 
 #if defined INIT_PARAM
@@ -894,6 +939,20 @@ void printQudaMultigridParam(QudaMultigridParam *param) {
 #else
     P(num_setup_iter[i], INVALID_INT);
 #endif
+#ifdef INIT_PARAM
+    P(setup_batch_all[i], QUDA_BOOLEAN_FALSE);
+#else
+    P(setup_batch_all[i], QUDA_BOOLEAN_INVALID);
+#endif
+#ifdef INIT_PARAM
+    P(setup_mask_tol[i], 0.0);
+    P(null_space_secs[i], 0.0);
+#else
+    P(setup_mask_tol[i], INVALID_DOUBLE);
+#endif
+#ifdef PRINT_PARAM
+    P(null_space_secs[i], INVALID_DOUBLE);
+#endif
 #ifdef INIT_PARAM
     P(use_eig_solver[i], QUDA_BOOLEAN_FALSE);
 #else
@@ -903,10 +962,12 @@ void printQudaMultigridParam(QudaMultigridParam *param) {
     P(setup_tol[i], 5e-6);
     P(setup_maxiter[i], 500);
     P(setup_maxiter_refresh[i], 0);
+    P(setup_refresh_threshold[i], 0.0);
 #else
     P(setup_tol[i], INVALID_DOUBLE);
     P(setup_maxiter[i], INVALID_INT);
     P(setup_maxiter_refresh[i], INVALID_INT);
+    P(setup_refresh_threshold[i], INVALID_DOUBLE);
 #endif
 
 #ifdef INIT_PARAM
@@ -1177,6 +1238,10 @@ void printQudaGaugeSmearParam(QudaGaugeSmearParam *param)
   P(alpha2, 0.0);
   P(alpha3, 0.0);
   P(dir_ignore, -1);
+  P(flow_tol, 0.0);
+  P(scale_type, QUDA_FLOW_SCALE_NONE);
+  P(scale_target, 0.3);
+  P(scale_t, 0.0);
 #else
   P(n_steps, (unsigned int)INVALID_INT);
   P(meas_interval, (unsigned int)INVALID_INT);
@@ -1189,6 +1254,10 @@ void printQudaGaugeSmearParam(QudaGaugeSmearParam *param)
   P(alpha2, INVALID_DOUBLE);
   P(alpha3, INVALID_DOUBLE);
   P(dir_ignore, INVALID_INT);
+  P(flow_tol, INVALID_DOUBLE);
+  P(scale_type, QUDA_FLOW_SCALE_INVALID);
+  P(scale_target, INVALID_DOUBLE);
+  P(scale_t, INVALID_DOUBLE);
 #endif
 
 #ifdef INIT_PARAM
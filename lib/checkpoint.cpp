@@ -0,0 +1,220 @@
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include <checkpoint.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+namespace quda
+{
+
+  namespace checkpoint
+  {
+
+    constexpr char magic[8] = "QUDACKP";
+    constexpr int32_t version = 1;
+
+    struct header_t {
+      char magic[8];
+      int32_t version;
+      int32_t nvec;
+      int32_t nmeta;
+      int32_t precision;
+      uint64_t bytes; // bytes per field
+    };
+
+    static const std::string &get_path()
+    {
+      static std::string path = {};
+      static bool init = false;
+
+      if (!init) {
+        auto env = getenv("QUDA_CHECKPOINT_PATH");
+        struct stat pstat;
+        if (env) {
+          if (stat(env, &pstat) || !S_ISDIR(pstat.st_mode)) {
+            warningQuda("The path \"%s\" specified by QUDA_CHECKPOINT_PATH does not exist or is not a directory.", env);
+          } else {
+            path = env;
+            logQuda(QUDA_SUMMARIZE, "Checkpointing enabled to %s every %d iterations\n", path.c_str(), interval());
+          }
+        }
+        init = true;
+      }
+
+      return path;
+    }
+
+    static std::string filename(const std::string &key)
+    {
+      return get_path() + "/" + key + "_rank" + std::to_string(comm_rank()) + ".ckpt";
+    }
+
+    bool enabled() { return get_path() != ""; }
+
+    int interval()
+    {
+      static int interval = 0;
+      if (interval == 0) {
+        auto env = getenv("QUDA_CHECKPOINT_INTERVAL");
+        interval = env ? atoi(env) : 100;
+        if (interval <= 0) errorQuda("Invalid QUDA_CHECKPOINT_INTERVAL=%d", interval);
+      }
+      return interval;
+    }
+
+    std::string key(const std::string &tag)
+    {
+      static std::map<std::string, int> count;
+      return tag + "_" + std::to_string(count[tag]++);
+    }
+
+    /**
+       Host-side staging buffers for the write in flight.  These are
+       only allocated and freed on the main thread; the writer thread
+       only reads from them.
+     */
+    static std::vector<ColorSpinorField> staging;
+    static std::thread writer;
+    static std::atomic<bool> write_error = false;
+    static std::string write_file;
+
+    void wait()
+    {
+      if (writer.joinable()) writer.join();
+      if (write_error) warningQuda("Failed to write checkpoint %s", write_file.c_str());
+      write_error = false;
+      staging.clear();
+    }
+
+    /**
+       @brief Return the parameters of a host-side field suitable for
+       staging v.  Snapshots are always stored in double precision so
+       that sets of mixed-precision fields (e.g., a solution and a
+       sloppy search direction) share a common layout.
+     */
+    static ColorSpinorParam host_param(const ColorSpinorField &v)
+    {
+      ColorSpinorParam param(v);
+      param.location = QUDA_CPU_FIELD_LOCATION;
+      param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+      param.setPrecision(QUDA_DOUBLE_PRECISION);
+      param.create = QUDA_NULL_FIELD_CREATE;
+      return param;
+    }
+
+    void save(const std::string &key, cvector_ref<const ColorSpinorField> &v, const std::vector<double> &meta)
+    {
+      if (!enabled()) return;
+      wait(); // only one write in flight at a time
+
+      host_timer_t timer;
+      timer.start();
+
+      staging.resize(v.size());
+      for (auto i = 0u; i < v.size(); i++) {
+        staging[i] = ColorSpinorField(host_param(v[i]));
+        staging[i] = v[i];
+      }
+
+      header_t header;
+      memcpy(header.magic, magic, sizeof(magic));
+      header.version = version;
+      header.nvec = v.size();
+      header.nmeta = meta.size();
+      header.precision = staging[0].Precision();
+      header.bytes = staging[0].Bytes();
+      for (auto &h : staging)
+        if (h.Bytes() != header.bytes) errorQuda("Checkpoint %s fields have mismatched sizes", key.c_str());
+
+      std::vector<const char *> data(v.size());
+      for (auto i = 0u; i < v.size(); i++) data[i] = staging[i].data<const char *>();
+
+      write_file = filename(key);
+      writer = std::thread([header, meta, data, file = write_file]() {
+        auto tmp = file + ".tmp";
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(meta.data()), meta.size() * sizeof(double));
+        for (auto &d : data) out.write(d, header.bytes);
+        out.close();
+        if (!out || std::rename(tmp.c_str(), file.c_str()) != 0) write_error = true;
+      });
+
+      timer.stop();
+      logQuda(QUDA_DEBUG_VERBOSE, "Checkpoint %s staged in %g secs\n", key.c_str(), timer.last());
+    }
+
+    int load(const std::string &key, cvector_ref<ColorSpinorField> &v, std::vector<double> &meta)
+    {
+      if (!enabled()) return -1;
+      wait();
+
+      bool valid = false;
+      header_t header = {};
+      std::ifstream in(filename(key), std::ios::binary);
+      auto param = host_param(v[0]);
+      ColorSpinorField h(param);
+
+      if (in) {
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        valid = in && !memcmp(header.magic, magic, sizeof(magic)) && header.version == version && header.nvec > 0
+          && static_cast<size_t>(header.nvec) <= v.size() && header.nmeta >= 0 && header.bytes == h.Bytes()
+          && header.precision == h.Precision();
+      }
+
+      if (valid) {
+        meta.resize(header.nmeta);
+        in.read(reinterpret_cast<char *>(meta.data()), meta.size() * sizeof(double));
+        valid = static_cast<bool>(in);
+      }
+
+      if (valid) { // ensure the payload is complete before committing to this snapshot
+        auto offset = in.tellg();
+        in.seekg(0, std::ios::end);
+        valid = static_cast<uint64_t>(in.tellg() - offset) == header.nvec * header.bytes;
+        in.seekg(offset);
+      }
+
+      // all ranks must agree that they hold the same valid snapshot
+      double hash = 0.0;
+      if (valid)
+        for (auto i = 0u; i < meta.size(); i++) hash += (i + 1) * meta[i];
+      std::vector<double> check
+        = {valid ? 0.0 : 1.0, double(header.nvec), -double(header.nvec), double(header.nmeta), -double(header.nmeta),
+           hash, -hash};
+      comm_allreduce_max(check);
+      if (check[0] != 0.0 || check[1] != -check[2] || check[3] != -check[4] || check[5] != -check[6]) return -1;
+
+      for (auto i = 0; i < header.nvec; i++) {
+        in.read(h.data<char *>(), header.bytes);
+        if (!in) errorQuda("Truncated checkpoint %s", filename(key).c_str());
+        v[i] = h;
+      }
+
+      logQuda(QUDA_SUMMARIZE, "Restored %d fields from checkpoint %s\n", header.nvec, key.c_str());
+      return header.nvec;
+    }
+
+    void finalize()
+    {
+      wait();
+      std::vector<ColorSpinorField>().swap(staging);
+    }
+
+    void remove(const std::string &key)
+    {
+      if (!enabled()) return;
+      wait();
+      std::remove(filename(key).c_str());
+    }
+
+  } // namespace checkpoint
+
+} // namespace quda
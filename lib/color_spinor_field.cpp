@@ -1,5 +1,6 @@
 #include <string.h>
 #include <iostream>
+#include <stack>
 #include <typeinfo>
 
 #include <color_spinor_field.h>
@@ -828,6 +829,29 @@ namespace quda
     if (siteSubset == QUDA_FULL_SITE_SUBSET) y[0] = savey0;
   }
 
+  static std::stack<QudaPrecision> halo_precision_stack;
+
+  void pushHaloPrecision(QudaPrecision precision)
+  {
+    halo_precision_stack.push(precision);
+
+    if (halo_precision_stack.size() > 15) {
+      warningQuda("Halo precision stack contains %u elements.  Is there a missing popHaloPrecision() somewhere?",
+                  static_cast<unsigned int>(halo_precision_stack.size()));
+    }
+  }
+
+  void popHaloPrecision()
+  {
+    if (halo_precision_stack.empty()) errorQuda("popHaloPrecision() called with empty stack");
+    halo_precision_stack.pop();
+  }
+
+  QudaPrecision getHaloPrecision()
+  {
+    return halo_precision_stack.empty() ? QUDA_INVALID_PRECISION : halo_precision_stack.top();
+  }
+
   FieldTmp<ColorSpinorField> ColorSpinorField::create_comms_batch(cvector_ref<const ColorSpinorField> &v, int nFace,
                                                                   bool spin_project)
   {
@@ -843,16 +867,27 @@ namespace quda
     }
     param.create = QUDA_GHOST_FIELD_CREATE;
 
+    // compress the halo if a lower halo precision has been requested
+    auto halo_precision = getHaloPrecision();
+    bool compress = (halo_precision == QUDA_SINGLE_PRECISION || halo_precision == QUDA_HALF_PRECISION
+                     || halo_precision == QUDA_QUARTER_PRECISION)
+      && halo_precision < param.Precision();
+    if (compress) param.setPrecision(param.Precision(), halo_precision);
+
     // we use a custom cache key for ghost-only fields
     FieldKey<ColorSpinorField> key;
     key.volume = v.VolString();
     key.aux = v.AuxString();
-    char aux[48];
+    char aux[64];
     strcpy(aux, ",nFace=");
     u32toa(aux + 7, nFace);
     strcpy(aux + 8, ",ghost_batch=");
     u32toa(aux + 21, v.size());
     if (spin_project && v.Nspin() > 1) strcat(aux, ",spin_project");
+    if (compress) {
+      strcat(aux, ",halo_prec=");
+      u32toa(aux + strlen(aux), halo_precision);
+    }
     key.aux += aux;
 
     return FieldTmp<ColorSpinorField>(key, param);
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <timer.h>
+#include <comm_link_model.h>
+
+namespace quda
+{
+
+  bool comm_link_model_enabled()
+  {
+    static bool init = false;
+    static bool enabled = true;
+    if (!init) {
+      auto env = getenv("QUDA_ENABLE_DSLASH_POLICY_MODEL");
+      if (env) enabled = atoi(env) != 0;
+      init = true;
+    }
+    return enabled;
+  }
+
+  namespace
+  {
+
+    constexpr size_t small_bytes = 64;
+    constexpr size_t large_bytes = 4 * 1024 * 1024;
+
+    /**
+       Time for exchanging a message with both neighbors in dimension
+       d, maximized over all processes
+     */
+    double exchangeTime(int d, char *buffer, size_t bytes, int n_iter)
+    {
+      char *send[2] = {buffer, buffer + bytes};
+      char *recv[2] = {buffer + 2 * bytes, buffer + 3 * bytes};
+
+      MsgHandle *mh_recv[2] = {comm_declare_receive_relative(recv[0], d, -1, bytes),
+                               comm_declare_receive_relative(recv[1], d, +1, bytes)};
+      MsgHandle *mh_send[2] = {comm_declare_send_relative(send[0], d, -1, bytes),
+                               comm_declare_send_relative(send[1], d, +1, bytes)};
+
+      comm_barrier();
+      host_timer_t timer;
+      timer.start();
+      for (int i = 0; i < n_iter; i++) {
+        for (auto &mh : mh_recv) comm_start(mh);
+        for (auto &mh : mh_send) comm_start(mh);
+        for (auto &mh : mh_send) comm_wait(mh);
+        for (auto &mh : mh_recv) comm_wait(mh);
+      }
+      timer.stop();
+
+      for (auto &mh : mh_recv) comm_free(mh);
+      for (auto &mh : mh_send) comm_free(mh);
+
+      double t = timer.last() / n_iter;
+      comm_allreduce_max(t);
+      return t;
+    }
+
+  } // namespace
+
+  bool comm_link_model_t::latencyBound(const array<size_t, 4> &bytes) const
+  {
+    for (int d = 0; d < 4; d++) {
+      if (!link[d].partitioned || bytes[d] == 0) continue;
+      if (time(d, bytes[d]) > 2.0 * link[d].latency) return false;
+    }
+    return true;
+  }
+
+  int comm_link_model_t::p2pTuneDims(const array<size_t, 4> &bytes) const
+  {
+    double t_inter = 0.0;
+    for (int d = 0; d < 4; d++)
+      if (!link[d].p2p) t_inter = std::max(t_inter, time(d, bytes[d]));
+
+    int dims = 0;
+    for (int d = 0; d < 4; d++)
+      if (link[d].p2p && bytes[d] > 0 && time(d, bytes[d]) <= t_inter) dims |= 1 << d;
+    return dims;
+  }
+
+  const comm_link_model_t &comm_link_model()
+  {
+    static bool init = false;
+    static comm_link_model_t model;
+    if (init) return model;
+
+    for (int d = 0; d < 4; d++) {
+      auto &link = model.link[d];
+      link.partitioned = comm_dim(d) > 1;
+      if (!link.partitioned) continue;
+
+      int p2p = comm_peer2peer_enabled(0, d) || comm_peer2peer_enabled(1, d);
+      comm_allreduce_max(p2p);
+      link.p2p = p2p;
+    }
+
+    // the timings are only needed if we are using the model
+    if (!comm_link_model_enabled()) {
+      init = true;
+      return model;
+    }
+
+    auto buffer = static_cast<char *>(pool_pinned_malloc(4 * large_bytes));
+    memset(buffer, 0, 4 * large_bytes);
+
+    auto buffer_d = pool_device_malloc(large_bytes);
+    host_timer_t timer;
+    qudaMemcpy(buffer, buffer_d, large_bytes, qudaMemcpyDeviceToHost); // warm up
+    timer.start();
+    for (int i = 0; i < 10; i++) qudaMemcpy(buffer, buffer_d, large_bytes, qudaMemcpyDeviceToHost);
+    timer.stop();
+    pool_device_free(buffer_d);
+    double t_copy = timer.last() / 10;
+    comm_allreduce_max(t_copy);
+    model.copy_bandwidth = large_bytes / t_copy;
+
+    for (int d = 0; d < 4; d++) {
+      auto &link = model.link[d];
+      if (!link.partitioned) continue;
+
+      exchangeTime(d, buffer, small_bytes, 1); // warm up
+      double t_small = exchangeTime(d, buffer, small_bytes, 100);
+      double t_large = exchangeTime(d, buffer, large_bytes, 10);
+
+      link.latency = t_small;
+      link.bandwidth = (large_bytes - small_bytes) / std::max(t_large - t_small, 1e-9);
+
+      logQuda(QUDA_VERBOSE, "Link model dim %d: p2p = %d, latency = %.2f us, bandwidth = %.2f GB/s\n", d, link.p2p,
+              1e6 * link.latency, 1e-9 * link.bandwidth);
+    }
+    logQuda(QUDA_VERBOSE, "Link model: device-host copy bandwidth = %.2f GB/s\n", 1e-9 * model.copy_bandwidth);
+
+    pool_pinned_free(buffer);
+    init = true;
+    return model;
+  }
+
+} // namespace quda
@@ -0,0 +1,158 @@
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <communicator_quda.h>
+#include <comm_progress.h>
+
+namespace quda
+{
+
+  using progress_clock = std::chrono::steady_clock;
+
+  static double seconds(progress_clock::duration d) { return std::chrono::duration<double>(d).count(); }
+
+  /**
+     State of a message handle known to the progress thread.  A handle
+     is active from comm_progress_start until the progress thread
+     observes its completion.
+   */
+  struct progress_entry_t {
+    Communicator *comm = nullptr;
+    bool active = false;
+    progress_clock::time_point posted;
+  };
+
+  /**
+     All state is guarded by a single mutex, which also serializes the
+     transport calls made on the message handles from the host and
+     progress threads.
+   */
+  static std::mutex progress_mutex;
+  static std::condition_variable progress_work; // signalled when a message is posted or on shutdown
+  static std::condition_variable progress_done; // signalled when a message completes
+  static std::unordered_map<MsgHandle *, progress_entry_t> progress_handles;
+  static std::vector<MsgHandle *> progress_active;
+  static std::thread progress_thread;
+  static bool progress_stop = false;
+  static comm_progress_stats_t progress_stats;
+
+  static void progress_loop()
+  {
+    std::unique_lock<std::mutex> lock(progress_mutex);
+    while (true) {
+      progress_work.wait(lock, [] { return progress_stop || !progress_active.empty(); });
+      if (progress_stop) break;
+
+      bool completed = false;
+      auto t0 = progress_clock::now();
+      for (auto it = progress_active.begin(); it != progress_active.end();) {
+        auto &entry = progress_handles[*it];
+        if (entry.comm->comm_query(*it)) {
+          entry.active = false;
+          progress_stats.messages++;
+          progress_stats.in_flight += seconds(progress_clock::now() - entry.posted);
+          it = progress_active.erase(it);
+          completed = true;
+        } else {
+          ++it;
+        }
+        progress_stats.tests++;
+      }
+      progress_stats.test += seconds(progress_clock::now() - t0);
+
+      if (completed) progress_done.notify_all();
+
+      // give the host thread a chance to post, query or wait
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+    }
+  }
+
+  void comm_progress_start(Communicator &comm, MsgHandle *mh)
+  {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    auto &entry = progress_handles[mh];
+    if (entry.active) errorQuda("Message handle %p has already been started", mh);
+
+    comm.comm_start(mh);
+    entry.comm = &comm;
+    entry.active = true;
+    entry.posted = progress_clock::now();
+    progress_active.push_back(mh);
+
+    if (!progress_thread.joinable()) {
+      progress_stop = false;
+      progress_thread = std::thread(progress_loop);
+    }
+    progress_work.notify_one();
+  }
+
+  int comm_progress_query(MsgHandle *mh)
+  {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    auto search = progress_handles.find(mh);
+    return search == progress_handles.end() || !search->second.active;
+  }
+
+  /**
+     @brief Wait for a handle to complete, with progress_mutex held
+   */
+  static void progress_wait(std::unique_lock<std::mutex> &lock, MsgHandle *mh)
+  {
+    auto search = progress_handles.find(mh);
+    if (search == progress_handles.end() || !search->second.active) return;
+
+    auto t0 = progress_clock::now();
+    auto &entry = search->second;
+    progress_done.wait(lock, [&] { return !entry.active; });
+    progress_stats.wait += seconds(progress_clock::now() - t0);
+  }
+
+  void comm_progress_wait(MsgHandle *mh)
+  {
+    std::unique_lock<std::mutex> lock(progress_mutex);
+    progress_wait(lock, mh);
+  }
+
+  void comm_progress_free(Communicator &comm, MsgHandle *&mh)
+  {
+    std::unique_lock<std::mutex> lock(progress_mutex);
+    progress_wait(lock, mh);
+    progress_handles.erase(mh);
+    comm.comm_free(mh);
+  }
+
+  comm_progress_stats_t comm_progress_stats()
+  {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    return progress_stats;
+  }
+
+  void comm_progress_finalize()
+  {
+    if (!progress_thread.joinable()) return;
+
+    {
+      std::lock_guard<std::mutex> lock(progress_mutex);
+      progress_stop = true;
+    }
+    progress_work.notify_one();
+    progress_thread.join();
+
+    auto &s = progress_stats;
+    logQuda(QUDA_SUMMARIZE,
+            "Comms progress thread: %lu messages, %lu tests in %.3e secs, mean in-flight time %.3e secs, host wait "
+            "%.3e secs\n",
+            s.messages, s.tests, s.test, s.messages ? s.in_flight / s.messages : 0.0, s.wait);
+
+    progress_handles.clear();
+    progress_active.clear();
+    progress_stats = {};
+  }
+
+} // namespace quda
@@ -275,6 +275,13 @@ namespace quda
     return query;
   }
 
+  bool Communicator::comm_thread_multiple()
+  {
+    int provided;
+    MPI_CHECK(MPI_Query_thread(&provided));
+    return provided == MPI_THREAD_MULTIPLE;
+  }
+
   void Communicator::comm_allreduce_sum_array(double *data, size_t size)
   {
     if (!comm_deterministic_reduce()) {
@@ -302,6 +302,9 @@ void Communicator::comm_wait(MsgHandle *mh) { QMP_CHECK(QMP_wait(mh->handle)); }
 
 int Communicator::comm_query(MsgHandle *mh) { return (QMP_is_complete(mh->handle) == QMP_TRUE); }
 
+// QMP message handles are not safe to progress from a second thread
+bool Communicator::comm_thread_multiple() { return false; }
+
 void Communicator::comm_allreduce_sum_array(double *data, size_t size)
 {
   if (!comm_deterministic_reduce()) {
@@ -81,6 +81,8 @@ namespace quda
 
   int Communicator::comm_query(MsgHandle *) { return 1; }
 
+  bool Communicator::comm_thread_multiple() { return true; }
+
   void Communicator::comm_allreduce_sum_array(double *, size_t) { }
 
   void Communicator::comm_allreduce_sum(size_t &) { }
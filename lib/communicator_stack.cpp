@@ -1,4 +1,5 @@
 #include <communicator_quda.h>
+#include <comm_progress.h>
 #include <map>
 #include <array.h>
 #include <lattice_field.h>
@@ -23,7 +24,11 @@ namespace quda
     current_key = default_comm_key;
   }
 
-  void finalize_communicator_stack() { communicator_stack.clear(); }
+  void finalize_communicator_stack()
+  {
+    comm_progress_finalize();
+    communicator_stack.clear();
+  }
 
   static Communicator &get_default_communicator()
   {
@@ -179,6 +184,8 @@ namespace quda
 
   void comm_enable_peer2peer(bool enable) { get_current_communicator().comm_enable_peer2peer(enable); }
 
+  void comm_enable_peer2peer(int dim, bool enable) { get_current_communicator().comm_enable_peer2peer(dim, enable); }
+
   bool comm_intranode_enabled(int dir, int dim) { return get_current_communicator().comm_intranode_enabled(dir, dim); }
 
   void comm_enable_intranode(bool enable) { get_current_communicator().comm_enable_intranode(enable); }
@@ -191,6 +198,8 @@ namespace quda
 
   bool comm_nvshmem_enabled() { return get_current_communicator().comm_nvshmem_enabled(); }
 
+  bool comm_progress_enabled() { return get_current_communicator().comm_progress_enabled(); }
+
   MsgHandle *comm_declare_send_rank(void *buffer, int rank, int tag, size_t nbytes)
   {
     return get_current_communicator().comm_declare_send_rank(buffer, rank, tag, nbytes);
@@ -226,13 +235,39 @@ namespace quda
 
 #define CHECK_MH(mh) { if (mh == nullptr) errorQuda("null message handle"); }
 
-  void comm_free(MsgHandle *&mh) { CHECK_MH(mh); get_current_communicator().comm_free(mh); }
+  // when the progress thread is enabled it owns all started handles
+  void comm_free(MsgHandle *&mh)
+  {
+    CHECK_MH(mh);
+    if (comm_progress_enabled())
+      comm_progress_free(get_current_communicator(), mh);
+    else
+      get_current_communicator().comm_free(mh);
+  }
 
-  void comm_start(MsgHandle *mh) { CHECK_MH(mh); get_current_communicator().comm_start(mh); }
+  void comm_start(MsgHandle *mh)
+  {
+    CHECK_MH(mh);
+    if (comm_progress_enabled())
+      comm_progress_start(get_current_communicator(), mh);
+    else
+      get_current_communicator().comm_start(mh);
+  }
 
-  void comm_wait(MsgHandle *mh) { CHECK_MH(mh); get_current_communicator().comm_wait(mh); }
+  void comm_wait(MsgHandle *mh)
+  {
+    CHECK_MH(mh);
+    if (comm_progress_enabled())
+      comm_progress_wait(mh);
+    else
+      get_current_communicator().comm_wait(mh);
+  }
 
-  int comm_query(MsgHandle *mh) { CHECK_MH(mh); return get_current_communicator().comm_query(mh); }
+  int comm_query(MsgHandle *mh)
+  {
+    CHECK_MH(mh);
+    return comm_progress_enabled() ? comm_progress_query(mh) : get_current_communicator().comm_query(mh);
+  }
 
 #undef CHECK_MH
 
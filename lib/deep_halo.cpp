@@ -0,0 +1,161 @@
+#include <deep_halo.h>
+#include <field_cache.h>
+#include <comm_quda.h>
+#include <comm_key.h>
+
+namespace quda
+{
+
+  void exchangeExtendedGhost(cvector_ref<ColorSpinorField> &v, const lat_dim_t &R)
+  {
+    for (int d = 0; d < 4; d++) {
+      if (!comm_dim_partitioned(d) || R[d] == 0) continue;
+
+      // slabs of depth R[d] in dimension d, with the transverse
+      // extent including the halos already filled in lower dimensions
+      ColorSpinorParam param(v[0]);
+      param.create = QUDA_NULL_FIELD_CREATE;
+      param.x[d] = (d == 0 && v[0].SiteSubset() == QUDA_PARITY_SITE_SUBSET) ? R[d] / 2 : R[d];
+      auto slab_tmp = getFieldTmp<ColorSpinorField>(param);
+      ColorSpinorField &slab = slab_tmp;
+
+      const size_t bytes = slab.Bytes();
+      const size_t msg_bytes = v.size() * bytes;
+      // buffer layout is [send back, send fwd, recv back, recv fwd]
+      auto buffer = static_cast<char *>(pool_pinned_malloc(4 * msg_bytes));
+      char *send[2] = {buffer, buffer + msg_bytes};
+      char *recv[2] = {buffer + 2 * msg_bytes, buffer + 3 * msg_bytes};
+
+      MsgHandle *mh_recv[2] = {comm_declare_receive_relative(recv[0], d, -1, msg_bytes),
+                               comm_declare_receive_relative(recv[1], d, +1, msg_bytes)};
+      MsgHandle *mh_send[2] = {comm_declare_send_relative(send[0], d, -1, msg_bytes),
+                               comm_declare_send_relative(send[1], d, +1, msg_bytes)};
+      for (auto &mh : mh_recv) comm_start(mh);
+
+      for (auto i = 0u; i < v.size(); i++) {
+        const int X = v[i].full_dim(d) - 2 * R[d]; // interior extent
+        if (R[d] > X) errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", R[d], X, d);
+
+        CommKey offset = {};
+        offset[d] = R[d]; // the first interior layers are sent backwards
+        copyFieldOffset(slab, v[i], offset, v[i].PCType());
+        qudaMemcpy(send[0] + i * bytes, slab.data(), bytes, qudaMemcpyDeviceToHost);
+
+        offset[d] = X; // the last interior layers are sent forwards
+        copyFieldOffset(slab, v[i], offset, v[i].PCType());
+        qudaMemcpy(send[1] + i * bytes, slab.data(), bytes, qudaMemcpyDeviceToHost);
+      }
+
+      for (auto &mh : mh_send) comm_start(mh);
+      for (auto &mh : mh_recv) comm_wait(mh);
+      for (auto &mh : mh_send) comm_wait(mh);
+
+      for (auto i = 0u; i < v.size(); i++) {
+        const int X = v[i].full_dim(d) - 2 * R[d];
+
+        CommKey offset = {};
+        offset[d] = 0; // the backward neighbor's last layers fill the backward halo
+        qudaMemcpy(slab.data(), recv[0] + i * bytes, bytes, qudaMemcpyHostToDevice);
+        copyFieldOffset(v[i], slab, offset, v[i].PCType());
+
+        offset[d] = X + R[d]; // the forward neighbor's first layers fill the forward halo
+        qudaMemcpy(slab.data(), recv[1] + i * bytes, bytes, qudaMemcpyHostToDevice);
+        copyFieldOffset(v[i], slab, offset, v[i].PCType());
+      }
+
+      for (auto &mh : mh_recv) comm_free(mh);
+      for (auto &mh : mh_send) comm_free(mh);
+      pool_pinned_free(buffer);
+    }
+  }
+
+  bool DeepHalo::supported(const DiracMatrix &mat)
+  {
+    auto dirac = mat.Expose();
+    switch (dirac->getDiracType()) {
+    case QUDA_WILSON_DIRAC:
+    case QUDA_WILSONPC_DIRAC:
+    case QUDA_STAGGERED_DIRAC:
+    case QUDA_STAGGEREDPC_DIRAC:
+    case QUDA_GAUGE_LAPLACE_DIRAC:
+    case QUDA_GAUGE_LAPLACEPC_DIRAC: break;
+    default: return false;
+    }
+    if (dirac->useDistancePC()) return false;
+
+    return dynamic_cast<const DiracM *>(&mat) || dynamic_cast<const DiracMdag *>(&mat)
+      || dynamic_cast<const DiracMdagM *>(&mat) || dynamic_cast<const DiracMMdag *>(&mat);
+  }
+
+  DeepHalo::DeepHalo(const DiracMatrix &mat, int depth) : depth(depth)
+  {
+    if (!supported(mat)) errorQuda("Deep-halo application not supported for operator %s", mat.Type().c_str());
+    if (depth < 1) errorQuda("Invalid deep-halo depth %d", depth);
+
+    // the halo depth is rounded up to even to preserve the checkerboarding
+    for (int d = 0; d < 4; d++) {
+      R[d] = comm_dim_partitioned(d) ? depth * mat.getStencilSteps() : 0;
+      R[d] += R[d] % 2;
+    }
+
+    auto base = mat.Expose();
+    gauge.reset(createExtendedGauge(*base->getGaugeField(), R));
+
+    switch (base->getDiracType()) {
+    case QUDA_WILSON_DIRAC: dirac = std::make_unique<DiracWilson>(static_cast<const DiracWilson &>(*base)); break;
+    case QUDA_WILSONPC_DIRAC: dirac = std::make_unique<DiracWilsonPC>(static_cast<const DiracWilsonPC &>(*base)); break;
+    case QUDA_STAGGERED_DIRAC:
+      dirac = std::make_unique<DiracStaggered>(static_cast<const DiracStaggered &>(*base));
+      break;
+    case QUDA_STAGGEREDPC_DIRAC:
+      dirac = std::make_unique<DiracStaggeredPC>(static_cast<const DiracStaggeredPC &>(*base));
+      break;
+    case QUDA_GAUGE_LAPLACE_DIRAC:
+      dirac = std::make_unique<GaugeLaplace>(static_cast<const GaugeLaplace &>(*base));
+      break;
+    case QUDA_GAUGE_LAPLACEPC_DIRAC:
+      dirac = std::make_unique<GaugeLaplacePC>(static_cast<const GaugeLaplacePC &>(*base));
+      break;
+    default: errorQuda("Unexpected dirac type %d", base->getDiracType());
+    }
+
+    // the halo is refreshed explicitly, so the operator runs without communication
+    dirac->updateFields(gauge.get(), nullptr, nullptr, nullptr);
+    int comm_dim[QUDA_MAX_DIM] = {};
+    dirac->setCommDim(comm_dim);
+
+    if (dynamic_cast<const DiracM *>(&mat))
+      ext = std::make_unique<DiracM>(*dirac);
+    else if (dynamic_cast<const DiracMdag *>(&mat))
+      ext = std::make_unique<DiracMdag>(*dirac);
+    else if (dynamic_cast<const DiracMdagM *>(&mat))
+      ext = std::make_unique<DiracMdagM>(*dirac);
+    else
+      ext = std::make_unique<DiracMMdag>(*dirac);
+    ext->shift = mat.shift;
+
+    logQuda(QUDA_VERBOSE, "Deep-halo operator with depth %d, halo = (%d, %d, %d, %d)\n", depth, R[0], R[1], R[2], R[3]);
+  }
+
+  ColorSpinorParam DeepHalo::extendedParam(const ColorSpinorField &field) const
+  {
+    ColorSpinorParam param(field);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    for (int d = 0; d < 4; d++)
+      param.x[d] += (d == 0 && field.SiteSubset() == QUDA_PARITY_SITE_SUBSET) ? R[d] : 2 * R[d];
+    return param;
+  }
+
+  void DeepHalo::extend(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const
+  {
+    CommKey offset = {R[0], R[1], R[2], R[3]};
+    for (auto i = 0u; i < in.size(); i++) copyFieldOffset(out[i], in[i], offset, in[i].PCType());
+  }
+
+  void DeepHalo::extract(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in) const
+  {
+    CommKey offset = {R[0], R[1], R[2], R[3]};
+    for (auto i = 0u; i < in.size(); i++) copyFieldOffset(out[i], in[i], offset, out[i].PCType());
+  }
+
+} // namespace quda
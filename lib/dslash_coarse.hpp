@@ -200,7 +200,12 @@ namespace quda {
       if (!checkParam(tp)) errorQuda("Invalid launch param");
 
       if (out.Location() == QUDA_CPU_FIELD_LOCATION) {
-        errorQuda("Not enabled");
+        // host fields are in QDP / space-spin-color order, and each host thread computes both directions and all
+        // dimensions, so there is no color-column or dimension splitting to dispatch on
+        if (tp.aux.x != 1 || tp.aux.y != 1)
+          errorQuda("Invalid host launch with color stride %d and dimension split %d", static_cast<int>(tp.aux.x),
+                    static_cast<int>(tp.aux.y));
+        launch_host<CoarseDslash>(tp, stream, Arg<1, 1, false>(out, inA, inB, Y, X, (Float)kappa, parity, halo));
       } else {
         checkNative(out[0], inA[0], inB[0], Y, X);
 
@@ -754,7 +759,7 @@ namespace quda {
 
       // before we do policy tuning we must ensure the kernel
       // constituents have been tuned since we can't do nested tuning
-      if (!tuned()) {
+      if (dslash.out.Location() == QUDA_CUDA_FIELD_LOCATION && !tuned()) {
         disableProfileCount();
 	for (auto &i : policies) if(i!= DslashCoarsePolicy::DSLASH_COARSE_POLICY_DISABLED) dslash(i);
 	enableProfileCount();
@@ -766,6 +771,12 @@ namespace quda {
 
    inline void apply(const qudaStream_t &)
    {
+     // the communication policies only differ in how device buffers are staged, so host fields use the basic policy
+     if (dslash.out.Location() == QUDA_CPU_FIELD_LOCATION) {
+       dslash(DslashCoarsePolicy::DSLASH_COARSE_BASIC);
+       return;
+     }
+
      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 
      if (tp.aux.x >= (int)policies.size()) errorQuda("Requested policy that is outside of range");
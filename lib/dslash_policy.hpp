@@ -1,9 +1,12 @@
+#include <map>
 #include <memory>
+#include <tuple>
 #include <tune_quda.h>
 #include <index_helper.cuh>
 #include <timer.h>
 #include <dslash_quda.h>
 #include <dslash_shmem.h>
+#include <comm_link_model.h>
 
 namespace quda
 {
@@ -1690,6 +1693,9 @@ namespace quda
   // list of p2p policies that are enabled
   extern std::vector<QudaP2PPolicy> p2p_policies;
 
+  // tuned peer-to-peer dimensions of each policy tuning key, policy and p2p policy
+  extern std::map<std::tuple<TuneKey, int, int>, int> p2p_dim_cache;
+
   template <typename Dslash> struct DslashFactory {
 
     // map of GDR policies to their non-GDR equivalents
@@ -1753,6 +1759,162 @@ namespace quda
     policies[static_cast<std::size_t>(p)] = QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED;
   }
 
+  /**
+     @brief Map a policy to its equivalent with a single fused exterior kernel
+     @return The fused policy, or the policy itself if it has none
+   */
+  inline QudaDslashPolicy fused_policy(QudaDslashPolicy p)
+  {
+    switch (p) {
+    case QudaDslashPolicy::QUDA_DSLASH: return QudaDslashPolicy::QUDA_FUSED_DSLASH;
+    case QudaDslashPolicy::QUDA_GDR_DSLASH: return QudaDslashPolicy::QUDA_FUSED_GDR_DSLASH;
+    case QudaDslashPolicy::QUDA_GDR_RECV_DSLASH: return QudaDslashPolicy::QUDA_FUSED_GDR_RECV_DSLASH;
+    case QudaDslashPolicy::QUDA_ZERO_COPY_PACK_DSLASH: return QudaDslashPolicy::QUDA_FUSED_ZERO_COPY_PACK_DSLASH;
+    case QudaDslashPolicy::QUDA_ZERO_COPY_DSLASH: return QudaDslashPolicy::QUDA_FUSED_ZERO_COPY_DSLASH;
+    case QudaDslashPolicy::QUDA_ZERO_COPY_PACK_GDR_RECV_DSLASH:
+      return QudaDslashPolicy::QUDA_FUSED_ZERO_COPY_PACK_GDR_RECV_DSLASH;
+    default: return p;
+    }
+  }
+
+  /**
+     @brief Apply the dslash with a given policy
+     @param[in] policy The dslash policy
+     @param[in] p2p The peer-to-peer policy
+     @param[in] p2p_off Bit mask of the dimensions in which
+     peer-to-peer communication is replaced by host-staged communication
+   */
+  template <typename Dslash>
+  void apply_policy(Dslash &dslash, cvector_ref<const ColorSpinorField> &in, const ColorSpinorField &halo,
+                    TimeProfile &profile, QudaDslashPolicy policy, QudaP2PPolicy p2p, int p2p_off = 0)
+  {
+    bool p2p_enabled = comm_peer2peer_enabled_global();
+    if (p2p == QudaP2PPolicy::QUDA_P2P_DEFAULT) comm_enable_peer2peer(false); // disable p2p if using default policy
+    for (int d = 0; d < 4; d++)
+      if (p2p_off & (1 << d)) comm_enable_peer2peer(d, false);
+    // set whether we are using remote packing writes or copy engines
+    dslash.dslashParam.remote_write = (p2p == QudaP2PPolicy::QUDA_P2P_REMOTE_WRITE ? 1 : 0);
+
+    auto dslashImp = DslashFactory<Dslash>::create(policy);
+    (*dslashImp)(dslash, in, halo, profile);
+
+    // restore p2p state
+    for (int d = 0; d < 4; d++)
+      if (p2p_off & (1 << d)) comm_enable_peer2peer(d, true);
+    comm_enable_peer2peer(p2p_enabled);
+  }
+
+  /**
+     @brief Second level of the policy tuning: for the policy selected
+     by DslashPolicyTune, tune the dimensions in which peer-to-peer
+     communication is replaced by host-staged communication.  The
+     result is stored in the tunecache alongside the policy.
+   */
+  template <typename Dslash> class DslashP2PDimTune : public Tunable
+  {
+    Dslash &dslash;
+    cvector_ref<const ColorSpinorField> &in;
+    const ColorSpinorField &halo;
+    TimeProfile &profile;
+    TuneKey key;
+    QudaDslashPolicy policy;
+    QudaP2PPolicy p2p;
+    int dims; // candidate dimensions
+
+    bool tuneGridDim() const override { return false; } // Don't tune the grid dimensions.
+    bool tuneAuxDim() const override { return true; }   // Do tune the aux dimensions.
+    unsigned int sharedBytesPerThread() const override { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &) const override { return 0; }
+
+    // the next subset of the candidate dimensions, wrapping to the empty set
+    int next(int p2p_off) const { return ((p2p_off | ~dims) + 1) & dims; }
+
+  public:
+    /**
+       @param[in] key The tune key of the policy tuning
+       @param[in] policy The tuned dslash policy
+       @param[in] p2p The tuned peer-to-peer policy
+       @param[in] dims Bit mask of the candidate dimensions
+     */
+    DslashP2PDimTune(Dslash &dslash, cvector_ref<const ColorSpinorField> &in, const ColorSpinorField &halo,
+                     TimeProfile &profile, const TuneKey &key, QudaDslashPolicy policy, QudaP2PPolicy p2p, int dims) :
+      dslash(dslash), in(in), halo(halo), profile(profile), key(key), policy(policy), p2p(p2p), dims(dims)
+    {
+      strcat(this->key.aux, ",p2p_dim");
+
+      // ensure the kernel constituents have been tuned for every candidate
+      if (!tuned()) {
+        disableProfileCount();
+        int p2p_off = 0;
+        do {
+          apply_policy(dslash, in, halo, profile, policy, p2p, p2p_off);
+          p2p_off = next(p2p_off);
+        } while (p2p_off != 0);
+        enableProfileCount();
+        setPolicyTuning(true);
+      }
+    }
+
+    virtual ~DslashP2PDimTune() { setPolicyTuning(false); }
+
+    /**
+       @return Bit mask of the dimensions in which peer-to-peer is disabled
+     */
+    int p2pOff() { return tuneLaunch(*this, getTuning(), getVerbosity()).aux.x; }
+
+    void apply(const qudaStream_t &) override
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      apply_policy(dslash, in, halo, profile, policy, p2p, tp.aux.x);
+    }
+
+    bool advanceAux(TuneParam &param) const override
+    {
+      param.aux.x = next(param.aux.x);
+      return param.aux.x != 0;
+    }
+
+    bool advanceTuneParam(TuneParam &param) const override { return advanceAux(param); }
+
+    void initTuneParam(TuneParam &param) const override
+    {
+      Tunable::initTuneParam(param);
+      param.aux = make_int4(0, 0, 0, 0);
+    }
+
+    void defaultTuneParam(TuneParam &param) const override
+    {
+      Tunable::defaultTuneParam(param);
+      param.aux = make_int4(0, 0, 0, 0);
+    }
+
+    TuneKey tuneKey() const override { return key; }
+
+    long long flops() const override
+    {
+      KernelType kernel_type = dslash.dslashParam.kernel_type;
+      dslash.dslashParam.kernel_type = KERNEL_POLICY;
+      long long flops_ = dslash.flops();
+      dslash.dslashParam.kernel_type = kernel_type;
+      return flops_;
+    }
+
+    long long bytes() const override
+    {
+      KernelType kernel_type = dslash.dslashParam.kernel_type;
+      dslash.dslashParam.kernel_type = KERNEL_POLICY;
+      long long bytes_ = dslash.bytes();
+      dslash.dslashParam.kernel_type = kernel_type;
+      return bytes_;
+    }
+
+    void preTune() override { dslash.preTune(); }
+
+    void postTune() override { dslash.postTune(); }
+
+    int32_t getTuneRank() const override { return dslash.getTuneRank(); }
+  };
+
   template <typename Dslash> class DslashPolicyTune : public Tunable
   {
     Dslash &dslash;
@@ -1761,16 +1923,76 @@ namespace quda
     cvector_ref<const ColorSpinorField> &in;
     const ColorSpinorField &halo;
     TimeProfile &profile;
+    std::vector<bool> pruned; // policies pruned by the link model
 
     bool tuneGridDim() const override { return false; } // Don't tune the grid dimensions.
     bool tuneAuxDim() const override { return true; }   // Do tune the aux dimensions.
     unsigned int sharedBytesPerThread() const override { return 0; }
     unsigned int sharedBytesPerBlock(const TuneParam &) const override { return 0; }
 
+    bool candidate(int i) const
+    {
+      return policies[i] != QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED && !pruned[i];
+    }
+
+    int first_candidate() const
+    {
+      int i = first_active_policy;
+      while (!candidate(i)) i++; // a pruned policy is always followed by its fused equivalent
+      return i;
+    }
+
+    /**
+       @return The halo message size per direction in each dimension
+     */
+    array<size_t, 4> haloBytes() const
+    {
+      array<size_t, 4> bytes = {};
+      for (int d = 0; d < 4; d++) bytes[d] = dslashParam.commDim[d] ? halo.GhostFaceBytes(d) : 0;
+      return bytes;
+    }
+
+    /**
+       @brief Prune the policies that the link model predicts cannot
+       win: when every exchange is latency bound, the exterior kernels
+       of the non-fused policies cannot overlap any significant
+       transfer time, so they are dominated by their fused
+       equivalents, which launch a single exterior kernel.
+     */
+    void prune()
+    {
+      if (!comm_link_model_enabled() || !comm_link_model().latencyBound(haloBytes())) return;
+
+      int n_pruned = 0;
+      for (auto i = 0u; i < policies.size(); i++) {
+        auto fused = fused_policy(static_cast<QudaDslashPolicy>(i));
+        if (policies[i] == QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED || fused == policies[i]
+            || policies[static_cast<int>(fused)] == QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED)
+          continue;
+        pruned[i] = true;
+        n_pruned++;
+      }
+      logQuda(QUDA_DEBUG_VERBOSE, "Latency-bound halo exchange: pruned %d non-fused policies\n", n_pruned);
+    }
+
+    /**
+       @return Bit mask of the dimensions for which peer-to-peer is tuned
+     */
+    int p2pTuneDims() const
+    {
+      auto &model = comm_link_model();
+      if (comm_link_model_enabled()) return model.p2pTuneDims(haloBytes());
+
+      int dims = 0;
+      for (int d = 0; d < 4; d++)
+        if (model.link[d].p2p && dslashParam.commDim[d]) dims |= 1 << d;
+      return dims;
+    }
+
   public:
     DslashPolicyTune(Dslash &dslash, cvector_ref<const ColorSpinorField> &in, const ColorSpinorField &halo,
                      TimeProfile &profile) :
-      dslash(dslash), dslashParam(dslash.dslashParam), in(in), halo(halo), profile(profile)
+      dslash(dslash), dslashParam(dslash.dslashParam), in(in), halo(halo), profile(profile), pruned(policies.size(), false)
     {
       if (!dslash_policy_init) {
 
@@ -1909,6 +2131,7 @@ namespace quda
       // constituents have been tuned since we can't do nested tuning
       if (!tuned()) {
         disableProfileCount();
+        prune();
 
         for (auto &p2p : p2p_policies) {
 
@@ -1921,6 +2144,8 @@ namespace quda
 
           for (auto &i : policies) {
 
+            if (i != QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED && pruned[static_cast<int>(i)]) continue;
+
             if (i == QudaDslashPolicy::QUDA_DSLASH ||
                 i == QudaDslashPolicy::QUDA_FUSED_DSLASH ||
                 i == QudaDslashPolicy::QUDA_ZERO_COPY_PACK_DSLASH ||
@@ -1984,15 +2209,28 @@ namespace quda
      if (tp.aux.x >= static_cast<int>(policies.size())) errorQuda("Requested policy that is outside of range");
      if (static_cast<QudaDslashPolicy>(tp.aux.x) == QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED)  errorQuda("Requested policy is disabled");
 
-     bool p2p_enabled = comm_peer2peer_enabled_global();
-     if (p2p_policies[tp.aux.y] == QudaP2PPolicy::QUDA_P2P_DEFAULT) comm_enable_peer2peer(false); // disable p2p if using default policy
-     dslashParam.remote_write = (p2p_policies[tp.aux.y] == QudaP2PPolicy::QUDA_P2P_REMOTE_WRITE ? 1 : 0); // set whether we are using remote packing writes or copy engines
-
-     auto dslashImp = DslashFactory<Dslash>::create(static_cast<QudaDslashPolicy>(tp.aux.x));
-     (*dslashImp)(dslash, in, halo, profile);
+     auto policy = static_cast<QudaDslashPolicy>(tp.aux.x);
+     auto p2p = p2p_policies[tp.aux.y];
+
+     // once the policy is tuned, tune the dimensions in which it uses peer-to-peer; the result is
+     // cached so that the tuner is only constructed (and the tunecache searched) once per key
+     int p2p_off = 0;
+     if (getTuning() && !activeTuning() && p2p != QudaP2PPolicy::QUDA_P2P_DEFAULT && comm_peer2peer_enabled_global()) {
+       auto key = std::make_tuple(tuneKey(), tp.aux.x, tp.aux.y);
+       auto it = p2p_dim_cache.find(key);
+       if (it != p2p_dim_cache.end()) {
+         p2p_off = it->second;
+       } else {
+         int dims = p2pTuneDims();
+         if (dims) {
+           DslashP2PDimTune<Dslash> p2p_tune(dslash, in, halo, profile, std::get<0>(key), policy, p2p, dims);
+           p2p_off = p2p_tune.p2pOff();
+         }
+         p2p_dim_cache[key] = p2p_off;
+       }
+     }
 
-     // restore p2p state
-     comm_enable_peer2peer(p2p_enabled);
+     apply_policy(dslash, in, halo, profile, policy, p2p, p2p_off);
    }
 
    // Find the best dslash policy
@@ -2000,9 +2238,9 @@ namespace quda
    {
      while ((unsigned)param.aux.x < policies.size()-1) {
        param.aux.x++;
-       if (policies[param.aux.x] != QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED) return true;
+       if (candidate(param.aux.x)) return true;
      }
-     param.aux.x = first_active_policy;
+     param.aux.x = first_candidate();
 
      while ((unsigned)param.aux.y < p2p_policies.size()-1) {
        param.aux.y++;
@@ -2017,7 +2255,7 @@ namespace quda
 
    void initTuneParam(TuneParam &param) const override {
      Tunable::initTuneParam(param);
-     param.aux.x = first_active_policy;
+     param.aux.x = first_candidate();
      param.aux.y = first_active_p2p_policy;
      param.aux.z = 0;
    }
@@ -65,6 +65,9 @@ namespace quda {
     // list of p2p policies that are enabled
     std::vector<QudaP2PPolicy> p2p_policies;
 
+    // tuned peer-to-peer dimensions of each policy tuning key, policy and p2p policy
+    std::map<std::tuple<TuneKey, int, int>, int> p2p_dim_cache;
+
     // string used as a tunekey to ensure we retune if the dslash policy env changes
     char policy_string[TuneKey::aux_n];
 
@@ -183,6 +186,7 @@ namespace quda {
     dslash_copy = true;
 
     dslash_policy_init = false;
+    p2p_dim_cache.clear();
     first_active_policy = 0;
     first_active_p2p_policy = 0;
 
@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda_internal.h>
+#include <eigensolve_quda.h>
+#include <random_quda.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+#include <eigen_helper.h>
+
+namespace quda
+{
+
+  // Chebyshev filtered subspace iteration constructor
+  ChebFilteredSubspace::ChebFilteredSubspace(const DiracMatrix &mat, QudaEigParam *eig_param) :
+    EigenSolver(mat, eig_param)
+  {
+    getProfile().TPSTART(QUDA_PROFILE_INIT);
+
+    // The filter is normalised at zero and amplifies the low end of the spectrum
+    if (eig_param->spectrum != QUDA_SPECTRUM_SR_EIG && eig_param->spectrum != QUDA_SPECTRUM_SM_EIG)
+      errorQuda("Chebyshev filtered subspace iteration supports only the SR and SM spectrum (requested %d)",
+                eig_param->spectrum);
+    if (eig_param->poly_deg < 1) errorQuda("Invalid Chebyshev filter degree %d", eig_param->poly_deg);
+
+    // The filter and projection are applied block_size vectors at a time
+    if (block_size <= 0 || block_size > n_kr) block_size = n_kr;
+
+    ritz.resize(n_kr, 0.0);
+
+    getProfile().TPSTOP(QUDA_PROFILE_INIT);
+  }
+
+  void ChebFilteredSubspace::operator()(std::vector<ColorSpinorField> &kSpace, std::vector<Complex> &evals)
+  {
+    // Pre-launch checks and preparation
+    //---------------------------------------------------------------------------
+    queryPrec(kSpace[0].Precision());
+    // Check to see if we are loading eigenvectors
+    if (strcmp(eig_param->vec_infile, "") != 0) {
+      logQuda(QUDA_VERBOSE, "Loading evecs from file name %s\n", eig_param->vec_infile);
+      loadFromFile(kSpace, evals);
+      return;
+    }
+
+    // The search space is followed by block_size vectors of workspace,
+    // which must also accommodate the temporaries of checkChebyOpMax
+    resize(kSpace, std::max(n_kr, 3) + block_size, QUDA_ZERO_FIELD_CREATE);
+    evals.resize(n_kr, 0.0);
+
+    // Estimate the upper bound of the spectrum if it was not given
+    checkChebyOpMax(kSpace);
+
+    // Preserve any valid initial guesses, populate the rest with rands
+    RNG rng(kSpace[0], 1234);
+    auto norm = blas::norm2({kSpace.begin(), kSpace.begin() + n_kr});
+    for (int i = 0; i < n_kr; i++) {
+      if (!std::isfinite(norm[i]) || norm[i] == 0.0) { spinorNoise(kSpace[i], rng, QUDA_NOISE_UNIFORM); }
+    }
+
+    // Filtered vectors are strongly aligned with the lowest modes, so
+    // we orthonormalise twice to retain orthogonality
+    auto orthonormalize = [&]() {
+      for (int k = 0; k < 2; k++) orthonormalizeHMGS(kSpace, ortho_block_size, n_kr, num_locked);
+    };
+    orthonormalize();
+
+    printEigensolverSetup();
+    logQuda(QUDA_VERBOSE, "Chebyshev filter degree %d, batch size %d\n", eig_param->poly_deg, block_size);
+
+    // The initial projection gives the lower bound of the first filter
+    rayleighRitz(kSpace);
+    filter_min = ritz[n_kr - 1];
+    //---------------------------------------------------------------------------
+
+    // Begin filtered subspace iteration
+    //---------------------------------------------------------------------------
+    getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
+
+    while (restart_iter < max_restarts && !converged) {
+
+      if (filter_min >= eig_param->a_max)
+        errorQuda("Chebyshev filter lower bound %e exceeds the spectral bound %e", filter_min, eig_param->a_max);
+
+      // Damp [filter_min, a_max], which holds everything above the search space
+      filter(kSpace, eig_param->poly_deg);
+      orthonormalize();
+
+      getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
+      rayleighRitz(kSpace);
+      getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
+
+      iter_locked = lockConverged(kSpace);
+      num_locked += iter_locked;
+      num_converged = num_locked;
+
+      // The next filter damps everything above the current search space
+      filter_min = ritz[n_kr - 1];
+
+      logQuda(QUDA_VERBOSE, "%04d converged eigenvalues at restart iter %04d\n", num_converged, restart_iter + 1);
+      logQuda(QUDA_DEBUG_VERBOSE, "iter Lock = %d\n", iter_locked);
+      logQuda(QUDA_DEBUG_VERBOSE, "filter interval = [%e, %e]\n", filter_min, eig_param->a_max);
+      for (int i = 0; i < n_kr; i++) {
+        logQuda(QUDA_DEBUG_VERBOSE, "Ritz[%d] = %.16e residual[%d] = %.16e\n", i, ritz[i], i, residua[i]);
+      }
+
+      if (num_converged >= n_conv) converged = true;
+
+      restart_iter++;
+    }
+
+    getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    for (int i = 0; i < n_kr; i++) evals[i] = ritz[i];
+
+    // Post computation report
+    //---------------------------------------------------------------------------
+    if (!converged) {
+      if (eig_param->require_convergence) {
+        errorQuda("Chebyshev filtered subspace iteration failed to compute the requested %d vectors with a %d search "
+                  "space in %d restart steps. Exiting.",
+                  n_conv, n_kr, max_restarts);
+      } else {
+        warningQuda("Chebyshev filtered subspace iteration failed to compute the requested %d vectors with a %d search "
+                    "space in %d restart steps. Continuing with current search space.",
+                    n_conv, n_kr, max_restarts);
+      }
+    } else {
+      logQuda(QUDA_SUMMARIZE,
+              "Chebyshev filtered subspace iteration computed the requested %d vectors in %d restart steps and %d "
+              "OP*x operations.\n",
+              n_conv, restart_iter, iter);
+
+      // Dump all Ritz values and residua
+      for (int i = 0; i < n_conv; i++) {
+        logQuda(QUDA_SUMMARIZE, "RitzValue[%04d]: (%+.16e, %+.16e) residual %.16e\n", i, ritz[i], 0.0, residua[i]);
+      }
+
+      // Compute eigenvalues/singular values
+      computeEvals(kSpace, evals);
+      if (compute_svd) computeSVD(kSpace, evals);
+    }
+
+    // Local clean-up
+    cleanUpEigensolver(kSpace, evals);
+  }
+
+  // Filtered subspace member functions
+  //---------------------------------------------------------------------------
+  void ChebFilteredSubspace::filter(std::vector<ColorSpinorField> &kSpace, int degree)
+  {
+    for (int i = num_locked; i < n_kr; i += block_size) {
+      int size = std::min(block_size, n_kr - i);
+      chebyFilter({kSpace.begin() + n_kr, kSpace.begin() + n_kr + size}, {kSpace.begin() + i, kSpace.begin() + i + size},
+                  degree, filter_min, eig_param->a_max);
+      for (int j = 0; j < size; j++) std::swap(kSpace[i + j], kSpace[n_kr + j]);
+      iter += size * std::max(degree - 1, 1);
+    }
+  }
+
+  void ChebFilteredSubspace::rayleighRitz(std::vector<ColorSpinorField> &kSpace)
+  {
+    int dim = n_kr - num_locked;
+    MatrixXcd H = MatrixXcd::Zero(dim, dim);
+
+    // Build H_ij = v_i^dag A v_j one block of columns at a time
+    getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
+    for (int j = 0; j < dim; j += block_size) {
+      int size = std::min(block_size, dim - j);
+      auto Av = {kSpace.begin() + n_kr, kSpace.begin() + n_kr + size};
+      mat(Av, {kSpace.begin() + num_locked + j, kSpace.begin() + num_locked + j + size});
+
+      std::vector<Complex> s(dim * size);
+      blas::block::cDotProduct(s, {kSpace.begin() + num_locked, kSpace.begin() + n_kr}, Av);
+      for (int i = 0; i < dim; i++)
+        for (int k = 0; k < size; k++) H(i, j + k) = s[i * size + k];
+    }
+    iter += dim;
+    getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    // Diagonalise the Hermitian part; the eigenvalues are in increasing order
+    getProfile().TPSTART(QUDA_PROFILE_EIGEN);
+    MatrixXcd Hs = 0.5 * (H + H.adjoint());
+    SelfAdjointEigenSolver<MatrixXcd> eigensolver(Hs);
+
+    std::vector<Complex> rot(dim * dim);
+    for (int i = 0; i < dim; i++) {
+      ritz[num_locked + i] = eigensolver.eigenvalues()[i];
+      for (int j = 0; j < dim; j++) rot[i * dim + j] = eigensolver.eigenvectors()(i, j);
+    }
+    getProfile().TPSTOP(QUDA_PROFILE_EIGEN);
+
+    // Rotate the unlocked vectors into the Ritz vectors
+    rotateVecs(kSpace, rot, n_kr, dim, dim, num_locked);
+  }
+
+  int ChebFilteredSubspace::lockConverged(std::vector<ColorSpinorField> &kSpace)
+  {
+    int n_locked = 0;
+    bool done = false;
+
+    for (int i = num_locked; i < n_conv && !done; i += block_size) {
+      int size = std::min(block_size, n_conv - i);
+      auto y = {kSpace.begin() + i, kSpace.begin() + i + size};
+      auto Ay = {kSpace.begin() + n_kr, kSpace.begin() + n_kr + size};
+
+      // ||theta_i * y_i - A * y_i||
+      mat(Ay, y);
+      iter += size;
+      std::vector<Complex> theta(ritz.begin() + i, ritz.begin() + i + size);
+      Complex n_unit(-1.0, 0.0);
+      auto res = blas::caxpbyNorm(theta, y, n_unit, Ay);
+
+      for (int j = 0; j < size; j++) {
+        residua[i + j] = sqrt(res[j]);
+        if (!done && residua[i + j] < tol * fabs(ritz[i + j])) {
+          logQuda(QUDA_DEBUG_VERBOSE, "**** Locking %d resid=%+.6e condition=%.6e ****\n", i + j, residua[i + j],
+                  tol * fabs(ritz[i + j]));
+          n_locked++;
+        } else {
+          // Pairs are locked in order
+          done = true;
+        }
+      }
+    }
+
+    return n_locked;
+  }
+
+} // namespace quda
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <eigensolve_quda.h>
+#include <blas_lapack.h>
+#include <kernels/gather_rows.cuh>
+
+namespace quda
+{
+
+  template <typename T, bool scatter> struct gather_rows_wrapper : TunableKernel1D {
+    GatherRowsArg<T, scatter> arg;
+
+    unsigned int minThreads() const { return arg.threads.x; }
+
+    gather_rows_wrapper(T *w, T *const *v, unsigned int ld, size_t start, unsigned int rows, unsigned int n,
+                        QudaFieldLocation location) :
+      TunableKernel1D(static_cast<size_t>(rows) * n, location), arg(w, v, ld, start, rows, n)
+    {
+      strcat(aux, scatter ? ",scatter" : ",gather");
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      launch<GatherRows, true>(tp, stream, arg);
+    }
+
+    long long bytes() const { return 2 * sizeof(T) * arg.threads.x; }
+  };
+
+  /**
+     @brief Gather (or scatter) a block of rows of a set of vectors
+     to (from) the columns of a column-major matrix in a single kernel
+     @param[in,out] w The matrix
+     @param[in] v Array of the vector pointers, resident at location
+     @param[in] ld The leading dimension of w
+     @param[in] start The first row of the block
+     @param[in] rows The number of rows in the block
+     @param[in] n The number of vectors
+     @param[in] prec The precision of the vectors
+     @param[in] location The location of the vectors and w
+   */
+  template <bool scatter>
+  void gatherRows(void *w, void *const *v, unsigned int ld, size_t start, unsigned int rows, unsigned int n,
+                  QudaPrecision prec, QudaFieldLocation location)
+  {
+    if (prec == QUDA_DOUBLE_PRECISION) {
+      using T = complex<double>;
+      gather_rows_wrapper<T, scatter> gather(static_cast<T *>(w), reinterpret_cast<T *const *>(v), ld, start, rows,
+                                             n, location);
+    } else if (prec == QUDA_SINGLE_PRECISION) {
+      using T = complex<float>;
+      gather_rows_wrapper<T, scatter> gather(static_cast<T *>(w), reinterpret_cast<T *const *>(v), ld, start, rows,
+                                             n, location);
+    } else {
+      errorQuda("Unsupported precision %d", prec);
+    }
+  }
+
+  void rotateVecsGEMM(cvector_ref<ColorSpinorField> &v, const std::vector<Complex> &rot_array, int dim, int keep,
+                      int workspace)
+  {
+    if (v.size() < static_cast<size_t>(dim)) errorQuda("Insufficient vectors %lu for dim = %d", v.size(), dim);
+    if (keep > dim) errorQuda("Cannot rotate %d vectors into %d", dim, keep);
+
+    const auto &v0 = v[0];
+    auto location = v0.Location();
+    auto prec = v0.Precision();
+    if (prec < QUDA_SINGLE_PRECISION) errorQuda("Unsupported precision %d", prec);
+    for (auto i = 0; i < dim; i++) {
+      if (v[i].Precision() != prec || v[i].Bytes() != v0.Bytes() || v[i].Location() != location)
+        errorQuda("Vector %d does not match vector 0", i);
+    }
+
+    // Each vector is treated as a column of complex numbers; any
+    // alignment padding is rotated along with the data
+    size_t elem = 2 * prec;
+    size_t length = v0.Bytes() / elem;
+
+    // The workspace holds a block of rows of the dim inputs and keep
+    // outputs.  The block is at least min_block rows so that the GEMM
+    // is compute bound and the launch count is small, and the gather
+    // is a single launch so its thread count must fit in an int.
+    constexpr size_t min_block = 4096;
+    size_t block = std::max<size_t>(1, static_cast<size_t>(std::max(workspace, 1)) * length / (dim + keep));
+    block = std::min(length, std::max(block, min_block));
+    block = std::min<size_t>(block, std::numeric_limits<int>::max() / dim);
+
+    // The rotation matrix in the vector precision
+    std::vector<char> rot_h(dim * keep * elem);
+    for (int i = 0; i < dim * keep; i++) {
+      if (prec == QUDA_DOUBLE_PRECISION)
+        reinterpret_cast<std::complex<double> *>(rot_h.data())[i] = rot_array[i];
+      else
+        reinterpret_cast<std::complex<float> *>(rot_h.data())[i] = std::complex<float>(rot_array[i]);
+    }
+
+    // The vector pointers, used by the gather and scatter kernels
+    std::vector<void *> ptr_h(dim);
+    for (int i = 0; i < dim; i++) ptr_h[i] = v[i].data();
+
+    bool device = location == QUDA_CUDA_FIELD_LOCATION;
+    auto alloc = [device](size_t bytes) { return device ? pool_device_malloc(bytes) : safe_malloc(bytes); };
+    void *w_in = alloc(block * dim * elem);
+    void *w_out = alloc(block * keep * elem);
+    void *rot = device ? alloc(rot_h.size()) : rot_h.data();
+    void **ptr = device ? static_cast<void **>(alloc(dim * sizeof(void *))) : ptr_h.data();
+    if (device) {
+      qudaMemcpy(rot, rot_h.data(), rot_h.size(), qudaMemcpyHostToDevice);
+      qudaMemcpy(ptr, ptr_h.data(), dim * sizeof(void *), qudaMemcpyHostToDevice);
+    }
+
+    // C = A * B, where A holds the gathered inputs (column major,
+    // block x dim) and B^T = rot_array (stored row major, dim x keep)
+    QudaBLASParam param = newQudaBLASParam();
+    param.blas_type = QUDA_BLAS_GEMM;
+    param.trans_a = QUDA_BLAS_OP_N;
+    param.trans_b = QUDA_BLAS_OP_T;
+    param.n = keep;
+    param.k = dim;
+    param.lda = block;
+    param.ldb = keep;
+    param.ldc = block;
+    param.a_offset = param.b_offset = param.c_offset = 0;
+    param.a_stride = param.b_stride = param.c_stride = 0;
+    std::complex<double> alpha = 1.0, beta = 0.0;
+    memcpy(&param.alpha, &alpha, sizeof(alpha));
+    memcpy(&param.beta, &beta, sizeof(beta));
+    param.batch_count = 1;
+    param.data_type = prec == QUDA_DOUBLE_PRECISION ? QUDA_BLAS_DATATYPE_Z : QUDA_BLAS_DATATYPE_C;
+    param.data_order = QUDA_BLAS_DATAORDER_COL;
+
+    auto gemm = device ? blas_lapack::native::stridedBatchGEMM : blas_lapack::generic::stridedBatchGEMM;
+
+    logQuda(QUDA_DEBUG_VERBOSE, "GEMM rotation of %d into %d vectors with %lu blocks of %lu rows\n", dim, keep,
+            (length + block - 1) / block, block);
+
+    getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
+    for (size_t start = 0; start < length; start += block) {
+      size_t rows = std::min(block, length - start);
+
+      // gather this block of the input vectors into the columns of w_in
+      gatherRows<false>(w_in, ptr, block, start, rows, dim, prec, location);
+
+      // the BLAS library may not run on our stream
+      if (device) qudaStreamSynchronize(device::get_default_stream());
+      param.m = rows;
+      gemm(w_in, rot, w_out, param, location);
+
+      // all the inputs of this block have been read, so we can write back in place
+      gatherRows<true>(w_out, ptr, block, start, rows, keep, prec, location);
+    }
+    getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    if (device) {
+      pool_device_free(w_in);
+      pool_device_free(w_out);
+      pool_device_free(rot);
+      pool_device_free(ptr);
+    } else {
+      host_free(w_in);
+      host_free(w_out);
+    }
+  }
+
+} // namespace quda
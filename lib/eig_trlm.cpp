@@ -4,6 +4,10 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <utility>
 
 #include <quda_internal.h>
 #include <eigensolve_quda.h>
@@ -13,9 +17,311 @@
 #include <util_quda.h>
 #include <tune_quda.h>
 #include <eigen_helper.h>
+#include <checkpoint.h>
 
 namespace quda
 {
+
+  namespace
+  {
+
+    /**
+       Symmetric matrix with the arrow-plus-tridiagonal structure that
+       results from a thick restart: a diagonal block of size m coupled
+       to row m through the arrow, followed by a tridiagonal block.
+       Both the inertia count and shifted linear solves with this
+       matrix are O(n), which the structured Ritz solver relies on.
+     */
+    struct ArrowTridiag {
+      const std::vector<double> &d; /** Diagonal, length n */
+      const std::vector<double> &e; /** e[i] = A(i, m) for i < m, and A(i, i + 1) for m <= i < n - 1 */
+      const int n;                  /** Matrix dimension */
+      const int m;                  /** Position of the arrow */
+      double lower = 0.0;           /** Gershgorin lower bound on the spectrum */
+      double upper = 0.0;           /** Gershgorin upper bound on the spectrum */
+      double norm = 0.0;            /** Bound on the spectral norm */
+      double pivmin = 0.0;          /** Smallest pivot magnitude allowed in the inertia count */
+
+      ArrowTridiag(const std::vector<double> &d, const std::vector<double> &e, int m) :
+        d(d), e(e), n(d.size()), m(m)
+      {
+        double emax2 = 0.0;
+        std::vector<double> radius(n, 0.0);
+        for (int i = 0; i < n - 1; i++) {
+          emax2 = std::max(emax2, e[i] * e[i]);
+          int j = i < m ? m : i + 1; // column coupled to row i
+          radius[i] += std::abs(e[i]);
+          radius[j] += std::abs(e[i]);
+        }
+        lower = d[0] - radius[0];
+        upper = d[0] + radius[0];
+        for (int i = 1; i < n; i++) {
+          lower = std::min(lower, d[i] - radius[i]);
+          upper = std::max(upper, d[i] + radius[i]);
+        }
+        norm = std::max(std::abs(lower), std::abs(upper));
+        pivmin = std::numeric_limits<double>::min() * std::max(1.0, emax2);
+      }
+
+      /**
+         @brief Count the eigenvalues less than each of a batch of
+         shifts, using Sylvester's law of inertia on the LDL^T
+         factorization of A - sigma I that first eliminates the
+         diagonal block into the arrow row.  Interleaving independent
+         shifts hides the latency of the division chain.
+         @param[in] sigma The shifts
+         @param[out] neg The number of eigenvalues less than each shift
+       */
+      template <int N> void count(const double *sigma, int *neg) const
+      {
+        double p[N];
+        for (int s = 0; s < N; s++) {
+          p[s] = d[m] - sigma[s];
+          neg[s] = 0;
+        }
+        for (int i = 0; i < m; i++) {
+          for (int s = 0; s < N; s++) {
+            double q = d[i] - sigma[s];
+            if (std::abs(q) < pivmin) q = -pivmin;
+            neg[s] += q < 0.0;
+            p[s] -= e[i] * (e[i] / q);
+          }
+        }
+        for (int i = m; i < n; i++) {
+          for (int s = 0; s < N; s++) {
+            if (i > m) p[s] = d[i] - sigma[s] - e[i - 1] * (e[i - 1] / p[s]);
+            if (std::abs(p[s]) < pivmin) p[s] = -pivmin;
+            neg[s] += p[s] < 0.0;
+          }
+        }
+      }
+
+      /**
+         @brief Compute a batch of consecutive eigenvalues by
+         simultaneous bisection, to an absolute accuracy of eps * norm
+         @param[in] k0 Index of the first eigenvalue in the batch
+         @param[out] w Eigenvalues k0 ... min(k0 + N, n) - 1
+       */
+      template <int N> void eigenvalues(int k0, double *w) const
+      {
+        constexpr double eps = std::numeric_limits<double>::epsilon();
+        double lo[N], hi[N], mid[N];
+        int neg[N];
+        for (int s = 0; s < N; s++) {
+          lo[s] = lower - eps * norm - 2.0 * pivmin;
+          hi[s] = upper + eps * norm + 2.0 * pivmin;
+        }
+
+        bool done = false;
+        while (!done) {
+          for (int s = 0; s < N; s++) mid[s] = 0.5 * (lo[s] + hi[s]);
+          count<N>(mid, neg);
+          done = true;
+          for (int s = 0; s < N; s++) {
+            if (neg[s] <= std::min(k0 + s, n - 1))
+              lo[s] = mid[s];
+            else
+              hi[s] = mid[s];
+            double mid_s = 0.5 * (lo[s] + hi[s]);
+            if (hi[s] - lo[s] > eps * (std::abs(lo[s]) + std::abs(hi[s]) + norm) + 2.0 * pivmin && mid_s > lo[s]
+                && mid_s < hi[s])
+              done = false;
+          }
+        }
+
+        for (int s = 0; s < N && k0 + s < n; s++) w[s] = 0.5 * (lo[s] + hi[s]);
+      }
+
+      /**
+         @brief Solve (A - sigma I) x = b in place: the diagonal block
+         is eliminated into the arrow row, and the remaining
+         tridiagonal system is solved by LU with partial pivoting
+         (following LAPACK dgtsv).  Tiny pivots are perturbed so that
+         solves at an eigenvalue remain finite, as inverse iteration
+         requires.
+         @param[in] sigma The shift
+         @param[in,out] x Right hand side on input, solution on output
+         @param[in,out] work Workspace of length at least 4 (n - m)
+       */
+      void solve(double sigma, std::vector<double> &x, std::vector<double> &work) const
+      {
+        const double tiny = std::numeric_limits<double>::epsilon() * norm;
+        auto pivot = [tiny](double p) { return std::abs(p) < tiny ? (p < 0.0 ? -tiny : tiny) : p; };
+
+        const int k = n - m;
+        double *dg = work.data(), *du = dg + k, *du2 = du + k, *dl = du2 + k;
+        double *b = x.data() + m;
+
+        dg[0] = d[m] - sigma;
+        for (int i = 0; i < m; i++) {
+          double q = pivot(d[i] - sigma);
+          dg[0] -= e[i] * (e[i] / q);
+          b[0] -= e[i] * (x[i] / q);
+        }
+        for (int i = 1; i < k; i++) dg[i] = d[m + i] - sigma;
+        for (int i = 0; i < k - 1; i++) du[i] = dl[i] = e[m + i];
+
+        for (int i = 0; i < k - 1; i++) {
+          if (std::abs(dg[i]) >= std::abs(dl[i])) {
+            dg[i] = pivot(dg[i]);
+            double fact = dl[i] / dg[i];
+            dg[i + 1] -= fact * du[i];
+            b[i + 1] -= fact * b[i];
+            du2[i] = 0.0;
+          } else { // interchange rows i and i + 1
+            double fact = dg[i] / dl[i];
+            dg[i] = dl[i];
+            double tmp = dg[i + 1];
+            dg[i + 1] = du[i] - fact * tmp;
+            du2[i] = i < k - 2 ? du[i + 1] : 0.0;
+            if (i < k - 2) du[i + 1] = -fact * du2[i];
+            du[i] = tmp;
+            tmp = b[i];
+            b[i] = b[i + 1];
+            b[i + 1] = tmp - fact * b[i + 1];
+          }
+        }
+        dg[k - 1] = pivot(dg[k - 1]);
+
+        b[k - 1] /= dg[k - 1];
+        if (k > 1) b[k - 2] = (b[k - 2] - du[k - 2] * b[k - 1]) / dg[k - 2];
+        for (int i = k - 3; i >= 0; i--) b[i] = (b[i] - du[i] * b[i + 1] - du2[i] * b[i + 2]) / dg[i];
+
+        for (int i = 0; i < m; i++) x[i] = (x[i] - e[i] * b[0]) / pivot(d[i] - sigma);
+      }
+    };
+
+    /**
+       @brief Compute the eigenvectors of an arrow-plus-tridiagonal
+       matrix by inverse iteration at the given eigenvalues.  Each
+       vector costs O(n), and distinct eigenvalues are processed
+       concurrently.  Eigenvalues that agree to within the rounding
+       level form clusters whose vectors are orthogonalized against
+       each other at every iteration, which keeps them distinct; the
+       residual loss of orthogonality between vectors with larger gaps
+       is removed for the kept vectors by orthonormalizeRitzClusters.
+       @param[in] A The matrix
+       @param[in] w The eigenvalues in ascending order
+       @param[out] V The eigenvectors, with V[n * j + i] holding
+       component i of eigenvector j
+     */
+    void arrowEigenvectors(const ArrowTridiag &A, const std::vector<double> &w, std::vector<double> &V)
+    {
+      constexpr double eps = std::numeric_limits<double>::epsilon();
+      constexpr int max_iter = 5;
+      constexpr int large_cluster = 64; // threshold for threading within a cluster
+      constexpr int block = 256;        // row blocking for the orthogonalization update
+      const int n = A.n;
+      const double ortol = 1e4 * eps * A.norm;
+      const double growth_min = 1.0 / (10.0 * std::sqrt(n) * eps * std::max(A.norm, A.pivmin));
+
+      V.resize(static_cast<size_t>(n) * n);
+
+      std::vector<std::pair<int, int>> small_clusters, large_clusters;
+      for (int c0 = 0, c1 = 1; c0 < n; c0 = c1++) {
+        while (c1 < n && w[c1] - w[c1 - 1] <= ortol) c1++;
+        (c1 - c0 >= large_cluster ? large_clusters : small_clusters).push_back({c0, c1});
+      }
+
+      std::atomic<int> unconverged = 0;
+      auto cluster = [&](std::pair<int, int> c, bool threaded) {
+        std::vector<double> x(n), work(4 * (n - A.m)), coeff(c.second - c.first);
+        for (int j = c.first; j < c.second; j++) {
+          // deterministic pseudo-random starting vector
+          uint64_t seed = 0x9e3779b97f4a7c15ull * (j + 1);
+          for (auto &xi : x) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            xi = static_cast<double>(seed >> 11) * 0x1.0p-53 - 0.5;
+          }
+
+          bool converged = false;
+          for (int iter = 0; iter < max_iter; iter++) {
+            A.solve(w[j], x, work);
+
+            // classical Gram-Schmidt, applied twice, against the earlier vectors of this cluster
+            const int nc = j - c.first;
+            for (int pass = 0; nc > 0 && pass < 2; pass++) {
+#ifdef _OPENMP
+#pragma omp parallel for if (threaded)
+#endif
+              for (int p = 0; p < nc; p++) {
+                const double *v = &V[static_cast<size_t>(n) * (c.first + p)];
+                double dot = 0.0;
+                for (int i = 0; i < n; i++) dot += v[i] * x[i];
+                coeff[p] = dot;
+              }
+#ifdef _OPENMP
+#pragma omp parallel for if (threaded)
+#endif
+              for (int i0 = 0; i0 < n; i0 += block) {
+                const int i1 = std::min(i0 + block, n);
+                for (int p = 0; p < nc; p++) {
+                  const double *v = &V[static_cast<size_t>(n) * (c.first + p)];
+                  for (int i = i0; i < i1; i++) x[i] -= coeff[p] * v[i];
+                }
+              }
+            }
+
+            double growth = 0.0;
+            for (auto xi : x) growth += xi * xi;
+            growth = std::sqrt(growth);
+            for (auto &xi : x) xi /= growth;
+
+            // one further iteration once the residual is at the rounding level
+            if (converged) break;
+            converged = growth >= growth_min;
+          }
+          if (!converged) unconverged++;
+
+          std::copy(x.begin(), x.end(), V.begin() + static_cast<size_t>(n) * j);
+        }
+      };
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (auto i = 0u; i < small_clusters.size(); i++) cluster(small_clusters[i], false);
+      for (auto &c : large_clusters) cluster(c, true);
+
+      if (unconverged > 0)
+        logQuda(QUDA_DEBUG_VERBOSE, "Inverse iteration did not converge for %d Ritz vectors\n", unconverged.load());
+    }
+
+  } // namespace
+
+  void arrowEigensolve(const std::vector<double> &d, const std::vector<double> &e, int m, std::vector<double> &w,
+                       std::vector<double> &V)
+  {
+    // eigenvalues by bisection on the O(n) inertia count, eigenvectors by inverse iteration with O(n) solves
+    ArrowTridiag A(d, e, m);
+    const int n = A.n;
+    constexpr int batch = 8;
+    w.resize(n + batch);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k = 0; k < n; k += batch) A.eigenvalues<batch>(k, &w[k]);
+    w.resize(n);
+
+    arrowEigenvectors(A, w, V);
+  }
+
+  void orthonormalizeRitzClusters(std::vector<double> &V, const double *w, int n, int k)
+  {
+    if (k < 2) return;
+    double norm = 0.0;
+    for (int j = 0; j < n; j++) norm = std::max(norm, std::abs(w[j]));
+    const double ortol = 1e-3 * norm;
+
+    Eigen::Map<MatrixXd> X(V.data(), n, n);
+    for (int c0 = 0, c1 = 1; c0 < k; c0 = c1++) {
+      while (c1 < k && std::abs(w[c1] - w[c1 - 1]) <= ortol) c1++;
+      if (c1 - c0 < 2) continue;
+      Eigen::HouseholderQR<MatrixXd> qr(X.middleCols(c0, c1 - c0));
+      X.middleCols(c0, c1 - c0) = qr.householderQ() * MatrixXd::Identity(n, c1 - c0);
+    }
+  }
+
   // Thick Restarted Lanczos Method constructor
   TRLM::TRLM(const DiracMatrix &mat, QudaEigParam *eig_param) : EigenSolver(mat, eig_param)
   {
@@ -67,6 +373,36 @@ namespace quda
 
     // Print Eigensolver params
     printEigensolverSetup();
+
+    // Resume from a checkpoint if one exists: the metadata holds the
+    // restart counters, the problem dimensions and the arrow matrix
+    std::string checkpoint_key;
+    int iter_saved = 0;
+    if (checkpoint::enabled()) {
+      checkpoint_key = checkpoint::key("trlm");
+      std::vector<double> meta;
+      auto n = checkpoint::load(checkpoint_key, kSpace, meta);
+      constexpr int n_counter = 9;
+      if (n > 0 && meta.size() == n_counter + 3 * static_cast<size_t>(n_kr) && meta[6] == n_ev && meta[7] == n_kr
+          && meta[8] == tol && n == meta[3] + 1) {
+        restart_iter = meta[0];
+        iter = meta[1];
+        num_converged = meta[2];
+        num_keep = meta[3];
+        num_locked = meta[4];
+        mat_norm = meta[5];
+        for (int i = 0; i < n_kr; i++) {
+          alpha[i] = meta[n_counter + i];
+          beta[i] = meta[n_counter + n_kr + i];
+          residua[i] = meta[n_counter + 2 * n_kr + i];
+        }
+        iter_saved = iter;
+        logQuda(QUDA_SUMMARIZE, "TRLM: resuming from checkpoint %s at restart %d\n", checkpoint_key.c_str(),
+                restart_iter);
+      } else if (n >= 0) {
+        warningQuda("Ignoring checkpoint %s since it does not match this eigensolve", checkpoint_key.c_str());
+      }
+    }
     //---------------------------------------------------------------------------
 
     // Begin TRLM Eigensolver computation
@@ -152,10 +488,31 @@ namespace quda
       }
 
       restart_iter++;
+
+      // Snapshot the kept Ritz vectors and residual vector, which are all that
+      // is needed to continue the thick restart
+      if (!checkpoint_key.empty() && !converged && iter - iter_saved >= checkpoint::interval()) {
+        std::vector<double> meta = {static_cast<double>(restart_iter),
+                                    static_cast<double>(iter),
+                                    static_cast<double>(num_converged),
+                                    static_cast<double>(num_keep),
+                                    static_cast<double>(num_locked),
+                                    mat_norm,
+                                    static_cast<double>(n_ev),
+                                    static_cast<double>(n_kr),
+                                    tol};
+        meta.insert(meta.end(), alpha.begin(), alpha.end());
+        meta.insert(meta.end(), beta.begin(), beta.end());
+        meta.insert(meta.end(), residua.begin(), residua.begin() + n_kr);
+        checkpoint::save(checkpoint_key, {kSpace.begin(), kSpace.begin() + num_keep + 1}, meta);
+        iter_saved = iter;
+      }
     }
 
     getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
 
+    if (!checkpoint_key.empty()) checkpoint::remove(checkpoint_key);
+
     // Post computation report
     //---------------------------------------------------------------------------
     if (!converged) {
@@ -256,10 +613,6 @@ namespace quda
     int dim = n_kr - num_locked;
     int arrow_pos = num_keep - num_locked;
 
-    // Eigen objects
-    MatrixXd A = MatrixXd::Zero(dim, dim);
-    ritz_mat.resize(dim * dim, 0.0);
-
     // Invert the spectrum due to chebyshev
     if (reverse) {
       for (int i = num_locked; i < n_kr - 1; i++) {
@@ -269,6 +622,31 @@ namespace quda
       alpha[n_kr - 1] *= -1.0;
     }
 
+    structured_ritz = dim >= structured_ritz_min_dim;
+    if (structured_ritz) {
+      // Exploit the arrow structure
+      std::vector<double> d = {alpha.begin() + num_locked, alpha.begin() + n_kr};
+      std::vector<double> e = {beta.begin() + num_locked, beta.begin() + n_kr - 1};
+      std::vector<double> w;
+      arrowEigensolve(d, e, arrow_pos, w, ritz_mat);
+
+      for (int i = 0; i < dim; i++) {
+        residua[i + num_locked] = fabs(beta[n_kr - 1] * ritz_mat[dim * i + dim - 1]);
+        alpha[i + num_locked] = w[i];
+      }
+
+      if (reverse) {
+        for (int i = num_locked; i < n_kr; i++) { alpha[i] *= -1.0; }
+      }
+
+      getProfile().TPSTOP(QUDA_PROFILE_EIGEN);
+      return;
+    }
+
+    // Eigen objects
+    MatrixXd A = MatrixXd::Zero(dim, dim);
+    ritz_mat.resize(dim * dim, 0.0);
+
     // Construct arrow mat A_{dim,dim}
     for (int i = 0; i < dim; i++) {
 
@@ -317,6 +695,13 @@ namespace quda
     int offset = n_kr + 1;
     int dim = n_kr - num_locked;
 
+    // only the kept Ritz vectors need to be mutually orthonormal
+    if (structured_ritz) {
+      getProfile().TPSTART(QUDA_PROFILE_EIGEN);
+      orthonormalizeRitzClusters(ritz_mat, alpha.data() + num_locked, dim, iter_keep);
+      getProfile().TPSTOP(QUDA_PROFILE_EIGEN);
+    }
+
     // Multi-BLAS friendly array to store part of Ritz matrix we want
     std::vector<double> ritz_mat_keep(dim * iter_keep);
     for (int j = 0; j < dim; j++) {
@@ -5,6 +5,7 @@
 #include <vector>
 #include <algorithm>
 #include <cfloat>
+#include <limits>
 
 #include <quda_internal.h>
 #include <eigensolve_quda.h>
@@ -15,6 +16,7 @@
 #include <util_quda.h>
 #include <tune_quda.h>
 #include <vector_io.h>
+#include <blas_lapack.h>
 #include <eigen_helper.h>
 
 namespace quda
@@ -85,6 +87,15 @@ namespace quda
     // underlying operators (M, Mdag) is computed.
     compute_svd = eig_param->compute_svd;
 
+    if (eig_param->use_poly_acc && eig_param->poly_halo_depth > 1) {
+      if (DeepHalo::supported(mat)) {
+        deep_halo = std::make_unique<DeepHalo>(mat, eig_param->poly_halo_depth);
+      } else {
+        warningQuda("Deep-halo polynomial acceleration not supported for operator %s, using regular halos",
+                    mat.Type().c_str());
+      }
+    }
+
     getProfile().TPSTOP(QUDA_PROFILE_INIT);
   }
 
@@ -112,6 +123,10 @@ namespace quda
       logQuda(QUDA_VERBOSE, "Creating Block TR Lanczos eigensolver\n");
       eig_solver = new BLKTRLM(mat, eig_param);
       break;
+    case QUDA_EIG_CHEB_FILTERED_SUBSPACE:
+      logQuda(QUDA_VERBOSE, "Creating Chebyshev filtered subspace eigensolver\n");
+      eig_solver = new ChebFilteredSubspace(mat, eig_param);
+      break;
     default: errorQuda("Invalid eig solver type");
     }
 
@@ -170,7 +185,8 @@ namespace quda
 
   void EigenSolver::checkChebyOpMax(std::vector<ColorSpinorField> &kSpace)
   {
-    if (eig_param->use_poly_acc) {
+    // The filtered subspace solver always needs the upper spectral bound
+    if (eig_param->use_poly_acc || eig_param->eig_type == QUDA_EIG_CHEB_FILTERED_SUBSPACE) {
       if (eig_param->a_max <= 0.0) {
         // Use part of the kSpace as temps
         eig_param->a_max = estimateChebyOpMax(kSpace[block_size + 2], kSpace[block_size + 1]);
@@ -269,9 +285,13 @@ namespace quda
 
     if (eig_param->poly_deg == 0) errorQuda("Polynomial acceleration requested with zero polynomial degree");
 
+    chebyFilter(out, in, eig_param->poly_deg, eig_param->a_min, eig_param->a_max);
+  }
+
+  void EigenSolver::chebyFilter(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in, int degree,
+                                double a, double b)
+  {
     // Compute the polynomial accelerated operator.
-    double a = eig_param->a_min;
-    double b = eig_param->a_max;
     double delta = (b - a) / 2.0;
     double theta = (b + a) / 2.0;
     double sigma1 = -delta / theta;
@@ -285,7 +305,12 @@ namespace quda
     mat({out.begin(), out.end()}, {in.begin(), in.end()});
     blas::caxpby(d2, in, d1, out);
 
-    if (eig_param->poly_deg == 1) return;
+    if (degree == 1) return;
+
+    if (deep_halo) {
+      chebyFilterDeepHalo(out, in, degree, a, b);
+      return;
+    }
 
     // C_0 is the current 'in'  vector.
     // C_1 is the current 'out' vector.
@@ -300,7 +325,7 @@ namespace quda
     double sigma_old = sigma1;
 
     // construct C_{m+1}(x)
-    for (int i = 2; i < eig_param->poly_deg; i++) {
+    for (int i = 2; i < degree; i++) {
       sigma = 1.0 / (2.0 / sigma1 - sigma_old);
 
       d1 = 2.0 * sigma / delta;
@@ -320,6 +345,59 @@ namespace quda
     for (auto i = 0u; i < in.size(); i++) std::swap(out[i], tmp2[i]);
   }
 
+  void EigenSolver::chebyFilterDeepHalo(cvector_ref<ColorSpinorField> &out, cvector_ref<const ColorSpinorField> &in,
+                                        int degree, double a, double b)
+  {
+    double delta = (b - a) / 2.0;
+    double theta = (b + a) / 2.0;
+    double sigma1 = -delta / theta;
+    double sigma;
+    double d1;
+    double d2;
+    double d3;
+
+    // C_{m-1} and C_{m} on the extended lattice are stored in the
+    // first and second halves of tmp, so that both share one exchange.
+    // C_0 and C_1 were computed by chebyFilter on the original lattice.
+    const auto n = in.size();
+    std::vector<ColorSpinorField> tmp, ext_out;
+    auto param = deep_halo->extendedParam(in[0]);
+    resize(tmp, 2 * n, param);
+    resize(ext_out, n, param);
+    cvector_ref<ColorSpinorField> tmp1 {tmp.begin(), tmp.begin() + n};
+    cvector_ref<ColorSpinorField> tmp2 {tmp.begin() + n, tmp.end()};
+    deep_halo->extend(tmp1, in);
+    deep_halo->extend(tmp2, out);
+
+    double sigma_old = sigma1;
+
+    // each application invalidates one stencil depth of the halo, so
+    // the halo is refreshed every deep_halo->Depth() applications
+    int steps = deep_halo->Depth();
+    for (int i = 2; i < degree; i++) {
+      if (steps == deep_halo->Depth()) {
+        deep_halo->exchange(tmp);
+        steps = 0;
+      }
+
+      sigma = 1.0 / (2.0 / sigma1 - sigma_old);
+
+      d1 = 2.0 * sigma / delta;
+      d2 = -d1 * theta;
+      d3 = -sigma * sigma_old;
+
+      (*deep_halo)(ext_out, tmp2);
+
+      blas::axpbypczw(d3, tmp1, d2, tmp2, d1, ext_out, tmp1);
+      for (auto j = 0u; j < n; j++) std::swap(tmp[j], tmp[n + j]);
+
+      sigma_old = sigma;
+      steps++;
+    }
+
+    deep_halo->extract(out, tmp2);
+  }
+
   double EigenSolver::estimateChebyOpMax(ColorSpinorField &out, ColorSpinorField &in)
   {
     RNG rng(in, 1234);
@@ -374,9 +452,9 @@ namespace quda
     return orthed;
   }
 
-  void EigenSolver::orthonormalizeHMGS(std::vector<ColorSpinorField> &vecs, int h_block_size, int size)
+  void EigenSolver::orthonormalizeHMGS(std::vector<ColorSpinorField> &vecs, int h_block_size, int size, int start)
   {
-    for (int i = 0; i < size; i++) {
+    for (int i = start; i < size; i++) {
       auto array_size = h_block_size;
       for (int j = 0; j < i; j += array_size) {
         if (i < h_block_size || h_block_size == 0) array_size = i;
@@ -556,6 +634,12 @@ namespace quda
     }
 
     int n_defl = n_ev_deflate;
+    if (coherentDeflation()) errorQuda("SVD deflation does not support a local coherence deflation space");
+    if (streamedDeflation()) {
+      logQuda(QUDA_VERBOSE, "Deflating %d left and right singular vectors from host memory\n", n_defl);
+      deflateStreamed(sol, src, evals, true, accumulate);
+      return;
+    }
     if (evecs.size() != (unsigned int)(2 * eig_param->n_conv))
       errorQuda("Incorrect deflation space sized %d passed to deflateSVD, expected %d", (int)(evecs.size()),
                 2 * eig_param->n_conv);
@@ -641,6 +725,15 @@ namespace quda
     int n_defl = n_ev_deflate;
     logQuda(QUDA_VERBOSE, "Deflating %d vectors\n", n_defl);
 
+    if (coherentDeflation()) {
+      deflateCoherent(sol, src, evals, accumulate);
+      return;
+    }
+    if (streamedDeflation()) {
+      deflateStreamed(sol, src, evals, false, accumulate);
+      return;
+    }
+
     // Perform Sum_i V_i * (L_i)^{-1} * (V_i)^dag * vec = vec_defl
     // for all i computed eigenvectors and values.
 
@@ -657,6 +750,235 @@ namespace quda
     blas::block::caxpy(s, {evecs.begin(), evecs.begin() + n_defl}, {sol.begin(), sol.end()});
   }
 
+  void EigenSolver::deflateCoherent(cvector_ref<ColorSpinorField> &sol, cvector_ref<const ColorSpinorField> &src,
+                                    const std::vector<Complex> &evals, bool accumulate) const
+  {
+    int n_defl = n_ev_deflate;
+    if (n_defl > static_cast<int>(coherent_evecs.size()))
+      errorQuda("Requested deflation with %d vectors, compressed space has only %lu", n_defl, coherent_evecs.size());
+
+    // Since each eigenvector is V c_i, with V the block-local basis,
+    // V_i^dag * vec = c_i^dag * (V^dag vec) and the deflated vector is
+    // V * Sum_i c_i * (L_i)^{-1} * A_i, so all the per-eigenvector work
+    // is done on the coefficients and we prolongate only once
+
+    // 1. Restrict the sources onto the block-local basis
+    ColorSpinorParam param(coherent_evecs[0]);
+    param.setPrecision(src[0].Precision(), QUDA_INVALID_PRECISION, true);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    std::vector<FieldTmp<ColorSpinorField>> src_c, sol_c;
+    for (auto i = 0u; i < src.size(); i++) {
+      src_c.push_back(getFieldTmp<ColorSpinorField>(param));
+      sol_c.push_back(getFieldTmp<ColorSpinorField>(param));
+    }
+    coherent_transfer->R(src_c, src);
+
+    // 2. Take block inner product: c_i^dag * (V^dag vec) = A_i
+    std::vector<Complex> s(n_defl * src.size());
+    blas::block::cDotProduct(s, {coherent_evecs.begin(), coherent_evecs.begin() + n_defl}, src_c);
+
+    // 3. Perform block caxpy on the coefficients: c_i * (L_i)^{-1} * A_i
+    for (auto j = 0u; j < src.size(); j++)
+      for (int i = 0; i < n_defl; i++) { s[i * src.size() + j] /= evals[i].real(); }
+    blas::zero(sol_c);
+    blas::block::caxpy(s, {coherent_evecs.begin(), coherent_evecs.begin() + n_defl}, sol_c);
+
+    // 4. Reconstruct vec_defl = V * Sum_i c_i * (L_i)^{-1} * A_i
+    if (accumulate) {
+      auto tmp = getFieldTmp(sol);
+      coherent_transfer->P(tmp, sol_c);
+      blas::xpy(tmp, sol);
+    } else {
+      coherent_transfer->P(sol, sol_c);
+    }
+  }
+
+  void EigenSolver::deflateStreamed(cvector_ref<ColorSpinorField> &sol, cvector_ref<const ColorSpinorField> &src,
+                                    const std::vector<Complex> &evals, bool svd, bool accumulate) const
+  {
+    int n_defl = n_ev_deflate;
+    int tile = std::min(eig_param->deflation_tile_size, n_defl);
+    int n_tile = (n_defl + tile - 1) / tile;
+
+    // Each staging buffer holds the vectors we accumulate, followed
+    // (for SVD deflation) by the left singular vectors we project onto
+    int dot_offset = svd ? eig_param->n_conv : 0;
+    int dot_begin = svd ? tile : 0;
+
+    const auto &stage = host_stage;
+    if (stage[0].size() < static_cast<size_t>(svd ? 2 * tile : tile))
+      errorQuda("Staging area of %lu vectors is too small for tile size %d", stage[0].size(), tile);
+    auto bytes = stage[0][0].Bytes();
+
+    auto copy_stream = device::get_stream(0);
+    auto compute_stream = device::get_default_stream();
+    qudaEvent_t copied[2] = {qudaEventCreate(), qudaEventCreate()};
+    qudaEvent_t released[2] = {qudaEventCreate(), qudaEventCreate()};
+
+    // Copy tile t into buffer t % 2, once the tile that last used it is done
+    auto fetch = [&](int t) {
+      int b = t % 2;
+      int begin = t * tile;
+      int size = std::min(tile, n_defl - begin);
+      if (t >= 2) qudaStreamWaitEvent(copy_stream, released[b], 0);
+      for (int i = 0; i < size; i++) {
+        qudaMemcpyAsync(stage[b][i].data(), host_evecs[begin + i].data_host(), bytes, qudaMemcpyHostToDevice,
+                        copy_stream);
+        if (svd)
+          qudaMemcpyAsync(stage[b][dot_begin + i].data(), host_evecs[dot_offset + begin + i].data_host(), bytes,
+                          qudaMemcpyHostToDevice, copy_stream);
+      }
+      qudaEventRecord(copied[b], copy_stream);
+    };
+
+    if (!accumulate) blas::zero(sol);
+
+    fetch(0);
+    for (int t = 0; t < n_tile; t++) {
+      int b = t % 2;
+      int begin = t * tile;
+      int size = std::min(tile, n_defl - begin);
+
+      // Overlap the transfer of the next tile with the work on this one
+      if (t + 1 < n_tile) fetch(t + 1);
+      qudaStreamWaitEvent(compute_stream, copied[b], 0);
+
+      // Sum_i V_i * (L_i)^{-1} * (V_i)^dag * vec over the vectors of this tile
+      std::vector<Complex> s(size * src.size());
+      blas::block::cDotProduct(s, {stage[b].begin() + dot_begin, stage[b].begin() + dot_begin + size}, src);
+      for (auto j = 0u; j < src.size(); j++)
+        for (int i = 0; i < size; i++) { s[i * src.size() + j] /= evals[begin + i].real(); }
+      blas::block::caxpy(s, {stage[b].begin(), stage[b].begin() + size}, sol);
+
+      qudaEventRecord(released[b], compute_stream);
+    }
+
+    for (auto &e : copied) qudaEventDestroy(e);
+    for (auto &e : released) qudaEventDestroy(e);
+  }
+
+  void EigenSolver::offloadDeflationSpace(std::vector<ColorSpinorField> &evecs)
+  {
+    if (eig_param->deflation_location != QUDA_CPU_FIELD_LOCATION) return;
+    if (evecs.empty() || streamedDeflation()) return;
+    if (coherentDeflation()) {
+      logQuda(QUDA_VERBOSE, "Keeping the local coherence deflation space in device memory\n");
+      return;
+    }
+    if (evecs[0].Location() != QUDA_CUDA_FIELD_LOCATION) errorQuda("Expected a device-resident deflation space");
+    if (eig_param->deflation_tile_size <= 0) errorQuda("Invalid deflation tile size %d", eig_param->deflation_tile_size);
+
+    // the staging area holds one tile, twice over for the left singular vectors of an SVD space
+    bool svd = evecs.size() == 2 * static_cast<size_t>(eig_param->n_conv);
+    int tile = std::min(eig_param->deflation_tile_size, n_ev_deflate);
+    ColorSpinorParam stage_param(evecs[0]);
+    stage_param.create = QUDA_NULL_FIELD_CREATE;
+    for (auto &s : host_stage) resize(s, svd ? 2 * tile : tile, stage_param);
+
+    size_t bytes = 0;
+    host_evecs.reserve(evecs.size());
+    for (auto &v : evecs) {
+      host_evecs.emplace_back(QUDA_MEMORY_HOST_PINNED, v.Bytes(), false);
+      qudaMemcpy(host_evecs.back().data_host(), v.data(), v.Bytes(), qudaMemcpyDeviceToHost);
+      bytes += v.Bytes();
+    }
+    evecs.clear();
+
+    logQuda(QUDA_SUMMARIZE, "Moved deflation space of %lu vectors (%.3f GiB) to host memory\n", host_evecs.size(),
+            bytes / pow(1024.0, 3));
+  }
+
+  void EigenSolver::compressDeflationSpace(std::vector<ColorSpinorField> &evecs)
+  {
+    if (evecs.empty() || coherentDeflation()) return;
+
+    auto convert = [](std::vector<ColorSpinorField> &v, QudaPrecision prec) {
+      for (auto &v_i : v) {
+        if (prec >= v_i.Precision()) continue;
+        ColorSpinorParam param(v_i);
+        param.setPrecision(prec, QUDA_INVALID_PRECISION, true);
+        param.create = QUDA_NULL_FIELD_CREATE;
+        ColorSpinorField tmp(param);
+        tmp = v_i;
+        std::swap(v_i, tmp);
+      }
+    };
+
+    size_t bytes = 0;
+    for (auto &v : evecs) bytes += v.Bytes();
+
+    auto prec = eig_param->deflation_prec == QUDA_INVALID_PRECISION ? evecs[0].Precision() : eig_param->deflation_prec;
+    auto n_vec = eig_param->deflation_coherence_n_vec;
+    bool svd = evecs.size() == 2 * static_cast<size_t>(eig_param->n_conv);
+
+    if (n_vec > 0 && svd) {
+      warningQuda("Local coherence compression is not supported for SVD deflation, compressing precision only");
+    } else if (n_vec > 0) {
+      if (n_vec > static_cast<int>(evecs.size()))
+        errorQuda("Local coherence basis size %d exceeds the deflation space size %lu", n_vec, evecs.size());
+
+      const auto &v0 = evecs[0];
+      const QudaParity parity = impliedParityFromMatPC(mat.getMatPCType());
+      bool pc = v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET;
+
+      int geo_bs[QUDA_MAX_DIM];
+      for (int d = 0; d < QUDA_MAX_DIM; d++) geo_bs[d] = d < 4 ? eig_param->deflation_coherence_geo_block_size[d] : 1;
+      int spin_bs = v0.Nspin() == 4 ? 2 : v0.Nspin() == 2 ? 1 : 0;
+
+      // The block orthogonalization requires full fields, so
+      // single-parity eigenvectors are embedded with zero on the
+      // other parity
+      ColorSpinorParam param(v0);
+      param.create = QUDA_ZERO_FIELD_CREATE;
+      if (pc) {
+        param.siteSubset = QUDA_FULL_SITE_SUBSET;
+        param.x[0] *= 2;
+      }
+      for (int d = 0; d < v0.Ndim(); d++)
+        if (param.x[d] % geo_bs[d] != 0)
+          errorQuda("Cannot block dim[%d] = %d with local coherence block size %d", d, param.x[d], geo_bs[d]);
+
+      coherent_basis.resize(n_vec);
+      for (int i = 0; i < n_vec; i++) {
+        coherent_basis[i] = ColorSpinorField(param);
+        if (pc)
+          coherent_basis[i][parity] = evecs[i];
+        else
+          coherent_basis[i] = evecs[i];
+      }
+
+      logQuda(QUDA_VERBOSE, "Building local coherence basis from %d eigenvectors\n", n_vec);
+      coherent_transfer = std::make_unique<Transfer>(coherent_basis, n_vec, 1, true, geo_bs, spin_bs,
+                                                     std::max(prec, QUDA_HALF_PRECISION), QUDA_TRANSFER_AGGREGATE);
+      if (pc) coherent_transfer->setSiteSubset(QUDA_PARITY_SITE_SUBSET, parity);
+
+      // Once constructed the transfer operator only refers to the
+      // first vector for its geometry
+      coherent_basis.resize(1);
+
+      // Replace the eigenvectors by their coefficients
+      coherent_evecs.resize(evecs.size());
+      for (auto &c : coherent_evecs) c = coherent_basis[0].create_coarse(geo_bs, spin_bs, n_vec, v0.Precision());
+      coherent_transfer->R(coherent_evecs, evecs);
+      evecs.clear();
+
+      convert(coherent_evecs, std::max(prec, QUDA_HALF_PRECISION));
+
+      size_t coherent_bytes = coherent_transfer->Vectors().Bytes();
+      for (auto &c : coherent_evecs) coherent_bytes += c.Bytes();
+      logQuda(QUDA_SUMMARIZE, "Compressed deflation space from %.3f GiB to %.3f GiB\n", bytes / pow(1024.0, 3),
+              coherent_bytes / pow(1024.0, 3));
+      return;
+    }
+
+    convert(evecs, prec);
+
+    size_t compressed_bytes = 0;
+    for (auto &v : evecs) compressed_bytes += v.Bytes();
+    logQuda(QUDA_SUMMARIZE, "Compressed deflation space from %.3f GiB to %.3f GiB\n", bytes / pow(1024.0, 3),
+            compressed_bytes / pow(1024.0, 3));
+  }
+
   void EigenSolver::loadFromFile(std::vector<ColorSpinorField> &kSpace,
                                  std::vector<Complex> &evals)
   {
@@ -800,6 +1122,13 @@ namespace quda
   {
     using matrix_t = eigen_matrix_t<T>;
 
+    if (useGEMMRotate(kSpace[0])) {
+      std::vector<Complex> rot(rot_array.begin(), rot_array.end());
+      rotateVecsGEMM({kSpace.begin() + locked, kSpace.begin() + locked + dim}, rot, dim, keep,
+                     batched_rotate > 0 ? batched_rotate : 4);
+      return;
+    }
+
     // If we have memory available, do the entire rotation
     if (batched_rotate <= 0 || batched_rotate >= keep) {
       if ((int)kSpace.size() < offset + keep) {
@@ -920,6 +1249,17 @@ namespace quda
     }
   }
 
+  bool EigenSolver::useGEMMRotate(const ColorSpinorField &v) const
+  {
+    if (eig_param->use_gemm_rotate != QUDA_BOOLEAN_TRUE) return false;
+    // block-float fields carry a per-site norm so are not plain complex arrays
+    if (v.Precision() < QUDA_SINGLE_PRECISION) return false;
+#ifndef NATIVE_LAPACK_LIB
+    if (v.Location() == QUDA_CUDA_FIELD_LOCATION) return false;
+#endif
+    return true;
+  }
+
   template void EigenSolver::rotateVecs<double>(std::vector<ColorSpinorField> &kSpace,
                                                 const std::vector<double> &rot_array, int offset, int dim, int keep,
                                                 int locked);
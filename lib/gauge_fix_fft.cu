@@ -51,6 +51,292 @@ namespace quda {
     long long bytes() const { return 4 * sizeof(Float) * data.Volume(); }
   };
 
+  template <typename Float> class GaugeFixFFTReorder : TunableKernel1D
+  {
+    template <FFTReorderType type> using Arg = GaugeFixFFTReorderArg<Float, type>;
+    const GaugeField &data;
+    FFTReorderType type;
+    int dim;
+    int P;
+    const complex<Float> *in;
+    complex<Float> *out;
+    char aux_tmp[TuneKey::aux_n];
+    unsigned int minThreads() const { return data.Volume(); }
+
+  public:
+    GaugeFixFFTReorder(const GaugeField &data) : TunableKernel1D(data), data(data) { strcpy(aux_tmp, aux); }
+
+    void apply(FFTReorderType type_, int dim_, int P_, const complex<Float> *in_, complex<Float> *out_)
+    {
+      type = type_;
+      dim = dim_;
+      P = P_;
+      in = in_;
+      out = out_;
+      strcpy(aux, aux_tmp);
+      strcat(aux, ",dim=");
+      u32toa(aux + strlen(aux), dim);
+      strcat(aux, ",P=");
+      u32toa(aux + strlen(aux), P);
+      switch (type) {
+      case FFT_LOCAL_TO_LINE: strcat(aux, ",local_to_line"); break;
+      case FFT_LINE_TO_LOCAL: strcat(aux, ",line_to_local"); break;
+      case FFT_RECV_TO_FFT: strcat(aux, ",recv_to_fft"); break;
+      case FFT_FFT_TO_SEND: strcat(aux, ",fft_to_send"); break;
+      default: errorQuda("Unknown reorder type %d", type);
+      }
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      switch (type) {
+      case FFT_LOCAL_TO_LINE: launch<FFTReorder>(tp, stream, Arg<FFT_LOCAL_TO_LINE>(data, dim, P, in, out)); break;
+      case FFT_LINE_TO_LOCAL: launch<FFTReorder>(tp, stream, Arg<FFT_LINE_TO_LOCAL>(data, dim, P, in, out)); break;
+      case FFT_RECV_TO_FFT: launch<FFTReorder>(tp, stream, Arg<FFT_RECV_TO_FFT>(data, dim, P, in, out)); break;
+      case FFT_FFT_TO_SEND: launch<FFTReorder>(tp, stream, Arg<FFT_FFT_TO_SEND>(data, dim, P, in, out)); break;
+      default: errorQuda("Unknown reorder type %d", type);
+      }
+    }
+
+    long long flops() const { return 0; }
+    long long bytes() const { return 2 * sizeof(complex<Float>) * data.Volume(); }
+  };
+
+  /**
+     @brief Distributed four-dimensional complex-to-complex FFT of a
+     field with one complex number per site, stored in the local
+     lexicographical order on each rank.  Each dimension is
+     transformed in turn as a batch of one-dimensional FFTs over
+     pencils: the data are reordered into lines along the dimension,
+     and if the dimension is partitioned over P ranks, the lines are
+     redistributed with an all-to-all between those ranks so that each
+     holds 1/P of the complete global lines.  After the FFT the
+     inverse all-to-all returns each rank its own slice of momenta,
+     so on exit rank c in dimension d holds momenta [c L_d, (c+1)
+     L_d) in local lexicographical order.
+  */
+  template <typename Float> class DistributedFFT
+  {
+    const GaugeField &meta;
+    GaugeFixFFTReorder<Float> reorder;
+    size_t volume;
+    int P[4];
+    FFTPlanHandle plan[4];
+    complex<Float> *buffer[2];
+    bool gdr;
+    void *send_h = nullptr;
+    void *recv_h = nullptr;
+    std::vector<MsgHandle *> mh_send[4];
+    std::vector<MsgHandle *> mh_recv[4];
+
+    size_t chunk_bytes(int d) const { return volume / P[d] * sizeof(complex<Float>); }
+
+    /**
+       @brief All-to-all between the ranks in dimension d: chunk q of
+       send is sent to the rank with coordinate q, and the chunk
+       received from rank q is stored in chunk q of recv
+    */
+    void exchange(int d, const complex<Float> *send, complex<Float> *recv)
+    {
+      const int me = comm_coord(d);
+      const size_t bytes = chunk_bytes(d);
+      if (!gdr) qudaMemcpy(send_h, send, volume * sizeof(complex<Float>), qudaMemcpyDeviceToHost);
+
+      for (auto &mh : mh_recv[d]) comm_start(mh);
+      for (auto &mh : mh_send[d]) comm_start(mh);
+
+      // our own chunk does not leave the rank
+      if (gdr)
+        qudaMemcpy(reinterpret_cast<char *>(recv) + me * bytes, reinterpret_cast<const char *>(send) + me * bytes,
+                   bytes, qudaMemcpyDeviceToDevice);
+      else
+        memcpy(static_cast<char *>(recv_h) + me * bytes, static_cast<char *>(send_h) + me * bytes, bytes);
+
+      for (auto &mh : mh_recv[d]) comm_wait(mh);
+      for (auto &mh : mh_send[d]) comm_wait(mh);
+      if (!gdr) qudaMemcpy(recv, recv_h, volume * sizeof(complex<Float>), qudaMemcpyHostToDevice);
+    }
+
+  public:
+    DistributedFFT(const GaugeField &meta) :
+      meta(meta), reorder(meta), volume(meta.Volume()), gdr(comm_gdr_enabled())
+    {
+      for (int i = 0; i < 2; i++) buffer[i] = static_cast<complex<Float> *>(device_malloc(volume * sizeof(complex<Float>)));
+      if (!gdr) {
+        send_h = pinned_malloc(volume * sizeof(complex<Float>));
+        recv_h = pinned_malloc(volume * sizeof(complex<Float>));
+      }
+
+      auto topo = comm_default_topology();
+      for (int d = 0; d < 4; d++) {
+        P[d] = comm_dim(d);
+        auto lines = volume / meta.X()[d];
+        if (lines % P[d] != 0)
+          errorQuda("Local lines %lu in dimension %d not divisible by the %d ranks in that dimension", lines, d, P[d]);
+
+        // after the all-to-all each rank holds lines / P complete lines of length P * L
+        SetPlanFFTMany(plan[d], make_int4(lines / P[d], 1, 1, P[d] * meta.X()[d]), 1, meta.Precision());
+
+        if (P[d] == 1) continue;
+        char *send = gdr ? reinterpret_cast<char *>(buffer[0]) : static_cast<char *>(send_h);
+        char *recv = gdr ? reinterpret_cast<char *>(buffer[1]) : static_cast<char *>(recv_h);
+        for (int q = 0; q < P[d]; q++) {
+          if (q == comm_coord(d)) continue;
+          int coords[4];
+          for (int i = 0; i < 4; i++) coords[i] = comm_coord(i);
+          coords[d] = q;
+          int rank = comm_rank_from_coords(topo, coords);
+          mh_send[d].push_back(comm_declare_send_rank(send + q * chunk_bytes(d), rank, d, chunk_bytes(d)));
+          mh_recv[d].push_back(comm_declare_recv_rank(recv + q * chunk_bytes(d), rank, d, chunk_bytes(d)));
+        }
+      }
+    }
+
+    DistributedFFT(const DistributedFFT &) = delete;
+    DistributedFFT &operator=(const DistributedFFT &) = delete;
+
+    ~DistributedFFT()
+    {
+      for (int d = 0; d < 4; d++) {
+        for (auto &mh : mh_send[d]) comm_free(mh);
+        for (auto &mh : mh_recv[d]) comm_free(mh);
+        FFTDestroyPlan(plan[d]);
+      }
+      for (int i = 0; i < 2; i++) device_free(buffer[i]);
+      if (send_h) host_free(send_h);
+      if (recv_h) host_free(recv_h);
+    }
+
+    /**
+       @brief Apply the transform
+       @param[in] in Input field in local lexicographical order
+       @param[out] out Output field in local lexicographical order
+       @param[in] direction FFT_FORWARD or FFT_INVERSE
+    */
+    void operator()(const complex<Float> *in, complex<Float> *out, int direction)
+    {
+      for (int d = 0; d < 4; d++) {
+        // the send handles are bound to buffer[0] and the receives to buffer[1]
+        reorder.apply(FFT_LOCAL_TO_LINE, d, P[d], d == 0 ? in : out, buffer[0]);
+        if (P[d] > 1) {
+          exchange(d, buffer[0], buffer[1]);
+          reorder.apply(FFT_RECV_TO_FFT, d, P[d], buffer[1], buffer[0]);
+        }
+        ApplyFFT(plan[d], buffer[0], buffer[1], direction);
+        if (P[d] > 1) {
+          reorder.apply(FFT_FFT_TO_SEND, d, P[d], buffer[1], buffer[0]);
+          exchange(d, buffer[0], buffer[1]);
+        }
+        reorder.apply(FFT_LINE_TO_LOCAL, d, P[d], buffer[1], out);
+      }
+    }
+
+    long long flops() const
+    {
+      double flops = 0.0;
+      for (int d = 0; d < 4; d++) flops += 5.0 * volume * log2(static_cast<double>(P[d] * meta.X()[d]));
+      return flops;
+    }
+
+    long long bytes() const { return 4 * 4 * reorder.bytes(); }
+  };
+
+  /**
+     @brief Exchange of Delta(x) on the faces of the local lattice, so
+     that g(x + mu) can be applied to links that cross a partitioned
+     boundary
+  */
+  template <typename Float> class GaugeFixFFTHalo : TunableKernel1D
+  {
+    const GaugeField &data;
+    const complex<Float> *delta;
+    complex<Float> *const *halo;
+    int mu;
+    bool gdr;
+    complex<Float> *send_d[4] = {};
+    void *send_h[4] = {};
+    void *recv_h[4] = {};
+    MsgHandle *mh_send[4] = {};
+    MsgHandle *mh_recv[4] = {};
+    char aux_tmp[TuneKey::aux_n];
+    unsigned int minThreads() const { return data.Volume() / data.X()[mu]; }
+    size_t face_bytes(int d) const { return 6 * data.Volume() / data.X()[d] * sizeof(complex<Float>); }
+
+  public:
+    GaugeFixFFTHalo(const GaugeField &data, const complex<Float> *delta, complex<Float> *const *halo) :
+      TunableKernel1D(data), data(data), delta(delta), halo(halo), mu(0), gdr(comm_gdr_enabled())
+    {
+      strcpy(aux_tmp, aux);
+      for (int d = 0; d < 4; d++) {
+        if (!comm_dim_partitioned(d)) continue;
+        send_d[d] = static_cast<complex<Float> *>(device_malloc(face_bytes(d)));
+        if (gdr) {
+          mh_send[d] = comm_declare_send_relative(send_d[d], d, -1, face_bytes(d));
+          mh_recv[d] = comm_declare_receive_relative(halo[d], d, +1, face_bytes(d));
+        } else {
+          send_h[d] = pinned_malloc(face_bytes(d));
+          recv_h[d] = pinned_malloc(face_bytes(d));
+          mh_send[d] = comm_declare_send_relative(send_h[d], d, -1, face_bytes(d));
+          mh_recv[d] = comm_declare_receive_relative(recv_h[d], d, +1, face_bytes(d));
+        }
+      }
+    }
+
+    GaugeFixFFTHalo(const GaugeFixFFTHalo &) = delete;
+    GaugeFixFFTHalo &operator=(const GaugeFixFFTHalo &) = delete;
+
+    ~GaugeFixFFTHalo()
+    {
+      for (int d = 0; d < 4; d++) {
+        if (!comm_dim_partitioned(d)) continue;
+        comm_free(mh_send[d]);
+        comm_free(mh_recv[d]);
+        device_free(send_d[d]);
+        if (send_h[d]) host_free(send_h[d]);
+        if (recv_h[d]) host_free(recv_h[d]);
+      }
+    }
+
+    void exchange()
+    {
+      for (int d = 0; d < 4; d++) {
+        if (!comm_dim_partitioned(d)) continue;
+        comm_start(mh_recv[d]);
+        mu = d;
+        setAux();
+        apply(device::get_default_stream());
+        if (!gdr) qudaMemcpy(send_h[d], send_d[d], face_bytes(d), qudaMemcpyDeviceToHost);
+        else qudaDeviceSynchronize();
+        comm_start(mh_send[d]);
+      }
+
+      for (int d = 0; d < 4; d++) {
+        if (!comm_dim_partitioned(d)) continue;
+        comm_wait(mh_recv[d]);
+        if (!gdr) qudaMemcpy(halo[d], recv_h[d], face_bytes(d), qudaMemcpyHostToDevice);
+        comm_wait(mh_send[d]);
+      }
+    }
+
+    void setAux()
+    {
+      strcpy(aux, aux_tmp);
+      strcat(aux, ",mu=");
+      u32toa(aux + strlen(aux), mu);
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      launch<FFTFacePack>(tp, stream, GaugeFixFFTFaceArg<Float>(data, mu, delta, send_d[mu]));
+    }
+
+    long long flops() const { return 0; }
+    long long bytes() const { return 2 * face_bytes(mu); }
+  };
+
   template <typename Arg>
   class GaugeFixQuality : TunableReduction2D {
     Arg &arg;
@@ -67,8 +353,8 @@ namespace quda {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       launch<FixQualityFFT>(arg.result, tp, stream, arg);
 
-      arg.result[0] /= static_cast<double>(3 * Arg::gauge_dir * meta.Volume());
-      arg.result[1] /= static_cast<double>(3 * meta.Volume());
+      arg.result[0] /= static_cast<double>(3 * Arg::gauge_dir * meta.Volume() * comm_size());
+      arg.result[1] /= static_cast<double>(3 * meta.Volume() * comm_size());
     }
 
     long long flops() const { return (36 * Arg::gauge_dir + 65) * meta.Volume(); }
@@ -182,8 +468,8 @@ namespace quda {
   };
 
   template <typename Float, QudaReconstructType recon, int gauge_dir>
-  void gaugeFixingFFT(GaugeField& data, int Nsteps, int verbose_interval,
-                      double alpha0, int autotune, double tolerance, int stopWtheta)
+  double3 gaugeFixingFFT(GaugeField &data, int Nsteps, int verbose_interval, double alpha0, int autotune,
+                         double tolerance, int stopWtheta)
   {
     TimeProfile profileInternalGaugeFixFFT("InternalGaugeFixQudaFFT", false);
 
@@ -204,8 +490,22 @@ namespace quda {
     FFTPlanHandle plan_zt;
 
     GaugeFixArg<Float, recon> arg(data, alpha0);
-    SetPlanFFT2DMany(plan_zt, size, 0, data.Precision()); // for space and time ZT
-    SetPlanFFT2DMany(plan_xy, size, 1, data.Precision()); // with space only XY
+#ifndef GAUGEFIXING_DONT_USE_GX
+    if (arg.distributed) errorQuda("Multi-GPU FFT gauge fixing requires GAUGEFIXING_DONT_USE_GX");
+#endif
+
+    // On a partitioned lattice the FFTs are distributed over all ranks,
+    // and Delta(x) is exchanged on the faces for the gauge update
+    std::unique_ptr<DistributedFFT<Float>> dfft;
+    std::unique_ptr<GaugeFixFFTHalo<Float>> halo;
+    if (arg.distributed) {
+      dfft = std::make_unique<DistributedFFT<Float>>(data);
+      halo = std::make_unique<GaugeFixFFTHalo<Float>>(data, arg.delta, arg.delta_halo);
+      data.exchangeGhost();
+    } else {
+      SetPlanFFT2DMany(plan_zt, size, 0, data.Precision()); // for space and time ZT
+      SetPlanFFT2DMany(plan_xy, size, 1, data.Precision()); // with space only XY
+    }
 
     GaugeFixFFTRotate<Float> GFRotate(data);
 
@@ -229,6 +529,16 @@ namespace quda {
         // it uses gx as temporary array!!!!!!
         //------------------------------------------------------------------------
         complex<Float> *_array = arg.delta + k * delta_pad;
+        if (arg.distributed) {
+          //------------------------------------------------------------------------
+          // 4D FFT, normalize and apply pmax^2/p^2, then 4D IFFT
+          //------------------------------------------------------------------------
+          (*dfft)(_array, arg.gx, FFT_FORWARD);
+          gfix.set_type(KERNEL_NORMALIZE);
+          gfix.apply(device::get_default_stream());
+          (*dfft)(arg.gx, _array, FFT_INVERSE);
+          continue;
+        }
         //////  2D FFT + 2D FFT
         //------------------------------------------------------------------------
         // Perform FFT on xy plane
@@ -275,8 +585,10 @@ namespace quda {
       //------------------------------------------------------------------------
       // Apply gauge fix to current gauge field
       //------------------------------------------------------------------------
+      if (arg.distributed) halo->exchange();
       gfix.set_type(KERNEL_UEO);
       gfix.apply(device::get_default_stream());
+      if (arg.distributed) data.exchangeGhost();
 
       //------------------------------------------------------------------------
       // Measure gauge quality and recalculate new Delta(x)
@@ -285,7 +597,8 @@ namespace quda {
       double action = argQ.getAction();
       diff = abs(action0 - action);
       if ((iter % verbose_interval) == (verbose_interval - 1) && getVerbosity() >= QUDA_SUMMARIZE)
-        printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
+        printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(),
+                   diff);
       if ( autotune && ((action - action0) < -1e-14) ) {
         if ( arg.alpha > 0.01 ) {
           arg.alpha = 0.95 * arg.alpha;
@@ -301,8 +614,9 @@ namespace quda {
       action0 = action;
     }
     if ((iter % verbose_interval) != (verbose_interval - 1) && getVerbosity() >= QUDA_SUMMARIZE)
-      printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
-    
+      printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
+    auto quality = make_double3(argQ.getAction(), argQ.getTheta(), diff);
+
     // Reunitarize at end
     const double unitarize_eps = 1e-14;
     const double max_error = 1e-10;
@@ -321,13 +635,18 @@ namespace quda {
     if (*num_failures_h > 0) errorQuda("Error in the unitarization (%d errors)\n", *num_failures_h);
     // end reunitarize
 
+    halo.reset();
+    dfft.reset();
     arg.free();
-    FFTDestroyPlan(plan_zt);
-    FFTDestroyPlan(plan_xy);
+    if (!arg.distributed) {
+      FFTDestroyPlan(plan_zt);
+      FFTDestroyPlan(plan_xy);
+    }
     profileInternalGaugeFixFFT.TPSTOP(QUDA_PROFILE_COMPUTE);
 
     double secs = profileInternalGaugeFixFFT.Last(QUDA_PROFILE_COMPUTE);
     double fftflop = 5.0 * (log2((double)( data.X()[0] * data.X()[1]) ) + log2( (double)(data.X()[2] * data.X()[3] )));
+    if (arg.distributed) fftflop = 5.0 * log2((double)data.Volume() * comm_size());
     fftflop *= (double)data.Volume();
     gfix.set_type(KERNEL_SET_INVPSQ);
     double gflops = gfix.flops() + gfixquality.flops();
@@ -357,24 +676,26 @@ namespace quda {
     logQuda(QUDA_SUMMARIZE, "Time: %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
 
     host_free(num_failures_h);
+    return quality;
   }
 
   template<typename Float, int nColors, QudaReconstructType recon> struct GaugeFixingFFT {
-    GaugeFixingFFT(GaugeField& data, int gauge_dir, int Nsteps, int verbose_interval,
-                   double alpha, int autotune, double tolerance, int stopWtheta)
+    GaugeFixingFFT(GaugeField &data, double3 &quality, int gauge_dir, int Nsteps, int verbose_interval, double alpha,
+                   int autotune, double tolerance, int stopWtheta)
     {
       if (gauge_dir != 3) {
         logQuda(QUDA_SUMMARIZE, "Starting Landau gauge fixing with FFTs...\n");
-        gaugeFixingFFT<Float, recon, 4>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        quality = gaugeFixingFFT<Float, recon, 4>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
       } else {
         logQuda(QUDA_SUMMARIZE, "Starting Coulomb gauge fixing with FFTs...\n");
-        gaugeFixingFFT<Float, recon, 3>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        quality = gaugeFixingFFT<Float, recon, 3>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
       }
     }
   };
 
   /**
-   * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
+   * @brief Gauge fixing with Steepest descent method with FFTs with support for single and multi GPU.
+   * On a partitioned lattice the FFTs are distributed over all ranks.
    * @param[in,out] data, quda gauge field
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
@@ -383,14 +704,37 @@ namespace quda {
    * @param[in] autotune, 1 to autotune the method, i.e., if the Fg inverts its tendency we decrease the alpha value
    * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when iteration reachs the maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterion and 1 to use the theta value
+   * @return The gauge functional (x), theta (y) and the change in the functional over the last step (z)
    */
-  void gaugeFixingFFT(GaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval, const double alpha,
-                      const int autotune, const double tolerance, const int stopWtheta)
+  double3 gaugeFixingFFT(GaugeField &data, const int gauge_dir, const int Nsteps, const int verbose_interval,
+                         const double alpha, const int autotune, const double tolerance, const int stopWtheta)
   {
+    double3 quality = {};
     getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
-    if (comm_partitioned()) errorQuda("Gauge Fixing with FFTs in multi-GPU support NOT implemented yet!");
-    instantiate<GaugeFixingFFT>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    bool extended = false;
+    for (int d = 0; d < 4; d++) extended = extended || data.R()[d] > 0;
+
+    if (extended) {
+      // the FFTs act on the local volume, with neighbouring links from the regular ghost zone
+      GaugeFieldParam param(data);
+      for (int d = 0; d < 4; d++) {
+        param.x[d] = data.X()[d] - 2 * data.R()[d];
+        param.r[d] = 0;
+      }
+      param.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+      param.create = QUDA_NULL_FIELD_CREATE;
+      GaugeField local(param);
+      copyExtendedGauge(local, data, QUDA_CUDA_FIELD_LOCATION);
+      instantiate<GaugeFixingFFT>(local, quality, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance,
+                                  stopWtheta);
+      copyExtendedGauge(data, local, QUDA_CUDA_FIELD_LOCATION);
+      data.exchangeExtendedGhost(data.R(), false);
+    } else {
+      instantiate<GaugeFixingFFT>(data, quality, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance,
+                                  stopWtheta);
+    }
     getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
+    return quality;
   }
 
 }
@@ -180,6 +180,12 @@ namespace quda {
     Arg &arg;
     const GaugeField &meta;
 
+    void normalize()
+    {
+      arg.result[0] /= static_cast<double>(3 * Arg::gauge_dir * 2 * arg.threads.x * comm_size());
+      arg.result[1] /= static_cast<double>(3 * 2 * arg.threads.x * comm_size());
+    }
+
   public:
     GaugeFixQuality(Arg &arg, const GaugeField &meta) :
       TunableReduction2D(meta),
@@ -191,9 +197,34 @@ namespace quda {
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       launch<FixQualityOVR>(arg.result, tp, stream, arg);
+      if (!commAsyncReduction()) normalize();
+    }
 
-      arg.result[0] /= static_cast<double>(3 * Arg::gauge_dir * 2 * arg.threads.x * comm_size());
-      arg.result[1] /= static_cast<double>(3 * 2 * arg.threads.x * comm_size());
+    /**
+       @brief Launch the quality reduction without waiting for its
+       result, which is collected later with complete().  This allows
+       the host to queue the following sweeps while the reduction is
+       in flight.  The kernel must have been tuned by a prior call to
+       apply().
+     */
+    void launch_async(const qudaStream_t &stream)
+    {
+      commAsyncReductionSet(true);
+      apply(stream);
+      commAsyncReductionSet(false);
+    }
+
+    /**
+       @brief Wait for a reduction launched with launch_async() and
+       complete the global reduction
+     */
+    void complete(const qudaStream_t &stream)
+    {
+      std::vector<typename Arg::reduce_t> result(1);
+      arg.complete(result, stream);
+      if (commGlobalReduction()) FixQualityOVR<Arg>::comm_reduce(result);
+      arg.result = result[0];
+      normalize();
     }
 
     long long flops() const { return (36LL * Arg::gauge_dir + 65LL) * meta.Volume(); }
@@ -228,6 +259,24 @@ namespace quda {
     }
   };
 
+  /**
+   * @brief Number of sweeps between convergence checks of the
+   * overrelaxation gauge fixing, set with the environment variable
+   * QUDA_GAUGE_FIX_CHECK_INTERVAL (default 1).  With the Delta stop
+   * criterion the action difference is then measured over this many
+   * sweeps.
+   */
+  static int gaugeFixCheckInterval()
+  {
+    static int interval = 0;
+    if (interval == 0) {
+      auto env = getenv("QUDA_GAUGE_FIX_CHECK_INTERVAL");
+      interval = env ? atoi(env) : 1;
+      if (interval <= 0) errorQuda("Invalid QUDA_GAUGE_FIX_CHECK_INTERVAL=%d", interval);
+    }
+    return interval;
+  }
+
   template <typename Float, QudaReconstructType recon, int gauge_dir>
   void gaugeFixingOVR(GaugeField &data,const int Nsteps, const int verbose_interval,
                       const double relax_boost, const double tolerance,
@@ -264,6 +313,10 @@ namespace quda {
     GaugeFixQualityOVRArg<Float, recon, gauge_dir> argQ(data);
     GaugeFixQuality<decltype(argQ)> GaugeFixQuality(argQ, data);
 
+    // with GPU-direct RDMA the faces are sent straight from device
+    // memory, else they are staged through pinned host buffers
+    const bool gdr = comm_gdr_enabled();
+
     void *send[4];
     void *recv[4];
     void *sendg[4];
@@ -280,6 +333,9 @@ namespace quda {
     MsgHandle *mh_recv_fwd[4];
     MsgHandle *mh_send_fwd[4];
     MsgHandle *mh_send_back[4];
+    // events used to order the face streams against the default stream
+    qudaEvent_t border_event;
+    qudaEvent_t unpack_event[8];
 
     if (comm_partitioned()) {
       for (int d = 0; d < 4; d++) {
@@ -290,19 +346,21 @@ namespace quda {
         recv_d[d] = device_malloc(bytes[d]);
         sendg_d[d] = device_malloc(bytes[d]);
         recvg_d[d] = device_malloc(bytes[d]);
-        hostbuffer_h[d] = (void*)pinned_malloc(4 * bytes[d]);
+        if (!gdr) hostbuffer_h[d] = (void*)pinned_malloc(4 * bytes[d]);
       }
       for (int d = 0; d < 4; d++) {
         if (!commDimPartitioned(d)) continue;
-        recv[d] = hostbuffer_h[d];
-        send[d] = static_cast<char*>(hostbuffer_h[d]) + bytes[d];
-        recvg[d] = static_cast<char*>(hostbuffer_h[d]) + 3 * bytes[d];
-        sendg[d] = static_cast<char*>(hostbuffer_h[d]) + 2 * bytes[d];
+        recv[d] = gdr ? recv_d[d] : hostbuffer_h[d];
+        send[d] = gdr ? send_d[d] : static_cast<char*>(hostbuffer_h[d]) + bytes[d];
+        recvg[d] = gdr ? recvg_d[d] : static_cast<char*>(hostbuffer_h[d]) + 3 * bytes[d];
+        sendg[d] = gdr ? sendg_d[d] : static_cast<char*>(hostbuffer_h[d]) + 2 * bytes[d];
         mh_recv_back[d] = comm_declare_receive_relative(recv[d], d, -1, bytes[d]);
         mh_recv_fwd[d]  = comm_declare_receive_relative(recvg[d], d, +1, bytes[d]);
         mh_send_back[d] = comm_declare_send_relative(sendg[d], d, -1, bytes[d]);
         mh_send_fwd[d]  = comm_declare_send_relative(send[d], d, +1, bytes[d]);
       }
+      border_event = qudaEventCreate();
+      for (auto &e : unpack_event) e = qudaEventCreate();
     }
 
     int *borderpoints[2];
@@ -329,39 +387,65 @@ namespace quda {
     GaugeFix<Float, recon, gauge_dir> gfixIntPoints(data, relax_boost, borderpoints, false, -1);
     GaugeFix<Float, recon, gauge_dir> gfixBorderPoints(data, relax_boost, borderpoints, true, threads);
 
+    // The convergence check is launched asynchronously every
+    // check_interval sweeps (and at every verbose_interval step), and
+    // is evaluated after the following sweep has been queued, so the
+    // reduction and its global sum do not stall the sweeps.
+    const int check_interval = gaugeFixCheckInterval();
+    bool pending = false; // whether a convergence check is in flight
+    int check_iter = 0;   // the sweep at which the pending check was launched
+
+    auto converged = [&]() {
+      GaugeFixQuality.complete(device::get_default_stream());
+      pending = false;
+      double action = argQ.getAction();
+      double diff = abs(action0 - action);
+      if ((check_iter % verbose_interval) == (verbose_interval - 1) && getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", check_iter + 1, argQ.getAction(), argQ.getTheta(), diff);
+      action0 = action;
+      return stopWtheta ? argQ.getTheta() < tolerance : diff < tolerance;
+    };
+
     int iter = 0;
     for (iter = 0; iter < Nsteps; iter++) {
       for (int p = 0; p < 2; p++) {
+        // post the receives before the border update so they are in place when the neighbors send; the
+        // unpacking of the previous half sweep (and its host-to-device copy) must have finished reading the
+        // receive buffers before they can be overwritten
+        for (int d = 0; d < 4; d++) {
+          if (!commDimPartitioned(d)) continue;
+          qudaEventSynchronize(unpack_event[d]);
+          comm_start(mh_recv_back[d]);
+          qudaEventSynchronize(unpack_event[4 + d]);
+          comm_start(mh_recv_fwd[d]);
+        }
+
         if (comm_partitioned()) {
           gfixBorderPoints.setParity(p); //compute border points
           gfixBorderPoints.apply(device::get_default_stream());
           flop += (double)gfixBorderPoints.flops();
           byte += (double)gfixBorderPoints.bytes();
+          qudaEventRecord(border_event, device::get_default_stream());
         }
 
+        //the packing waits for the update to the border points only, not the whole device
         for (int d = 0; d < 4; d++) {
           if (!commDimPartitioned(d)) continue;
-          comm_start(mh_recv_back[d]);
-          comm_start(mh_recv_fwd[d]);
-        }
-        //wait for the update to the halo points before start packing...
-        qudaDeviceSynchronize();
-        for (int d = 0; d < 4; d++) {
-          if (!commDimPartitioned(d)) continue;
+          qudaStreamWaitEvent(device::get_stream(d), border_event, 0);
+          qudaStreamWaitEvent(device::get_stream(4 + d), border_event, 0);
           //extract top face
           GaugeFixPacker<Float, recon, true, true>
             (data, reinterpret_cast<complex<Float>*>(send_d[d]), p, d, device::get_stream(d));
           //extract bottom ghost
           GaugeFixPacker<Float, recon, true, false>
             (data, reinterpret_cast<complex<Float>*>(sendg_d[d]), 1 - p, d, device::get_stream(4 + d));
-        }
-        for (int d = 0; d < 4; d++) {
-          if (!commDimPartitioned(d)) continue;
-          qudaMemcpyAsync(send[d], send_d[d], bytes[d], qudaMemcpyDeviceToHost, device::get_stream(d));
-          qudaMemcpyAsync(sendg[d], sendg_d[d], bytes[d], qudaMemcpyDeviceToHost, device::get_stream(4 + d));
+          if (!gdr) {
+            qudaMemcpyAsync(send[d], send_d[d], bytes[d], qudaMemcpyDeviceToHost, device::get_stream(d));
+            qudaMemcpyAsync(sendg[d], sendg_d[d], bytes[d], qudaMemcpyDeviceToHost, device::get_stream(4 + d));
+          }
         }
 
-        //compute interior points
+        //compute interior points while the faces are in flight
         gfixIntPoints.setParity(p);
         gfixIntPoints.apply(device::get_default_stream());
         flop += (double)gfixIntPoints.flops();
@@ -377,32 +461,28 @@ namespace quda {
         for (int d = 0; d < 4; d++) {
           if (!commDimPartitioned(d)) continue;
           comm_wait(mh_recv_back[d]);
-          qudaMemcpyAsync(recv_d[d], recv[d], bytes[d], qudaMemcpyHostToDevice, device::get_stream(d));
-        }
-        for (int d = 0; d < 4; d++) {
-          if (!commDimPartitioned(d)) continue;
-          comm_wait(mh_recv_fwd[d]);
-          qudaMemcpyAsync(recvg_d[d], recvg[d], bytes[d], qudaMemcpyHostToDevice, device::get_stream(4 + d));
-        }
-
-        for (int d = 0; d < 4; d++) {
-          if (!commDimPartitioned(d)) continue;
+          if (!gdr) qudaMemcpyAsync(recv_d[d], recv[d], bytes[d], qudaMemcpyHostToDevice, device::get_stream(d));
           GaugeFixPacker<Float, recon, false, false>
             (data, reinterpret_cast<complex<Float>*>(recv_d[d]), p, d, device::get_stream(d));
+          qudaEventRecord(unpack_event[d], device::get_stream(d));
         }
-        for (int d = 0; d < 4; d++ ) {
+        for (int d = 0; d < 4; d++) {
           if (!commDimPartitioned(d)) continue;
+          comm_wait(mh_recv_fwd[d]);
+          if (!gdr) qudaMemcpyAsync(recvg_d[d], recvg[d], bytes[d], qudaMemcpyHostToDevice, device::get_stream(4 + d));
           GaugeFixPacker<Float, recon, false, true>
             (data, reinterpret_cast<complex<Float>*>(recvg_d[d]), 1 - p, d, device::get_stream(4 + d));
+          qudaEventRecord(unpack_event[4 + d], device::get_stream(4 + d));
         }
+
+        //the next parity update must see the new halo
         for (int d = 0; d < 4; d++ ) {
           if (!commDimPartitioned(d)) continue;
+          qudaStreamWaitEvent(device::get_default_stream(), unpack_event[d], 0);
+          qudaStreamWaitEvent(device::get_default_stream(), unpack_event[4 + d], 0);
           comm_wait(mh_send_back[d]);
           comm_wait(mh_send_fwd[d]);
-          qudaStreamSynchronize(device::get_stream(d));
-          qudaStreamSynchronize(device::get_stream(4 + d));
         }
-        qudaStreamSynchronize(device::get_default_stream());
       }
 
       if ((iter % reunit_interval) == (reunit_interval - 1)) {
@@ -412,21 +492,19 @@ namespace quda {
         flop += 4588.0 * data.Volume();
         byte += 2 * data.Bytes();
       }
-      GaugeFixQuality.apply(device::get_default_stream());
-      flop += (double)GaugeFixQuality.flops();
-      byte += (double)GaugeFixQuality.bytes();
 
-      double action = argQ.getAction();
-      double diff = abs(action0 - action);
-      if ((iter % verbose_interval) == (verbose_interval - 1) && getVerbosity() >= QUDA_SUMMARIZE)
-        printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
-      if (stopWtheta) {
-        if (argQ.getTheta() < tolerance) break;
-      } else {
-        if ( diff < tolerance ) break;
+      // evaluate the check launched at a previous sweep
+      if (pending && converged()) break;
+
+      if ((iter + 1) % check_interval == 0 || (iter % verbose_interval) == (verbose_interval - 1)) {
+        GaugeFixQuality.launch_async(device::get_default_stream());
+        flop += (double)GaugeFixQuality.flops();
+        byte += (double)GaugeFixQuality.bytes();
+        pending = true;
+        check_iter = iter;
       }
-      action0 = action;
     }
+    if (pending) converged();
 
     if ((iter % reunit_interval) != 0 )  {
       *num_failures_h = 0;
@@ -449,6 +527,7 @@ namespace quda {
     host_free(num_failures_h);
 
     if ( comm_partitioned() ) {
+      qudaDeviceSynchronize();
       data.exchangeExtendedGhost(data.R(),false);
       for ( int d = 0; d < 4; d++ ) {
         if ( commDimPartitioned(d)) {
@@ -460,9 +539,11 @@ namespace quda {
           device_free(recv_d[d]);
           device_free(sendg_d[d]);
           device_free(recvg_d[d]);
-          host_free(hostbuffer_h[d]);
+          if (!gdr) host_free(hostbuffer_h[d]);
         }
       }
+      qudaEventDestroy(border_event);
+      for (auto &e : unpack_event) qudaEventDestroy(e);
     }
 
     profileInternalGaugeFixOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -10,20 +10,19 @@ namespace quda {
     const GaugeField &u;
     GaugeField &mom;
     double epsilon;
-    const paths<4> &p;
+    const path_program &prog;
     unsigned int minThreads() const { return mom.VolumeCB(); }
-    unsigned int sharedBytesPerThread() const { return 4 * sizeof(int); } // for thread_array
 
   public:
-    ForceGauge(const GaugeField &u, GaugeField &mom, double epsilon, const paths<4> &p) :
+    ForceGauge(const GaugeField &u, GaugeField &mom, double epsilon, const path_program &prog) :
       TunableKernel3D(u, 2, 4),
       u(u),
       mom(mom),
       epsilon(epsilon),
-      p(p)
+      prog(prog)
     {
-      strcat(aux, ",num_paths=");
-      strcat(aux, std::to_string(p.num_paths).c_str());
+      strcat(aux, ",num_links=");
+      strcat(aux, std::to_string(prog.n_link).c_str());
       strcat(aux, comm_dim_partitioned_string());
       apply(device::get_default_stream());
     }
@@ -32,49 +31,78 @@ namespace quda {
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       launch<GaugeForce>(tp, stream, GaugeForceArg<Float, nColor, recon_u,
-                         compute_force ? QUDA_RECONSTRUCT_10 : QUDA_RECONSTRUCT_NO, compute_force>(mom, u, epsilon, p));
+                         compute_force ? QUDA_RECONSTRUCT_10 : QUDA_RECONSTRUCT_NO, compute_force>(mom, u, epsilon, prog));
     }
 
     void preTune() { mom.backup(); }
     void postTune() { mom.restore(); }
 
-    long long flops() const { return (p.count - p.num_paths + 1) * 198ll * mom.Volume() * 4; }
-    long long bytes() const { return (p.count + 1ll) * u.Bytes() + 2 * mom.Bytes(); }
+    // the multiplications of the program, plus the multiplication by U(x) in each direction
+    long long flops() const { return (prog.n_mult + 4ll) * 198ll * mom.Volume(); }
+    long long bytes() const { return (prog.n_link + 4ll) * u.Bytes() / 4 + 2 * mom.Bytes(); }
   };
 
   template<typename Float, int nColor, QudaReconstructType recon_u> using GaugeForce_ = ForceGauge<Float,nColor,recon_u,true>;
 
   template<typename Float, int nColor, QudaReconstructType recon_u> using GaugePath = ForceGauge<Float,nColor,recon_u,false>;
 
+  /**
+     @brief Compile the paths into a program with one group per
+     direction, where the paths of direction dir start from the
+     neighboring site in that direction
+   */
+  static path_program compileForcePaths(std::vector<int **> &input_path, std::vector<int> &length,
+                                        std::vector<double> &path_coeff, int num_paths)
+  {
+    if (input_path.size() != 4) errorQuda("Input path vector is of size %lu, expected 4", input_path.size());
+    if (static_cast<int>(length.size()) != num_paths)
+      errorQuda("Path length vector is of size %lu, expected %d", length.size(), num_paths);
+    if (static_cast<int>(path_coeff.size()) != num_paths)
+      errorQuda("Path coefficient vector is of size %lu, expected %d", path_coeff.size(), num_paths);
+
+    std::vector<path_group> groups(4);
+    for (int dir = 0; dir < 4; dir++) {
+      groups[dir].origin[dir] = 1;
+      for (int i = 0; i < num_paths; i++) {
+        if (path_coeff[i] == 0) continue;
+        groups[dir].path.emplace_back(input_path[dir][i], input_path[dir][i] + length[i]);
+        groups[dir].slot.push_back(0);
+        groups[dir].coeff.push_back(path_coeff[i]);
+      }
+    }
+
+    return path_program(groups);
+  }
+
   void gaugeForce(GaugeField& mom, const GaugeField& u, double epsilon, std::vector<int**>& input_path,
-                  std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int path_max_length)
+                  std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int)
   {
     getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
     checkPrecision(mom, u);
     checkLocation(mom, u);
     if (mom.Reconstruct() != QUDA_RECONSTRUCT_10) errorQuda("Reconstruction type %d not supported", mom.Reconstruct());
 
-    paths<4> p(input_path, length, path_coeff, num_paths, path_max_length);
+    auto prog = compileForcePaths(input_path, length, path_coeff, num_paths);
 
     // gauge field must be passed as first argument so we peel off its reconstruct type
-    instantiate<GaugeForce_>(u, mom, epsilon, p);
-    p.free();
+    instantiate<GaugeForce_>(u, mom, epsilon, prog);
+    prog.free();
     getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
   }
   
   void gaugePath(GaugeField& out, const GaugeField& u, double coeff, std::vector<int**>& input_path,
-		 std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int path_max_length)
+		 std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int)
   {
     getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
     checkPrecision(out, u);
     checkLocation(out, u);
     if (out.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Reconstruction type %d not supported", out.Reconstruct());
 
-    paths<4> p(input_path, length, path_coeff, num_paths, path_max_length);
+    auto prog = compileForcePaths(input_path, length, path_coeff, num_paths);
 
     // gauge field must be passed as first argument so we peel off its reconstruct type
-    instantiate<GaugePath>(u, out, coeff, p);
-    p.free();
+    instantiate<GaugePath>(u, out, coeff, prog);
+    prog.free();
     getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
   }
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <numeric>
 #include <gauge_field.h>
 #include <gauge_path_quda.h>
 #include <instantiate.h>
@@ -9,25 +11,27 @@ namespace quda {
   template<typename Float, int nColor, QudaReconstructType recon>
   class GaugeLoopTrace : public TunableMultiReduction {
     const GaugeField &u;
-    using reduce_t = array<double, 2>;
+    using reduce_t = array<double, 2 * loop_trace_group_size()>;
     std::vector<reduce_t>& loop_traces;
     double factor;
-    const paths<1> p;
-    unsigned int sharedBytesPerThread() const override { return 4 * sizeof(int); } // for thread_array
+    const path_program &prog;
 
   public:
     // max block size of 8 is arbitrary for now
-    GaugeLoopTrace(const GaugeField &u, std::vector<reduce_t> &loop_traces, double factor, const paths<1>& p) :
-      TunableMultiReduction(u, 2u, p.num_paths, 8),
+    GaugeLoopTrace(const GaugeField &u, std::vector<reduce_t> &loop_traces, double factor, const path_program &prog) :
+      TunableMultiReduction(u, 2u, prog.num_groups, 8),
       u(u),
       loop_traces(loop_traces),
       factor(factor),
-      p(p)
+      prog(prog)
     {
-      if (p.num_paths != static_cast<int>(loop_traces.size())) errorQuda("Loop traces size %lu != number of paths %d", loop_traces.size(), p.num_paths);
+      if (prog.num_groups != static_cast<int>(loop_traces.size()))
+        errorQuda("Loop traces size %lu != number of loop groups %d", loop_traces.size(), prog.num_groups);
 
-      strcat(aux, "num_paths=");
-      u32toa(aux + strlen(aux), p.num_paths);
+      strcat(aux, "num_groups=");
+      u32toa(aux + strlen(aux), prog.num_groups);
+      strcat(aux, ",num_links=");
+      u32toa(aux + strlen(aux), prog.n_link);
 
       apply(device::get_default_stream());
     }
@@ -35,7 +39,7 @@ namespace quda {
     void apply(const qudaStream_t &stream) override
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      GaugeLoopTraceArg<Float, nColor, recon> arg(u, factor, p);
+      GaugeLoopTraceArg<Float, nColor, recon> arg(u, factor, prog);
       launch<GaugeLoop>(loop_traces, tp, stream, arg);
     }
 
@@ -44,30 +48,62 @@ namespace quda {
       auto Nc = u.Ncolor();
       auto mat_mul_flops = 8ll * Nc * Nc * Nc - 2 * Nc * Nc;
       // matrix multiplies + traces + rescale
-      return (p.count * mat_mul_flops + p.num_paths * (2 * Nc + 2)) * u.Volume();
+      return (prog.n_mult * mat_mul_flops + prog.n_emit * (2 * Nc + 2)) * u.Volume();
     }
 
     long long bytes() const override
     {
       // links * one LatticeColorMatrix worth of data
-      return p.count * u.Bytes() / 4;
+      return prog.n_link * u.Bytes() / 4;
     }
   };
 
   void gaugeLoopTrace(const GaugeField& u, std::vector<Complex>& loop_traces, double factor, std::vector<int**>& input_path,
-		 std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int path_max_length)
+		 std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int)
   {
     getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
-    paths<1> p(input_path, length, path_coeff, num_paths, path_max_length);
+    if (input_path.size() != 1) errorQuda("Input path vector is of size %lu, expected 1", input_path.size());
+    if (static_cast<int>(length.size()) != num_paths)
+      errorQuda("Path length vector is of size %lu, expected %d", length.size(), num_paths);
+    if (static_cast<int>(path_coeff.size()) != num_paths)
+      errorQuda("Path coefficient vector is of size %lu, expected %d", path_coeff.size(), num_paths);
+    if (static_cast<int>(loop_traces.size()) != num_paths)
+      errorQuda("Loop traces size %lu != number of paths %d", loop_traces.size(), num_paths);
 
-    std::vector<array<double, 2>> tr_array(loop_traces.size());
+    // sort the loops so that those sharing the longest prefixes are grouped together
+    std::vector<int> index;
+    for (int i = 0; i < num_paths; i++)
+      if (path_coeff[i] != 0) index.push_back(i);
+    auto path = [&](int i) { return std::vector<int>(input_path[0][i], input_path[0][i] + length[i]); };
+    std::stable_sort(index.begin(), index.end(), [&](int a, int b) { return path(a) < path(b); });
 
-    // gauge field must be passed as first argument so we peel off its reconstruct type
-    instantiate<GaugeLoopTrace, ReconstructNo12>(u, tr_array, factor, p);
+    constexpr int group_size = loop_trace_group_size();
+    std::vector<path_group> groups((index.size() + group_size - 1) / group_size);
+    for (auto i = 0u; i < index.size(); i++) {
+      auto &group = groups[i / group_size];
+      group.path.push_back(path(index[i]));
+      group.slot.push_back(i % group_size);
+      group.coeff.push_back(path_coeff[index[i]]);
+    }
+
+    for (auto &l : loop_traces) l = 0.0;
+
+    if (groups.size() > 0) {
+      path_program prog(groups);
+      std::vector<array<double, 2 * group_size>> tr_array(groups.size());
 
-    for (auto i = 0u; i < tr_array.size(); i++) { loop_traces[i] = Complex(tr_array[i][0], tr_array[i][1]); }
+      // gauge field must be passed as first argument so we peel off its reconstruct type
+      instantiate<GaugeLoopTrace, ReconstructNo12>(u, tr_array, factor, prog);
+
+      for (auto i = 0u; i < index.size(); i++) {
+        auto &tr = tr_array[i / group_size];
+        auto slot = i % group_size;
+        loop_traces[index[i]] = Complex(tr[2 * slot + 0], tr[2 * slot + 1]);
+      }
+
+      prog.free();
+    }
 
-    p.free();
     getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
   }
 
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstring>
+#include <quda_internal.h>
+#include <gauge_path_program.h>
+
+namespace quda
+{
+
+  bool gaugePathSharing()
+  {
+    static bool init = false;
+    static bool sharing = true;
+    if (!init) {
+      auto env = getenv("QUDA_ENABLE_GAUGE_PATH_SHARING");
+      if (env) sharing = atoi(env) != 0;
+      init = true;
+    }
+    return sharing;
+  }
+
+  namespace
+  {
+
+    /**
+       Node of the prefix trie, corresponding to the product of links
+       along a path prefix.
+     */
+    struct node_t {
+      int step = -1;                            // direction of the last link of the prefix
+      int dir = 0;                              // link direction
+      bool backwards = false;                   // whether the link is traversed backwards
+      array<int, 4> offset = {};                // link site relative to the origin
+      array<int, 4> end = {};                   // site reached by the prefix
+      std::vector<int> children;                // child nodes in order of insertion
+      std::vector<std::pair<int, double>> emit; // paths ending here: output slot and coefficient
+    };
+
+    struct trie_t {
+      bool share;
+      std::vector<node_t> nodes;
+
+      trie_t(const array<int, 4> &origin, bool share) : share(share), nodes(1)
+      {
+        nodes[0].end = origin;
+      }
+
+      void insert(const std::vector<int> &path, int slot, double coeff)
+      {
+        int n = 0;
+        for (auto step : path) {
+          if (step < 0 || step > 7) errorQuda("Invalid path direction %d", step);
+
+          int c = -1;
+          if (share) {
+            for (auto k : nodes[n].children)
+              if (nodes[k].step == step) c = k;
+          }
+
+          if (c < 0) {
+            node_t child;
+            child.step = step;
+            child.backwards = step > 3;
+            child.dir = child.backwards ? 7 - step : step;
+            child.end = nodes[n].end;
+            // backwards links are stored on the adjacent site
+            if (child.backwards) child.end[child.dir]--;
+            child.offset = child.end;
+            if (!child.backwards) child.end[child.dir]++;
+
+            c = nodes.size();
+            nodes.push_back(child);
+            nodes[n].children.push_back(c);
+          }
+          n = c;
+        }
+
+        auto &emit = nodes[n].emit;
+        auto it = std::find_if(emit.begin(), emit.end(), [=](const std::pair<int, double> &e) { return e.first == slot; });
+        if (it != emit.end())
+          it->second += coeff;
+        else
+          emit.push_back({slot, coeff});
+      }
+
+      /**
+         Emit the instructions for the subtree rooted at node n, whose
+         parent product is in slot src, storing its product in slot
+         dst.  Every child but the last extends a copy of the product
+         in the next slot, so the product is only kept alive while
+         further children need it.
+       */
+      int compile(std::vector<path_instruction> &inst, int n, int src, int dst) const
+      {
+        auto &node = nodes[n];
+        if (n > 0) {
+          path_instruction link = {};
+          link.op = path_instruction::link_op;
+          link.src = src;
+          link.dst = dst;
+          link.dir = node.dir;
+          link.backwards = node.backwards;
+          link.offset = node.offset;
+          link.parity = (node.offset[0] + node.offset[1] + node.offset[2] + node.offset[3]) & 1;
+          inst.push_back(link);
+        }
+
+        for (auto &e : node.emit) {
+          path_instruction emit = {};
+          emit.op = path_instruction::emit_op;
+          emit.src = n > 0 ? dst : -1;
+          emit.slot = e.first;
+          emit.coeff = e.second;
+          inst.push_back(emit);
+        }
+
+        int max_slot = dst;
+        auto n_child = node.children.size();
+        for (auto i = 0u; i < n_child; i++) {
+          // the children of the root start from the identity
+          int child_src = n > 0 ? dst : -1;
+          int child_dst = (n == 0 || i == n_child - 1) ? dst : dst + 1;
+          max_slot = std::max(max_slot, compile(inst, node.children[i], child_src, child_dst));
+        }
+        return max_slot;
+      }
+    };
+
+    std::vector<path_instruction> compileGroup(const path_group &group, bool share)
+    {
+      trie_t trie(group.origin, share);
+      for (auto i = 0u; i < group.path.size(); i++) trie.insert(group.path[i], group.slot[i], group.coeff[i]);
+
+      std::vector<path_instruction> inst;
+      int max_slot = trie.compile(inst, 0, -1, 0);
+
+      // too many live partial products: fall back to evaluating each path from scratch
+      if (max_slot >= path_program::max_slots) return compileGroup(group, false);
+      return inst;
+    }
+
+  } // namespace
+
+  path_program::path_program(const std::vector<path_group> &groups) : num_groups(groups.size())
+  {
+    std::vector<int> begin_h(num_groups + 1, 0);
+    std::vector<path_instruction> inst_h;
+    int n_link_naive = 0;
+    int n_mult_naive = 0;
+
+    for (auto g = 0; g < num_groups; g++) {
+      auto group_inst = compileGroup(groups[g], gaugePathSharing());
+      inst_h.insert(inst_h.end(), group_inst.begin(), group_inst.end());
+      begin_h[g + 1] = inst_h.size();
+
+      for (auto &p : groups[g].path) {
+        n_link_naive += p.size();
+        n_mult_naive += p.size() > 0 ? p.size() - 1 : 0;
+      }
+    }
+
+    for (auto &i : inst_h) {
+      if (i.op == path_instruction::link_op) {
+        n_link++;
+        if (i.src >= 0) n_mult++;
+      } else {
+        n_emit++;
+      }
+    }
+
+    logQuda(QUDA_DEBUG_VERBOSE,
+            "Gauge path program: %d groups, %d links and %d multiplications (%d and %d without sharing)\n", num_groups,
+            n_link, n_mult, n_link_naive, n_mult_naive);
+
+    // copy the program to the device in a single allocation
+    size_t begin_bytes = (num_groups + 1) * sizeof(int);
+    begin_bytes = ((begin_bytes + sizeof(path_instruction) - 1) / sizeof(path_instruction)) * sizeof(path_instruction);
+    size_t bytes = begin_bytes + inst_h.size() * sizeof(path_instruction);
+
+    auto buffer_h = static_cast<char *>(safe_malloc(bytes));
+    memset(buffer_h, 0, bytes);
+    memcpy(buffer_h, begin_h.data(), begin_h.size() * sizeof(int));
+    if (inst_h.size() > 0) memcpy(buffer_h + begin_bytes, inst_h.data(), inst_h.size() * sizeof(path_instruction));
+
+    buffer = pool_device_malloc(bytes);
+    qudaMemcpy(buffer, buffer_h, bytes, qudaMemcpyHostToDevice);
+    host_free(buffer_h);
+
+    begin = static_cast<const int *>(buffer);
+    inst = reinterpret_cast<const path_instruction *>(static_cast<char *>(buffer) + begin_bytes);
+  }
+
+  void path_program::free() { pool_device_free(buffer); }
+
+} // namespace quda
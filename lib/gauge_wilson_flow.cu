@@ -13,6 +13,7 @@ namespace quda {
     GaugeField &out;
     GaugeField &temp;
     const GaugeField &in;
+    GaugeField &aux;
     const real epsilon;
     const QudaGaugeSmearType wflow_type;
     const QudaWFlowStepType step_type;
@@ -33,11 +34,12 @@ namespace quda {
 
   public:
     GaugeWFlowStep(GaugeField &out, GaugeField &temp, const GaugeField &in, const double epsilon,
-                   const QudaGaugeSmearType wflow_type, const QudaWFlowStepType step_type) :
+                   const QudaGaugeSmearType wflow_type, const QudaWFlowStepType step_type, GaugeField &aux) :
       TunableKernel3D(in, 2, wflow_dim),
       out(out),
       temp(temp),
       in(in),
+      aux(aux),
       epsilon(epsilon),
       wflow_type(wflow_type),
       step_type(step_type)
@@ -53,6 +55,8 @@ namespace quda {
       case WFLOW_STEP_W1: strcat(aux, "_W1"); break;
       case WFLOW_STEP_W2: strcat(aux, "_W2"); break;
       case WFLOW_STEP_VT: strcat(aux, "_VT"); break;
+      case WFLOW_STEP_W2_EMBEDDED: strcat(aux, "_W2_embedded"); break;
+      case WFLOW_STEP_VT_EMBEDDED: strcat(aux, "_VT_embedded"); break;
       default : errorQuda("Unknown Wilson Flow step type %d", step_type);
       }
 
@@ -71,13 +75,21 @@ namespace quda {
       case QUDA_GAUGE_SMEAR_WILSON_FLOW:
         switch (step_type) {
         case WFLOW_STEP_W1:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon, aux));
           break;
         case WFLOW_STEP_W2:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon, aux));
           break;
         case WFLOW_STEP_VT:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon, aux));
+          break;
+        case WFLOW_STEP_W2_EMBEDDED:
+          launch<WFlow>(tp, stream,
+                        Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W2_EMBEDDED>(out, temp, in, epsilon, aux));
+          break;
+        case WFLOW_STEP_VT_EMBEDDED:
+          launch<WFlow>(tp, stream,
+                        Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_VT_EMBEDDED>(out, temp, in, epsilon, aux));
           break;
         }
         break;
@@ -85,13 +97,21 @@ namespace quda {
         tp.set_max_shared_bytes = true;
         switch (step_type) {
         case WFLOW_STEP_W1:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon, aux));
           break;
         case WFLOW_STEP_W2:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon, aux));
           break;
         case WFLOW_STEP_VT:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon, aux));
+          break;
+        case WFLOW_STEP_W2_EMBEDDED:
+          launch<WFlow>(tp, stream,
+                        Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W2_EMBEDDED>(out, temp, in, epsilon, aux));
+          break;
+        case WFLOW_STEP_VT_EMBEDDED:
+          launch<WFlow>(tp, stream,
+                        Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_VT_EMBEDDED>(out, temp, in, epsilon, aux));
           break;
         }
         break;
@@ -99,8 +119,21 @@ namespace quda {
       }
     }
 
-    void preTune() { out.backup(); temp.backup(); }
-    void postTune() { out.restore(); temp.restore(); }
+    bool embedded() const { return step_type == WFLOW_STEP_W2_EMBEDDED || step_type == WFLOW_STEP_VT_EMBEDDED; }
+
+    void preTune()
+    {
+      out.backup();
+      temp.backup();
+      if (embedded()) aux.backup();
+    }
+
+    void postTune()
+    {
+      out.restore();
+      temp.restore();
+      if (embedded()) aux.restore();
+    }
 
     long long flops() const
     {
@@ -124,8 +157,12 @@ namespace quda {
       case QUDA_GAUGE_SMEAR_SYMANZIK_FLOW: links = 24; break;
       default : errorQuda("Unknown Wilson Flow type");
       }
-      auto temp_io = step_type == WFLOW_STEP_W2 ? 2 : step_type == WFLOW_STEP_VT ? 1 : 0;
-      return ((1 + (wflow_dim - 1) * links) * in.Bytes() + out.Bytes() + temp_io * temp.Bytes());
+      auto temp_io = (step_type == WFLOW_STEP_W2 || step_type == WFLOW_STEP_W2_EMBEDDED) ? 2 :
+        (step_type == WFLOW_STEP_VT || step_type == WFLOW_STEP_VT_EMBEDDED)          ? 1 :
+                                                                                       0;
+      auto aux_io = step_type == WFLOW_STEP_W2_EMBEDDED ? 1 : step_type == WFLOW_STEP_VT_EMBEDDED ? 2 : 0;
+      return ((1 + (wflow_dim - 1) * links) * in.Bytes() + out.Bytes() + temp_io * temp.Bytes()
+              + aux_io * aux.Bytes());
     }
   }; // GaugeWFlowStep
 
@@ -140,15 +177,15 @@ namespace quda {
     
     // Set each step type as an arg parameter, update halos if needed
     // Step W1
-    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_W1);
+    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_W1, temp);
     out.exchangeExtendedGhost(out.R(), false);
 
     // Step W2
-    instantiate<GaugeWFlowStep>(in, temp, out, epsilon, smear_type, WFLOW_STEP_W2);
+    instantiate<GaugeWFlowStep>(in, temp, out, epsilon, smear_type, WFLOW_STEP_W2, temp);
     in.exchangeExtendedGhost(in.R(), false);
 
     // Step Vt
-    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_VT);
+    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_VT, temp);
     out.exchangeExtendedGhost(out.R(), false);
   }
 
@@ -162,7 +199,38 @@ namespace quda {
     if (!(smear_type == QUDA_GAUGE_SMEAR_WILSON_FLOW || smear_type == QUDA_GAUGE_SMEAR_SYMANZIK_FLOW))
       errorQuda("Gauge smear type %d not supported for flow kernels", smear_type);
 
-    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, step_type);
+    if (step_type == WFLOW_STEP_W2_EMBEDDED || step_type == WFLOW_STEP_VT_EMBEDDED)
+      errorQuda("Embedded step type %d requires WFlowStepAdaptive", step_type);
+
+    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, step_type, temp);
     out.exchangeExtendedGhost(out.R(), false);
   }
+
+  double WFlowStepAdaptive(GaugeField &out, GaugeField &temp, GaugeField &in, GaugeField &aux, const double epsilon,
+                           const QudaGaugeSmearType smear_type)
+  {
+    checkPrecision(out, temp, in, aux);
+    checkReconstruct(out, in);
+    checkNative(out, in);
+    if (temp.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Temporary vector must not use reconstruct");
+    if (aux.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Error field must not use reconstruct");
+    if (aux.Volume() != temp.Volume())
+      errorQuda("Error field volume %lu does not match temporary volume %lu", aux.Volume(), temp.Volume());
+    if (!(smear_type == QUDA_GAUGE_SMEAR_WILSON_FLOW || smear_type == QUDA_GAUGE_SMEAR_SYMANZIK_FLOW))
+      errorQuda("Gauge smear type %d not supported for flow kernels", smear_type);
+
+    // Step W1
+    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_W1, aux);
+    out.exchangeExtendedGhost(out.R(), false);
+
+    // Step W2, with the embedded second-order update written to aux
+    instantiate<GaugeWFlowStep>(in, temp, out, epsilon, smear_type, WFLOW_STEP_W2_EMBEDDED, aux);
+    in.exchangeExtendedGhost(in.R(), false);
+
+    // Step Vt, with aux replaced by the difference between the two updates
+    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_VT_EMBEDDED, aux);
+    out.exchangeExtendedGhost(out.R(), false);
+
+    return aux.abs_max();
+  }
 }
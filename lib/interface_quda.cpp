@@ -11,6 +11,8 @@
 #include <timer.h>
 #include <comm_quda.h>
 #include <tune_quda.h>
+#include <telemetry.h>
+#include <checkpoint.h>
 #include <blas_quda.h>
 #include <gauge_field.h>
 #include <dirac_quda.h>
@@ -31,6 +33,7 @@
 
 #include <multigrid.h>
 #include <deflation.h>
+#include <md_action.h>
 
 #include <gauge_backup.h>
 #include <clover_backup.h>
@@ -218,6 +221,9 @@ static TimeProfile profileCovDev("covDevQuda");
 //!< Profiler for momentum action
 static TimeProfile profileMomAction("momActionQuda");
 
+//!< Profiler for molecular dynamics
+static TimeProfile profileMD("evolveMDQuda");
+
 //!< Profiler for sink projection
 static TimeProfile profileSinkProject("sinkProjectQuda");
 
@@ -498,6 +504,7 @@ void initQudaMemory()
   device::create_context();
 
   loadTuneCache();
+  telemetry::init();
 
   // initalize the memory pool allocators
   pool::init();
@@ -1365,6 +1372,9 @@ void endQuda(void)
     solutionResident.clear();
     momResident = GaugeField();
 
+    // join the checkpoint writer and free its staging buffers
+    checkpoint::finalize();
+
     LatticeField::freeGhostBuffer();
     ColorSpinorField::freeGhostBuffer();
     FieldTmp<ColorSpinorField>::destroy();
@@ -1384,6 +1394,7 @@ void endQuda(void)
 
     saveTuneCache();
     saveProfile();
+    telemetry::destroy();
 
     // flush any outstanding force monitoring (if enabled)
     flushForceMonitor();
@@ -1430,6 +1441,7 @@ void endQuda(void)
     profileProject.Print();
     profilePhase.Print();
     profileMomAction.Print();
+  profileMD.Print();
     profileSinkProject.Print();
     profileEnd.Print();
 
@@ -1555,6 +1567,7 @@ namespace quda {
     diracParam.distance_pc_t0 = inv_param->distance_pc_t0;
 
     for (int i=0; i<4; i++) diracParam.commDim[i] = 1;   // comms are always on
+    diracParam.halo_precision = inv_param->halo_prec;
 
     if (diracParam.gauge->Precision() != inv_param->cuda_prec)
       errorQuda("Gauge precision %d does not match requested precision %d\n", diracParam.gauge->Precision(),
@@ -1575,6 +1588,7 @@ namespace quda {
     for (int i=0; i<4; i++) {
       diracParam.commDim[i] = 1;   // comms are always on
     }
+    diracParam.halo_precision = inv_param->halo_prec_sloppy;
 
     if (diracParam.gauge->Precision() != inv_param->cuda_prec_sloppy)
       errorQuda("Gauge precision %d does not match requested precision %d\n", diracParam.gauge->Precision(),
@@ -1593,6 +1607,7 @@ namespace quda {
     for (int i=0; i<4; i++) {
       diracParam.commDim[i] = 1;   // comms are always on
     }
+    diracParam.halo_precision = QUDA_INVALID_PRECISION;
 
     if (diracParam.gauge->Precision() != inv_param->cuda_prec_refinement_sloppy)
       errorQuda("Gauge precision %d does not match requested precision %d\n", diracParam.gauge->Precision(),
@@ -1618,6 +1633,7 @@ namespace quda {
     for (int i=0; i<4; i++) {
       diracParam.commDim[i] = comms ? 1 : 0;
     }
+    diracParam.halo_precision = inv_param->halo_prec_precondition;
 
     // In the preconditioned staggered CG allow a different dslash type in the preconditioning
     if(inv_param->inv_type == QUDA_PCG_INVERTER && inv_param->dslash_type == QUDA_ASQTAD_DSLASH
@@ -1661,6 +1677,7 @@ namespace quda {
     diracParam.clover = cloverEigensolver;
 
     for (int i = 0; i < 4; i++) { diracParam.commDim[i] = 1; }
+    diracParam.halo_precision = QUDA_INVALID_PRECISION;
 
     // In the deflated staggered CG allow a different dslash type
     if (inv_param->inv_type == QUDA_PCG_INVERTER && inv_param->dslash_type == QUDA_ASQTAD_DSLASH
@@ -3407,80 +3424,16 @@ void dslashMultiSrcQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, Quda
   callMultiSrcQuda(_hp_x, _hp_b, param, op, parity);
 }
 
-/*!
- * Generic version of the multi-shift solver. Should work for
- * most fermions. Note that offset[0] is not folded into the mass parameter.
- *
- * For Wilson-type fermions, the solution_type must be MATDAG_MAT or MATPCDAG_MATPC,
- * and solve_type must be NORMOP or NORMOP_PC. The solution and solve
- * preconditioning have to match.
- *
- * For Staggered-type fermions, the solution_type must be MATPC, and the
- * solve type must be DIRECT_PC. This difference in convention is because
- * preconditioned staggered operator is normal, unlike with Wilson-type fermions.
+/**
+   @brief Solve the shifted systems of invertMultiShiftQuda for a
+   device source, leaving the solutions in solutionResident.  The
+   source is rescaled in the process.
+   @param[in,out] b The source
+   @param[in,out] param The solver parameters
  */
-void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
+static void invertMultiShift(ColorSpinorField &b, QudaInvertParam *param)
 {
-  auto profile = pushProfile(profileMulti, param);
-  profilerStart(__func__);
-
-  if (!initialized) errorQuda("QUDA not initialized");
-
-  checkInvertParam(param, hp_x[0], hp_b);
-
-  // check the gauge fields have been created
-  checkGauge(param);
-
-  if (param->num_offset > QUDA_MAX_MULTI_SHIFT)
-    errorQuda("Number of shifts %d requested greater than QUDA_MAX_MULTI_SHIFT %d", param->num_offset,
-              QUDA_MAX_MULTI_SHIFT);
-
-  pushVerbosity(param->verbosity);
-
-  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
   bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) || (param->solve_type == QUDA_NORMOP_PC_SOLVE);
-  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) || (param->solution_type ==  QUDA_MATPC_SOLUTION);
-  bool direct_solve = (param->solve_type == QUDA_DIRECT_SOLVE) || (param->solve_type == QUDA_DIRECT_PC_SOLVE);
-
-  if (param->dslash_type == QUDA_ASQTAD_DSLASH ||
-      param->dslash_type == QUDA_STAGGERED_DSLASH) {
-
-    if (param->solution_type != QUDA_MATPC_SOLUTION) {
-      errorQuda("For Staggered-type fermions, multi-shift solver only supports MATPC solution type");
-    }
-
-    if (param->solve_type != QUDA_DIRECT_PC_SOLVE) {
-      errorQuda("For Staggered-type fermions, multi-shift solver only supports DIRECT_PC solve types");
-    }
-
-  } else { // Wilson type
-
-    if (mat_solution) {
-      errorQuda("For Wilson-type fermions, multi-shift solver does not support MAT or MATPC solution types");
-    }
-    if (direct_solve) {
-      errorQuda("For Wilson-type fermions, multi-shift solver does not support DIRECT or DIRECT_PC solve types");
-    }
-    if (pc_solution & !pc_solve) {
-      errorQuda("For Wilson-type fermions, preconditioned (PC) solution_type requires a PC solve_type");
-    }
-    if (!pc_solution & pc_solve) {
-      errorQuda("For Wilson-type fermions, in multi-shift solver, a preconditioned (PC) solve_type requires a PC solution_type");
-    }
-  }
-
-  param->iter = 0;
-
-  for (int i=0; i<param->num_offset-1; i++) {
-    for (int j=i+1; j<param->num_offset; j++) {
-      if (param->offset[i] > param->offset[j])
-        errorQuda("Offsets must be ordered from smallest to largest");
-    }
-  }
-
-  if (param->distance_pc_alpha0 != 0.0 && param->distance_pc_t0 >= 0) {
-    errorQuda("Multi-shift solver does not support distance preconditioning");
-  }
 
   // Create the matrix.
   // The way this works is that createDirac will create 'd' and 'dSloppy'
@@ -3508,34 +3461,8 @@ void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
 
   std::vector<double> r2_old(param->num_offset);
 
-  // Grab the dimension array of the input gauge field.
-  const auto X = (param->dslash_type == QUDA_ASQTAD_DSLASH) ? gaugeFatPrecise->X() : gaugePrecise->X();
-
-  // This creates a ColorSpinorParam struct, from the host data
-  // pointer, the definitions in param, the dimensions X, and whether
-  // the solution is on a checkerboard instruction or not. These can
-  // then be used as 'instructions' to create the actual
-  // ColorSpinorField
-  ColorSpinorParam cpuParam(hp_b, *param, X, pc_solution, param->input_location);
-  ColorSpinorField h_b(cpuParam);
-
-  std::vector<ColorSpinorField> h_x;
-  h_x.resize(param->num_offset);
-
-  cpuParam.location = param->output_location;
-  for(int i=0; i < param->num_offset; i++) {
-    cpuParam.v = hp_x[i];
-    h_x[i] = ColorSpinorField(cpuParam);
-  }
-
-  // Now I need a colorSpinorParam for the device
-  ColorSpinorParam cudaParam(cpuParam, *param, QUDA_CUDA_FIELD_LOCATION);
-  // This setting will download a host vector
-  cudaParam.create = QUDA_COPY_FIELD_CREATE;
-  cudaParam.field = &h_b;
-  ColorSpinorField b(cudaParam); // Creates b and downloads h_b to it
-
   // Create the solution fields filled with zero
+  ColorSpinorParam cudaParam(b);
   cudaParam.create = QUDA_ZERO_FIELD_CREATE;
 
   // now check if we need to invalidate the solution vectors
@@ -3726,20 +3653,127 @@ void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
     }
 
     logQuda(QUDA_VERBOSE, "Solution %d = %g\n", i, blas::norm2(x[i]));
-    if (!param->make_resident_solution) h_x[i] = x[i];
   }
 
+  delete d;
+  delete dSloppy;
+  delete dPre;
+  delete dRefine;
+}
+
+/*!
+ * Generic version of the multi-shift solver. Should work for
+ * most fermions. Note that offset[0] is not folded into the mass parameter.
+ *
+ * For Wilson-type fermions, the solution_type must be MATDAG_MAT or MATPCDAG_MATPC,
+ * and solve_type must be NORMOP or NORMOP_PC. The solution and solve
+ * preconditioning have to match.
+ *
+ * For Staggered-type fermions, the solution_type must be MATPC, and the
+ * solve type must be DIRECT_PC. This difference in convention is because
+ * preconditioned staggered operator is normal, unlike with Wilson-type fermions.
+ */
+void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
+{
+  auto profile = pushProfile(profileMulti, param);
+  profilerStart(__func__);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  checkInvertParam(param, hp_x[0], hp_b);
+
+  // check the gauge fields have been created
+  checkGauge(param);
+
+  if (param->num_offset > QUDA_MAX_MULTI_SHIFT)
+    errorQuda("Number of shifts %d requested greater than QUDA_MAX_MULTI_SHIFT %d", param->num_offset,
+              QUDA_MAX_MULTI_SHIFT);
+
+  pushVerbosity(param->verbosity);
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) || (param->solve_type == QUDA_NORMOP_PC_SOLVE);
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) || (param->solution_type ==  QUDA_MATPC_SOLUTION);
+  bool direct_solve = (param->solve_type == QUDA_DIRECT_SOLVE) || (param->solve_type == QUDA_DIRECT_PC_SOLVE);
+
+  if (param->dslash_type == QUDA_ASQTAD_DSLASH ||
+      param->dslash_type == QUDA_STAGGERED_DSLASH) {
+
+    if (param->solution_type != QUDA_MATPC_SOLUTION) {
+      errorQuda("For Staggered-type fermions, multi-shift solver only supports MATPC solution type");
+    }
+
+    if (param->solve_type != QUDA_DIRECT_PC_SOLVE) {
+      errorQuda("For Staggered-type fermions, multi-shift solver only supports DIRECT_PC solve types");
+    }
+
+  } else { // Wilson type
+
+    if (mat_solution) {
+      errorQuda("For Wilson-type fermions, multi-shift solver does not support MAT or MATPC solution types");
+    }
+    if (direct_solve) {
+      errorQuda("For Wilson-type fermions, multi-shift solver does not support DIRECT or DIRECT_PC solve types");
+    }
+    if (pc_solution & !pc_solve) {
+      errorQuda("For Wilson-type fermions, preconditioned (PC) solution_type requires a PC solve_type");
+    }
+    if (!pc_solution & pc_solve) {
+      errorQuda("For Wilson-type fermions, in multi-shift solver, a preconditioned (PC) solve_type requires a PC solution_type");
+    }
+  }
+
+  param->iter = 0;
+
+  for (int i=0; i<param->num_offset-1; i++) {
+    for (int j=i+1; j<param->num_offset; j++) {
+      if (param->offset[i] > param->offset[j])
+        errorQuda("Offsets must be ordered from smallest to largest");
+    }
+  }
+
+  if (param->distance_pc_alpha0 != 0.0 && param->distance_pc_t0 >= 0) {
+    errorQuda("Multi-shift solver does not support distance preconditioning");
+  }
+
+  // Grab the dimension array of the input gauge field.
+  const auto X = (param->dslash_type == QUDA_ASQTAD_DSLASH) ? gaugeFatPrecise->X() : gaugePrecise->X();
+
+  // This creates a ColorSpinorParam struct, from the host data
+  // pointer, the definitions in param, the dimensions X, and whether
+  // the solution is on a checkerboard instruction or not. These can
+  // then be used as 'instructions' to create the actual
+  // ColorSpinorField
+  ColorSpinorParam cpuParam(hp_b, *param, X, pc_solution, param->input_location);
+  ColorSpinorField h_b(cpuParam);
+
+  std::vector<ColorSpinorField> h_x;
+  h_x.resize(param->num_offset);
+
+  cpuParam.location = param->output_location;
+  for(int i=0; i < param->num_offset; i++) {
+    cpuParam.v = hp_x[i];
+    h_x[i] = ColorSpinorField(cpuParam);
+  }
+
+  // Now I need a colorSpinorParam for the device
+  ColorSpinorParam cudaParam(cpuParam, *param, QUDA_CUDA_FIELD_LOCATION);
+  // This setting will download a host vector
+  cudaParam.create = QUDA_COPY_FIELD_CREATE;
+  cudaParam.field = &h_b;
+  ColorSpinorField b(cudaParam); // Creates b and downloads h_b to it
+
+  invertMultiShift(b, param);
+
+  if (!param->make_resident_solution)
+    for (int i = 0; i < param->num_offset; i++) h_x[i] = solutionResident[i];
+
   profileMulti.TPSTART(QUDA_PROFILE_EPILOGUE);
 
   if (!param->make_resident_solution) solutionResident.clear();
 
   profileMulti.TPSTOP(QUDA_PROFILE_EPILOGUE);
 
-  delete d;
-  delete dSloppy;
-  delete dPre;
-  delete dRefine;
-
   profilerStop(__func__);
   popVerbosity();
 }
@@ -4230,15 +4264,15 @@ void computeStaggeredForceQuda(void *h_mom, double dt, double delta, void *, voi
 #endif
   delete dirac;
 
-  // compute quark-field outer product
-  for (int i=0; i<nvector; i++) {
-    ColorSpinorField &x = *(X[i]);
+  // compute quark-field outer product of all shifts together
+  vector_ref<const ColorSpinorField> x;
+  std::vector<array<double, 2>> coeff(nvector);
+  for (int i = 0; i < nvector; i++) {
+    x.push_back(*(X[i]));
     // second component is zero since we have no three hop term
-    double coeff[2] = {inv_param->residue[i], 0.0};
-
-    // Operate on even-parity sites
-    computeStaggeredOprod(cudaForce_, x, coeff, 1);
+    coeff[i] = {inv_param->residue[i], 0.0};
   }
+  computeStaggeredOprod(cudaForce_, x, coeff, 1);
 
   // mom += delta * [U * force]TA
   applyU(cudaForce, *gaugePrecise);
@@ -4255,20 +4289,141 @@ void computeStaggeredForceQuda(void *h_mom, double dt, double delta, void *, voi
   for (int i=0; i<nvector; i++) delete X[i];
 }
 
-void computeHISQForceQuda(void* const milc_momentum,
-                          double dt,
-                          const double level2_coeff[6],
-                          const double fat7_coeff[6],
-                          const void* const w_link,
-                          const void* const v_link,
-                          const void* const u_link,
-                          void **fermion,
-                          int num_terms,
-                          int num_naik_terms,
-                          double **coeff,
-                          QudaGaugeParam* gParam)
+/**
+   @brief Accumulate the outer products of a set of HISQ quark fields,
+   in batches of up to get_max_multi_rhs() fields that are summed by a
+   single kernel.  Host fields are staged through pinned memory and
+   uploaded on a separate stream, so that the transfer of each batch
+   overlaps the outer product of the previous one.  Resident fields
+   are the even-parity multi-shift solutions, whose odd-parity
+   component is reconstructed on the device with the dslash.
+   @param[out] oprod The one- and three-hop outer-product fields
+   @param[in] qParam Parameters of the device quark fields
+   @param[in] fermion Host quark fields, or nullptr if we are using the resident solutions
+   @param[in] dirac Operator used to reconstruct the odd parity of the resident solutions
+   @param[in] index Index of each quark field in fermion or solutionResident
+   @param[in] coeff One- and three-hop coefficients of each quark field
+ */
+static void computeHISQOprod(GaugeField *oprod[], ColorSpinorParam qParam, void **fermion, const Dirac *dirac,
+                             const std::vector<int> &index, const std::vector<array<double, 2>> &coeff)
+{
+  const int n = index.size();
+  if (n == 0) return;
+  const int batch = std::min<int>(n, get_max_multi_rhs());
+  const int n_batch = (n + batch - 1) / batch;
+
+  // zero creation so that any padding is left clear by the reordering
+  qParam.location = QUDA_CUDA_FIELD_LOCATION;
+  qParam.create = QUDA_ZERO_FIELD_CREATE;
+  std::vector<ColorSpinorField> quark;
+  resize(quark, batch, qParam);
+
+  auto compute = [&](int begin, int size) {
+    computeStaggeredOprod(oprod, {quark.begin(), quark.begin() + size}, {coeff.begin() + begin, coeff.begin() + begin + size},
+                          3);
+  };
+
+  if (!fermion) {
+    auto &x0 = solutionResident[index[0]];
+    ColorSpinorParam yParam(qParam);
+    yParam.setPrecision(x0.Precision(), x0.Precision(), true);
+    yParam.create = QUDA_NULL_FIELD_CREATE;
+    const bool convert = x0.Precision() != qParam.Precision();
+    std::vector<ColorSpinorField> y;
+    if (convert) resize(y, batch, yParam);
+
+    for (int t = 0; t < n_batch; t++) {
+      int begin = t * batch;
+      int size = std::min(batch, n - begin);
+
+      // the dslash is applied in the precision of the solver
+      auto &x = convert ? y : quark;
+      vector_ref<ColorSpinorField> even, odd;
+      for (int i = 0; i < size; i++) {
+        x[i].Even() = solutionResident[index[begin + i]];
+        even.push_back(x[i].Even());
+        odd.push_back(x[i].Odd());
+      }
+      dirac->Dslash(odd, even, QUDA_ODD_PARITY);
+      if (convert)
+        for (int i = 0; i < size; i++) quark[i] = y[i];
+
+      compute(begin, size);
+    }
+    return;
+  }
+
+  // the MILC quark fields all share this layout
+  ColorSpinorParam cpuParam(qParam);
+  cpuParam.location = QUDA_CPU_FIELD_LOCATION;
+  cpuParam.create = QUDA_REFERENCE_FIELD_CREATE;
+  cpuParam.fieldOrder = QUDA_SPACE_COLOR_SPIN_FIELD_ORDER;
+  cpuParam.v = fermion[index[0]];
+  ColorSpinorField cpuQuark(cpuParam);
+  const size_t bytes = cpuQuark.Bytes();
+
+  char *pinned[2], *stage[2];
+  for (int b = 0; b < 2; b++) {
+    pinned[b] = static_cast<char *>(pool_pinned_malloc(batch * bytes));
+    stage[b] = static_cast<char *>(pool_device_malloc(batch * bytes));
+  }
+
+  auto copy_stream = device::get_stream(0);
+  auto compute_stream = device::get_default_stream();
+  qudaEvent_t copied[2] = {qudaEventCreate(), qudaEventCreate()};
+  qudaEvent_t released[2] = {qudaEventCreate(), qudaEventCreate()};
+
+  // Upload batch t into buffer t % 2, once the batch that last used it is done
+  auto fetch = [&](int t) {
+    int b = t % 2;
+    int begin = t * batch;
+    int size = std::min(batch, n - begin);
+    if (t >= 2) qudaEventSynchronize(copied[b]);
+    for (int i = 0; i < size; i++) memcpy(pinned[b] + i * bytes, fermion[index[begin + i]], bytes);
+    if (t >= 2) qudaStreamWaitEvent(copy_stream, released[b], 0);
+    qudaMemcpyAsync(stage[b], pinned[b], size * bytes, qudaMemcpyHostToDevice, copy_stream);
+    qudaEventRecord(copied[b], copy_stream);
+  };
+
+  fetch(0);
+  for (int t = 0; t < n_batch; t++) {
+    int b = t % 2;
+    int begin = t * batch;
+    int size = std::min(batch, n - begin);
+
+    // reorder the MILC fields into the device order
+    qudaStreamWaitEvent(compute_stream, copied[b], 0);
+    for (int i = 0; i < size; i++)
+      copyGenericColorSpinor(quark[i], cpuQuark, QUDA_CUDA_FIELD_LOCATION, nullptr, stage[b] + i * bytes);
+    qudaEventRecord(released[b], compute_stream);
+
+    compute(begin, size);
+
+    // Overlap the transfer of the next batch with the work on this one
+    if (t + 1 < n_batch) fetch(t + 1);
+  }
+
+  qudaDeviceSynchronize();
+  for (auto &e : copied) qudaEventDestroy(e);
+  for (auto &e : released) qudaEventDestroy(e);
+  for (int b = 0; b < 2; b++) {
+    pool_pinned_free(pinned[b]);
+    pool_device_free(stage[b]);
+  }
+}
+
+/**
+   @brief Compute the HISQ fermion force from the quark fields given
+   either on the host or as resident multi-shift solutions, see
+   computeHISQForceQuda and computeHISQForceResidentQuda
+   @param[in] fermion Host quark fields, or nullptr if we are using the resident solutions
+   @param[in] inv_param Parameters of the multi-shift solve (required for the resident solutions)
+ */
+static void computeHISQForce(void *const milc_momentum, double dt, const double level2_coeff[6],
+                             const double fat7_coeff[6], const void *const w_link, const void *const v_link,
+                             const void *const u_link, void **fermion, int num_terms, int num_naik_terms,
+                             double **coeff, QudaGaugeParam *gParam, QudaInvertParam *inv_param)
 {
-  auto profile = pushProfile(profileHISQForce);
   checkGaugeParam(gParam);
 
   using namespace quda;
@@ -4337,47 +4492,41 @@ void computeHISQForceQuda(void* const milc_momentum,
     qParam.pad = 0;
     for (int dir=0; dir<4; ++dir) qParam.x[dir] = oParam.x[dir];
 
-    // create the device quark field
-    qParam.create = QUDA_NULL_FIELD_CREATE;
-    qParam.location = QUDA_CUDA_FIELD_LOCATION;
-    ColorSpinorField cudaQuark(qParam);
-
-    // create the host quark field
-    qParam.location = QUDA_CPU_FIELD_LOCATION;
-    qParam.create = QUDA_REFERENCE_FIELD_CREATE;
-    qParam.fieldOrder = QUDA_SPACE_COLOR_SPIN_FIELD_ORDER;
-    qParam.v = fermion[0];
+    // the resident solutions need the staggered operator to reconstruct their odd parity
+    std::unique_ptr<Dirac> dirac;
+    if (!fermion) {
+      if (!inv_param->use_resident_solution) errorQuda("%s requires resident solution", __func__);
+      if (solutionResident.size() < (unsigned int)num_terms)
+        errorQuda("solutionResident.size() %lu is less than the number of terms %d", solutionResident.size(), num_terms);
+      bool pc_solve = (inv_param->solve_type == QUDA_DIRECT_PC_SOLVE) || (inv_param->solve_type == QUDA_NORMOP_PC_SOLVE);
+      if (!pc_solve) errorQuda("Preconditioned solve type required not %d\n", inv_param->solve_type);
+      DiracParam diracParam;
+      setDiracParam(diracParam, inv_param, pc_solve);
+      dirac.reset(Dirac::create(diracParam));
+    }
 
     { // regular terms
       GaugeField *oprod[2] = {&stapleOprod, &naikOprod};
-
-      // loop over different quark fields
+      std::vector<int> index(num_terms);
+      std::vector<array<double, 2>> c(num_terms);
       for (int i = 0; i < num_terms; ++i) {
-
-        // Wrap the MILC quark field
-        qParam.v = fermion[i];
-        ColorSpinorField cpuQuark(qParam); // create host quark field
-
-        cudaQuark = cpuQuark;
-        computeStaggeredOprod(oprod, cudaQuark, coeff[i], 3);
+        index[i] = i;
+        c[i] = {coeff[i][0], coeff[i][1]};
       }
+      computeHISQOprod(oprod, qParam, fermion, dirac.get(), index, c);
     }
 
     { // naik terms
       oneLinkOprod.copy(stapleOprod);
       ax(level2_coeff[0], oneLinkOprod);
       GaugeField *oprod[2] = {&oneLinkOprod, &naikOprod};
-
-      // loop over different quark fields
+      std::vector<int> index(num_naik_terms);
+      std::vector<array<double, 2>> c(num_naik_terms);
       for (int i = 0; i < num_naik_terms; ++i) {
-
-        // Wrap the MILC quark field
-        qParam.v = fermion[i + num_terms - num_naik_terms];
-        ColorSpinorField cpuQuark(qParam); // create host quark field
-
-        cudaQuark = cpuQuark;
-        computeStaggeredOprod(oprod, cudaQuark, coeff[i + num_terms], 3);
+        index[i] = i + num_terms - num_naik_terms;
+        c[i] = {coeff[i + num_terms][0], coeff[i + num_terms][1]};
       }
+      computeHISQOprod(oprod, qParam, fermion, dirac.get(), index, c);
     }
   }
 
@@ -4550,6 +4699,25 @@ void computeHISQForceQuda(void* const milc_momentum,
     momResident = GaugeField();
 }
 
+void computeHISQForceQuda(void *const milc_momentum, double dt, const double level2_coeff[6], const double fat7_coeff[6],
+                          const void *const w_link, const void *const v_link, const void *const u_link, void **fermion,
+                          int num_terms, int num_naik_terms, double **coeff, QudaGaugeParam *gParam)
+{
+  auto profile = pushProfile(profileHISQForce);
+  computeHISQForce(milc_momentum, dt, level2_coeff, fat7_coeff, w_link, v_link, u_link, fermion, num_terms,
+                   num_naik_terms, coeff, gParam, nullptr);
+}
+
+void computeHISQForceResidentQuda(void *const milc_momentum, double dt, const double level2_coeff[6],
+                                  const double fat7_coeff[6], const void *const w_link, const void *const v_link,
+                                  const void *const u_link, int num_terms, int num_naik_terms, double **coeff,
+                                  QudaGaugeParam *gParam, QudaInvertParam *inv_param)
+{
+  auto profile = pushProfile(profileHISQForce, inv_param);
+  computeHISQForce(milc_momentum, dt, level2_coeff, fat7_coeff, w_link, v_link, u_link, nullptr, num_terms,
+                   num_naik_terms, coeff, gParam, inv_param);
+}
+
 void computeCloverForceQuda(void *h_mom, double dt, void **h_x, void **, double *coeff, double kappa2, double ck,
                             int nvector, double multiplicity, void *, QudaGaugeParam *gauge_param,
                             QudaInvertParam *inv_param)
@@ -4879,6 +5047,387 @@ void gaussMomQuda(unsigned long long seed, double sigma)
   quda::gaugeGauss(momResident, seed, sigma);
 }
 
+/**
+   @brief Propagate an in-place update of gaugePrecise to the resident
+   fields derived from it: the sloppy and extended gauge fields and,
+   if param is set, the clover field and its sloppy copies
+   @param[in] param Parameters for recomputing the clover field, or
+   nullptr if there is no clover field to recompute
+ */
+static void refreshResidentGauge(QudaInvertParam *param)
+{
+  gaugePrecise->exchangeGhost();
+
+  // the sloppy fields may alias each other, so only copy each once
+  std::vector<GaugeField *> gauge = {gaugePrecise};
+  for (auto g : {gaugeSloppy, gaugePrecondition, gaugeRefinement, gaugeEigensolver}) {
+    if (!g || std::find(gauge.begin(), gauge.end(), g) != gauge.end()) continue;
+    g->copy(*gaugePrecise);
+    gauge.push_back(g);
+  }
+
+  for (auto ex : {extendedGaugeResident, gaugeExtended}) {
+    if (!ex) continue;
+    ex->copy(*gaugePrecise);
+    ex->exchangeExtendedGhost(ex->R(), redundant_comms);
+  }
+
+  if (param && cloverPrecise) {
+    createCloverQuda(param);
+
+    std::vector<CloverField *> clover = {cloverPrecise};
+    for (auto c : {cloverSloppy, cloverPrecondition, cloverRefinement, cloverEigensolver}) {
+      if (!c || std::find(clover.begin(), clover.end(), c) != clover.end()) continue;
+      c->copy(*cloverPrecise);
+      clover.push_back(c);
+    }
+  }
+}
+
+/**
+   @return The resident extended gauge field, recreated if its halo
+   is not deep enough for the gauge force
+ */
+static GaugeField &residentExtendedGauge()
+{
+  if (extendedGaugeResident) {
+    for (int d = 0; d < 4; d++) {
+      if (extendedGaugeResident->R()[d] < R[d]) {
+        delete extendedGaugeResident;
+        extendedGaugeResident = nullptr;
+        break;
+      }
+    }
+  }
+  if (!extendedGaugeResident) extendedGaugeResident = createExtendedGauge(*gaugePrecise, R, getProfile());
+  return *extendedGaugeResident;
+}
+
+/**
+   @brief Solve the shifted systems of a fermion monomial, leaving the
+   solutions in solutionResident
+ */
+static void solveMonomial(md_fermion_monomial &f)
+{
+  auto profile = pushProfile(profileMulti, &f.param);
+  pushVerbosity(f.param.verbosity);
+  ColorSpinorField b(f.phi); // the solver rescales the source
+  invertMultiShift(b, &f.param);
+  popVerbosity();
+}
+
+namespace quda
+{
+
+  md_action::md_action(QudaGaugeParam &param)
+  {
+    if (!gaugePrecise) errorQuda("No resident gauge field");
+    if (gaugePrecise->Precision() != param.cuda_prec)
+      errorQuda("Precision %d does not match the resident gauge field precision %d", param.cuda_prec,
+                gaugePrecise->Precision());
+    if (gaugePrecise->StaggeredPhaseApplied()) errorQuda("Resident gauge field has the staggered phase applied");
+
+    if (momResident.empty()) {
+      GaugeFieldParam gParamMom(param, nullptr, QUDA_ASQTAD_MOM_LINKS);
+      gParamMom.location = QUDA_CUDA_FIELD_LOCATION;
+      gParamMom.reconstruct = QUDA_RECONSTRUCT_10;
+      gParamMom.setPrecision(param.cuda_prec, true);
+      gParamMom.create = QUDA_ZERO_FIELD_CREATE;
+      momResident = GaugeField(gParamMom);
+    } else if (momResident.Precision() != gaugePrecise->Precision()) {
+      errorQuda("Resident momentum precision %d does not match the resident gauge field precision %d",
+                momResident.Precision(), gaugePrecise->Precision());
+    }
+
+    GaugeFieldParam u_param(*gaugePrecise);
+    u_param.create = QUDA_NULL_FIELD_CREATE;
+    u_tmp = GaugeField(u_param);
+  }
+
+  void md_action::hamiltonian(double *h)
+  {
+    int k = 0;
+    h[k++] = computeMomAction(momResident);
+
+    auto &u = residentExtendedGauge();
+    for (auto &g : gauge) {
+      std::vector<int *> loop(g.loop.size());
+      for (auto i = 0u; i < loop.size(); i++) loop[i] = g.loop[i].data();
+      std::vector<int **> input_path = {loop.data()};
+
+      std::vector<Complex> traces(loop.size());
+      gaugeLoopTrace(u, traces, 1.0, input_path, g.loop_length, g.loop_coeff, loop.size(), g.max_length + 1);
+
+      double action = 0.0;
+      for (auto &t : traces) action += t.real();
+      h[k++] = -g.beta_nc * action;
+    }
+
+    for (auto &f : fermion) {
+      solveMonomial(f);
+
+      double action = f.residue_0 * blas::norm2(f.phi);
+      for (int i = 0; i < f.param.num_offset; i++)
+        action += f.param.residue[i] * blas::reDotProduct(f.phi, solutionResident[i]);
+
+      // the clover term is eliminated on the opposite parity to the preconditioned system
+      int parity = f.param.matpc_type == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC ? 1 : 0;
+      if (f.multiplicity != 0.0) action -= f.multiplicity * cloverPrecise->TrLog()[parity];
+      h[k++] = action;
+    }
+  }
+
+  void md_action::updateP(GaugeField &mom, double dt)
+  {
+    auto &u = residentExtendedGauge();
+    for (auto &g : gauge) {
+      std::vector<int *> path[4];
+      std::vector<int **> input_path(4);
+      for (int d = 0; d < 4; d++) {
+        for (auto &p : g.path[d]) path[d].push_back(p.data());
+        input_path[d] = path[d].data();
+      }
+      gaugeForce(mom, u, dt * g.beta_nc, input_path, g.length, g.coeff, g.length.size(), g.max_length);
+    }
+
+    for (auto &f : fermion) {
+      solveMonomial(f);
+
+      // conventions of computeCloverForceQuda
+      const double kappa2 = -f.param.kappa * f.param.kappa;
+      const double ck = -f.param.clover_coeff / 8.0;
+      const int n = f.param.num_offset;
+      QudaParity parity = f.param.matpc_type == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC ? QUDA_EVEN_PARITY : QUDA_ODD_PARITY;
+
+      ColorSpinorParam qParam(nullptr, f.param, gaugePrecise->X(), false, QUDA_CUDA_FIELD_LOCATION);
+      qParam.setPrecision(mom.Precision(), mom.Precision(), true);
+      qParam.create = QUDA_NULL_FIELD_CREATE;
+      qParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+
+      std::vector<ColorSpinorField> x(n), x0(n);
+      std::vector<double> force_coeff(n);
+      std::vector<array<double, 2>> epsilon(n);
+      for (int i = 0; i < n; i++) {
+        x[i] = ColorSpinorField(qParam);
+        x[i][parity] = solutionResident[i];
+        force_coeff[i] = 2.0 * dt * f.param.residue[i] * kappa2;
+        epsilon[i] = {2.0 * ck * f.param.residue[i] * dt, -kappa2 * 2.0 * ck * f.param.residue[i] * dt};
+      }
+
+      computeCloverForce(mom, u, *gaugePrecise, *cloverPrecise, x, x0, force_coeff, epsilon,
+                         2.0 * ck * f.multiplicity * dt, false, f.param);
+    }
+  }
+
+  void md_action::updateU(double dt)
+  {
+    updateGaugeField(u_tmp, dt, *gaugePrecise, momResident, false, true);
+    std::swap(*gaugePrecise, u_tmp);
+    refreshResidentGauge(fermion.size() > 0 ? &fermion[0].param : nullptr);
+  }
+
+  void md_action::updatePForceGradient(double dt, double xi)
+  {
+    GaugeFieldParam param(momResident);
+    param.create = QUDA_ZERO_FIELD_CREATE;
+    GaugeField force(param);
+    updateP(force, 1.0);
+
+    // evaluate the force on the displaced field, keeping the original in u_tmp
+    updateGaugeField(u_tmp, xi, *gaugePrecise, force, false, true);
+    std::swap(*gaugePrecise, u_tmp);
+    refreshResidentGauge(fermion.size() > 0 ? &fermion[0].param : nullptr);
+
+    updateP(momResident, dt);
+
+    std::swap(*gaugePrecise, u_tmp);
+    refreshResidentGauge(fermion.size() > 0 ? &fermion[0].param : nullptr);
+  }
+
+  void md_action::evolve(double tau, int n_steps, QudaMDIntegrator integrator)
+  {
+    if (n_steps < 1) errorQuda("Invalid number of steps %d", n_steps);
+    const double h = tau / n_steps;
+
+    // the momentum updates at the ends of consecutive steps are merged
+    switch (integrator) {
+    case QUDA_MD_INTEGRATOR_LEAPFROG:
+      // P(h/2) U(h) P(h/2)
+      updateP(momResident, 0.5 * h);
+      for (int i = 0; i < n_steps; i++) {
+        updateU(h);
+        updateP(momResident, i < n_steps - 1 ? h : 0.5 * h);
+      }
+      break;
+    case QUDA_MD_INTEGRATOR_OMELYAN: {
+      // P(lambda h) U(h/2) P((1 - 2 lambda) h) U(h/2) P(lambda h)
+      constexpr double lambda = 0.1931833275037836;
+      updateP(momResident, lambda * h);
+      for (int i = 0; i < n_steps; i++) {
+        updateU(0.5 * h);
+        updateP(momResident, (1.0 - 2.0 * lambda) * h);
+        updateU(0.5 * h);
+        updateP(momResident, i < n_steps - 1 ? 2.0 * lambda * h : lambda * h);
+      }
+      break;
+    }
+    case QUDA_MD_INTEGRATOR_FORCE_GRADIENT:
+      // P(h/6) U(h/2) P'(2h/3) U(h/2) P(h/6), where the force-gradient
+      // term of P' is approximated by evaluating the force on exp(h^2/24 F) U
+      updateP(momResident, h / 6.0);
+      for (int i = 0; i < n_steps; i++) {
+        updateU(0.5 * h);
+        updatePForceGradient(2.0 * h / 3.0, h * h / 24.0);
+        updateU(0.5 * h);
+        updateP(momResident, i < n_steps - 1 ? h / 3.0 : h / 6.0);
+      }
+      break;
+    default: errorQuda("Invalid integrator %d", integrator);
+    }
+  }
+
+} // namespace quda
+
+void *newMDActionQuda(QudaGaugeParam *param)
+{
+  auto profile = pushProfile(profileMD);
+  checkGaugeParam(param);
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  return static_cast<void *>(new md_action(*param));
+}
+
+void destroyMDActionQuda(void *action) { delete static_cast<md_action *>(action); }
+
+void addGaugeMonomialQuda(void *action, int ***input_path_buf, int *path_length, double *loop_coeff, int num_paths,
+                          int max_length, double beta_nc)
+{
+  auto &md = *static_cast<md_action *>(action);
+
+  md_gauge_monomial g;
+  g.beta_nc = beta_nc;
+  g.max_length = max_length;
+  g.length.assign(path_length, path_length + num_paths);
+  g.coeff.assign(loop_coeff, loop_coeff + num_paths);
+
+  for (int d = 0; d < 4; d++) {
+    for (int i = 0; i < num_paths; i++) {
+      if (path_length[i] > max_length) errorQuda("Path %d length %d exceeds max_length %d", i, path_length[i], max_length);
+      std::vector<int> loop = {d};
+      loop.insert(loop.end(), input_path_buf[d][i], input_path_buf[d][i] + path_length[i]);
+
+      // the path must return to the start of the link it is the force on
+      int disp[4] = {};
+      for (auto step : loop) {
+        if (step < 0 || step > 7) errorQuda("Invalid path direction %d", step);
+        disp[step < 4 ? step : 7 - step] += step < 4 ? 1 : -1;
+      }
+      if (disp[0] || disp[1] || disp[2] || disp[3]) errorQuda("Path %d of direction %d does not close a loop", i, d);
+
+      g.path[d].emplace_back(loop.begin() + 1, loop.end());
+      g.loop.push_back(loop);
+      g.loop_length.push_back(path_length[i] + 1);
+      g.loop_coeff.push_back(loop_coeff[i] / (path_length[i] + 1));
+    }
+  }
+
+  md.gauge.push_back(std::move(g));
+}
+
+int addCloverMonomialQuda(void *action, void *phi, double residue_0, double multiplicity, QudaInvertParam *param)
+{
+  auto profile = pushProfile(profileMD);
+  auto &md = *static_cast<md_action *>(action);
+
+  checkInvertParam(param, nullptr, phi);
+  if (param->dslash_type != QUDA_CLOVER_WILSON_DSLASH)
+    errorQuda("Fermion monomials only support clover-Wilson fermions, not dslash type %d", param->dslash_type);
+  if (!cloverPrecise) errorQuda("No resident clover field");
+  if (param->solution_type != QUDA_MATPCDAG_MATPC_SOLUTION || param->solve_type != QUDA_NORMOP_PC_SOLVE)
+    errorQuda("Fermion monomials require a MatPCDagMatPC solution with a normal-operator PC solve");
+  if (param->matpc_type != QUDA_MATPC_EVEN_EVEN_ASYMMETRIC && param->matpc_type != QUDA_MATPC_ODD_ODD_ASYMMETRIC)
+    errorQuda("Fermion monomials require asymmetric preconditioning, not MatPC type %d", param->matpc_type);
+  if (param->num_offset < 1 || param->num_offset > QUDA_MAX_MULTI_SHIFT)
+    errorQuda("Invalid number of shifts %d", param->num_offset);
+  for (int i = 0; i < param->num_offset - 1; i++)
+    if (param->offset[i] > param->offset[i + 1]) errorQuda("Offsets must be ordered from smallest to largest");
+  if (param->clover_coeff == 0.0 && param->clover_csw == 0.0) errorQuda("neither clover coefficient nor Csw set");
+
+  md_fermion_monomial f;
+  f.param = *param;
+  f.param.clover_coeff = (param->clover_coeff == 0.0 ? param->kappa * param->clover_csw : param->clover_coeff);
+  f.param.make_resident_solution = 1;
+  f.param.compute_action = 0;
+  f.residue_0 = residue_0;
+  f.multiplicity = multiplicity;
+
+  // the monomials share the resident clover field
+  if (md.fermion.size() > 0 && f.param.clover_coeff != md.fermion[0].param.clover_coeff)
+    errorQuda("Clover coefficient %e does not match that of the resident clover field %e", f.param.clover_coeff,
+              md.fermion[0].param.clover_coeff);
+
+  md.fermion.push_back(std::move(f));
+  int monomial = md.fermion.size() - 1;
+  updateCloverMonomialQuda(action, monomial, phi);
+  return monomial;
+}
+
+void updateCloverMonomialQuda(void *action, int monomial, void *phi)
+{
+  auto profile = pushProfile(profileMD);
+  auto &md = *static_cast<md_action *>(action);
+  if (monomial < 0 || monomial >= static_cast<int>(md.fermion.size())) errorQuda("Invalid monomial %d", monomial);
+  auto &f = md.fermion[monomial];
+
+  ColorSpinorParam cpuParam(phi, f.param, gaugePrecise->X(), true, f.param.input_location);
+  ColorSpinorField h_phi(cpuParam);
+
+  ColorSpinorParam cudaParam(cpuParam, f.param, QUDA_CUDA_FIELD_LOCATION);
+  cudaParam.create = QUDA_COPY_FIELD_CREATE;
+  cudaParam.field = &h_phi;
+  f.phi = ColorSpinorField(cudaParam);
+}
+
+void hamiltonianMDQuda(void *action, double *h)
+{
+  auto profile = pushProfile(profileMD);
+  static_cast<md_action *>(action)->hamiltonian(h);
+}
+
+void evolveMDQuda(void *action, double tau, int n_steps, QudaMDIntegrator integrator)
+{
+  auto profile = pushProfile(profileMD);
+  static_cast<md_action *>(action)->evolve(tau, n_steps, integrator);
+}
+
+void trajectoryMDQuda(void *action, double tau, int n_steps, QudaMDIntegrator integrator, unsigned long long seed,
+                      double *h_begin, double *h_end)
+{
+  auto profile = pushProfile(profileMD);
+  auto &md = *static_cast<md_action *>(action);
+
+  // the momentum is distributed as exp(-S) with S computed by momActionQuda
+  quda::gaugeGauss(momResident, seed, 1.0);
+
+  md.u_backup = *gaugePrecise;
+  md.mom_backup = momResident;
+
+  md.hamiltonian(h_begin);
+  md.evolve(tau, n_steps, integrator);
+  md.hamiltonian(h_end);
+}
+
+void rejectMDQuda(void *action)
+{
+  auto profile = pushProfile(profileMD);
+  auto &md = *static_cast<md_action *>(action);
+  if (md.u_backup.empty()) errorQuda("No trajectory to reject");
+
+  gaugePrecise->copy(md.u_backup);
+  momResident.copy(md.mom_backup);
+  refreshResidentGauge(md.fermion.size() > 0 ? &md.fermion[0].param : nullptr);
+}
+
 /*
  * Computes the total, spatial and temporal plaquette averages of the loaded gauge configuration.
  */
@@ -4946,7 +5495,70 @@ void copyExtendedResidentGaugeQuda(void *resident_gauge)
   static_cast<GaugeField *>(resident_gauge)->copy(*extendedGaugeResident);
 }
 
-void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *inv_param, unsigned int n_steps, double alpha)
+/**
+   @brief Apply a smearing operator to a set of host sources.  The
+   sources are uploaded and smeared in batches of get_max_multi_rhs()
+   fields, so each step is a single multi-RHS kernel that shares the
+   gauge field loads across the batch.  The upload of the next batch
+   is issued once the smearing of the current batch has been queued,
+   so that the host-side reordering of the next batch overlaps with
+   the smearing kernels.
+   @param[in] h_out Host output fields
+   @param[in] h_in Host input fields
+   @param[in] cpuParam Parameters of the host fields
+   @param[in] in_location Location of the input fields
+   @param[in] out_location Location of the output fields
+   @param[in] cudaParam Parameters of the device fields
+   @param[in] smear Functor smear(out, in) that smears a batch,
+   leaving the result in out; in may be overwritten
+ */
+template <typename Smear>
+static void smearMultiSrc(const std::vector<void *> &h_out, const std::vector<void *> &h_in, ColorSpinorParam cpuParam,
+                          QudaFieldLocation in_location, QudaFieldLocation out_location, ColorSpinorParam cudaParam,
+                          Smear &&smear)
+{
+  if (h_out.size() != h_in.size()) errorQuda("Number of outputs %lu != number of inputs %lu", h_out.size(), h_in.size());
+  const size_t n_src = h_in.size();
+  const size_t batch = std::min<size_t>(n_src, get_max_multi_rhs());
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+
+  auto wrap = [&](const std::vector<void *> &h, QudaFieldLocation location, size_t begin, size_t size) {
+    std::vector<ColorSpinorField> v(size);
+    cpuParam.location = location;
+    for (auto i = 0u; i < size; i++) {
+      cpuParam.v = h[begin + i];
+      v[i] = ColorSpinorField(cpuParam);
+    }
+    return v;
+  };
+
+  auto upload = [&](std::vector<ColorSpinorField> &in, size_t begin) {
+    auto size = std::min(batch, n_src - begin);
+    resize(in, size, cudaParam);
+    auto h = wrap(h_in, in_location, begin, size);
+    blas::copy(in, h);
+  };
+
+  std::vector<ColorSpinorField> in[2];
+  std::vector<ColorSpinorField> out;
+  upload(in[0], 0);
+
+  for (size_t begin = 0, k = 0; begin < n_src; begin += batch, k ^= 1) {
+    resize(out, in[k].size(), cudaParam);
+    smear(out, in[k]);
+
+    if (begin + batch < n_src) upload(in[k ^ 1], begin + batch);
+
+    auto h = wrap(h_out, out_location, begin, out.size());
+    blas::copy(h, out);
+  }
+}
+
+/**
+   @brief Wuppertal smearing of a set of host sources, see performWuppertalnStep
+ */
+static void wuppertalSmear(const std::vector<void *> &h_out, const std::vector<void *> &h_in, QudaInvertParam *inv_param,
+                           unsigned int n_steps, double alpha)
 {
   auto profile = pushProfile(profileWuppertal);
   pushVerbosity(inv_param->verbosity);
@@ -4968,17 +5580,8 @@ void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *inv_param,
     precise = gaugePrecise;
   }
 
-  ColorSpinorParam cpuParam(h_in, *inv_param, precise->X(), false, inv_param->input_location);
-  ColorSpinorField in_h(cpuParam);
-
+  ColorSpinorParam cpuParam(h_in[0], *inv_param, precise->X(), false, inv_param->input_location);
   ColorSpinorParam cudaParam(cpuParam, *inv_param, QUDA_CUDA_FIELD_LOCATION);
-  ColorSpinorField in(cudaParam);
-  in = in_h;
-
-  logQuda(QUDA_DEBUG_VERBOSE, "In CPU %e CUDA %e\n", blas::norm2(in_h), blas::norm2(in));
-
-  cudaParam.create = QUDA_NULL_FIELD_CREATE;
-  ColorSpinorField out(cudaParam);
   int parity = 0;
 
   // Computes out(x) = 1/(1+6*alpha)*(in(x) + alpha*\sum_mu (U_{-\mu}(x)in(x+mu) + U^\dagger_mu(x-mu)in(x-mu)))
@@ -4992,25 +5595,38 @@ void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *inv_param,
     if (i == 3) comm_dim[i] = 0;
   }
 
-  for (unsigned int i = 0; i < n_steps; i++) {
-    if (i) in = out;
-    ApplyLaplace(out, in, *precise, 3, a, b, in, parity, comm_dim, profileWuppertal);
-    logQuda(QUDA_DEBUG_VERBOSE, "Step %d, vector norm %e\n", i, blas::norm2(out));
-  }
-
-  cpuParam.v = h_out;
-  cpuParam.location = inv_param->output_location;
-  ColorSpinorField out_h(cpuParam);
-  out_h = out;
+  auto smear = [&](std::vector<ColorSpinorField> &out, std::vector<ColorSpinorField> &in) {
+    for (unsigned int i = 0; i < n_steps; i++) {
+      if (i) std::swap(in, out);
+      ApplyLaplace(out, in, *precise, 3, a, b, in, parity, comm_dim, profileWuppertal);
+      logQuda(QUDA_DEBUG_VERBOSE, "Step %d, vector norm %e\n", i, blas::norm2(out[0]));
+    }
+  };
 
-  logQuda(QUDA_DEBUG_VERBOSE, "Out CPU %e CUDA %e\n", blas::norm2(out_h), blas::norm2(out));
+  smearMultiSrc(h_out, h_in, cpuParam, inv_param->input_location, inv_param->output_location, cudaParam, smear);
 
   if (gaugeSmeared != nullptr) delete precise;
 
   popVerbosity();
 }
 
-void performTwoLinkGaussianSmearNStep(void *h_in, QudaQuarkSmearParam *smear_param)
+void performWuppertalnStep(void *h_out, void *h_in, QudaInvertParam *inv_param, unsigned int n_steps, double alpha)
+{
+  wuppertalSmear({h_out}, {h_in}, inv_param, n_steps, alpha);
+}
+
+void performWuppertalnStepMultiSrc(void **h_out, void **h_in, int n_src, QudaInvertParam *inv_param,
+                                   unsigned int n_steps, double alpha)
+{
+  if (n_src <= 0) errorQuda("Invalid number of sources %d", n_src);
+  wuppertalSmear({h_out, h_out + n_src}, {h_in, h_in + n_src}, inv_param, n_steps, alpha);
+}
+
+/**
+   @brief Two-link Gaussian smearing of a set of host sources, see
+   performTwoLinkGaussianSmearNStep
+ */
+static void twoLinkGaussianSmear(const std::vector<void *> &h_in, QudaQuarkSmearParam *smear_param)
 {
   if (smear_param->n_steps == 0) return;
   auto profile = pushProfile(profileGaussianSmear, smear_param);
@@ -5055,18 +5671,13 @@ void performTwoLinkGaussianSmearNStep(void *h_in, QudaQuarkSmearParam *smear_par
 
   inv_param->dslash_type = QUDA_ASQTAD_DSLASH;
 
-  ColorSpinorParam cpuParam(h_in, *inv_param, X, QUDA_MAT_SOLUTION, QUDA_CPU_FIELD_LOCATION);
+  ColorSpinorParam cpuParam(h_in[0], *inv_param, X, QUDA_MAT_SOLUTION, QUDA_CPU_FIELD_LOCATION);
   cpuParam.nSpin = 1;
-  // QUDA style pointer for host data.
-  ColorSpinorField in_h(cpuParam);
 
   // Device side data.
   ColorSpinorParam cudaParam(cpuParam);
   cudaParam.location = QUDA_CUDA_FIELD_LOCATION;
-  cudaParam.create   = QUDA_ZERO_FIELD_CREATE;
   cudaParam.setPrecision(inv_param->cuda_prec, inv_param->cuda_prec, true);
-  ColorSpinorField in(cudaParam);
-  ColorSpinorField out(cudaParam);
 
   // Create the smearing operator
   //------------------------------------------------------
@@ -5096,9 +5707,6 @@ void performTwoLinkGaussianSmearNStep(void *h_in, QudaQuarkSmearParam *smear_par
   Dirac &dirac = *d;
   DiracM qsmear_op(dirac);
 
-  // Copy host data to device
-  in = in_h;
-
   const double ftmp    = -(smear_param->width*smear_param->width)/(4.0*smear_param->n_steps*4.0);  /* Extra 4 to compensate for stride 2 */
   // Scale up the source to prevent underflow
   profileGaussianSmear.TPSTART(QUDA_PROFILE_COMPUTE);
@@ -5106,24 +5714,38 @@ void performTwoLinkGaussianSmearNStep(void *h_in, QudaQuarkSmearParam *smear_par
   const double msq = 1. / ftmp;
   const double a       = inv_param->laplace3D * 2.0 + msq;
   const QudaParity  parity   = QUDA_INVALID_PARITY;
-  for (int i = 0; i < smear_param->n_steps; i++) {
-    if (i > 0) std::swap(in, out);
 
-    qsmear_op.Expose()->SmearOp(out, in, a, 0.0, smear_param->t0, parity);
-    logQuda(QUDA_DEBUG_VERBOSE, "Step %d, vector norm %e\n", i, blas::norm2(out));
-    blas::axpby(a * ftmp, in, -ftmp, out);
-  }
+  auto smear = [&](std::vector<ColorSpinorField> &out, std::vector<ColorSpinorField> &in) {
+    for (int i = 0; i < smear_param->n_steps; i++) {
+      if (i > 0) std::swap(in, out);
 
-  profileGaussianSmear.TPSTOP(QUDA_PROFILE_COMPUTE);
+      qsmear_op.Expose()->SmearOp(out, in, a, 0.0, smear_param->t0, parity);
+      logQuda(QUDA_DEBUG_VERBOSE, "Step %d, vector norm %e\n", i, blas::norm2(out[0]));
+      blas::axpby(a * ftmp, in, -ftmp, out);
+    }
+  };
 
-  // Copy device data to host.
-  in_h = out;
+  // the sources are smeared in place
+  smearMultiSrc(h_in, h_in, cpuParam, QUDA_CPU_FIELD_LOCATION, QUDA_CPU_FIELD_LOCATION, cudaParam, smear);
+
+  profileGaussianSmear.TPSTOP(QUDA_PROFILE_COMPUTE);
 
   delete d;
 
   if (smear_param->delete_2link != 0) { freeUniqueGaugeQuda(QUDA_SMEARED_LINKS); }
 }
 
+void performTwoLinkGaussianSmearNStep(void *h_in, QudaQuarkSmearParam *smear_param)
+{
+  twoLinkGaussianSmear({h_in}, smear_param);
+}
+
+void performTwoLinkGaussianSmearNStepMultiSrc(void **h_in, int n_src, QudaQuarkSmearParam *smear_param)
+{
+  if (n_src <= 0) errorQuda("Invalid number of sources %d", n_src);
+  twoLinkGaussianSmear({h_in, h_in + n_src}, smear_param);
+}
+
 void performGaugeSmearQuda(QudaGaugeSmearParam *smear_param, QudaGaugeObservableParam *obs_param)
 {
   auto profile = pushProfile(profileGaugeSmear);
@@ -5208,20 +5830,121 @@ void performWFlowQuda(QudaGaugeSmearParam *smear_param, QudaGaugeObservableParam
   logQuda(QUDA_SUMMARIZE, "%le %.16e %+.16e %+.16e %+.16e %+.16e\n", smear_param->t0, obs_param[0].plaquette[0],
           obs_param[0].energy[0], obs_param[0].energy[1], obs_param[0].energy[2], obs_param[0].qcharge);
 
-  for (unsigned int i = 0; i < smear_param->n_steps; i++) {
+  // With a non-zero tolerance the step size is adapted to keep the
+  // local error of each step below flow_tol, with steps clipped so
+  // that measurements are taken at the same flow times as for the
+  // fixed step size integrator
+  const bool adaptive = smear_param->flow_tol > 0.0;
+  const double t_end = smear_param->t0 + smear_param->n_steps * smear_param->epsilon;
+  const double t_meas = smear_param->meas_interval * smear_param->epsilon;
+  double t = smear_param->t0;
+  double epsilon = smear_param->epsilon;
+  unsigned int n_reject = 0;
+
+  // The W2 step overwrites the input, so keep a copy to restart rejected steps
+  std::unique_ptr<GaugeField> gaugeBackup = adaptive ? std::make_unique<GaugeField>(gParamEx) : nullptr;
+  std::unique_ptr<GaugeField> gaugeError = adaptive ? std::make_unique<GaugeField>(gParam) : nullptr;
+
+  // The scale condition is evaluated after every step, with the crossing interpolated linearly
+  const bool scale = smear_param->scale_type != QUDA_FLOW_SCALE_NONE;
+  QudaGaugeObservableParam scale_param = newQudaGaugeObservableParam();
+  scale_param.compute_qcharge = QUDA_BOOLEAN_TRUE;
+  smear_param->scale_t = 0.0;
+  double t_prev = t; // flow time at which f_prev was evaluated
+  double f_prev = 0.0;
+  double w_prev = 0.0;
+  double t_mid_prev = 0.0;
+  bool w_valid = false; // t d/dt t^2 <E> needs two steps
+  if (scale) {
+    gaugeObservables(in, scale_param);
+    f_prev = t * t * scale_param.energy[0];
+  }
+
+  bool accepted = false;
+  const int n_meas = smear_param->n_steps / smear_param->meas_interval;
+  for (unsigned int i = 0; adaptive ? t_end - t > 1e-12 * smear_param->epsilon : i < smear_param->n_steps;) {
     // Perform W1, W2, and Vt Wilson Flow steps as defined in
     // https://arxiv.org/abs/1006.4518v3
-    if (i > 0) std::swap(in, out); // output from prior step becomes input for next step
-    WFlowStep(out, gaugeTemp, in, smear_param->epsilon, smear_param->smear_type);
+    if (accepted) std::swap(in, out); // output from prior step becomes input for next step
+
+    bool measure = (i + 1) % smear_param->meas_interval == 0;
+    bool clipped = false;
+    double h = epsilon;
+    double t_stop = t_end;
+    if (adaptive) {
+      if (measurement_n < n_meas) t_stop = smear_param->t0 + (measurement_n + 1) * t_meas;
+      clipped = t_stop - t <= epsilon;
+      h = clipped ? t_stop - t : epsilon;
+      measure = clipped && measurement_n < n_meas;
+
+      gaugeBackup->copy(in);
+      double dist = WFlowStepAdaptive(out, gaugeTemp, in, *gaugeError, h, smear_param->smear_type);
+
+      // step size for a third-order local error, see https://arxiv.org/abs/1301.4388
+      double h_new = dist > 0.0 ? h * std::min(0.95 * std::cbrt(smear_param->flow_tol / dist), 2.0) : 2.0 * h;
+      logQuda(QUDA_DEBUG_VERBOSE, "t = %e step %e distance %e next step %e\n", t, h, dist, h_new);
+
+      if (dist > smear_param->flow_tol) {
+        if (h_new < 1e-8 * smear_param->epsilon) errorQuda("Flow step size %e underflow at t = %e", h_new, t);
+        epsilon = h_new;
+        n_reject++;
+        accepted = false;
+        in.copy(*gaugeBackup);
+        in.exchangeExtendedGhost(in.R(), false);
+        continue;
+      }
+      if (!clipped || h_new < epsilon) epsilon = h_new; // a clipped step may understate the natural step size
+    } else {
+      WFlowStep(out, gaugeTemp, in, h, smear_param->smear_type);
+    }
+    accepted = true;
+    if (adaptive)
+      t = clipped ? t_stop : t + h;
+    else
+      t = smear_param->t0 + smear_param->epsilon * (i + 1);
+    i++;
 
-    if ((i + 1) % smear_param->meas_interval == 0) {
+    if (measure) {
       measurement_n++; // increment measurements.
       gaugeObservables(out, obs_param[measurement_n]);
-      logQuda(QUDA_SUMMARIZE, "%le %.16e %+.16e %+.16e %+.16e %+.16e\n", (smear_param->t0 + smear_param->epsilon * (i + 1)),
-              obs_param[measurement_n].plaquette[0], obs_param[measurement_n].energy[0],
-              obs_param[measurement_n].energy[1], obs_param[measurement_n].energy[2], obs_param[measurement_n].qcharge);
+      logQuda(QUDA_SUMMARIZE, "%le %.16e %+.16e %+.16e %+.16e %+.16e\n", t, obs_param[measurement_n].plaquette[0],
+              obs_param[measurement_n].energy[0], obs_param[measurement_n].energy[1],
+              obs_param[measurement_n].energy[2], obs_param[measurement_n].qcharge);
+    }
+
+    if (scale) {
+      gaugeObservables(out, scale_param);
+      double f = t * t * scale_param.energy[0];
+      double target = smear_param->scale_target;
+
+      if (smear_param->scale_type == QUDA_FLOW_SCALE_T0) {
+        if (f_prev < target && f >= target)
+          smear_param->scale_t = t_prev + (target - f_prev) / (f - f_prev) * (t - t_prev);
+      } else {
+        // t d/dt t^2 <E> at the midpoint of the step
+        double t_mid = 0.5 * (t + t_prev);
+        double w = t_mid * (f - f_prev) / (t - t_prev);
+        if (w_valid && w_prev < target && w >= target)
+          smear_param->scale_t = t_mid_prev + (target - w_prev) / (w - w_prev) * (t_mid - t_mid_prev);
+        w_prev = w;
+        t_mid_prev = t_mid;
+        w_valid = true;
+      }
+      t_prev = t;
+      f_prev = f;
+
+      if (smear_param->scale_t > 0.0) {
+        logQuda(QUDA_SUMMARIZE, "Flow scale %s reached at t = %.16e\n",
+                smear_param->scale_type == QUDA_FLOW_SCALE_T0 ? "t0" : "w0^2", smear_param->scale_t);
+        break;
+      }
     }
   }
+
+  if (adaptive) logQuda(QUDA_VERBOSE, "Adaptive flow reached t = %e with %u rejected steps\n", t, n_reject);
+  if (scale && smear_param->scale_t == 0.0)
+    warningQuda("Flow scale target %e not reached by t = %e", smear_param->scale_target, t);
+
   // copy out to gaugeSmeared so that flowed gauge can be saved to host and WFlow can be restarted 
   copyExtendedGauge(*gaugeSmeared, out, QUDA_CUDA_FIELD_LOCATION);
   gaugeSmeared->exchangeExtendedGhost( gaugeSmeared->R() );
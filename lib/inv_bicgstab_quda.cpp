@@ -93,7 +93,8 @@ namespace quda {
 
     if (param.deflate) {
       // Construct the eigensolver and deflation space if requested.
-      if (param.eig_param.eig_type == QUDA_EIG_TR_LANCZOS || param.eig_param.eig_type == QUDA_EIG_BLK_TR_LANCZOS) {
+      if (param.eig_param.eig_type == QUDA_EIG_TR_LANCZOS || param.eig_param.eig_type == QUDA_EIG_BLK_TR_LANCZOS
+          || param.eig_param.eig_type == QUDA_EIG_CHEB_FILTERED_SUBSPACE) {
         constructDeflationSpace(b[0], matMdagM);
       } else {
         // Use Arnoldi to inspect the space only and turn off deflation
@@ -110,6 +111,7 @@ namespace quda {
           eig_solve->computeSVD(evecs, evals);
         }
         deflate_compute = false;
+        compressDeflationSpace();
       }
       if (recompute_evals) {
         eig_solve->computeEvals(evecs, evals);
@@ -280,6 +280,7 @@ namespace quda
         (*eig_solve)(evecs, evals);
         if (!param.is_preconditioner) getProfile().TPSTART(QUDA_PROFILE_PREAMBLE);
         deflate_compute = false;
+        compressDeflationSpace();
       }
       if (recompute_evals) {
         eig_solve->computeEvals(evecs, evals);
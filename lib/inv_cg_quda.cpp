@@ -16,6 +16,7 @@
 
 #include <reliable_updates.h>
 #include <invert_x_update.h>
+#include <checkpoint.h>
 
 namespace quda {
 
@@ -119,6 +120,7 @@ namespace quda {
         (*eig_solve)(evecs, evals);
         if (!param.is_preconditioner) getProfile().TPSTART(QUDA_PROFILE_INIT);
         deflate_compute = false;
+        compressDeflationSpace();
       }
       if (recompute_evals) {
         eig_solve->computeEvals(evecs, evals);
@@ -126,6 +128,33 @@ namespace quda {
       }
     }
 
+    // resume from a checkpoint of this solve if one exists: the
+    // solution is restored into y, and the search direction into p
+    std::string checkpoint_key;
+    vector<double> r2_old_checkpoint(b.size(), 0.0);
+    int k_checkpoint = 0;
+    bool restored = false;
+    if (advanced_feature && param.checkpoint && !param.is_preconditioner) {
+      checkpoint_key = checkpoint::key("cg");
+      std::vector<double> meta; // iteration count, source norms, previous residual norms
+      auto n = checkpoint::load(checkpoint_key, vector_ref<ColorSpinorField>(y, p), meta);
+      restored = n == 2 * static_cast<int>(b.size()) && meta.size() == 1 + 2 * b.size();
+      for (auto i = 0u; restored && i < b.size(); i++)
+        if (std::abs(meta[1 + i] - b2[i]) > 1e-10 * b2[i]) restored = false;
+
+      if (restored) {
+        k_checkpoint = meta[0];
+        for (auto i = 0u; i < b.size(); i++) r2_old_checkpoint[i] = meta[1 + b.size() + i];
+        blas::copy(x, y);
+        logQuda(QUDA_SUMMARIZE, "CG: resuming from checkpoint %s at iteration %d\n", checkpoint_key.c_str(),
+                k_checkpoint);
+      } else if (n >= 0) {
+        warningQuda("Ignoring checkpoint %s since it does not match this solve", checkpoint_key.c_str());
+      }
+    }
+    cvector_ref<const ColorSpinorField> p_start = restored ? vector_ref<const ColorSpinorField>(p) : p_init;
+    cvector<double> &r2_old_start = restored ? r2_old_checkpoint : r2_old_init;
+
     const double u = precisionEpsilon(param.precision_sloppy);
     const double uhigh = precisionEpsilon(); // solver precision
 
@@ -141,7 +170,7 @@ namespace quda {
 
     // compute initial residual
     vector<double> r2(b2.size(), 0.0);
-    if (advanced_feature && param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+    if (advanced_feature && (param.use_init_guess == QUDA_USE_INIT_GUESS_YES || restored)) {
       // Compute r = b - A * x
       mat(r, x);
       r2 = blas::xmyNorm(b, r);
@@ -169,13 +198,13 @@ namespace quda {
     auto csParam(r_sloppy[0]);
     std::vector<XUpdateBatch> x_update_batch(b.size());
     for (auto i = 0u; i < b.size(); i++)
-      x_update_batch[i] = XUpdateBatch(Np, !p_init[i].empty() ? p_init[i] : r_sloppy[i], csParam);
+      x_update_batch[i] = XUpdateBatch(Np, !p_start[i].empty() ? p_start[i] : r_sloppy[i], csParam);
 
     vector<double> r2_old(r2.size(), 0.0);
     for (auto i = 0u; i < b.size(); i++) {
-      if (r2_old_init[i] != 0.0 and !p_init[i].empty()) {
+      if (r2_old_start[i] != 0.0 and !p_start[i].empty()) {
         // FIXME vectorize this
-        r2_old[i] = r2_old_init[i];
+        r2_old[i] = r2_old_start[i];
         Complex rp = blas::cDotProduct(r_sloppy[i], x_update_batch[i].get_current_field()) / (r2[i]);
         blas::caxpy(-rp, r_sloppy[i], x_update_batch[i].get_current_field());
         beta[i] = r2[i] / r2_old[i];
@@ -197,7 +226,8 @@ namespace quda {
       getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
     }
 
-    int k = 0;
+    int k = k_checkpoint;
+    int k_saved = k_checkpoint;
 
     PrintStats("CG", k, r2, b2);
 
@@ -217,6 +247,22 @@ namespace quda {
 
     ReliableUpdates ru(ru_params, r2[0]);
 
+    // the adaptive policy may apply the sloppy operator at the
+    // preconditioner precision, converting the sloppy vectors around
+    // each application
+    std::unique_ptr<AdaptiveReliable> adaptive;
+    std::vector<ColorSpinorField> p_low;
+    std::vector<ColorSpinorField> Ap_low;
+    if (advanced_feature && param.use_adaptive_reliable && !alternative_reliable && param.delta > 0.0) {
+      std::vector<QudaPrecision> precision = {param.precision_sloppy};
+      auto gauge_precon = matPrecon.Expose()->getGaugeField();
+      if (!param.is_preconditioner && param.schwarz_type == QUDA_INVALID_SCHWARZ
+          && param.precision_precondition < param.precision_sloppy && gauge_precon
+          && gauge_precon->Precision() == param.precision_precondition)
+        precision.insert(precision.begin(), param.precision_precondition);
+      adaptive = std::make_unique<AdaptiveReliable>(precision, param.delta);
+    }
+
     auto get_p = [](std::vector<XUpdateBatch> &x_update_batch, bool next = false) {
       vector_ref<ColorSpinorField> p;
       p.reserve(x_update_batch.size());
@@ -234,7 +280,21 @@ namespace quda {
     while ( !converged && k < param.maxiter ) {
       auto p = get_p(x_update_batch);
       auto p_next = get_p(x_update_batch, true);
-      matSloppy(Ap, p);
+      if (adaptive && adaptive->current() != param.precision_sloppy) {
+        if (p_low.empty()) {
+          ColorSpinorParam low_param(r_sloppy[0]);
+          low_param.create = QUDA_NULL_FIELD_CREATE;
+          low_param.setPrecision(adaptive->current());
+          resize(p_low, b.size(), low_param);
+          resize(Ap_low, b.size(), low_param);
+        }
+        blas::copy(p_low, p);
+        matPrecon(Ap_low, p_low);
+        blas::copy(Ap, Ap_low);
+      } else {
+        matSloppy(Ap, p);
+      }
+      if (adaptive) adaptive->step();
 
       vector<double> sigma(b.size());
 
@@ -339,6 +399,11 @@ namespace quda {
         mat(r, y);       //  here we can use x as tmp
         r2 = blas::xmyNorm(b, r);
 
+        if (adaptive) {
+          adaptive->update(ru.rNorm, sqrt(r2[0]));
+          ru.update_delta(adaptive->delta);
+        }
+
         if (param.deflate && sqrt(r2[0]) < ru.maxr_deflate * param.tol_restart) {
           // Deflate and accumulate to solution vector
           eig_solve->deflate(y, r, evecs, evals, true);
@@ -369,6 +434,16 @@ namespace quda {
         for (auto i = 0u; i < b.size(); i++) rp[i] /= r2[i];
         blas::caxpy(-rp, r_sloppy, p);
 
+        // snapshot the state needed to resume from here: on restart
+        // p is re-orthogonalized against the recomputed residual
+        if (!checkpoint_key.empty() && k + 1 - k_saved >= checkpoint::interval()) {
+          std::vector<double> meta = {static_cast<double>(k + 1)};
+          meta.insert(meta.end(), b2.begin(), b2.end());
+          meta.insert(meta.end(), r2_old.begin(), r2_old.end());
+          checkpoint::save(checkpoint_key, vector_ref<const ColorSpinorField>(y, p), meta);
+          k_saved = k + 1;
+        }
+
         for (auto i = 0u; i < beta.size(); i++) beta[i] = r2[i] / r2_old[i];
         blas::xpayz(r_sloppy, beta, p, p_next);
 
@@ -399,6 +474,8 @@ namespace quda {
     blas::copy(x, x_sloppy);
     blas::xpy(y, x);
 
+    if (!checkpoint_key.empty()) checkpoint::remove(checkpoint_key);
+
     if (!param.is_preconditioner) {
       getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
       getProfile().TPSTART(QUDA_PROFILE_EPILOGUE);
@@ -410,6 +487,16 @@ namespace quda {
 
     logQuda(QUDA_VERBOSE, "CG: Reliable updates = %d\n", ru.rUpdate);
 
+    if (adaptive) {
+      param.adaptive_iter_low += adaptive->iter_low();
+      param.adaptive_switches += adaptive->switches;
+      param.adaptive_delta = adaptive->delta;
+      param.adaptive_max_gap = std::max(param.adaptive_max_gap, adaptive->max_gap);
+      logQuda(QUDA_VERBOSE,
+              "CG: Adaptive reliable updates: %d iterations at reduced precision, %d switches, delta = %e, max gap = %e\n",
+              adaptive->iter_low(), adaptive->switches, adaptive->delta, adaptive->max_gap);
+    }
+
     if (advanced_feature && param.compute_true_res) {
       // compute the true residuals
       mat(r, x);
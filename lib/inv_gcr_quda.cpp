@@ -10,6 +10,8 @@
 #include <invert_quda.h>
 #include <util_quda.h>
 #include <color_spinor_field.h>
+#include <checkpoint.h>
+#include <telemetry.h>
 
 #include <sys/time.h>
 
@@ -205,7 +207,8 @@ namespace quda {
     getProfile().TPSTART(QUDA_PROFILE_INIT);
     if (param.deflate) {
       // Construct the eigensolver and deflation space if requested.
-      if (param.eig_param.eig_type == QUDA_EIG_TR_LANCZOS || param.eig_param.eig_type == QUDA_EIG_BLK_TR_LANCZOS) {
+      if (param.eig_param.eig_type == QUDA_EIG_TR_LANCZOS || param.eig_param.eig_type == QUDA_EIG_BLK_TR_LANCZOS
+          || param.eig_param.eig_type == QUDA_EIG_CHEB_FILTERED_SUBSPACE) {
         constructDeflationSpace(b[0], matMdagM);
       } else {
         // Use Arnoldi to inspect the space only and turn off deflation
@@ -222,6 +225,7 @@ namespace quda {
           eig_solve->computeSVD(evecs, evals);
         }
         deflate_compute = false;
+        compressDeflationSpace();
       }
       if (recompute_evals) {
         eig_solve->computeEvals(evecs, evals);
@@ -233,8 +237,30 @@ namespace quda {
     vector<double> b2 = blas::norm2(b); // norm sq of source
     vector<double> r2;                  // norm sq of residual
 
+    // resume from a checkpoint of this solve if one exists, using r as the staging field
+    std::string checkpoint_key;
+    int iter_checkpoint = 0;
+    bool restored = false;
+    if (param.checkpoint && !param.is_preconditioner) {
+      checkpoint_key = checkpoint::key("gcr");
+      std::vector<double> meta; // iteration count, source norms
+      auto n = checkpoint::load(checkpoint_key, r, meta);
+      restored = n == static_cast<int>(b.size()) && meta.size() == 1 + b.size();
+      for (auto i = 0u; restored && i < b.size(); i++)
+        if (std::abs(meta[1 + i] - b2[i]) > 1e-10 * b2[i]) restored = false;
+
+      if (restored) {
+        iter_checkpoint = meta[0];
+        blas::copy(x, r);
+        logQuda(QUDA_SUMMARIZE, "GCR: resuming from checkpoint %s at iteration %d\n", checkpoint_key.c_str(),
+                iter_checkpoint);
+      } else if (n >= 0) {
+        warningQuda("Ignoring checkpoint %s since it does not match this solve", checkpoint_key.c_str());
+      }
+    }
+
     // compute initial residual depending on whether we have an initial guess or not
-    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES || restored) {
       // Compute r = b - A * x
       mat(r, x);
       r2 = blas::xmyNorm(b, r);
@@ -288,7 +314,8 @@ namespace quda {
 
     blas::copy(r_sloppy, r);
 
-    int total_iter = 0;
+    int total_iter = iter_checkpoint;
+    int iter_saved = iter_checkpoint;
     int restart = 0;
     auto r2_old = r2;
     double maxr_deflate = sqrt(r2[0]);
@@ -393,6 +420,7 @@ namespace quda {
 
         if (!convergence(r2, heavy_quark_res, stop, stop_hq)) {
           restart++; // restarting if residual is still too great
+          telemetry::restart(r2);
 
           PrintStats("GCR (restart)", restart, r2, b2, heavy_quark_res);
           blas::copy(r_sloppy, r);
@@ -401,6 +429,14 @@ namespace quda {
 
           // prevent ending the Krylov space prematurely if other convergence criteria not met 
           if (r2 < stop) l2_converge = true;
+
+          // the Krylov space is empty at a restart so the solution is the full state
+          if (!checkpoint_key.empty() && total_iter - iter_saved >= checkpoint::interval()) {
+            std::vector<double> meta = {static_cast<double>(total_iter)};
+            meta.insert(meta.end(), b2.begin(), b2.end());
+            checkpoint::save(checkpoint_key, x, meta);
+            iter_saved = total_iter;
+          }
         }
 
         r2_old = r2;
@@ -410,6 +446,8 @@ namespace quda {
     getProfile().TPSTOP(QUDA_PROFILE_COMPUTE);
     getProfile().TPSTART(QUDA_PROFILE_EPILOGUE);
 
+    if (!checkpoint_key.empty()) checkpoint::remove(checkpoint_key);
+
     if (k >= param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
 
     logQuda(QUDA_VERBOSE, "GCR: number of restarts = %d\n", restart);
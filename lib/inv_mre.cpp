@@ -134,20 +134,255 @@ namespace quda
     getProfile().TPSTOP(QUDA_PROFILE_CHRONO);
   }
 
-  void chronoExtrapolate(ColorSpinorField &x, const ColorSpinorField &b, std::vector<ColorSpinorField> &basis,
-                         DiracMatrix &m, bool hermitian)
+  namespace
+  {
+    /**
+       @return The relative rounding error of a given precision
+     */
+    double chronoEpsilon(QudaPrecision precision)
+    {
+      switch (precision) {
+      case QUDA_DOUBLE_PRECISION: return std::numeric_limits<double>::epsilon() / 2.;
+      case QUDA_SINGLE_PRECISION: return std::numeric_limits<float>::epsilon() / 2.;
+      case QUDA_HALF_PRECISION: return std::pow(2., -13);
+      case QUDA_QUARTER_PRECISION: return std::pow(2., -6);
+      default: errorQuda("Invalid precision %d", precision);
+      }
+      return 0.0;
+    }
+  } // namespace
+
+  void ChronoHistory::clear()
+  {
+    p.clear();
+    q.clear();
+    valid.clear();
+    probe.clear();
+    G.clear();
+  }
+
+  void ChronoHistory::add(cvector_ref<const ColorSpinorField> &x, int max_dim, QudaPrecision precision, bool replace_last)
+  {
+    if (max_dim < (int)p.size())
+      errorQuda("Requested chrono_max_dim %i is smaller than already existing chronology %lu", max_dim, p.size());
+    if (p.size() > 0 && p[0].Precision() != precision) clear();
+
+    // the replaced entries and those beyond max_dim drop out of the history
+    const int N = p.size();
+    const int n = std::min(static_cast<int>(x.size()), max_dim);
+    const int first = replace_last ? std::min(n, N) : 0;
+    const int n_keep = std::min(N - first, max_dim - n);
+    const int M = n + n_keep;
+
+    std::vector<ColorSpinorField> recycle;
+    for (int i = 0; i < N; i++)
+      if (i < first || i >= first + n_keep) recycle.push_back(std::move(p[i]));
+
+    std::vector<ColorSpinorField> p_new(M);
+    std::vector<ColorSpinorField> q_new(M);
+    std::vector<bool> valid_new(M, false);
+    std::vector<double4> probe_new(M);
+    std::vector<Complex> G_new(M * M, 0.0);
+
+    ColorSpinorParam param(x[0]);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(precision);
+    for (int k = 0; k < n; k++) {
+      if (k < (int)recycle.size())
+        p_new[k] = std::move(recycle[k]);
+      else
+        p_new[k] = ColorSpinorField(param);
+      p_new[k] = x[k];
+    }
+
+    // the Gram matrix of the entries we keep is unchanged
+    for (int j = 0; j < n_keep; j++) {
+      p_new[n + j] = std::move(p[first + j]);
+      q_new[n + j] = std::move(q[first + j]);
+      valid_new[n + j] = valid[first + j];
+      probe_new[n + j] = probe[first + j];
+      for (int l = 0; l < n_keep; l++) G_new[(n + j) * M + n + l] = G[(first + j) * N + first + l];
+    }
+
+    p = std::move(p_new);
+    q = std::move(q_new);
+    valid = std::move(valid_new);
+    probe = std::move(probe_new);
+    G = std::move(G_new);
+  }
+
+  void ChronoHistory::extrapolate(cvector_ref<ColorSpinorField> &x, cvector_ref<const ColorSpinorField> &b,
+                                  const DiracMatrix &m, QudaPrecision precision, bool hermitian)
   {
     getProfile().TPSTART(QUDA_PROFILE_CHRONO);
 
-    ColorSpinorParam cs_param(basis[0]);
-    std::vector<ColorSpinorField> Ap(basis.size(), cs_param);
+    const int N = p.size();
+    const int n_rhs = b.size();
+    if (N == 0) {
+      blas::zero(x);
+      getProfile().TPSTOP(QUDA_PROFILE_CHRONO);
+      return;
+    }
+    if (p[0].Precision() > precision)
+      errorQuda("Chrono storage precision %d exceeds the operator precision %d", p[0].Precision(), precision);
+
+    if (hermitian != this->hermitian) {
+      // the Gram matrix is of the other form so must be recomputed
+      std::fill(valid.begin(), valid.end(), false);
+      if (hermitian)
+        for (auto &qi : q) qi = ColorSpinorField();
+      this->hermitian = hermitian;
+    }
+
+    // apply the operator to the entries without a current Gram
+    // matrix row, together with one valid entry that probes whether
+    // the operator has changed since its row was computed
+    std::vector<int> w;
+    int k = -1;
+    for (int i = 0; i < N; i++) {
+      if (!valid[i])
+        w.push_back(i);
+      else if (k < 0)
+        k = i;
+    }
+    if (k >= 0) w.push_back(k);
+
+    // entries stored at lower precision are copied to the operator precision
+    const bool copy = p[0].Precision() != precision;
+    ColorSpinorParam param(p[0]);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(precision);
+
+    std::vector<ColorSpinorField> p_tmp;
+    std::vector<ColorSpinorField> Ap;
+    p_tmp.reserve(copy ? N : 0);
+    Ap.reserve(N);
+    vector_ref<const ColorSpinorField> in;
+    std::vector<double4> w_probe;
+
+    auto apply = [&](size_t begin) {
+      for (auto j = begin; j < w.size(); j++) {
+        if (copy) {
+          p_tmp.emplace_back(param);
+          blas::copy(p_tmp.back(), p[w[j]]);
+          in.push_back(p_tmp.back());
+        } else {
+          in.push_back(p[w[j]]);
+        }
+        Ap.emplace_back(param);
+      }
+      if (begin == w.size()) return;
+
+      vector_ref<const ColorSpinorField> in_w {in.begin() + begin, in.end()};
+      vector_ref<ColorSpinorField> Ap_w {Ap.begin() + begin, Ap.end()};
+      m(Ap_w, in_w);
+      auto r = blas::cDotProductNormAB(in_w, Ap_w);
+      w_probe.insert(w_probe.end(), r.begin(), r.end());
+    };
 
-    m(Ap, basis);
+    apply(0);
+
+    if (k >= 0) {
+      const auto &r = w_probe.back();
+      const auto &s = probe[k];
+      const double tol = 16 * chronoEpsilon(precision);
+      bool changed = std::abs(Complex(r.x, r.y) - Complex(s.x, s.y)) > tol * sqrt(s.z * s.w)
+        || std::abs(r.w - s.w) > tol * s.w;
+
+      if (changed) {
+        logQuda(QUDA_DEBUG_VERBOSE, "Chrono operator has changed, recomputing the Gram matrix\n");
+        auto begin = w.size();
+        for (int i = 0; i < N; i++)
+          if (valid[i] && i != k) w.push_back(i);
+        std::fill(valid.begin(), valid.end(), false);
+        apply(begin);
+      } else {
+        w.pop_back();
+        w_probe.pop_back();
+        in.pop_back();
+        Ap.pop_back();
+        if (copy) p_tmp.pop_back();
+      }
+    }
+
+    const int nw = w.size();
+    if (nw > 0) {
+      if (!hermitian) {
+        for (int j = 0; j < nw; j++) {
+          if (q[w[j]].empty()) {
+            ColorSpinorParam q_param(p[w[j]]);
+            q_param.create = QUDA_NULL_FIELD_CREATE;
+            q[w[j]] = ColorSpinorField(q_param);
+          }
+          q[w[j]] = Ap[j];
+        }
+      }
+
+      // the new columns of the Gram matrix, using a single block reduction
+      std::vector<Complex> R(N * nw);
+      if (hermitian)
+        blas::block::cDotProduct(R, p, Ap); // (p_i, A p_j)
+      else
+        blas::block::cDotProduct(R, q, Ap); // (A p_i, A p_j)
+
+      std::vector<int> pos(N, -1);
+      for (int j = 0; j < nw; j++) pos[w[j]] = j;
+      for (int j = 0; j < nw; j++) {
+        for (int i = 0; i < N; i++) {
+          if (pos[i] < 0) {
+            G[i * N + w[j]] = R[i * nw + j];
+            G[w[j] * N + i] = conj(R[i * nw + j]);
+          } else {
+            // both entries are new: average the two estimates to keep the matrix Hermitian
+            G[i * N + w[j]] = 0.5 * (R[i * nw + j] + conj(R[w[j] * nw + pos[i]]));
+          }
+        }
+        valid[w[j]] = true;
+        probe[w[j]] = w_probe[j];
+      }
+    }
+
+    // the projected sources, P^dag b or (A P)^dag b
+    std::vector<Complex> phi_(N * n_rhs);
+    blas::block::cDotProduct(phi_, hermitian ? p : q, b);
+
+    getProfile().TPSTOP(QUDA_PROFILE_CHRONO);
+    getProfile().TPSTART(QUDA_PROFILE_EIGEN);
+
+    typedef Matrix<Complex, Dynamic, Dynamic> matrix;
+    matrix A(N, N);
+    matrix phi(N, n_rhs);
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) A(i, j) = G[i * N + j];
+      for (int r = 0; r < n_rhs; r++) phi(i, r) = phi_[i * n_rhs + r];
+    }
+
+    // the history is not orthogonalized, so we solve with the
+    // pseudo-inverse, dropping directions that are linearly
+    // dependent to within the storage precision
+    SelfAdjointEigenSolver<matrix> eigen(A);
+    const auto &lambda = eigen.eigenvalues();
+    const double cut = 16 * N * chronoEpsilon(p[0].Precision()) * lambda.cwiseAbs().maxCoeff();
+    Matrix<Complex, Dynamic, 1> lambda_inv(N);
+    int rank = 0;
+    for (int i = 0; i < N; i++) {
+      lambda_inv(i) = std::abs(lambda(i)) > cut ? 1.0 / lambda(i) : 0.0;
+      if (std::abs(lambda(i)) > cut) rank++;
+    }
+    matrix psi = eigen.eigenvectors() * (lambda_inv.asDiagonal() * (eigen.eigenvectors().adjoint() * phi));
+
+    getProfile().TPSTOP(QUDA_PROFILE_EIGEN);
+    getProfile().TPSTART(QUDA_PROFILE_CHRONO);
+
+    std::vector<Complex> alpha(N * n_rhs);
+    for (int i = 0; i < N; i++)
+      for (int r = 0; r < n_rhs; r++) alpha[i * n_rhs + r] = psi(i, r);
+
+    blas::zero(x);
+    blas::block::caxpy(alpha, p, x);
 
-    bool orthogonal = true;
-    bool apply_mat = false;
-    MinResExt mre(m, orthogonal, apply_mat, hermitian);
-    mre(x, b, basis, Ap);
+    logQuda(QUDA_VERBOSE, "Chrono forecast: N = %d, rank = %d, %d Gram matrix rows updated, %d right-hand sides\n", N,
+            rank, nw, n_rhs);
 
     getProfile().TPSTOP(QUDA_PROFILE_CHRONO);
   }
@@ -127,6 +127,7 @@ namespace quda
         // compute the deflation space.
         (*eig_solve)(evecs, evals);
         deflate_compute = false;
+        compressDeflationSpace();
       }
       if (recompute_evals) {
         eig_solve->computeEvals(evecs, evals);
@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <cstring>
 
 #include <multigrid.h>
 #include <tune_quda.h>
 #include <random_quda.h>
 #include <vector_io.h>
+#include <checkpoint.h>
+#include <gauge_tools.h>
 
 // for building the KD inverse op
 #include <staggered_kd_build_xinv.h>
@@ -28,6 +31,21 @@ namespace quda
     if (param.level >= QUDA_MAX_MG_LEVEL)
       errorQuda("Level=%d is greater than limit of multigrid recursion depth", param.level);
 
+    if (param.level < param.Nlevel - 1 && param.cycle_type != QUDA_MG_CYCLE_VCYCLE
+        && param.cycle_type != QUDA_MG_CYCLE_RECURSIVE && param.cycle_type != QUDA_MG_CYCLE_KCYCLE)
+      errorQuda("Multigrid cycle type %d not supported", param.cycle_type);
+
+    // only the coarse-grid operators have host implementations, so the fine grid must be resident on the device
+    if (param.level == 0 && param.location != QUDA_CUDA_FIELD_LOCATION)
+      errorQuda("Fine grid must be run on the device (location = %d)", param.location);
+
+    // the MMA (tensor core) kernels only have device implementations
+    if (param.location == QUDA_CPU_FIELD_LOCATION && (param.dslash_use_mma || param.transfer_use_mma))
+      errorQuda("MMA dslash (%d) and transfer (%d) are not supported on host level %d", param.dslash_use_mma,
+                param.transfer_use_mma, param.level);
+    if (param.setup_location == QUDA_CPU_FIELD_LOCATION && param.setup_use_mma && param.level < param.Nlevel - 1)
+      errorQuda("MMA coarse-operator setup is not supported with host setup on level %d", param.level);
+
     if (param.coarse_grid_solution_type == QUDA_MATPC_SOLUTION && param.smoother_solve_type != QUDA_DIRECT_PC_SOLVE)
       errorQuda("Cannot use preconditioned coarse grid solution without preconditioned smoother solve");
 
@@ -67,8 +85,18 @@ namespace quda
               loadVectors(param.B);
             } else if (param.mg_global.use_eig_solver[param.level]) {
               generateEigenVectors(); // Run the eigensolver
-            } else {
+            } else if (!checkpoint::enabled()) {
               generateNullVectors(param.B);
+            } else {
+              // reuse the null space from a checkpoint of an earlier run of this setup if one exists
+              null_checkpoint = checkpoint::key("mg_level" + std::to_string(param.level));
+              std::vector<double> meta;
+              auto expected = nullCheckpointMeta();
+              if (checkpoint::load(null_checkpoint, param.B, meta) != static_cast<int>(param.B.size())
+                  || !nullCheckpointMatch(meta, expected)) {
+                generateNullVectors(param.B);
+                checkpoint::save(null_checkpoint, param.B, expected);
+              }
             }
           }
         } else if (strcmp(param.mg_global.vec_infile[param.level], "")
@@ -101,12 +129,20 @@ namespace quda
     diracSmoother = param.matSmooth->Expose();
     diracSmootherSloppy = param.matSmoothSloppy->Expose();
 
+    // whether the null space has changed and the transfer operator needs rebuilding
+    bool refresh_transfer = refresh;
+
     // Only refresh if we needed to generate near-nulls, that is,
     // if we aren't doing a staggered KD solve
     if (param.level != 0 || param.transfer_type == QUDA_TRANSFER_AGGREGATE) {
       // Refresh the null-space vectors if we need to
       if (refresh && param.level < param.Nlevel - 1) {
-        if (param.mg_global.setup_maxiter_refresh[param.level]) generateNullVectors(param.B, refresh);
+        if (param.mg_global.setup_maxiter_refresh[param.level]) {
+          if (param.mg_global.setup_refresh_threshold[param.level] > 0.0)
+            refresh_transfer = refreshNullVectors(param.B);
+          else
+            generateNullVectors(param.B, refresh);
+        }
       }
     }
 
@@ -116,7 +152,7 @@ namespace quda
       if (transfer) {
         // restoring FULL parity in Transfer changed at the end of this procedure
         transfer->setSiteSubset(QUDA_FULL_SITE_SUBSET, QUDA_INVALID_PARITY);
-        if (resetTransfer || refresh) {
+        if (resetTransfer || refresh_transfer) {
           transfer->reset();
           resetTransfer = false;
         }
@@ -204,9 +240,9 @@ namespace quda
 
     // We're going back up the coarse construct stack now, prefetch the gauge fields on
     // this level back to device memory.
-    diracResidual->prefetch(QUDA_CUDA_FIELD_LOCATION);
-    diracSmoother->prefetch(QUDA_CUDA_FIELD_LOCATION);
-    diracSmootherSloppy->prefetch(QUDA_CUDA_FIELD_LOCATION);
+    diracResidual->prefetch(param.location);
+    diracSmoother->prefetch(param.location);
+    diracSmootherSloppy->prefetch(param.location);
 
     logQuda(QUDA_VERBOSE, "Setup of level %d done\n", param.level);
 
@@ -552,9 +588,9 @@ namespace quda
   void MG::destroyCoarseSolver() {
     pushLevel(param.level);
 
-    if (param.cycle_type == QUDA_MG_CYCLE_VCYCLE && param.level < param.Nlevel-2) {
+    if (!krylovCoarseSolver()) {
       // nothing to do
-    } else if (param.cycle_type == QUDA_MG_CYCLE_RECURSIVE || param.level == param.Nlevel-2) {
+    } else {
       if (coarse_solver) {
         auto &coarse_solver_inner = reinterpret_cast<PreconditionedSolver *>(coarse_solver)->ExposeSolver();
         // int defl_size = coarse_solver_inner.evecs.size();
@@ -571,8 +607,6 @@ namespace quda
         delete param_coarse_solver;
         param_coarse_solver = nullptr;
       }
-    } else {
-      errorQuda("Multigrid cycle type %d not supported", param.cycle_type);
     }
 
     popLevel();
@@ -583,14 +617,17 @@ namespace quda
 
     logQuda(QUDA_VERBOSE, "Creating coarse solver wrapper\n");
     destroyCoarseSolver();
-    if (param.cycle_type == QUDA_MG_CYCLE_VCYCLE && param.level < param.Nlevel-2) {
+    if (!krylovCoarseSolver()) {
       // if coarse solver is not a bottom solver and on the second to bottom level then we can just use the coarse solver as is
       coarse_solver = coarse;
       logQuda(QUDA_VERBOSE, "Assigned coarse solver to coarse MG operator\n");
-    } else if (param.cycle_type == QUDA_MG_CYCLE_RECURSIVE || param.level == param.Nlevel-2) {
+    } else {
 
       param_coarse_solver = new SolverParam(param);
       param_coarse_solver->inv_type = param.mg_global.coarse_solver[param.level + 1];
+      // the K-cycle needs a flexible outer solver since the coarse MG preconditioner varies between iterations
+      if (param.cycle_type == QUDA_MG_CYCLE_KCYCLE && param.level < param.Nlevel - 2)
+        param_coarse_solver->inv_type = QUDA_GCR_INVERTER;
       param_coarse_solver->is_preconditioner = false;
       param_coarse_solver->sloppy_converge = true; // this means we don't check the true residual before declaring convergence
       param_coarse_solver->return_residual = false; // coarse solver does need to return residual vector
@@ -601,6 +638,14 @@ namespace quda
       if (param.mg_global.use_eig_solver[param.Nlevel - 1] && (param.level == param.Nlevel - 2)) {
         param_coarse_solver->eig_param = *param.mg_global.eig_param[param.Nlevel - 1];
         param_coarse_solver->deflate = QUDA_BOOLEAN_TRUE;
+        // a deflation space carried across coarse solvers is reused
+        // with recomputed eigenvalues, so it is kept uncompressed on
+        // the device
+        if (param.mg_global.preserve_deflation) {
+          param_coarse_solver->eig_param.deflation_prec = QUDA_INVALID_PRECISION;
+          param_coarse_solver->eig_param.deflation_coherence_n_vec = 0;
+          param_coarse_solver->eig_param.deflation_location = QUDA_CUDA_FIELD_LOCATION;
+        }
         // Due to coherence between these levels, an initial guess
         // might be beneficial.
         if (param.mg_global.coarse_guess == QUDA_BOOLEAN_TRUE) {
@@ -710,8 +755,6 @@ namespace quda
       }
 
       logQuda(QUDA_VERBOSE, "Assigned coarse solver to preconditioned GCR solver\n");
-    } else {
-      errorQuda("Multigrid cycle type %d not supported", param.cycle_type);
     }
     logQuda(QUDA_VERBOSE, "Coarse solver wrapper done\n");
 
@@ -724,9 +767,10 @@ namespace quda
 
     if (param.level < param.Nlevel - 1) {
       if (coarse) delete coarse;
-      if (param.level == param.Nlevel-1 || param.cycle_type == QUDA_MG_CYCLE_RECURSIVE) {
-	if (coarse_solver) delete coarse_solver;
-	if (param_coarse_solver) delete param_coarse_solver;
+      // otherwise the coarse solver is the coarse MG itself
+      if (krylovCoarseSolver()) {
+        if (coarse_solver) delete coarse_solver;
+        if (param_coarse_solver) delete param_coarse_solver;
       }
 
       if (transfer) delete transfer;
@@ -748,9 +792,47 @@ namespace quda
     if (param_presmooth) delete param_presmooth;
     if (param_coarse) delete param_coarse;
 
+    // the null space snapshot only protects the lifetime of this setup
+    if (!null_checkpoint.empty()) checkpoint::remove(null_checkpoint);
+
     popLevel();
   }
 
+  std::vector<double> MG::nullCheckpointMeta() const
+  {
+    // version of the metadata layout below
+    constexpr double meta_version = 2.0;
+    std::vector<double> meta = {meta_version, static_cast<double>(param.B.size()),
+                                static_cast<double>(param.mg_global.num_setup_iter[param.level]),
+                                static_cast<double>(param.mg_global.setup_maxiter[param.level])};
+
+    // the null space depends on the fine-grid gauge field and parameters, so these identify the snapshot
+    const MG *finest = this;
+    while (finest->param.fine) finest = finest->param.fine;
+    auto dirac = finest->param.matResidual->Expose();
+    meta.insert(meta.end(), {dirac->Kappa(), dirac->Mass(), dirac->Mu()});
+
+    auto gauge = dirac->getGaugeField();
+    if (!gauge) errorQuda("Cannot checkpoint the null space of an operator without a gauge field");
+    lat_dim_t R;
+    for (int d = 0; d < 4; d++) R[d] = comm_dim_partitioned(d);
+    // the plaquette requires the neighbouring links, so is computed on an extended copy
+    std::unique_ptr<GaugeField> extended(createExtendedGauge(*gauge, R));
+    auto plaq = plaquette(*extended);
+    meta.insert(meta.end(), {static_cast<double>(gauge->Volume()) * comm_size(), plaq.x, plaq.y, plaq.z});
+
+    return meta;
+  }
+
+  bool MG::nullCheckpointMatch(const std::vector<double> &meta, const std::vector<double> &expected)
+  {
+    if (meta.size() != expected.size()) return false;
+    // the plaquette reduction need not be bitwise reproducible between runs
+    for (auto i = 0u; i < meta.size(); i++)
+      if (std::abs(meta[i] - expected[i]) > 1e-12 * std::max(1.0, std::abs(expected[i]))) return false;
+    return true;
+  }
+
   bool check_deviation(double deviation, double tol)
   {
     return (deviation > tol || std::isnan(deviation) || std::isinf(deviation));
@@ -1172,7 +1254,7 @@ namespace quda
     if ( inner_solution_type == QUDA_MATPC_SOLUTION && param.smoother_solve_type != QUDA_DIRECT_PC_SOLVE)
       errorQuda("For this coarse grid solution type, a preconditioned smoother is required");
 
-    if (param.level < param.Nlevel-1) {
+    if (param.level < param.Nlevel - 1) {
       // do the pre smoothing
       std::vector<ColorSpinorField> out(b.size()), in(b.size());
       diracSmoother->prepare(out, in, x, b, outer_solution_type);
@@ -1294,9 +1376,11 @@ namespace quda
     if (param.level < param.Nlevel - 2) coarse->dumpNullVectors();
   }
 
-  void MG::generateNullVectors(std::vector<ColorSpinorField> &B, bool refresh)
+  void MG::generateNullVectors(std::vector<ColorSpinorField> &B, bool refresh, const std::vector<bool> &active)
   {
     pushLevel(param.level);
+    host_timer_t setup_timer;
+    setup_timer.start();
 
     SolverParam solverParam(param); // Set solver field parameters:
     // set null-space generation options - need to expose these
@@ -1331,14 +1415,16 @@ namespace quda
     solverParam.residual_type = static_cast<QudaResidualType>(QUDA_L2_RELATIVE_RESIDUAL);
     solverParam.compute_null_vector = QUDA_COMPUTE_NULL_VECTOR_YES;
     ColorSpinorParam csParam(B[0]);                             // Create spinor field parameters:
-    csParam.setPrecision(r[0].Precision(), r[0].Precision(), true); // ensure native ordering
-    csParam.location = QUDA_CUDA_FIELD_LOCATION; // hard code to GPU location for null-space generation for now
+    csParam.location = param.location; // generate the null space where this level is run
+    csParam.setPrecision(r[0].Precision(), r[0].Precision(),
+                         csParam.location == QUDA_CUDA_FIELD_LOCATION); // native ordering on the device only
     csParam.gammaBasis = B[0].Nspin() == 1 ? QUDA_DEGRAND_ROSSI_GAMMA_BASIS :
                                              QUDA_UKQCD_GAMMA_BASIS; // degrand-rossi required for staggered
     csParam.create = QUDA_ZERO_FIELD_CREATE;
+    const int batch = nullSpaceBatchSize(B.size());
     std::vector<ColorSpinorField> b, x;
-    resize(b, param.n_vec_batch, csParam);
-    resize(x, param.n_vec_batch, csParam);
+    resize(b, batch, csParam);
+    resize(x, batch, csParam);
 
     csParam.create = QUDA_NULL_FIELD_CREATE;
 
@@ -1404,49 +1490,99 @@ namespace quda
         }
       }
 
-      // launch solver for each source
-      if (B.size() % param.n_vec_batch != 0) errorQuda("Bad batch size %d", param.n_vec_batch);
-      for (auto i = 0u; i < B.size(); i += param.n_vec_batch) {
+      if (!active.empty() && active.size() != B.size())
+        errorQuda("Active mask size %lu does not match number of vectors %lu", active.size(), B.size());
+
+      // gather the vectors to relax on this iteration
+      vector_ref<ColorSpinorField> relax;
+      std::vector<unsigned int> relax_idx;
+      for (auto i = 0u; i < B.size(); i++) {
+        if (!active.empty() && !active[i]) continue;
+        relax.push_back(B[i]);
+        relax_idx.push_back(i);
+      }
+
+      // with a single batch, mask out the vectors that are already near-null from subsequent setup iterations
+      const double mask_tol = param.mg_global.setup_mask_tol[param.level];
+      if (param.mg_global.setup_batch_all[param.level] == QUDA_BOOLEAN_TRUE && mask_tol > 0.0 && si > 0
+          && relax.size() > 0) {
+        auto residual = nullSpaceResidual(relax);
+        vector_ref<ColorSpinorField> unconverged;
+        std::vector<unsigned int> unconverged_idx;
+        for (auto i = 0u; i < relax.size(); i++) {
+          if (residual[i] < mask_tol) continue;
+          unconverged.push_back(relax[i]);
+          unconverged_idx.push_back(relax_idx[i]);
+        }
+        logQuda(QUDA_VERBOSE, "%lu of %lu null-space vectors converged, relaxing the remaining %lu\n",
+                relax.size() - unconverged.size(), relax.size(), unconverged.size());
+        relax.swap(unconverged);
+        relax_idx.swap(unconverged_idx);
+      }
+
+      // launch solver for each batch of sources
+      for (auto i = 0u; i < relax.size(); i += batch) {
+        const auto n = std::min(static_cast<size_t>(batch), relax.size() - i);
+        vector_ref<ColorSpinorField> xb {x.begin(), x.begin() + n};
+        vector_ref<ColorSpinorField> bb {b.begin(), b.begin() + n};
+        vector_ref<ColorSpinorField> Bb {relax.begin() + i, relax.begin() + i + n};
+
         if (param.mg_global.setup_type
             == QUDA_TEST_VECTOR_SETUP) { // DDalphaAMG test vector idea solving against the vector
-          copy({b.begin(), b.begin() + param.n_vec_batch}, {B.begin() + i, B.begin() + i + param.n_vec_batch});
-          zero(x); // with zero initial guess
+          copy(bb, Bb);
+          zero(xb); // with zero initial guess
         } else {
-          copy({x.begin(), x.begin() + param.n_vec_batch}, {B.begin() + i, B.begin() + i + param.n_vec_batch});
-          zero(b);
+          copy(xb, Bb);
+          zero(bb);
         }
 
         if (getVerbosity() >= QUDA_VERBOSE) {
-          auto nrm2 = norm2(x);
-          auto b2 = norm2(b);
-          for (auto j = 0; j < param.n_vec_batch; j++)
-            printfQuda("%d Initial guess = %g, Initial rhs = %g\n", i + j, nrm2[j], b2[j]);
+          auto nrm2 = norm2(xb);
+          auto b2 = norm2(bb);
+          for (auto j = 0u; j < n; j++)
+            printfQuda("%u Initial guess = %g, Initial rhs = %g\n", relax_idx[i + j], nrm2[j], b2[j]);
         }
 
-        std::vector<ColorSpinorField> out(param.n_vec_batch), in(param.n_vec_batch);
-        diracSmoother->prepare(out, in, x, b, QUDA_MAT_SOLUTION);
+        std::vector<ColorSpinorField> out(n), in(n);
+        diracSmoother->prepare(out, in, xb, bb, QUDA_MAT_SOLUTION);
         (*solve)(out, in);
-        diracSmoother->reconstruct(x, b, QUDA_MAT_SOLUTION);
+        diracSmoother->reconstruct(xb, bb, QUDA_MAT_SOLUTION);
 
         if (getVerbosity() >= QUDA_VERBOSE) {
-          auto nrm2 = norm2(x);
-          for (auto j = 0; j < param.n_vec_batch; j++) printfQuda("%d Solution = %g\n", i + j, nrm2[j]);
+          auto nrm2 = norm2(xb);
+          for (auto j = 0u; j < n; j++) printfQuda("%u Solution = %g\n", relax_idx[i + j], nrm2[j]);
         }
 
-        copy({B.begin() + i, B.begin() + i + param.n_vec_batch}, {x.begin(), x.begin() + param.n_vec_batch});
+        copy(Bb, xb);
       }
 
       // global orthonormalization of the generated null-space vectors
       if (param.mg_global.post_orthonormalize) {
-        for (auto i = 0u; i < B.size(); i++) {
-          for (auto j = 0u; j < i; j++) {
-            Complex alpha = cDotProduct(B[j], B[i]); // <j,i>
-            caxpy(-alpha, B[j], B[i]);               // i-<j,i>j
+        if (param.mg_global.setup_batch_all[param.level] == QUDA_BOOLEAN_TRUE) {
+          // block classical Gram-Schmidt, applied twice for stability, needs one block reduction per vector
+          for (auto i = 0u; i < B.size(); i++) {
+            for (int pass = 0; pass < (i > 0 ? 2 : 0); pass++) {
+              std::vector<Complex> alpha(i);
+              block::cDotProduct(alpha, {B.begin(), B.begin() + i}, B[i]);
+              for (auto &a : alpha) a = -a;
+              block::caxpy(alpha, {B.begin(), B.begin() + i}, B[i]);
+            }
+            double nrm2 = norm2(B[i]);
+            if (sqrt(nrm2) > 1e-16)
+              ax(1.0 / sqrt(nrm2), B[i]); // i/<i,i>
+            else errorQuda("\nCannot normalize %u vector (nrm=%e)\n", i, sqrt(nrm2));
+          }
+        } else {
+          for (auto i = 0u; i < B.size(); i++) {
+            for (auto j = 0u; j < i; j++) {
+              Complex alpha = cDotProduct(B[j], B[i]); // <j,i>
+              caxpy(-alpha, B[j], B[i]);               // i-<j,i>j
+            }
+            double nrm2 = norm2(B[i]);
+            if (sqrt(nrm2) > 1e-16)
+              ax(1.0 / sqrt(nrm2), B[i]); // i/<i,i>
+            else errorQuda("\nCannot normalize %u vector (nrm=%e)\n", i, sqrt(nrm2));
           }
-          double nrm2 = norm2(B[i]);
-          if (sqrt(nrm2) > 1e-16)
-            ax(1.0 / sqrt(nrm2), B[i]); // i/<i,i>
-          else errorQuda("\nCannot normalize %u vector (nrm=%e)\n", i, sqrt(nrm2));
         }
       }
 
@@ -1489,6 +1625,23 @@ namespace quda
       diracSmootherSloppy->setCommDim(commDim);
     }
 
+    // record the reference near-null residual of the vectors we have just relaxed for subsequent adaptive refreshes;
+    // a global orthonormalization also changes the vectors that were not relaxed, so then every reference is reset
+    if (param.mg_global.setup_refresh_threshold[param.level] > 0.0) {
+      auto residual = nullSpaceResidual(B);
+      bool orthonormalized = param.mg_global.pre_orthonormalize == QUDA_BOOLEAN_TRUE
+        || param.mg_global.post_orthonormalize == QUDA_BOOLEAN_TRUE;
+      if (null_residual.size() != B.size()) null_residual.resize(B.size());
+      for (auto i = 0u; i < B.size(); i++)
+        if (active.empty() || active[i] || orthonormalized) null_residual[i] = residual[i];
+    }
+
+    qudaDeviceSynchronize();
+    setup_timer.stop();
+    param.mg_global.null_space_secs[param.level] = setup_timer.last();
+    logQuda(QUDA_SUMMARIZE, "Null-space generation of %lu vectors in batches of %d took %g seconds\n", B.size(), batch,
+            setup_timer.last());
+
     if (param.mg_global.vec_store[param.level] == QUDA_BOOLEAN_TRUE) { // conditional store of null vectors
       saveVectors(B);
     }
@@ -1496,6 +1649,104 @@ namespace quda
     popLevel();
   }
 
+  int MG::nullSpaceBatchSize(int n_vec) const
+  {
+    if (param.mg_global.setup_batch_all[param.level] != QUDA_BOOLEAN_TRUE) {
+      if (n_vec % param.n_vec_batch != 0) errorQuda("Bad batch size %d", param.n_vec_batch);
+      return param.n_vec_batch;
+    }
+
+    // fewest batches that respect the multi-RHS limit, balanced in size
+    int max_batch = static_cast<int>(get_max_multi_rhs());
+    int n_batch = (n_vec + max_batch - 1) / max_batch;
+    return (n_vec + n_batch - 1) / n_batch;
+  }
+
+  std::vector<double> MG::nullSpaceResidual(cvector_ref<const ColorSpinorField> &B)
+  {
+    pushLevel(param.level);
+
+    ColorSpinorParam csParam(B[0]);
+    csParam.location = param.location;
+    csParam.setPrecision(r[0].Precision(), r[0].Precision(), csParam.location == QUDA_CUDA_FIELD_LOCATION);
+    csParam.gammaBasis = B[0].Nspin() == 1 ? QUDA_DEGRAND_ROSSI_GAMMA_BASIS : QUDA_UKQCD_GAMMA_BASIS;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    const int batch = nullSpaceBatchSize(B.size());
+    std::vector<ColorSpinorField> b, x, Ax;
+    resize(b, batch, csParam);
+    resize(x, batch, csParam);
+
+    std::vector<double> residual(B.size());
+    for (auto i = 0u; i < B.size(); i += batch) {
+      const auto n = std::min(static_cast<size_t>(batch), B.size() - i);
+      vector_ref<ColorSpinorField> xb {x.begin(), x.begin() + n};
+      vector_ref<ColorSpinorField> bb {b.begin(), b.begin() + n};
+      copy(xb, {B.begin() + i, B.begin() + i + n});
+      zero(bb);
+
+      // measure the residual of the same (possibly preconditioned) system the setup solver relaxes against
+      std::vector<ColorSpinorField> out(n), in(n);
+      diracSmoother->prepare(out, in, xb, bb, QUDA_MAT_SOLUTION);
+      if (Ax.empty()) resize(Ax, batch, QUDA_NULL_FIELD_CREATE, out[0]);
+      vector_ref<ColorSpinorField> Axb {Ax.begin(), Ax.begin() + n};
+      (*param.matSmooth)(Axb, out);
+
+      auto Ax2 = norm2(Axb);
+      auto x2 = norm2(out);
+      for (auto j = 0u; j < n; j++) residual[i + j] = x2[j] > 0.0 ? sqrt(Ax2[j] / x2[j]) : 0.0;
+    }
+
+    popLevel();
+    return residual;
+  }
+
+  bool MG::refreshNullVectors(std::vector<ColorSpinorField> &B)
+  {
+    pushLevel(param.level);
+
+    bool updated = true;
+    if (null_residual.size() != B.size()) {
+      // no reference available, e.g., vectors were loaded or are eigenvectors, so refresh everything
+      logQuda(QUDA_VERBOSE, "No reference near-null residual available, refreshing all null-space vectors\n");
+      generateNullVectors(B, true);
+    } else {
+      auto residual = nullSpaceResidual(B);
+      auto threshold = param.mg_global.setup_refresh_threshold[param.level];
+
+      // a batch is relaxed together, so mark the whole batch if any of its vectors has degraded, unless all
+      // vectors are relaxed in a single batch in which case the degraded vectors are compacted together
+      const int mask_width = param.mg_global.setup_batch_all[param.level] == QUDA_BOOLEAN_TRUE ?
+        1 :
+        nullSpaceBatchSize(B.size());
+      std::vector<bool> active(B.size(), false);
+      int n_active = 0;
+      for (auto i = 0u; i < B.size(); i += mask_width) {
+        bool degraded = false;
+        for (auto j = i; j < i + mask_width; j++) {
+          auto growth = residual[j] / null_residual[j];
+          logQuda(QUDA_DEBUG_VERBOSE, "Vector %u: near-null residual = %e, reference = %e, growth = %e\n", j,
+                  residual[j], null_residual[j], growth);
+          if (check_deviation(growth - 1.0, threshold)) degraded = true;
+        }
+        if (degraded) {
+          for (auto j = i; j < i + mask_width; j++) active[j] = true;
+          n_active += mask_width;
+        }
+      }
+
+      logQuda(QUDA_SUMMARIZE, "Adaptive refresh: %d of %lu null-space vectors degraded beyond threshold %e\n", n_active,
+              B.size(), threshold);
+
+      if (n_active > 0)
+        generateNullVectors(B, true, active);
+      else
+        updated = false;
+    }
+
+    popLevel();
+    return updated;
+  }
+
   // generate a full span of free vectors.
   // FIXME: Assumes fine level is SU(3).
   void MG::buildFreeVectors(std::vector<ColorSpinorField> &B)
@@ -1,12 +1,12 @@
 #include "invert_quda.h"
+#include "checkpoint.h"
 
 namespace quda
 {
 
   // vector of spinors used for forecasting solutions in HMC
 #define QUDA_MAX_CHRONO 12
-  // each entry is one p
-  std::vector<std::vector<ColorSpinorField>> chronoResident(QUDA_MAX_CHRONO);
+  std::vector<ChronoHistory> chronoResident(QUDA_MAX_CHRONO);
 
   void flushChrono(int i)
   {
@@ -205,6 +205,7 @@ namespace quda
     } else if (!mat_solution && direct_solve) { // perform the first of two solves: A^dag y = b
       DiracMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
       SolverParam solverParam(param);
+      solverParam.checkpoint = checkpoint::enabled();
       Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, mEig);
       (*solve)(out, in);
       blas::copy(in, out);
@@ -215,12 +216,13 @@ namespace quda
     if (direct_solve) {
       DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
       SolverParam solverParam(param);
+      solverParam.checkpoint = checkpoint::enabled();
 
       // chronological forecasting
       if (param.chrono_use_resident && chronoResident[param.chrono_index].size() > 0) {
         bool hermitian = false;
         auto &mChrono = param.chrono_precision == param.cuda_prec ? m : mSloppy;
-        chronoExtrapolate(out[0], in[0], chronoResident[param.chrono_index], mChrono, hermitian);
+        chronoResident[param.chrono_index].extrapolate(out, in, mChrono, param.chrono_precision, hermitian);
       }
 
       Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, mEig);
@@ -230,12 +232,13 @@ namespace quda
     } else if (!norm_error_solve) {
       DiracMdagM m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
       SolverParam solverParam(param);
+      solverParam.checkpoint = checkpoint::enabled();
 
       // chronological forecasting
       if (param.chrono_use_resident && chronoResident[param.chrono_index].size() > 0) {
         bool hermitian = true;
         auto &mChrono = param.chrono_precision == param.cuda_prec ? m : mSloppy;
-        chronoExtrapolate(out[0], in[0], chronoResident[param.chrono_index], mChrono, hermitian);
+        chronoResident[param.chrono_index].extrapolate(out, in, mChrono, param.chrono_precision, hermitian);
       }
 
       // if using a Schwarz preconditioner with a normal operator then we must use the DiracMdagMLocal operator
@@ -255,6 +258,7 @@ namespace quda
       DiracMMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
       auto tmp = getFieldTmp(cvector_ref<ColorSpinorField>(in));
       SolverParam solverParam(param);
+      solverParam.checkpoint = checkpoint::enabled();
       Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, mEig);
       (*solve)(tmp, in);    // y = (M M^\dag) b
       dirac.Mdag(out, tmp); // x = M^dag y
@@ -272,25 +276,9 @@ namespace quda
       const int i = param.chrono_index;
       if (i >= QUDA_MAX_CHRONO) errorQuda("Requested chrono index %d is outside of max %d\n", i, QUDA_MAX_CHRONO);
 
-      auto &basis = chronoResident[i];
-
-      if (param.chrono_max_dim < (int)basis.size()) {
-        errorQuda("Requested chrono_max_dim %i is smaller than already existing chronology %lu", param.chrono_max_dim,
-                  basis.size());
-      }
-
-      if (not param.chrono_replace_last) {
-        // if we have not filled the space yet just augment
-        if ((int)basis.size() < param.chrono_max_dim) {
-          ColorSpinorParam cs_param(out[0]);
-          cs_param.setPrecision(param.chrono_precision);
-          basis.emplace_back(cs_param);
-        }
-
-        // shuffle every entry down one and bring the last to the front
-        std::rotate(basis.begin(), basis.end() - 1, basis.end());
-      }
-      basis[0] = out[0]; // set first entry to new solution
+      // the history cannot be stored at higher precision than the operator is applied in
+      auto precision = std::min(param.chrono_storage_precision, param.chrono_precision);
+      chronoResident[i].add(out, param.chrono_max_dim, precision, param.chrono_replace_last);
     }
 
     dirac.reconstruct(x, b, param.solution_type);
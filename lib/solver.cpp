@@ -4,6 +4,7 @@
 #include <eigensolve_quda.h>
 #include <accelerator.h>
 #include <madwf_ml.h> // For MADWF
+#include <telemetry.h>
 #include <cmath>
 #include <limits>
 
@@ -221,6 +222,7 @@ namespace quda {
     inner.iter = 0;
     inner.inv_type_precondition = QUDA_INVALID_INVERTER;
     inner.is_preconditioner = true; // tell inner solver it is a preconditioner
+    inner.checkpoint = false;       // only the outer solver is checkpointed
     inner.pipeline = true;
 
     inner.schwarz_type = outer.schwarz_type;
@@ -344,6 +346,24 @@ namespace quda {
     getProfile().TPSTOP(QUDA_PROFILE_FREE);
   }
 
+  void Solver::compressDeflationSpace()
+  {
+    if (!param.deflate) return;
+    if (param.eig_param.deflation_prec == QUDA_INVALID_PRECISION && param.eig_param.deflation_coherence_n_vec == 0
+        && param.eig_param.deflation_location != QUDA_CPU_FIELD_LOCATION)
+      return;
+
+    // preserved spaces are handed back to the caller or reused with
+    // recomputed eigenvalues, so we leave these at full precision
+    if (param.eig_param.preserve_deflation) {
+      logQuda(QUDA_VERBOSE, "Not compressing a preserved deflation space\n");
+      return;
+    }
+
+    eig_solve->compressDeflationSpace(evecs);
+    eig_solve->offloadDeflationSpace(evecs);
+  }
+
   void Solver::injectDeflationSpace(std::vector<ColorSpinorField> &defl_space)
   {
     if (!evecs.empty()) errorQuda("Solver deflation space should be empty, instead size=%lu\n", evecs.size());
@@ -478,6 +498,8 @@ namespace quda {
 
       if (std::isnan(r2[i]) || std::isinf(r2[i])) errorQuda("Solver appears to have diverged for n = %d", i);
     }
+
+    telemetry::iteration(this, name, k, r2, b2);
   }
 
   void Solver::PrintSummary(const char *name, int k, cvector<double> &r2, cvector<double> &b2, cvector<double> &r2_tol,
@@ -517,6 +539,8 @@ namespace quda {
         }
       }
     }
+
+    telemetry::solve_end(this, k, r2, b2);
   }
 
   double Solver::precisionEpsilon(QudaPrecision prec) const
@@ -595,6 +619,12 @@ namespace quda {
     for (auto i = 0u; i < true_res.size(); i++) param.true_res[i] = true_res[i];
     for (auto i = 0u; i < true_res_hq.size(); i++) param.true_res_hq[i] = true_res_hq[i];
     param.iter += iter;
+    param.adaptive_iter_low += adaptive_iter_low;
+    param.adaptive_switches += adaptive_switches;
+    if (use_adaptive_reliable) {
+      param.adaptive_delta = adaptive_delta;
+      param.adaptive_max_gap = std::max(param.adaptive_max_gap, adaptive_max_gap);
+    }
     if (offset >= 0) {
       param.true_res_offset[offset] = true_res_offset[offset];
       param.iter_res_offset[offset] = iter_res_offset[offset];
@@ -13,31 +13,35 @@ namespace quda {
     template <int dim = -1> using Arg = StaggeredOprodArg<Float, nColor, dim>;
     GaugeField &U;
     GaugeField &L;
-    const ColorSpinorField &inA;
-    const ColorSpinorField &inB;
+    cvector_ref<const ColorSpinorField> &inA;
+    cvector_ref<const ColorSpinorField> &inB;
+    const ColorSpinorField &halo;
     const int parity;
-    const real coeff[2];
+    const std::vector<array<double, 2>> &coeff;
     const int nFace;
     OprodKernelType kernel;
     int dir;
     int displacement;
     unsigned int minThreads() const
     {
-      return kernel == INTERIOR ? inB.VolumeCB() : displacement * inB.GhostFaceCB()[dir];
+      return kernel == INTERIOR ? inB.VolumeCB() : displacement * inB[0].GhostFaceCB()[dir];
     }
 
   public:
-    StaggeredOprod(GaugeField &U, GaugeField &L, ColorSpinorField &inA, ColorSpinorField &inB,
-                   int parity, const double coeff[2], int nFace) :
+    StaggeredOprod(GaugeField &U, GaugeField &L, cvector_ref<const ColorSpinorField> &inA,
+                   cvector_ref<const ColorSpinorField> &inB, const ColorSpinorField &halo, int parity,
+                   const std::vector<array<double, 2>> &coeff, int nFace) :
       TunableKernel1D(U),
       U(U),
       L(L),
       inA(inA),
       inB(inB),
+      halo(halo),
       parity(parity),
-      coeff{static_cast<real>(coeff[0]), static_cast<real>(coeff[1])},
+      coeff(coeff),
       nFace(nFace)
     {
+      setRHSstring(aux, inA.size());
       char aux2[TuneKey::aux_n];
       strcpy(aux2, aux);
       kernel = INTERIOR;
@@ -69,13 +73,13 @@ namespace quda {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 
       if (kernel == INTERIOR) {
-        launch<Interior>(tp, stream, Arg<>(U, L, inA, inB, parity, displacement, nFace, coeff));
+        launch<Interior>(tp, stream, Arg<>(U, L, inA, inB, halo, parity, displacement, nFace, coeff));
       } else if (kernel == EXTERIOR) {
         switch (dir) {
-        case 0: launch<Exterior>(tp, stream, Arg<0>(U, L, inA, inB, parity, displacement, nFace, coeff)); break;
-        case 1: launch<Exterior>(tp, stream, Arg<1>(U, L, inA, inB, parity, displacement, nFace, coeff)); break;
-        case 2: launch<Exterior>(tp, stream, Arg<2>(U, L, inA, inB, parity, displacement, nFace, coeff)); break;
-        case 3: launch<Exterior>(tp, stream, Arg<3>(U, L, inA, inB, parity, displacement, nFace, coeff)); break;
+        case 0: launch<Exterior>(tp, stream, Arg<0>(U, L, inA, inB, halo, parity, displacement, nFace, coeff)); break;
+        case 1: launch<Exterior>(tp, stream, Arg<1>(U, L, inA, inB, halo, parity, displacement, nFace, coeff)); break;
+        case 2: launch<Exterior>(tp, stream, Arg<2>(U, L, inA, inB, halo, parity, displacement, nFace, coeff)); break;
+        case 3: launch<Exterior>(tp, stream, Arg<3>(U, L, inA, inB, halo, parity, displacement, nFace, coeff)); break;
         default: errorQuda("Unexpected direction %d", dir);
         }
       } else {
@@ -94,34 +98,73 @@ namespace quda {
       if (U.data() != L.data()) L.restore();
     }
 
-    long long flops() const { return 0; } // FIXME
-    long long bytes() const { return 0; } // FIXME
+    // outer product + multiply-add per vector pair and output link
+    long long flops() const
+    {
+      long long oprod_flops = nColor * nColor * 6 + 4 * nColor * nColor;
+      long long links = kernel == INTERIOR ? 4ll * (nFace == 3 ? 2 : 1) : 1ll;
+      return minThreads() * links * inA.size() * oprod_flops;
+    }
+
+    // the output links are read and written once, independent of the number of vector pairs
+    long long bytes() const
+    {
+      long long links = kernel == INTERIOR ? 4ll * (nFace == 3 ? 2 : 1) : 1ll;
+      long long link_bytes = 2 * 2 * nColor * nColor * U.Precision();
+      long long vector_bytes = 2 * nColor * inA[0].Precision();
+      return minThreads() * links * (link_bytes + 2 * inA.size() * vector_bytes);
+    }
   }; // StaggeredOprod
 
-  void computeStaggeredOprod(GaugeField &U, GaugeField &L, ColorSpinorField &inEven, ColorSpinorField &inOdd,
-                             int parity, const double coeff[2], int nFace)
+  /**
+     @brief Accumulate the outer products of a batch of vector pairs
+     for the given parity.  The halos of all vectors are exchanged
+     together in a single batched exchange.
+   */
+  void computeStaggeredOprod(GaugeField &U, GaugeField &L, cvector_ref<const ColorSpinorField> &inA,
+                             cvector_ref<const ColorSpinorField> &inB, int parity,
+                             const std::vector<array<double, 2>> &coeff, int nFace)
   {
-    checkNative(U, L);
-    ColorSpinorField &inA = (parity & 1) ? inOdd : inEven;
-    ColorSpinorField &inB = (parity & 1) ? inEven : inOdd;
+    if (inA.size() > get_max_multi_rhs()) {
+      auto h = inA.size() / 2;
+      computeStaggeredOprod(U, L, {inA.begin(), inA.begin() + h}, {inB.begin(), inB.begin() + h}, parity,
+                            {coeff.begin(), coeff.begin() + h}, nFace);
+      computeStaggeredOprod(U, L, {inA.begin() + h, inA.end()}, {inB.begin() + h, inB.end()}, parity,
+                            {coeff.begin() + h, coeff.end()}, nFace);
+      return;
+    }
 
-    inB.exchangeGhost((QudaParity)(1-parity), nFace, 0);
-    instantiate<StaggeredOprod, ReconstructNone>(U, L, inA, inB, parity, coeff, nFace);
+    checkNative(U, L);
+    auto halo_tmp = ColorSpinorField::create_comms_batch(inB, nFace, false);
+    ColorSpinorField &halo = halo_tmp;
+    halo.exchangeGhost((QudaParity)(1 - parity), nFace, 0, nullptr, nullptr, false, false, QUDA_INVALID_PRECISION, 0,
+                       inB);
+    instantiate<StaggeredOprod, ReconstructNone>(U, L, inA, inB, halo, parity, coeff, nFace);
 
-    inB.bufferIndex = (1 - inB.bufferIndex);
+    halo.bufferIndex = (1 - halo.bufferIndex);
   }
 
-  void computeStaggeredOprod(GaugeField *out[], ColorSpinorField& in, const double coeff[], int nFace)
+  void computeStaggeredOprod(GaugeField *out[], cvector_ref<const ColorSpinorField> &in,
+                             const std::vector<array<double, 2>> &coeff, int nFace)
   {
     if constexpr (is_enabled<QUDA_STAGGERED_DSLASH>()) {
+      if (in.size() != coeff.size()) errorQuda("Number of fields %lu and coefficients %lu do not match", in.size(), coeff.size());
       getProfile().TPSTART(QUDA_PROFILE_COMPUTE);
+
+      vector_ref<const ColorSpinorField> even, odd;
+      for (auto i = 0u; i < in.size(); i++) {
+        even.push_back(in[i].Even());
+        odd.push_back(in[i].Odd());
+      }
+
       if (nFace == 1) {
-        computeStaggeredOprod(*out[0], *out[0], in.Even(), in.Odd(), 0, coeff, nFace);
-        double coeff_[2] = {-coeff[0], 0.0}; // need to multiply by -1 on odd sites
-        computeStaggeredOprod(*out[0], *out[0], in.Even(), in.Odd(), 1, coeff_, nFace);
+        computeStaggeredOprod(*out[0], *out[0], even, odd, 0, coeff, nFace);
+        auto coeff_ = coeff; // need to multiply by -1 on odd sites
+        for (auto &c : coeff_) c = {-c[0], 0.0};
+        computeStaggeredOprod(*out[0], *out[0], odd, even, 1, coeff_, nFace);
       } else if (nFace == 3) {
-        computeStaggeredOprod(*out[0], *out[1], in.Even(), in.Odd(), 0, coeff, nFace);
-        computeStaggeredOprod(*out[0], *out[1], in.Even(), in.Odd(), 1, coeff, nFace);
+        computeStaggeredOprod(*out[0], *out[1], even, odd, 0, coeff, nFace);
+        computeStaggeredOprod(*out[0], *out[1], odd, even, 1, coeff, nFace);
       } else {
         errorQuda("Invalid nFace=%d", nFace);
       }
@@ -131,4 +174,10 @@ namespace quda {
     }
   }
 
+  void computeStaggeredOprod(GaugeField *out[], ColorSpinorField &in, const double coeff[], int nFace)
+  {
+    std::vector<array<double, 2>> coeff_(1, {coeff[0], nFace == 3 ? coeff[1] : 0.0});
+    computeStaggeredOprod(out, in, coeff_, nFace);
+  }
+
 } // namespace quda
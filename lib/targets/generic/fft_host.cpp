@@ -0,0 +1,364 @@
+#include <complex>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstring>
+
+#include <FFT_Plans.h>
+#include <malloc_quda.h>
+#include <quda_api.h>
+
+#ifdef QUDA_FFTW
+#include <fftw3.h>
+#endif
+
+namespace quda
+{
+
+  namespace fft
+  {
+
+#ifdef QUDA_FFTW
+
+    /**
+       @brief FFTW plans for a given transform.  FFTW plans are bound
+       to the placement (in or out of place) of the data, so we
+       lazily create one plan per direction and placement, and then
+       execute these on the actual arrays with the new-array interface.
+     */
+    template <typename real> struct fftw_traits;
+
+    template <> struct fftw_traits<double> {
+      using complex = fftw_complex;
+      using plan_t = fftw_plan;
+      static plan_t plan(int rank, const int *n, int batch, complex *in, complex *out, int sign)
+      {
+        int dist = 1;
+        for (int i = 0; i < rank; i++) dist *= n[i];
+        return fftw_plan_many_dft(rank, n, batch, in, nullptr, 1, dist, out, nullptr, 1, dist, sign,
+                                  FFTW_ESTIMATE | FFTW_UNALIGNED);
+      }
+      static void execute(plan_t p, complex *in, complex *out) { fftw_execute_dft(p, in, out); }
+      static void destroy(plan_t p) { fftw_destroy_plan(p); }
+    };
+
+    template <> struct fftw_traits<float> {
+      using complex = fftwf_complex;
+      using plan_t = fftwf_plan;
+      static plan_t plan(int rank, const int *n, int batch, complex *in, complex *out, int sign)
+      {
+        int dist = 1;
+        for (int i = 0; i < rank; i++) dist *= n[i];
+        return fftwf_plan_many_dft(rank, n, batch, in, nullptr, 1, dist, out, nullptr, 1, dist, sign,
+                                   FFTW_ESTIMATE | FFTW_UNALIGNED);
+      }
+      static void execute(plan_t p, complex *in, complex *out) { fftwf_execute_dft(p, in, out); }
+      static void destroy(plan_t p) { fftwf_destroy_plan(p); }
+    };
+
+    template <typename real> class Plan
+    {
+      using traits = fftw_traits<real>;
+      using complex = typename traits::complex;
+      FFTPlanHandle handle;                    // copy of the plan dimensions
+      typename traits::plan_t plan[2][2] = {}; // [direction][in place]
+
+    public:
+      Plan(const FFTPlanHandle &handle) : handle(handle) { }
+
+      ~Plan()
+      {
+        for (auto &d : plan)
+          for (auto &p : d)
+            if (p) traits::destroy(p);
+      }
+
+      void apply(std::complex<real> *in, std::complex<real> *out, int direction)
+      {
+        auto i = reinterpret_cast<complex *>(in);
+        auto o = reinterpret_cast<complex *>(out);
+        auto &p = plan[direction == FFT_FORWARD ? 0 : 1][in == out ? 1 : 0];
+        if (!p) {
+          p = traits::plan(handle.rank, handle.n, handle.batch, i, o,
+                           direction == FFT_FORWARD ? FFTW_FORWARD : FFTW_BACKWARD);
+          if (!p) errorQuda("Failed to create FFTW plan");
+        }
+        traits::execute(p, i, o);
+      }
+    };
+
+#else
+
+    /**
+       @brief One-dimensional mixed-radix FFT of length n.  The length
+       is factorized into primes, and each factor is applied as a
+       Stockham autosort stage, alternating between the data and a
+       work array, so that no bit-reversal permutation is needed.
+       Radices other than 2 and 4 use a generic O(p^2) butterfly, so
+       lengths with large prime factors are supported but slow.
+     */
+    template <typename real> class Transform1D
+    {
+      using complex = std::complex<real>;
+
+      struct stage_t {
+        int radix;                    // radix of this stage
+        int stride;                   // product of the radices of the previous stages
+        std::vector<complex> twiddle; // twiddle factors w_m^(r q) for m = n / stride
+        std::vector<complex> dft;     // radix-p DFT matrix w_p^(j r)
+      };
+
+      int n;
+      std::vector<stage_t> stages;
+
+    public:
+      Transform1D(int n) : n(n)
+      {
+        std::vector<int> factors;
+        int m = n;
+        while (m % 4 == 0) {
+          factors.push_back(4);
+          m /= 4;
+        }
+        for (int p = 2; p * p <= m; p++) {
+          while (m % p == 0) {
+            factors.push_back(p);
+            m /= p;
+          }
+        }
+        if (m > 1) factors.push_back(m);
+
+        int stride = 1;
+        for (auto p : factors) {
+          stage_t s;
+          s.radix = p;
+          s.stride = stride;
+          int len = n / stride;
+          int q_max = len / p;
+          s.twiddle.resize(p * q_max);
+          for (int q = 0; q < q_max; q++)
+            for (int r = 0; r < p; r++)
+              s.twiddle[q * p + r] = std::polar(1.0, -2.0 * M_PI * ((static_cast<long>(r) * q) % len) / len);
+          s.dft.resize(p * p);
+          for (int j = 0; j < p; j++)
+            for (int r = 0; r < p; r++) s.dft[j * p + r] = std::polar(1.0, -2.0 * M_PI * ((j * r) % p) / p);
+          stages.push_back(s);
+          stride *= p;
+        }
+      }
+
+      /**
+         @brief Transform a contiguous array of length n in place
+         @param[in,out] x The data
+         @param[in] work Work array of length n
+         @param[in] forward Whether this is a forward or inverse transform
+       */
+      void operator()(complex *x, complex *work, bool forward) const
+      {
+        complex *in = x;
+        complex *out = work;
+        auto w = [forward](const complex &z) { return forward ? z : std::conj(z); };
+
+        for (auto &s : stages) {
+          const int p = s.radix;
+          const int stride = s.stride;
+          const int m = n / (stride * p);
+
+          for (int q = 0; q < m; q++) {
+            for (int k = 0; k < stride; k++) {
+              const complex *a = in + k + stride * q;
+              complex *b = out + k + stride * p * q;
+              if (p == 2) {
+                complex a0 = a[0], a1 = a[stride * m];
+                b[0] = a0 + a1;
+                b[stride] = (a0 - a1) * w(s.twiddle[q * p + 1]);
+              } else if (p == 4) {
+                complex a0 = a[0], a1 = a[stride * m], a2 = a[2 * stride * m], a3 = a[3 * stride * m];
+                complex t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, t3 = a1 - a3;
+                t3 = forward ? complex(t3.imag(), -t3.real()) : complex(-t3.imag(), t3.real()); // t3 * -+i
+                b[0] = t0 + t2;
+                b[stride] = (t1 + t3) * w(s.twiddle[q * p + 1]);
+                b[2 * stride] = (t0 - t2) * w(s.twiddle[q * p + 2]);
+                b[3 * stride] = (t1 - t3) * w(s.twiddle[q * p + 3]);
+              } else {
+                for (int r = 0; r < p; r++) {
+                  complex sum = 0.0;
+                  for (int j = 0; j < p; j++) sum += a[j * stride * m] * w(s.dft[j * p + r]);
+                  b[r * stride] = sum * w(s.twiddle[q * p + r]);
+                }
+              }
+            }
+          }
+          std::swap(in, out);
+        }
+
+        if (in != x) std::memcpy(x, in, n * sizeof(complex));
+      }
+    };
+
+    template <typename real> class Plan
+    {
+      using complex = std::complex<real>;
+      FFTPlanHandle handle;                     // copy of the plan dimensions
+      std::vector<Transform1D<real>> transform; // one per dimension
+
+    public:
+      Plan(const FFTPlanHandle &handle) : handle(handle)
+      {
+        for (int d = 0; d < handle.rank; d++) transform.emplace_back(handle.n[d]);
+      }
+
+      void apply(complex *in, complex *out, int direction)
+      {
+        size_t volume = 1;
+        for (int d = 0; d < handle.rank; d++) volume *= handle.n[d];
+        size_t total = volume * handle.batch;
+        if (in != out) std::memcpy(out, in, total * sizeof(complex));
+
+        // apply the 1-d transform along each dimension in turn; the
+        // inner-most dimension is contiguous, the others are gathered
+        size_t inner = 1;
+        for (int d = handle.rank - 1; d >= 0; d--) {
+          const size_t len = handle.n[d];
+          const size_t lines = total / len;
+          const auto &T = transform[d];
+
+#pragma omp parallel
+          {
+            std::vector<complex> line(len);
+            std::vector<complex> work(len);
+#pragma omp for
+            for (size_t l = 0; l < lines; l++) {
+              complex *x = out + (l / inner) * len * inner + (l % inner);
+              if (inner == 1) {
+                T(x, work.data(), direction == FFT_FORWARD);
+              } else {
+                for (size_t i = 0; i < len; i++) line[i] = x[i * inner];
+                T(line.data(), work.data(), direction == FFT_FORWARD);
+                for (size_t i = 0; i < len; i++) x[i * inner] = line[i];
+              }
+            }
+          }
+          inner *= len;
+        }
+      }
+    };
+
+#endif // QUDA_FFTW
+
+    template <typename real> Plan<real> &get_plan(FFTPlanHandle &handle, QudaPrecision precision)
+    {
+      if (!handle.plan) errorQuda("FFT plan has not been created");
+      if (handle.precision != precision)
+        errorQuda("FFT plan precision %d does not match data precision %d", handle.precision, precision);
+      return *static_cast<Plan<real> *>(handle.plan);
+    }
+
+    /**
+       @brief Apply the host transform, staging the input and output
+       through host memory if they are resident on the device.
+     */
+    template <typename real, typename complex2>
+    void apply(FFTPlanHandle &handle, complex2 *data_in, complex2 *data_out, int direction)
+    {
+      auto &plan = get_plan<real>(handle, sizeof(real) == sizeof(double) ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION);
+      if (direction != FFT_FORWARD && direction != FFT_INVERSE) errorQuda("Invalid FFT direction %d", direction);
+
+      size_t bytes = sizeof(complex2) * handle.batch;
+      for (int d = 0; d < handle.rank; d++) bytes *= handle.n[d];
+
+      bool device_in = get_pointer_location(data_in) == QUDA_CUDA_FIELD_LOCATION;
+      bool device_out = get_pointer_location(data_out) == QUDA_CUDA_FIELD_LOCATION;
+
+      auto in = reinterpret_cast<std::complex<real> *>(data_in);
+      auto out = reinterpret_cast<std::complex<real> *>(data_out);
+      void *buffer = nullptr;
+      if (device_in || device_out) {
+        // a single host buffer that is transformed in place
+        buffer = pool_pinned_malloc(bytes);
+        if (device_in) qudaMemcpy(buffer, data_in, bytes, qudaMemcpyDeviceToHost);
+        else
+          memcpy(buffer, data_in, bytes);
+        in = static_cast<std::complex<real> *>(buffer);
+        out = in;
+      }
+
+      plan.apply(in, out, direction);
+
+      if (buffer) {
+        if (device_out) qudaMemcpy(data_out, buffer, bytes, qudaMemcpyHostToDevice);
+        else
+          memcpy(data_out, buffer, bytes);
+        pool_pinned_free(buffer);
+      }
+    }
+
+    void set_plan(FFTPlanHandle &handle, int rank, const int *n, int batch, QudaPrecision precision)
+    {
+      if (precision != QUDA_DOUBLE_PRECISION && precision != QUDA_SINGLE_PRECISION)
+        errorQuda("Unsupported FFT precision %d", precision);
+      handle.rank = rank;
+      for (int d = 0; d < rank; d++) {
+        if (n[d] <= 0) errorQuda("Invalid FFT length %d in dimension %d", n[d], d);
+        handle.n[d] = n[d];
+      }
+      handle.batch = batch;
+      handle.precision = precision;
+      if (precision == QUDA_DOUBLE_PRECISION)
+        handle.plan = new Plan<double>(handle);
+      else
+        handle.plan = new Plan<float>(handle);
+    }
+
+  } // namespace fft
+
+  void ApplyFFT(FFTPlanHandle &plan, float2 *data_in, float2 *data_out, int direction)
+  {
+    fft::apply<float>(plan, data_in, data_out, direction);
+  }
+
+  void ApplyFFT(FFTPlanHandle &plan, double2 *data_in, double2 *data_out, int direction)
+  {
+    fft::apply<double>(plan, data_in, data_out, direction);
+  }
+
+  void SetPlanFFTMany(FFTPlanHandle &plan, int4 size, int dim, QudaPrecision precision)
+  {
+    switch (dim) {
+    case 1: {
+      int n[1] = {size.w};
+      fft::set_plan(plan, 1, n, size.x * size.y * size.z, precision);
+    } break;
+    case 3: {
+      int n[3] = {size.x, size.y, size.z};
+      fft::set_plan(plan, 3, n, size.w, precision);
+    } break;
+    default: errorQuda("Unsupported FFT dimension %d", dim);
+    }
+  }
+
+  void SetPlanFFT2DMany(FFTPlanHandle &plan, int4 size, int dim, QudaPrecision precision)
+  {
+    switch (dim) {
+    case 0: {
+      int n[2] = {size.w, size.z}; // outer-most dimension is first
+      fft::set_plan(plan, 2, n, size.x * size.y, precision);
+    } break;
+    case 1: {
+      int n[2] = {size.y, size.x}; // outer-most dimension is first
+      fft::set_plan(plan, 2, n, size.z * size.w, precision);
+    } break;
+    default: errorQuda("Unsupported FFT dimension %d", dim);
+    }
+  }
+
+  void FFTDestroyPlan(FFTPlanHandle &plan)
+  {
+    if (plan.precision == QUDA_DOUBLE_PRECISION)
+      delete static_cast<fft::Plan<double> *>(plan.plan);
+    else
+      delete static_cast<fft::Plan<float> *>(plan.plan);
+    plan = FFTPlanHandle();
+  }
+
+} // namespace quda
@@ -0,0 +1,313 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <telemetry.h>
+#include <comm_quda.h>
+#include <tune_quda.h> // version, hash, resource path
+
+namespace quda
+{
+
+  namespace telemetry
+  {
+
+    namespace
+    {
+
+      enum class event_type { scope_begin, scope_end, solve_begin, solve_end, iteration, reliable, restart, kernel };
+
+      struct event_t {
+        event_type type;
+        double t = 0.0;             // seconds since the stream was opened
+        int scope = 0;              // innermost scope when the event was recorded
+        int parent = 0;             // scope_begin and solve_begin: enclosing scope
+        int iter = 0;               // iteration, solve_end: iteration count
+        std::string label;          // scope or solver name, kernel: name
+        std::string volume;         // kernel: volume string of the tune key
+        std::string aux;            // kernel: aux string of the tune key
+        float time = 0.0;           // kernel: tuned time
+        long long flops = 0;        // kernel: flops
+        long long bytes = 0;        // kernel: bytes
+        std::vector<double> r2;     // residual norms squared
+        std::vector<double> b2;     // source norms squared
+      };
+
+      /**
+         An open scope: either a level of the output-prefix stack or a
+         solve, identified by the solver instance
+       */
+      struct scope_t {
+        int id;
+        const void *solver;
+      };
+
+      constexpr size_t batch_size = 4096; // queue length at which the writer is woken
+
+      bool is_enabled = false;
+      std::mutex mutex; // guards all of the state below
+      std::condition_variable cv;
+      std::vector<event_t> queue;
+      std::thread writer;
+      bool running = false;
+      std::vector<scope_t> scopes;
+      int next_id = 1; // scope 0 is the whole run
+      std::chrono::time_point<std::chrono::steady_clock> start_time;
+
+      void write_string(std::ostream &out, const std::string &s)
+      {
+        out << '"';
+        for (auto c : s) {
+          switch (c) {
+          case '"': out << "\\\""; break;
+          case '\\': out << "\\\\"; break;
+          case '\n': out << "\\n"; break;
+          case '\t': out << "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) >= 0x20) out << c;
+            break;
+          }
+        }
+        out << '"';
+      }
+
+      void write_array(std::ostream &out, const std::vector<double> &v)
+      {
+        out << '[';
+        for (auto i = 0u; i < v.size(); i++) out << (i > 0 ? "," : "") << v[i];
+        out << ']';
+      }
+
+      void write(std::ostream &out, const event_t &e)
+      {
+        static const char *names[]
+          = {"scope_begin", "scope_end", "solve_begin", "solve_end", "iter", "reliable", "restart", "kernel"};
+        out << "{\"t\":" << e.t << ",\"ev\":\"" << names[static_cast<int>(e.type)] << "\",\"scope\":" << e.scope;
+
+        switch (e.type) {
+        case event_type::scope_begin:
+        case event_type::solve_begin:
+          out << ",\"parent\":" << e.parent << ",\"label\":";
+          write_string(out, e.label);
+          break;
+        case event_type::scope_end: break;
+        case event_type::solve_end:
+        case event_type::iteration:
+          out << ",\"iter\":" << e.iter << ",\"r2\":";
+          write_array(out, e.r2);
+          out << ",\"b2\":";
+          write_array(out, e.b2);
+          break;
+        case event_type::reliable:
+        case event_type::restart:
+          out << ",\"r2\":";
+          write_array(out, e.r2);
+          break;
+        case event_type::kernel:
+          out << ",\"name\":";
+          write_string(out, e.label);
+          out << ",\"volume\":";
+          write_string(out, e.volume);
+          out << ",\"aux\":";
+          write_string(out, e.aux);
+          out << ",\"time\":" << e.time << ",\"flops\":" << e.flops << ",\"bytes\":" << e.bytes;
+          break;
+        }
+        out << "}\n";
+      }
+
+      /**
+         @brief The function run by the writer thread: formats and
+         writes the queued events in batches until the stream is closed
+       */
+      void write_loop(std::ofstream out)
+      {
+        std::vector<event_t> batch;
+        while (true) {
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(100), [] { return queue.size() >= batch_size || !running; });
+            batch.swap(queue);
+            if (batch.empty() && !running) break;
+          }
+          for (auto &e : batch) write(out, e);
+          batch.clear();
+          out.flush();
+        }
+      }
+
+      /**
+         @brief Queue an event, stamping it with the time and the
+         innermost scope.  Must be called with the mutex held.
+       */
+      void post(event_t &&e)
+      {
+        e.t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        if (e.type != event_type::scope_begin && e.type != event_type::solve_begin)
+          e.scope = scopes.empty() ? 0 : scopes.back().id;
+        queue.push_back(std::move(e));
+        if (queue.size() == batch_size) cv.notify_one();
+      }
+
+      void open(event_type type, const char *label, const void *solver)
+      {
+        const int id = next_id++;
+        event_t e {type};
+        e.parent = scopes.empty() ? 0 : scopes.back().id;
+        e.scope = id;
+        e.label = label;
+        post(std::move(e));
+        scopes.push_back({id, solver});
+      }
+
+      /**
+         @brief Close the innermost scope
+       */
+      void close()
+      {
+        auto type = scopes.back().solver ? event_type::solve_end : event_type::scope_end;
+        post(event_t {type});
+        scopes.pop_back();
+      }
+
+    } // namespace
+
+    bool enabled() { return is_enabled; }
+
+    void init()
+    {
+      char *enable_str = getenv("QUDA_ENABLE_TELEMETRY");
+      if (!enable_str || strcmp(enable_str, "1") != 0 || is_enabled) return;
+
+      auto resource_path = get_resource_path();
+      if (resource_path.empty()) {
+        warningQuda("Telemetry disabled since QUDA_RESOURCE_PATH is not set");
+        return;
+      }
+
+      auto path = resource_path + "/telemetry_n" + std::to_string(comm_rank()) + ".jsonl";
+      std::ofstream out(path);
+      if (!out) {
+        warningQuda("Telemetry disabled since %s could not be opened", path.c_str());
+        return;
+      }
+      out << "{\"t\":0,\"ev\":\"header\",\"version\":";
+      write_string(out, get_quda_version());
+      out << ",\"hash\":";
+      write_string(out, get_quda_hash());
+      out << ",\"rank\":" << comm_rank() << "}\n";
+
+      logQuda(QUDA_SUMMARIZE, "Writing telemetry to %s\n", path.c_str());
+      start_time = std::chrono::steady_clock::now();
+      running = true;
+      writer = std::thread(write_loop, std::move(out));
+      is_enabled = true;
+    }
+
+    void destroy()
+    {
+      if (!is_enabled) return;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!scopes.empty()) close();
+        running = false;
+        is_enabled = false;
+      }
+      cv.notify_one();
+      writer.join();
+    }
+
+    void push_scope(const char *label)
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      open(event_type::scope_begin, label, nullptr);
+    }
+
+    void pop_scope()
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      // close any solves that did not report their end
+      while (!scopes.empty() && scopes.back().solver) close();
+      if (!scopes.empty()) close();
+    }
+
+    void iteration(const void *solver, const char *name, int iter, cvector<double> &r2, cvector<double> &b2)
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+
+      // find the open solve of this solver within the innermost output-prefix scope
+      auto it = scopes.rbegin();
+      while (it != scopes.rend() && it->solver && it->solver != solver) it++;
+      if (it != scopes.rend() && it->solver == solver) {
+        while (scopes.back().solver != solver) close();
+      } else {
+        open(event_type::solve_begin, name, solver);
+      }
+
+      event_t e {event_type::iteration};
+      e.iter = iter;
+      e.r2 = r2;
+      e.b2 = b2;
+      post(std::move(e));
+    }
+
+    void reliable_update(double r2)
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      event_t e {event_type::reliable};
+      e.r2 = {r2};
+      post(std::move(e));
+    }
+
+    void restart(cvector<double> &r2)
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      event_t e {event_type::restart};
+      e.r2 = r2;
+      post(std::move(e));
+    }
+
+    void solve_end(const void *solver, int iter, cvector<double> &r2, cvector<double> &b2)
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+
+      auto it = scopes.rbegin();
+      while (it != scopes.rend() && it->solver && it->solver != solver) it++;
+      if (it == scopes.rend() || it->solver != solver) return; // the solve never reported an iteration
+      while (scopes.back().solver != solver) close();
+
+      event_t e {event_type::solve_end};
+      e.iter = iter;
+      e.r2 = r2;
+      e.b2 = b2;
+      post(std::move(e));
+      scopes.pop_back();
+    }
+
+    void kernel(const TuneKey &key, float time, long long flops, long long bytes)
+    {
+      if (!is_enabled) return;
+      std::lock_guard<std::mutex> lock(mutex);
+      event_t e {event_type::kernel};
+      e.label = key.name;
+      e.volume = key.volume;
+      e.aux = key.aux;
+      e.time = time;
+      e.flops = flops;
+      e.bytes = bytes;
+      post(std::move(e));
+    }
+
+  } // namespace telemetry
+
+} // namespace quda
@@ -19,6 +19,7 @@
 #include <functional>
 #include <utility>
 #include <json_helper.h>
+#include <telemetry.h>
 
 #include <communicator_quda.h>
 
@@ -937,6 +938,9 @@ namespace quda
         trace_list.push_back(trace_entry);
       }
 
+      if (!tuning && !is_policy && telemetry::enabled())
+        telemetry::kernel(key, param_tuned.time, tunable.flops(), tunable.bytes());
+
       if (!is_policy) {
         Tunable::flops_global(Tunable::flops_global() + tunable.flops()); // increment flops counter
         Tunable::bytes_global(Tunable::bytes_global() + tunable.bytes()); // increment bytes counter
@@ -960,6 +964,9 @@ namespace quda
       logQuda(QUDA_DEBUG_VERBOSE, "Launching %s with %s at vol=%s with %s (untuned)\n", key.name, key.aux, key.volume,
               tunable.paramString(param_default).c_str());
 
+      // untuned kernels have no timing, so only their work is recorded
+      if (!tuning && !is_policy && telemetry::enabled()) telemetry::kernel(key, 0.0, tunable.flops(), tunable.bytes());
+
       if (!is_policy) {
         Tunable::flops_global(Tunable::flops_global() + tunable.flops()); // increment flops counter
         Tunable::bytes_global(Tunable::bytes_global() + tunable.bytes()); // increment bytes counter
@@ -1172,6 +1179,8 @@ namespace quda
         trace_list.push_back(trace_entry);
       }
 
+      if (!is_policy && telemetry::enabled()) telemetry::kernel(key, param.time, tunable.flops(), tunable.bytes());
+
     } else if (&tunable != active_tunable) {
       errorQuda("Unexpected call to tuneLaunch() in %s::apply()", typeid(tunable).name());
     }
@@ -9,6 +9,7 @@
 #include <util_quda.h>
 #include <malloc_quda.h>
 #include <tune_quda.h>
+#include <telemetry.h>
 
 using namespace quda;
 
@@ -142,6 +143,7 @@ void pushOutputPrefix(const char *prefix)
 
   // set new prefix
   setOutputPrefix(prefix);
+  telemetry::push_scope(prefix);
 
   if (pstack.size() > 15) {
     warningQuda("Verbosity stack contains %u elements.  Is there a missing popOutputPrefix() somewhere?",
@@ -156,6 +158,7 @@ void popOutputPrefix()
   // recover prefix from stack
   char *prefix_restore = pstack.top();
   setOutputPrefix(prefix_restore);
+  telemetry::pop_scope();
   host_free(prefix_restore);
   pstack.pop();
 }
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <vector>
+#include <comm_quda.h>
+#include <comm_progress.h>
+#include <test.h>
+
+/*
+   This test checks the communication progress thread.  Each rank
+   exchanges a ring of messages with its neighbours in every
+   dimension, which on a single rank degenerates to messages sent to
+   itself, and we check the payloads arrive intact when completion is
+   detected with comm_query as well as with comm_wait.  The test is
+   run with QUDA_ENABLE_COMMS_PROGRESS=1 unless this is overridden in
+   the environment.
+ */
+
+using namespace quda;
+constexpr auto test_timeout_secs = std::chrono::seconds(10);
+constexpr size_t n_elem = 1 << 16;
+constexpr int n_iter = 16;
+
+struct CommProgressTest : public ::testing::TestWithParam<bool> {
+  bool use_query;
+  CommProgressTest() : use_query(GetParam()) { }
+};
+
+TEST_P(CommProgressTest, verify)
+{
+  std::vector<std::vector<int>> send(8, std::vector<int>(n_elem));
+  std::vector<std::vector<int>> recv(8, std::vector<int>(n_elem));
+  std::vector<MsgHandle *> mh_send(8), mh_recv(8);
+
+  for (int dim = 0; dim < 4; dim++) {
+    for (int dir = 0; dir < 2; dir++) {
+      int i = 2 * dim + dir;
+      // send in direction dir, receive from the opposite direction
+      mh_send[i] = comm_declare_send_relative(send[i].data(), dim, dir ? 1 : -1, n_elem * sizeof(int));
+      mh_recv[i] = comm_declare_receive_relative(recv[i].data(), dim, dir ? -1 : 1, n_elem * sizeof(int));
+    }
+  }
+  // message handles are null when built without communications
+  if (!mh_send[0]) GTEST_SKIP();
+
+  auto complete = [&](MsgHandle *mh) {
+    if (use_query) {
+      const auto start_time = std::chrono::steady_clock::now();
+      while (!comm_query(mh) && std::chrono::steady_clock::now() - start_time < test_timeout_secs) { }
+      return comm_query(mh) != 0;
+    }
+    comm_wait(mh);
+    return true;
+  };
+
+  for (int iter = 0; iter < n_iter; iter++) {
+    for (int i = 0; i < 8; i++) {
+      for (auto j = 0u; j < n_elem; j++) send[i][j] = (iter * 8 + i) * n_elem + j;
+      comm_start(mh_recv[i]);
+    }
+    for (int i = 0; i < 8; i++) comm_start(mh_send[i]);
+
+    for (int i = 0; i < 8; i++) {
+      EXPECT_TRUE(complete(mh_recv[i])) << "Receive " << i << " did not complete within the timeout period";
+      EXPECT_TRUE(complete(mh_send[i])) << "Send " << i << " did not complete within the timeout period";
+    }
+
+    // the neighbour sent the same pattern as we did
+    for (int i = 0; i < 8; i++) EXPECT_EQ(send[i], recv[i]);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    comm_free(mh_send[i]);
+    comm_free(mh_recv[i]);
+  }
+
+  if (comm_progress_enabled()) {
+    auto stats = comm_progress_stats();
+    printfQuda("Progress thread: %lu messages, mean in-flight time %e secs, host wait %e secs\n", stats.messages,
+               stats.messages ? stats.in_flight / stats.messages : 0.0, stats.wait);
+    EXPECT_GE(stats.messages, static_cast<size_t>(16 * n_iter));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(CommProgress, CommProgressTest, ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool> &info) { return info.param ? "query" : "wait"; });
+
+int main(int argc, char **argv)
+{
+  // must be set before MPI is initialized so the required thread level is requested
+  setenv("QUDA_ENABLE_COMMS_PROGRESS", "1", 0);
+  quda_test test("comm_progress_test", argc, argv);
+  test.init();
+  return test.execute();
+}
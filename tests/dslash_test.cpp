@@ -67,7 +67,7 @@ TEST_F(DslashTest, verify)
   dslash_test_wrapper.run_test(2);
 
   double deviation = dslash_test_wrapper.verify();
-  double tol = getTolerance(dslash_test_wrapper.inv_param.cuda_prec);
+  double tol = getTolerance(dslash_test_wrapper.inv_param.cuda_prec, dslash_test_wrapper.inv_param.halo_prec);
   // If we are using tensor core we tolerate a greater deviation
   if (dslash_type == QUDA_MOBIUS_DWF_DSLASH && dslash_test_wrapper.dtest_type == dslash_test_type::MatPCDagMatPCLocal)
     tol *= 10;
@@ -791,6 +791,9 @@ struct DslashTestWrapper {
     host_timer_t host_timer;
     device_timer_t device_timer;
 
+    // apply the requested halo precision to the operator halos
+    pushHaloPrecision(inv_param.halo_prec);
+
     comm_barrier();
     device_timer.start();
 
@@ -1015,6 +1018,8 @@ struct DslashTestWrapper {
     device_timer.stop();
     dslash_time.event_time = device_timer.last();
 
+    popHaloPrecision();
+
     return dslash_time;
   }
 
@@ -1054,6 +1059,17 @@ struct DslashTestWrapper {
 
       size_t ghost_bytes = cudaSpinor[0].GhostBytes();
 
+      // rescale to the size of a compressed halo
+      auto prec = cudaSpinor[0].Precision();
+      if (inv_param.halo_prec != QUDA_INVALID_PRECISION && inv_param.halo_prec < prec) {
+        auto site_bytes = getHaloSiteBytes(cudaSpinor[0].Nspin(), cudaSpinor[0].Ncolor(), prec);
+        auto halo_site_bytes = getHaloSiteBytes(cudaSpinor[0].Nspin(), cudaSpinor[0].Ncolor(), inv_param.halo_prec);
+        ghost_bytes = (ghost_bytes * halo_site_bytes) / site_bytes;
+        printfQuda("Halo precision = %d (field precision = %d), halo compression ratio = %.2f\n", inv_param.halo_prec,
+                   prec, static_cast<double>(site_bytes) / halo_site_bytes);
+        ::testing::Test::RecordProperty("Halo_compression_ratio", static_cast<double>(site_bytes) / halo_site_bytes);
+      }
+
       printfQuda("Effective halo bi-directional bandwidth (GB/s) GPU = %f ( CPU = %f, min = %f , max = %f ) for "
                  "aggregate message size %lu bytes\n",
                  1.0e-9 * 2 * ghost_bytes * niter / dslash_time.event_time,
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <eigensolve_quda.h>
+#include <eigen_helper.h>
+#include <test.h>
+
+/*
+   This test checks the structured arrow-plus-tridiagonal eigensolver
+   used by the thick-restarted Lanczos method for large restarts
+   (arrowEigensolve and orthonormalizeRitzClusters) against the dense
+   Eigen solver.  The matrices are larger than the size at which TRLM
+   switches to the structured solver, and include degenerate Ritz
+   values (decoupled equal diagonal elements) and tight clusters.
+ */
+
+using namespace quda;
+
+// n, arrow position, whether to add degenerate and clustered Ritz values
+using test_t = ::testing::tuple<int, int, bool>;
+
+struct EigArrowTest : public ::testing::TestWithParam<test_t> {
+  int n;
+  int m;
+  bool clustered;
+  EigArrowTest() :
+    n(::testing::get<0>(GetParam())), m(::testing::get<1>(GetParam())), clustered(::testing::get<2>(GetParam()))
+  {
+  }
+};
+
+TEST_P(EigArrowTest, verify)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  // the kept Ritz values and their couplings form the arrow, followed by the new Lanczos coefficients
+  std::vector<double> d(n), e(n - 1);
+  for (auto &di : d) di = dist(gen);
+  for (auto &ei : e) ei = 0.1 * dist(gen);
+  std::sort(d.begin(), d.begin() + m);
+
+  if (clustered) {
+    // converged Ritz values decouple from the arrow: equal pairs give degenerate eigenvalues
+    for (int i = 0; i < m / 4; i += 2) {
+      d[i + 1] = d[i];
+      e[i] = e[i + 1] = 0.0;
+    }
+    // a tight cluster of weakly coupled Ritz values
+    for (int i = m / 2; i < m / 2 + 8; i++) {
+      d[i] = 0.5 + 1e-10 * (i - m / 2);
+      e[i] = 1e-9 * dist(gen);
+    }
+  }
+
+  MatrixXd A = MatrixXd::Zero(n, n);
+  for (int i = 0; i < n; i++) A(i, i) = d[i];
+  for (int i = 0; i < m; i++) A(i, m) = A(m, i) = e[i];
+  for (int i = m; i < n - 1; i++) A(i, i + 1) = A(i + 1, i) = e[i];
+
+  SelfAdjointEigenSolver<MatrixXd> eigensolver(A);
+  const auto &w_ref = eigensolver.eigenvalues();
+  const auto &V_ref = eigensolver.eigenvectors();
+  const double norm = std::max(std::abs(w_ref[0]), std::abs(w_ref[n - 1]));
+
+  std::vector<double> w, V;
+  arrowEigensolve(d, e, m, w, V);
+  orthonormalizeRitzClusters(V, w.data(), n, n);
+  ASSERT_EQ(w.size(), static_cast<size_t>(n));
+  Eigen::Map<MatrixXd> X(V.data(), n, n);
+
+  for (int j = 0; j < n; j++) {
+    EXPECT_LE(std::abs(w[j] - w_ref[j]), 1e-12 * norm) << "eigenvalue " << j;
+    EXPECT_LE((A * X.col(j) - w[j] * X.col(j)).norm(), 1e-10 * norm) << "eigenvector " << j;
+
+    // isolated eigenvectors are unique up to sign
+    bool isolated = (j == 0 || w_ref[j] - w_ref[j - 1] > 1e-3 * norm)
+      && (j == n - 1 || w_ref[j + 1] - w_ref[j] > 1e-3 * norm);
+    if (isolated) EXPECT_GE(std::abs(X.col(j).dot(V_ref.col(j))), 1.0 - 1e-10) << "eigenvector " << j;
+  }
+
+  // within the degenerate and clustered subspaces the vectors are only unique up to rotation, so check orthonormality
+  auto ortho = (X.transpose() * X - MatrixXd::Identity(n, n)).cwiseAbs().maxCoeff();
+  EXPECT_LE(ortho, 1e-10);
+}
+
+INSTANTIATE_TEST_SUITE_P(EigArrow, EigArrowTest,
+                         ::testing::Combine(::testing::Values(300, 600), ::testing::Values(64, 200),
+                                            ::testing::Values(false, true)),
+                         [](const ::testing::TestParamInfo<test_t> &info) {
+                           return "n" + std::to_string(::testing::get<0>(info.param)) + "_m"
+                             + std::to_string(::testing::get<1>(info.param))
+                             + (::testing::get<2>(info.param) ? "_clustered" : "");
+                         });
+
+int main(int argc, char **argv)
+{
+  quda_test test("eig_arrow_test", argc, argv);
+  test.init();
+  return test.execute();
+}
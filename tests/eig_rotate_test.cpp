@@ -0,0 +1,97 @@
+#include <random>
+#include <vector>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <eigensolve_quda.h>
+#include <test.h>
+#include "misc.h"
+
+/*
+   This test checks the site-blocked GEMM rotation used by the
+   eigensolvers (rotateVecsGEMM) against the multi-BLAS rotation used
+   by EigenSolver::rotateVecs.  A set of random vectors is rotated in
+   place by a random n_dim x n_keep matrix, with a workspace small enough
+   that the rotation is done over several blocks of sites, and
+   compared with the result of blas::block::caxpy.
+ */
+
+using namespace quda;
+using test_t = ::testing::tuple<QudaPrecision, QudaFieldLocation>;
+constexpr int n_dim = 24;
+constexpr int n_keep = 16;
+
+struct EigRotateTest : public ::testing::TestWithParam<test_t> {
+  QudaPrecision prec;
+  QudaFieldLocation location;
+  EigRotateTest() : prec(::testing::get<0>(GetParam())), location(::testing::get<1>(GetParam())) { }
+};
+
+TEST_P(EigRotateTest, verify)
+{
+  if ((QUDA_PRECISION & prec) == 0) GTEST_SKIP();
+#ifndef NATIVE_LAPACK_LIB
+  if (location == QUDA_CUDA_FIELD_LOCATION) GTEST_SKIP();
+#endif
+
+  ColorSpinorParam param;
+  param.nColor = 3;
+  param.nSpin = 4;
+  param.nDim = 4;
+  param.siteSubset = QUDA_PARITY_SITE_SUBSET;
+  param.x[0] = xdim / 2;
+  param.x[1] = ydim;
+  param.x[2] = zdim;
+  param.x[3] = tdim;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.pc_type = QUDA_4D_PC;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  param.setPrecision(QUDA_DOUBLE_PRECISION);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  ColorSpinorField h(param);
+
+  param.location = location;
+  param.setPrecision(prec, prec, true);
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  std::vector<ColorSpinorField> v, w;
+  resize(v, n_dim, param);
+  resize(w, n_keep, param);
+  for (auto &vi : v) {
+    h.Source(QUDA_RANDOM_SOURCE, 0, 0, 0);
+    vi = h;
+  }
+
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<Complex> rot(n_dim * n_keep);
+  for (auto &r : rot) r = {dist(gen), dist(gen)};
+
+  // reference: w_j = sum_i v_i rot[i * keep + j]
+  blas::block::caxpy(rot, v, w);
+
+  // blocks are at least 4096 rows, so the ctest lattice (8^3x10) gives several blocks and a partial one
+  rotateVecsGEMM(v, rot, n_dim, n_keep, 1);
+
+  auto tol = prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5;
+  for (int j = 0; j < n_keep; j++) {
+    auto w2 = blas::norm2(w[j]);
+    auto dev = blas::xmyNorm(v[j], w[j]);
+    EXPECT_LE(sqrt(dev / w2), tol) << "vector " << j;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(EigRotate, EigRotateTest,
+                         ::testing::Combine(::testing::Values(QUDA_SINGLE_PRECISION, QUDA_DOUBLE_PRECISION),
+                                            ::testing::Values(QUDA_CPU_FIELD_LOCATION, QUDA_CUDA_FIELD_LOCATION)),
+                         [](const ::testing::TestParamInfo<test_t> &info) {
+                           return std::string(get_prec_str(::testing::get<0>(info.param)))
+                             + (::testing::get<1>(info.param) == QUDA_CUDA_FIELD_LOCATION ? "_device" : "_host");
+                         });
+
+int main(int argc, char **argv)
+{
+  quda_test test("eig_rotate_test", argc, argv);
+  test.init();
+  return test.execute();
+}
@@ -44,6 +44,7 @@ void display_test_info(QudaEigParam &param)
   printfQuda(" - solver mode %s\n", get_eig_type_str(param.eig_type));
   printfQuda(" - spectrum requested %s\n", get_eig_spectrum_str(param.spectrum));
   if (param.eig_type == QUDA_EIG_BLK_TR_LANCZOS) printfQuda(" - eigenvector block size %d\n", param.block_size);
+  if (param.eig_type == QUDA_EIG_CHEB_FILTERED_SUBSPACE) printfQuda(" - filter batch size %d\n", param.block_size);
   printfQuda(" - number of eigenvectors requested %d\n", param.n_conv);
   printfQuda(" - size of eigenvector search space %d\n", param.n_ev);
   printfQuda(" - size of Krylov space %d\n", param.n_kr);
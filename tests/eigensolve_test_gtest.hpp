@@ -9,6 +9,9 @@ bool skip_test(test_t param)
   if (!quda::is_enabled(prec)) return true; // skip if precision is not enabled
   // dwf-style solves must use a normal solver
   if (is_chiral(dslash_type) && (::testing::get<2>(param) == QUDA_BOOLEAN_FALSE)) return true;
+  // the Chebyshev filter only targets the low end of the spectrum
+  if (::testing::get<1>(param) == QUDA_EIG_CHEB_FILTERED_SUBSPACE && ::testing::get<5>(param) != QUDA_SPECTRUM_SR_EIG)
+    return true;
   return false;
 }
 
@@ -96,7 +99,8 @@ using ::testing::Combine;
 using ::testing::Values;
 
 // Can solve hermitian systems
-auto hermitian_solvers = Values(QUDA_EIG_TR_LANCZOS, QUDA_EIG_BLK_TR_LANCZOS, QUDA_EIG_IR_ARNOLDI);
+auto hermitian_solvers
+  = Values(QUDA_EIG_TR_LANCZOS, QUDA_EIG_BLK_TR_LANCZOS, QUDA_EIG_IR_ARNOLDI, QUDA_EIG_CHEB_FILTERED_SUBSPACE);
 
 // Can solve non-hermitian systems
 auto non_hermitian_solvers = Values(QUDA_EIG_IR_ARNOLDI);
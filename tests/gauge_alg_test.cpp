@@ -67,6 +67,18 @@ struct GaugeAlgTest : public ::testing::TestWithParam<test_t> {
     return ((a0 < prec_val) && (a1 < prec_val) && (a2 < prec_val));
   }
 
+  /**
+     @brief Check that the FFT gauge fixing met its stopping
+     criterion, theta or the change in the gauge functional, rather
+     than running out of iterations
+     @param[in] quality The gauge functional, theta and last change in the functional
+   */
+  bool checkConvergence(double3 quality)
+  {
+    printfQuda("Functional: %.16e, theta: %.16e, delta: %.16e\n", quality.x, quality.y, quality.z);
+    return gf_theta_condition ? quality.y < gf_tolerance : quality.z < gf_tolerance;
+  }
+
   bool CheckDeterminant(double2 detu)
   {
     double prec_val = 5e-8;
@@ -76,14 +88,6 @@ struct GaugeAlgTest : public ::testing::TestWithParam<test_t> {
 
   virtual void SetUp()
   {
-#ifndef QUDA_BUILD_NATIVE_FFT // skip FFT tests if FFT not available
-    const ::testing::TestInfo *const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
-    const char *name = test_info->name();
-    if (strncmp(name, "Landau_FFT", 10) == 0 || strncmp(name, "Coulomb_FFT", 11) == 0) {
-      execute = false;
-      GTEST_SKIP();
-    }
-#endif
     if (!is_enabled(precision)) {
       execute = false;
       GTEST_SKIP();
@@ -241,20 +245,17 @@ struct GaugeAlgTest : public ::testing::TestWithParam<test_t> {
   virtual void run_fft()
   {
     if (execute) {
-      if (!comm_partitioned()) {
-        printfQuda("Landau gauge fixing with steepest descent method with FFTs\n");
-        gaugeFixingFFT(*U, gf_gauge_dir, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
-                       gf_theta_condition);
-
-        auto plaq_gf = plaquette(*U);
-        printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
-        printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
-        ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
-        // Save if output string is specified
-        if (gauge_store) save_gauge();
-      } else {
-        errorQuda("Cannot perform FFT gauge fixing with MPI partitions.");
-      }
+      printfQuda("Landau gauge fixing with steepest descent method with FFTs\n");
+      auto quality = gaugeFixingFFT(*U, gf_gauge_dir, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune,
+                                    gf_tolerance, gf_theta_condition);
+
+      auto plaq_gf = plaquette(*U);
+      printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
+      printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
+      ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
+      ASSERT_TRUE(checkConvergence(quality));
+      // Save if output string is specified
+      if (gauge_store) save_gauge();
     }
   }
 
@@ -327,30 +328,72 @@ TEST_P(GaugeAlgTest, Coulomb_Overrelaxation)
 TEST_P(GaugeAlgTest, Landau_FFT)
 {
   if (execute) {
-    if (!comm_partitioned()) {
-      printfQuda("Landau gauge fixing with steepest descent method with FFTs\n");
-      gaugeFixingFFT(*U, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
-                     gf_theta_condition);
-      auto plaq_gf = plaquette(*U);
-      printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
-      printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
-      ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
-    }
+    printfQuda("Landau gauge fixing with steepest descent method with FFTs\n");
+    auto quality = gaugeFixingFFT(*U, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
+                                  gf_theta_condition);
+    auto plaq_gf = plaquette(*U);
+    printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
+    printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
+    ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
+    ASSERT_TRUE(checkConvergence(quality));
   }
 }
 
 TEST_P(GaugeAlgTest, Coulomb_FFT)
 {
   if (execute) {
-    if (!comm_partitioned()) {
-      printfQuda("Coulomb gauge fixing with steepest descent method with FFTs\n");
-      gaugeFixingFFT(*U, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
-                     gf_theta_condition);
-      auto plaq_gf = plaquette(*U);
-      printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
-      printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
-      ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
-    }
+    printfQuda("Coulomb gauge fixing with steepest descent method with FFTs\n");
+    auto quality = gaugeFixingFFT(*U, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
+                                  gf_theta_condition);
+    auto plaq_gf = plaquette(*U);
+    printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
+    printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
+    ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
+    ASSERT_TRUE(checkConvergence(quality));
+  }
+}
+
+TEST_P(GaugeAlgTest, Landau_FFT_Partitioned)
+{
+  if (execute) {
+    // the unpartitioned reference needs the whole lattice on this rank
+    if (comm_size() > 1 || comm_partitioned()) GTEST_SKIP();
+
+    // the same configuration, fixed with the single-rank FFTs and with the distributed FFTs
+    GaugeFieldParam gParam(*U);
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    for (int d = 0; d < 4; d++) gParam.r[d] = 0;
+    GaugeField ref(gParam);
+    copyExtendedGauge(ref, *U, QUDA_CUDA_FIELD_LOCATION);
+
+    printfQuda("Landau gauge fixing with FFTs on the unpartitioned lattice\n");
+    auto quality_ref = gaugeFixingFFT(ref, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, false, gf_tolerance,
+                                      gf_theta_condition);
+    ASSERT_TRUE(checkConvergence(quality_ref));
+
+    // partitioning every dimension on a single rank takes the distributed FFT, face exchange and
+    // global momentum paths, with each rank (this one) its own neighbour
+    for (int d = 0; d < 4; d++) commDimPartitionedSet(d);
+    if (!comm_partitioned()) GTEST_SKIP(); // single-GPU build
+
+    GaugeField dist(gParam);
+    copyExtendedGauge(dist, *U, QUDA_CUDA_FIELD_LOCATION);
+    printfQuda("Landau gauge fixing with FFTs on the partitioned lattice\n");
+    auto quality = gaugeFixingFFT(dist, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, false, gf_tolerance,
+                                  gf_theta_condition);
+    commDimPartitionedReset();
+    ASSERT_TRUE(checkConvergence(quality));
+
+    // the gauge functional and link trace depend on the gauge, so they only agree if both runs found the same gauge
+    auto tr_ref = getLinkTrace(ref);
+    auto tr = getLinkTrace(dist);
+    printfQuda("Tr ref: %.16e:%.16e\n", tr_ref.x / 3.0, tr_ref.y / 3.0);
+    printfQuda("Tr:     %.16e:%.16e\n", tr.x / 3.0, tr.y / 3.0);
+    double tol = precision == QUDA_DOUBLE_PRECISION ? gf_tolerance * 1e2 : 1e-5;
+    EXPECT_LT(std::abs(quality.x - quality_ref.x), tol);
+    EXPECT_LT(std::abs(tr.x - tr_ref.x) / 3.0, tol);
+    EXPECT_LT(std::abs(tr.y - tr_ref.y) / 3.0, tol);
   }
 }
 
@@ -1,11 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 #include <quda.h>
 #include <host_utils.h>
 #include <command_line_params.h>
 #include <gauge_field.h>
+#include <clover_field.h>
 #include <instantiate.h>
 #include "misc.h"
 #include "gauge_force_reference.h"
@@ -392,6 +396,193 @@ void gauge_loop_test(loop_test_t loop_param)
     << "Plaquette from QUDA loop trace and QUDA dedicated plaquette function do not agree";
 }
 
+using md_test_t = ::testing::tuple<QudaPrecision, QudaMDIntegrator, bool>;
+
+// Integrate a trajectory of the Wilson gauge action, optionally with a
+// clover-Wilson pseudofermion, forwards and then backwards, which must
+// return to the starting Hamiltonian and plaquette.  The trajectory is
+// then repeated from the same starting point with half the step size:
+// the energy violation must scale with the order of the integrator,
+// which requires the force to be consistent with the action.
+void gauge_md_test(md_test_t md_param)
+{
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  setWilsonGaugeParam(gauge_param);
+
+  gauge_param.cuda_prec = ::testing::get<0>(md_param);
+  gauge_param.gauge_order = gauge_order;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+
+  setDims(gauge_param.X);
+
+  auto integrator = ::testing::get<1>(md_param);
+  bool clover = ::testing::get<2>(md_param);
+
+  // the plaquette staples
+  int num_paths = 6;
+  int max_length = 3;
+  std::vector<double> loop_coeff(num_paths, 1.0);
+  int **input_path_buf[4];
+  for (int dir = 0; dir < 4; dir++) {
+    input_path_buf[dir] = (int **)safe_malloc(num_paths * sizeof(int *));
+    for (int i = 0; i < num_paths; i++) {
+      input_path_buf[dir][i] = (int *)safe_malloc(length[i] * sizeof(int));
+      if (dir == 0)
+        memcpy(input_path_buf[dir][i], path_dir_x[i], length[i] * sizeof(int));
+      else if (dir == 1)
+        memcpy(input_path_buf[dir][i], path_dir_y[i], length[i] * sizeof(int));
+      else if (dir == 2)
+        memcpy(input_path_buf[dir][i], path_dir_z[i], length[i] * sizeof(int));
+      else if (dir == 3)
+        memcpy(input_path_buf[dir][i], path_dir_t[i], length[i] * sizeof(int));
+    }
+  }
+
+  quda::GaugeFieldParam param(gauge_param);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  param.order = QUDA_QDP_GAUGE_ORDER;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  quda::GaugeField U_qdp(param);
+
+  // fills the gauge field with random numbers
+  createSiteLinkCPU(U_qdp, gauge_param.cpu_prec, 0);
+
+  param.order = QUDA_MILC_GAUGE_ORDER;
+  quda::GaugeField U_milc(param);
+  if (gauge_order == QUDA_MILC_GAUGE_ORDER) U_milc.copy(U_qdp);
+
+  void *sitelink = nullptr;
+  void *sitelink_array[QUDA_MAX_DIM];
+  if (gauge_order == QUDA_MILC_GAUGE_ORDER) {
+    sitelink = U_milc.data();
+  } else if (gauge_order == QUDA_QDP_GAUGE_ORDER) {
+    for (int d = 0; d < 4; d++) sitelink_array[d] = U_qdp.data(d);
+    sitelink = reinterpret_cast<void *>(sitelink_array);
+  } else {
+    errorQuda("Unsupported gauge order %d", gauge_order);
+  }
+
+  loadGaugeQuda(sitelink, &gauge_param);
+
+  // two-flavour clover-Wilson pseudofermion: S = phi^dag (M^dag M)^-1 phi - 2 Tr log A
+  QudaInvertParam inv_param = newQudaInvertParam();
+  std::vector<double> phi;
+  if (clover) {
+    auto dslash_type_save = dslash_type;
+    dslash_type = QUDA_CLOVER_WILSON_DSLASH;
+    setInvertParam(inv_param);
+    dslash_type = dslash_type_save;
+
+    inv_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+    inv_param.clover_cpu_prec = QUDA_DOUBLE_PRECISION;
+    inv_param.cuda_prec = inv_param.cuda_prec_sloppy = gauge_param.cuda_prec;
+    inv_param.clover_cuda_prec = inv_param.clover_cuda_prec_sloppy = gauge_param.cuda_prec;
+    inv_param.cuda_prec_precondition = inv_param.clover_cuda_prec_precondition = gauge_param.cuda_prec;
+    inv_param.cuda_prec_refinement_sloppy = inv_param.clover_cuda_prec_refinement_sloppy = gauge_param.cuda_prec;
+    inv_param.cuda_prec_eigensolver = inv_param.clover_cuda_prec_eigensolver = gauge_param.cuda_prec;
+    inv_param.compute_clover = 1;
+    inv_param.compute_clover_inverse = 1;
+    inv_param.return_clover = 0;
+    inv_param.return_clover_inverse = 0;
+    loadCloverQuda(nullptr, nullptr, &inv_param);
+
+    inv_param.inv_type = QUDA_CG_INVERTER;
+    inv_param.solution_type = QUDA_MATPCDAG_MATPC_SOLUTION;
+    inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
+    inv_param.matpc_type = QUDA_MATPC_EVEN_EVEN_ASYMMETRIC;
+    inv_param.mass_normalization = QUDA_KAPPA_NORMALIZATION;
+    inv_param.num_offset = 1;
+    inv_param.offset[0] = 0.0;
+    inv_param.residue[0] = 1.0;
+    inv_param.tol = inv_param.tol_offset[0] = 1e-12;
+    inv_param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+    inv_param.maxiter = 10000;
+
+    phi.resize(V / 2 * spinor_site_size);
+    for (auto &p : phi) p = rand() / static_cast<double>(RAND_MAX) - 0.5;
+  }
+
+  double plaq_begin[3], plaq_end[3];
+  plaqQuda(plaq_begin);
+
+  double beta_nc = 5.6 / 3.0;
+  double tau = 0.2;
+  int n_steps = 4;
+
+  void *action = newMDActionQuda(&gauge_param);
+  addGaugeMonomialQuda(action, input_path_buf, length, loop_coeff.data(), num_paths, max_length, beta_nc);
+  if (clover) addCloverMonomialQuda(action, phi.data(), 0.0, 2.0, &inv_param);
+
+  const int n_h = clover ? 3 : 2;
+  auto sum = [n_h](const double *h) {
+    double s = 0.0;
+    for (int i = 0; i < n_h; i++) s += h[i];
+    return s;
+  };
+
+  double h_begin[3], h_end[3], h_reverse[3], h_begin2[3], h_end2[3];
+  trajectoryMDQuda(action, tau, n_steps, integrator, 1234, h_begin, h_end);
+  evolveMDQuda(action, -tau, n_steps, integrator);
+  hamiltonianMDQuda(action, h_reverse);
+  plaqQuda(plaq_end);
+
+  // the same trajectory, with the same starting field and momentum, with half the step size
+  rejectMDQuda(action);
+  trajectoryMDQuda(action, tau, 2 * n_steps, integrator, 1234, h_begin2, h_end2);
+
+  double dH = sum(h_end) - sum(h_begin);
+  double dH2 = sum(h_end2) - sum(h_begin2);
+  printfQuda("H = %e, dH = %e with %d steps, dH = %e with %d steps, reversibility violation = %e\n", sum(h_begin), dH,
+             n_steps, dH2, 2 * n_steps, sum(h_reverse) - sum(h_begin));
+
+  destroyMDActionQuda(action);
+
+  // return the resident momentum to free it
+  param.order = QUDA_MILC_GAUGE_ORDER;
+  param.reconstruct = QUDA_RECONSTRUCT_10;
+  param.link_type = QUDA_ASQTAD_MOM_LINKS;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  quda::GaugeField Mom_milc(param);
+  param.order = QUDA_QDP_GAUGE_ORDER;
+  quda::GaugeField Mom_qdp(param);
+  void *mom_array[QUDA_MAX_DIM];
+  for (int d = 0; d < 4; d++) mom_array[d] = Mom_qdp.data(d);
+  void *mom = gauge_order == QUDA_MILC_GAUGE_ORDER ? Mom_milc.data() : reinterpret_cast<void *>(mom_array);
+  gauge_param.make_resident_mom = 0;
+  gauge_param.return_result_mom = 1;
+  momResidentQuda(mom, &gauge_param);
+
+  if (clover) freeCloverQuda();
+  freeGaugeQuda();
+
+  for (int dir = 0; dir < 4; dir++) {
+    for (int i = 0; i < num_paths; i++) host_free(input_path_buf[dir][i]);
+    host_free(input_path_buf[dir]);
+  }
+
+  double h = 0.0;
+  for (int i = 0; i < n_h; i++) h += std::abs(h_begin[i]);
+  auto tol = getTolerance(gauge_param.cuda_prec);
+  ASSERT_LE(std::abs(sum(h_reverse) - sum(h_begin)) / h, tol) << "Hamiltonian not restored by reversing the trajectory";
+  ASSERT_LE(std::abs(plaq_end[0] - plaq_begin[0]), tol) << "Plaquette not restored by reversing the trajectory";
+  ASSERT_LE(std::abs(sum(h_begin2) - sum(h_begin)) / h, tol)
+    << "Trajectory not restarted from the same field and momentum";
+
+  // the energy violation vanishes with the step size; an inconsistent force leaves an O(1) violation
+  ASSERT_LE(std::abs(dH), 1e-2 * h) << "Energy violation too large";
+
+  // the violation of a trajectory scales as the step size to the order of the integrator (the minimum-norm
+  // Omelyan integrator is second order), which can only be resolved above the rounding of the Hamiltonian
+  int order = integrator == QUDA_MD_INTEGRATOR_FORCE_GRADIENT ? 4 : 2;
+  double noise = 1e3 * std::numeric_limits<double>::epsilon() * h;
+  if (gauge_param.cuda_prec == QUDA_DOUBLE_PRECISION && std::abs(dH2) > noise) {
+    double ratio = dH / dH2;
+    printfQuda("Energy violation ratio = %e, expected %d\n", ratio, 1 << order);
+    ASSERT_GE(ratio, 0.5 * (1 << order)) << "Energy violation does not scale with the order of the integrator";
+    ASSERT_LE(ratio, 2.0 * (1 << order)) << "Energy violation does not scale with the order of the integrator";
+  }
+}
+
 struct GaugePathTest : public ::testing::TestWithParam<force_test_t>
 {
   force_test_t param;
@@ -418,6 +609,21 @@ TEST_P(GaugeLoopTest, verify)
   gauge_loop_test(param);
 }
 
+struct GaugeMDTest : public ::testing::TestWithParam<md_test_t>
+{
+  md_test_t param;
+  GaugeMDTest() : param(GetParam()) { }
+};
+
+TEST_P(GaugeMDTest, verify)
+{
+  QudaPrecision prec = ::testing::get<0>(param);
+  if (!quda::is_enabled(prec)) GTEST_SKIP();
+  // the fermion monomial is only tested in double precision, where the solver is accurate enough for the energy
+  if (::testing::get<2>(param) && (!quda::is_enabled_clover() || prec != QUDA_DOUBLE_PRECISION)) GTEST_SKIP();
+  gauge_md_test(param);
+}
+
 using ::testing::Combine;
 using ::testing::Values;
 
@@ -433,6 +639,20 @@ INSTANTIATE_TEST_SUITE_P(GaugeLoopTest, GaugeLoopTest,
                          [](testing::TestParamInfo<loop_test_t> param)
                          { return std::string(get_prec_str(testing::get<0>(param.param))); });
 
+INSTANTIATE_TEST_SUITE_P(GaugeMDTest, GaugeMDTest,
+                         Combine(Values(QUDA_SINGLE_PRECISION, QUDA_DOUBLE_PRECISION),
+                                 Values(QUDA_MD_INTEGRATOR_LEAPFROG, QUDA_MD_INTEGRATOR_OMELYAN,
+                                        QUDA_MD_INTEGRATOR_FORCE_GRADIENT),
+                                 Values(false, true)),
+                         [](testing::TestParamInfo<md_test_t> param) {
+                           auto integrator = testing::get<1>(param.param);
+                           return std::string(get_prec_str(testing::get<0>(param.param))) + "_"
+                             + (integrator == QUDA_MD_INTEGRATOR_LEAPFROG ? "leapfrog" :
+                                integrator == QUDA_MD_INTEGRATOR_OMELYAN  ? "omelyan" :
+                                                                            "force_gradient")
+                             + (testing::get<2>(param.param) ? "_clover" : "");
+                         });
+
 static void display_test_info()
 {
   printfQuda("running the following test:\n");
@@ -482,6 +702,7 @@ int main(int argc, char **argv)
     gauge_force_test({prec, true});
     gauge_force_test({prec, false});
     gauge_loop_test({prec});
+    gauge_md_test({prec, QUDA_MD_INTEGRATOR_OMELYAN, false});
   }
 
   endQuda();
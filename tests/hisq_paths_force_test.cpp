@@ -11,6 +11,8 @@
 #include "hisq_force_reference.h"
 #include "ks_improved_force.h"
 #include "momentum.h"
+#include <color_spinor_field.h>
+#include <staggered_oprod.h>
 #include <timer.h>
 #include <gtest/gtest.h>
 
@@ -561,6 +563,78 @@ static int hisq_force_test(bool lepage)
   return accuracy_level;
 }
 
+/**
+   @brief Check the batched staggered outer product, as used by the
+   HISQ force, against the sum of the outer products of each field.
+   More fields than get_max_multi_rhs() are used, so the batch is
+   split, and on a partitioned dimension the exterior kernels of the
+   one- and three-hop terms are also exercised.
+   @param[in] nFace Number of faces (1 or 3)
+   @return The deviation relative to the largest element of the outer product
+ */
+static double staggered_oprod_test(int nFace)
+{
+  const int n = get_max_multi_rhs() + 1;
+
+  ColorSpinorParam param;
+  param.nColor = 3;
+  param.nSpin = 1;
+  param.nDim = 4;
+  param.pc_type = QUDA_4D_PC;
+  param.siteSubset = QUDA_FULL_SITE_SUBSET;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  param.create = QUDA_NULL_FIELD_CREATE;
+  param.setPrecision(force_prec);
+  for (int d = 0; d < 4; d++) param.x[d] = cpuGauge->X()[d];
+  ColorSpinorField host(param);
+
+  param.location = QUDA_CUDA_FIELD_LOCATION;
+  param.setPrecision(force_prec, force_prec, true);
+  std::vector<ColorSpinorField> quark(n, param);
+  std::vector<array<double, 2>> coeff(n);
+  for (int i = 0; i < n; i++) {
+    host.Source(QUDA_RANDOM_SOURCE);
+    quark[i] = host;
+    coeff[i] = {1.0 / (i + 1), nFace == 3 ? -0.5 / (i + 2) : 0.0};
+  }
+
+  GaugeFieldParam oParam(*cudaForce);
+  oParam.create = QUDA_ZERO_FIELD_CREATE;
+  GaugeField batched[2] = {GaugeField(oParam), GaugeField(oParam)};
+  GaugeField single[2] = {GaugeField(oParam), GaugeField(oParam)};
+
+  GaugeField *out_batched[2] = {&batched[0], &batched[1]};
+  computeStaggeredOprod(out_batched, {quark.begin(), quark.end()}, coeff, nFace);
+
+  GaugeField *out_single[2] = {&single[0], &single[1]};
+  for (int i = 0; i < n; i++) {
+    double c[2] = {coeff[i][0], coeff[i][1]};
+    computeStaggeredOprod(out_single, quark[i], c, nFace);
+  }
+
+  GaugeFieldParam hParam(*cpuForce);
+  hParam.create = QUDA_NULL_FIELD_CREATE;
+  GaugeField a(hParam);
+  GaugeField b(hParam);
+
+  double deviation = 0.0;
+  for (int k = 0; k < (nFace == 3 ? 2 : 1); k++) {
+    a.copy(batched[k]);
+    b.copy(single[k]);
+    double scale = single[k].abs_max();
+    for (int dir = 0; dir < 4; dir++) {
+      double diff = compare_floats_v2(a.data(dir), b.data(dir), V * gauge_site_size, scale, force_prec);
+      deviation = std::max(deviation, diff / scale);
+    }
+  }
+  logQuda(QUDA_SUMMARIZE, "Batched outer product of %d fields with nFace = %d: relative deviation %e\n", n, nFace,
+          deviation);
+
+  return deviation;
+}
+
 static void display_test_info()
 {
   printfQuda("running the following fermion force computation test:\n");
@@ -592,6 +666,14 @@ TEST(paths_no_lepage, verify)
   }
 }
 
+TEST(oprod, batched)
+{
+  for (int nFace : {1, 3}) {
+    double deviation = staggered_oprod_test(nFace);
+    ASSERT_LE(deviation, getTolerance(force_prec)) << "Batched and single-field outer products do not agree";
+  }
+}
+
 int main(int argc, char **argv)
 {
   // initalize google test
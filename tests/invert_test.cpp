@@ -396,6 +396,141 @@ std::vector<std::array<double, 2>> solve(test_t param)
   return res;
 }
 
+chrono_result_t chrono_test()
+{
+  loadFields(QUDA_DOUBLE_PRECISION);
+
+  // a multi-RHS batch, so that replacing the newest entries covers every right-hand side
+  const int n_src = 2;
+  multishift = 1;
+
+  QudaInvertParam param = inv_param;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.solution_type = QUDA_MATPC_SOLUTION;
+  param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  param.cuda_prec = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_sloppy = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_refinement_sloppy = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_precondition = QUDA_DOUBLE_PRECISION;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.tol = 1e-10;
+  param.tol_hq = 0.0;
+  param.maxiter = 10000;
+  param.num_offset = 0;
+  param.solution_accumulator_pipeline = 1;
+  param.eig_param = nullptr;
+  param.preconditioner = nullptr;
+  param.inv_type_precondition = QUDA_INVALID_INVERTER;
+  param.schwarz_type = QUDA_INVALID_SCHWARZ;
+  param.use_adaptive_reliable = 0;
+  param.num_src = n_src;
+  param.num_src_per_sub_partition = n_src;
+  for (int d = 0; d < 4; d++) param.split_grid[d] = 1;
+
+  param.chrono_index = 0;
+  param.chrono_max_dim = 2 * n_src;
+  param.chrono_precision = QUDA_DOUBLE_PRECISION;
+  param.chrono_storage_precision = chrono_storage_prec;
+  flushChronoQuda(param.chrono_index);
+
+  const size_t length = Vh * spinor_site_size;
+  std::vector<std::vector<double>> b(n_src, std::vector<double>(length));
+  std::vector<std::vector<double>> x(n_src, std::vector<double>(length));
+  std::vector<double> check(length);
+  std::vector<void *> b_ptr(n_src), x_ptr(n_src);
+  for (int i = 0; i < n_src; i++) {
+    for (auto &v : b[i]) v = rand() / static_cast<double>(RAND_MAX) - 0.5;
+    b_ptr[i] = b[i].data();
+    x_ptr[i] = x[i].data();
+  }
+
+  chrono_result_t result = {0, 0, 0, 0.0};
+  auto chrono_solve = [&](bool use_resident, bool replace_last) {
+    param.chrono_use_resident = use_resident;
+    param.chrono_make_resident = 1;
+    param.chrono_replace_last = replace_last;
+    for (auto &xi : x) std::fill(xi.begin(), xi.end(), 0.0);
+    invertMultiSrcQuda(x_ptr.data(), b_ptr.data(), &param);
+    for (int i = 0; i < n_src; i++) {
+      auto rsd = verifyInversion(x[i].data(), b[i].data(), check.data(), gauge_param, param, gauge.data(),
+                                 clover.data(), clover_inv.data(), i);
+      result.res_max = std::max(result.res_max, rsd[0]);
+    }
+    return param.iter;
+  };
+
+  // populate the history
+  result.iter_cold = chrono_solve(false, false);
+
+  // a slowly varying source, as in molecular dynamics: the forecast replaces the newest entries
+  for (auto &bi : b)
+    for (auto &v : bi) v += 1e-2 * (rand() / static_cast<double>(RAND_MAX) - 0.5);
+  result.iter_forecast = chrono_solve(true, true);
+
+  // changing the operator leaves the stored Gram matrix stale: the forecast must detect this and rebuild it
+  param.kappa *= 0.98;
+  result.iter_changed = chrono_solve(true, false);
+
+  flushChronoQuda(param.chrono_index);
+  return result;
+}
+
+streamed_deflation_result_t streamed_deflation_test()
+{
+  loadFields(QUDA_DOUBLE_PRECISION);
+  multishift = 1;
+
+  QudaInvertParam param = inv_param;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.solution_type = QUDA_MATPC_SOLUTION;
+  param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  param.cuda_prec = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_sloppy = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_refinement_sloppy = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_precondition = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_eigensolver = QUDA_DOUBLE_PRECISION;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.tol = 1e-12;
+  param.tol_hq = 0.0;
+  param.maxiter = 10000;
+  param.num_offset = 0;
+  param.solution_accumulator_pipeline = 1;
+  param.preconditioner = nullptr;
+  param.inv_type_precondition = QUDA_INVALID_INVERTER;
+  param.schwarz_type = QUDA_INVALID_SCHWARZ;
+  param.use_adaptive_reliable = 0;
+
+  // the space is recomputed for each solve, and only a space that is not preserved is moved to the host
+  QudaEigParam eig = eig_param;
+  eig.preserve_deflation = QUDA_BOOLEAN_FALSE;
+  param.eig_param = &eig;
+
+  const size_t length = Vh * spinor_site_size;
+  std::vector<double> b(length);
+  for (auto &v : b) v = rand() / static_cast<double>(RAND_MAX) - 0.5;
+  std::vector<double> x_device(length, 0.0);
+  std::vector<double> x_host(length, 0.0);
+
+  streamed_deflation_result_t result = {0, 0, 0.0};
+  eig.deflation_location = QUDA_CUDA_FIELD_LOCATION;
+  invertQuda(x_device.data(), b.data(), &param);
+  result.iter_device = param.iter;
+
+  eig.deflation_location = QUDA_CPU_FIELD_LOCATION;
+  invertQuda(x_host.data(), b.data(), &param);
+  result.iter_host = param.iter;
+
+  double diff2 = 0.0, norm2 = 0.0;
+  for (size_t i = 0; i < length; i++) {
+    diff2 += (x_host[i] - x_device[i]) * (x_host[i] - x_device[i]);
+    norm2 += x_device[i] * x_device[i];
+  }
+  quda::comm_allreduce_sum(diff2);
+  quda::comm_allreduce_sum(norm2);
+  result.sol_diff = sqrt(diff2 / norm2);
+  return result;
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -465,10 +600,27 @@ int main(int argc, char **argv)
     if (quda::comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
     result = RUN_ALL_TESTS();
   } else {
-    for (int rep = 0; rep < nrepeat; rep++)
-      solve(test_t {prec, prec_sloppy, inv_type, solution_type, solve_type, multishift, solution_accumulator_pipeline,
-                    schwarz_t {precon_schwarz_type, inv_multigrid ? QUDA_MG_INVERTER : precon_type, prec_precondition},
-                    inv_param.residual_type});
+    // apply the same tolerance allowances as InvertTest::verify so that a ctest of this path fails on the true residual
+    double tol_check = tol;
+    if (is_chiral(dslash_type)) tol_check *= std::sqrt(static_cast<double>(Lsdim));
+    if (is_normal_residual(inv_type)) tol_check *= 50;
+    if (is_full_solution(solution_type) && is_preconditioned_solve(solve_type)) tol_check *= 10;
+
+    for (int rep = 0; rep < nrepeat; rep++) {
+      auto res = solve(test_t {prec, prec_sloppy, inv_type, solution_type, solve_type, multishift,
+                               solution_accumulator_pipeline,
+                               schwarz_t {precon_schwarz_type, inv_multigrid ? QUDA_MG_INVERTER : precon_type,
+                                          prec_precondition},
+                               inv_param.residual_type});
+      if (verify_results && (inv_param.residual_type & QUDA_L2_RELATIVE_RESIDUAL)) {
+        for (auto &rsd : res) {
+          if (rsd[0] > tol_check) {
+            printfQuda("True residual %e exceeds tolerance %e\n", rsd[0], tol_check);
+            result = 1;
+          }
+        }
+      }
+    }
   }
 
   // finalize the QUDA library
@@ -54,6 +54,39 @@ bool skip_test(test_t param)
   return false;
 }
 
+/**
+   @brief Load the gauge and, if needed, clover fields to the device in
+   the given precision, unless they are already resident in it
+   @param[in] prec The device precision of the fields
+ */
+void loadFields(QudaPrecision prec)
+{
+  if (prec == last_prec) return;
+  if (last_prec != QUDA_INVALID_PRECISION) {
+    freeGaugeQuda();
+    if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) freeCloverQuda();
+  }
+
+  // Load the gauge field to the device
+  gauge_param.cuda_prec = prec;
+  gauge_param.cuda_prec_sloppy = prec;
+  gauge_param.cuda_prec_precondition = prec;
+  gauge_param.cuda_prec_refinement_sloppy = prec;
+  gauge_param.cuda_prec_eigensolver = prec;
+  loadGaugeQuda(gauge.data(), &gauge_param);
+
+  if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+    // Load the clover terms to the device
+    inv_param.clover_cuda_prec = prec;
+    inv_param.clover_cuda_prec_sloppy = prec;
+    inv_param.clover_cuda_prec_precondition = prec;
+    inv_param.clover_cuda_prec_refinement_sloppy = prec;
+    inv_param.clover_cuda_prec_eigensolver = prec;
+    loadCloverQuda(clover.data(), clover_inv.data(), &inv_param);
+  }
+  last_prec = prec;
+}
+
 class InvertTest : public ::testing::TestWithParam<test_t>
 {
 protected:
@@ -67,31 +100,7 @@ public:
     if (skip_test(GetParam())) GTEST_SKIP();
 
     // check if outer precision has changed and update if it has
-    if (::testing::get<0>(param) != last_prec) {
-      if (last_prec != QUDA_INVALID_PRECISION) {
-        freeGaugeQuda();
-        if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) freeCloverQuda();
-      }
-
-      // Load the gauge field to the device
-      gauge_param.cuda_prec = ::testing::get<0>(param);
-      gauge_param.cuda_prec_sloppy = ::testing::get<0>(param);
-      gauge_param.cuda_prec_precondition = ::testing::get<0>(param);
-      gauge_param.cuda_prec_refinement_sloppy = ::testing::get<0>(param);
-      gauge_param.cuda_prec_eigensolver = ::testing::get<0>(param);
-      loadGaugeQuda(gauge.data(), &gauge_param);
-
-      if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
-        // Load the clover terms to the device
-        inv_param.clover_cuda_prec = ::testing::get<0>(param);
-        inv_param.clover_cuda_prec_sloppy = ::testing::get<0>(param);
-        inv_param.clover_cuda_prec_precondition = ::testing::get<0>(param);
-        inv_param.clover_cuda_prec_refinement_sloppy = ::testing::get<0>(param);
-        inv_param.clover_cuda_prec_eigensolver = ::testing::get<0>(param);
-        loadCloverQuda(clover.data(), clover_inv.data(), &inv_param);
-      }
-      last_prec = ::testing::get<0>(param);
-    }
+    loadFields(::testing::get<0>(param));
 
     // Compute plaquette as a sanity check
     double plaq[3];
@@ -102,6 +111,30 @@ public:
 
 std::vector<std::array<double, 2>> solve(test_t param);
 
+/**
+   @brief Iteration counts and largest true residual of the chronological forecasting test
+ */
+struct chrono_result_t {
+  int iter_cold;     /**< iterations of the solves without a history */
+  int iter_forecast; /**< iterations of the forecast solves that replace the newest history entries */
+  int iter_changed;  /**< iterations of the forecast solves after the operator has changed */
+  double res_max;    /**< largest true residual over all solves */
+};
+
+chrono_result_t chrono_test();
+
+TEST(InvertChrono, forecast)
+{
+  if (dslash_type != QUDA_WILSON_DSLASH || prec != QUDA_DOUBLE_PRECISION || cpu_prec != QUDA_DOUBLE_PRECISION)
+    GTEST_SKIP();
+  if (chrono_storage_prec != QUDA_INVALID_PRECISION && !(QUDA_PRECISION & chrono_storage_prec)) GTEST_SKIP();
+
+  auto result = chrono_test();
+  EXPECT_LT(result.iter_forecast, result.iter_cold) << "forecast from the chronological history did not help";
+  EXPECT_LT(result.iter_changed, result.iter_cold) << "forecast after the operator change did not help";
+  EXPECT_LE(result.res_max, 1e-10);
+}
+
 TEST_P(InvertTest, verify)
 {
   if (skip_test(GetParam())) GTEST_SKIP();
@@ -127,6 +160,28 @@ TEST_P(InvertTest, verify)
   }
 }
 
+/**
+   @brief Iteration counts and solution difference of the streamed deflation test
+ */
+struct streamed_deflation_result_t {
+  int iter_device; /**< iterations with the deflation space in device memory */
+  int iter_host;   /**< iterations with the deflation space streamed from host memory */
+  double sol_diff; /**< relative L2 difference between the two solutions */
+};
+
+streamed_deflation_result_t streamed_deflation_test();
+
+TEST(InvertDeflation, streamed)
+{
+  if (!inv_deflate || is_chiral(dslash_type)) GTEST_SKIP();
+  if (prec != QUDA_DOUBLE_PRECISION || cpu_prec != QUDA_DOUBLE_PRECISION) GTEST_SKIP();
+
+  auto result = streamed_deflation_test();
+  // the tiles accumulate in a different order, so allow the count to differ by one
+  EXPECT_NEAR(result.iter_host, result.iter_device, 1);
+  EXPECT_LE(result.sol_diff, 1e-8) << "host streamed and device-resident deflation give different solutions";
+}
+
 std::string gettestname(::testing::TestParamInfo<test_t> param)
 {
   std::string name;
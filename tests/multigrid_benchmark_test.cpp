@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <array>
+#include <vector>
 
 #include <quda_internal.h>
 #include <color_spinor_field.h>
@@ -15,6 +17,7 @@
 #include <tune_quda.h>
 #include <gauge_tools.h>
 #include <gtest/gtest.h>
+#include <quda.h>
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
@@ -181,6 +184,25 @@ TEST(multi_rhs_test, verify)
   }
 }
 
+void apply(int test, cvector_ref<ColorSpinorField> &x, cvector_ref<const ColorSpinorField> &y)
+{
+  auto xEven = make_parity_subset(x, QUDA_EVEN_PARITY);
+  auto yEven = make_parity_subset(y, QUDA_EVEN_PARITY);
+  auto yOdd = make_parity_subset(y, QUDA_ODD_PARITY);
+
+  switch (test) {
+  case 0: dirac->Dslash(xEven, yOdd, QUDA_EVEN_PARITY); break;
+  case 1: dirac->M(x, y); break;
+  case 2: dirac->Clover(xEven, yEven, QUDA_EVEN_PARITY); break;
+  case 3: dirac->Mdag(x, y); break;
+  case 4: dirac->MdagM(x, y); break;
+  case 5: dirac_pc->M(xEven, yOdd); break;
+  case 6: dirac_pc->Mdag(xEven, yOdd); break;
+  case 7: dirac_pc->MdagM(xEven, yOdd); break;
+  default: errorQuda("Undefined test %d", test);
+  }
+}
+
 double benchmark(int test, const int niter)
 {
   printfQuda("\nBenchmarking %s precision with %d iterations...\n\n", get_prec_str(prec), niter);
@@ -188,42 +210,92 @@ double benchmark(int test, const int niter)
   device_timer_t device_timer;
   device_timer.start();
 
-  auto xEven = make_parity_subset(xD, QUDA_EVEN_PARITY);
-  auto yEven = make_parity_subset(yD, QUDA_EVEN_PARITY);
-  auto yOdd = make_parity_subset(yD, QUDA_ODD_PARITY);
+  for (int i = 0; i < niter; ++i) apply(test, xD, yD);
 
-  switch (test) {
-  case 0:
-    for (int i = 0; i < niter; ++i) dirac->Dslash(xEven, yOdd, QUDA_EVEN_PARITY);
-    break;
-  case 1:
-    for (int i = 0; i < niter; ++i) dirac->M(xD, yD);
-    break;
-  case 2:
-    for (int i = 0; i < niter; ++i) dirac->Clover(xEven, yEven, QUDA_EVEN_PARITY);
-    break;
-  case 3:
-    for (int i = 0; i < niter; ++i) dirac->Mdag(xD, yD);
-    break;
-  case 4:
-    for (int i = 0; i < niter; ++i) dirac->MdagM(xD, yD);
-    break;
-  case 5:
-    for (int i = 0; i < niter; ++i) dirac_pc->M(xEven, yOdd);
-    break;
-  case 6:
-    for (int i = 0; i < niter; ++i) dirac_pc->Mdag(xEven, yOdd);
-    break;
-  case 7:
-    for (int i = 0; i < niter; ++i) dirac_pc->MdagM(xEven, yOdd);
-    break;
-  default: errorQuda("Undefined test %d", test);
-  }
+  device_timer.stop();
+  return device_timer.last();
+}
+
+/**
+   @brief Time the operator applied to each source in turn, for
+   comparison with the batched multi-RHS application.  This measures
+   the operator only; the null-space generation itself is timed by
+   benchmark_null_space.
+ */
+double benchmark_unbatched(int test, const int niter)
+{
+  device_timer_t device_timer;
+  device_timer.start();
+
+  for (int i = 0; i < niter; ++i)
+    for (auto j = 0u; j < xD.size(); j++) apply(test, xD[j], yD[j]);
 
   device_timer.stop();
   return device_timer.last();
 }
 
+/**
+   @brief Time the null-space generation on each level of a multigrid
+   setup on a Wilson-type fine grid (--dslash-type, --mg-* options),
+   with the vectors relaxed in batches of --mg-nvec-batch and with all
+   vectors relaxed together (--mg-setup-batch-all).  Each mode is run
+   once untimed first, so that neither timing includes the autotuning
+   and allocation, and the timed runs are in the opposite order.
+ */
+void benchmark_null_space(int argc, char **argv)
+{
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  setWilsonGaugeParam(gauge_param);
+  QudaInvertParam inv_param = newQudaInvertParam();
+  QudaInvertParam mg_inv_param = newQudaInvertParam();
+  QudaMultigridParam mg_param = newQudaMultigridParam();
+  setQudaMgSolveTypes();
+  setMultigridInvertParam(inv_param);
+  mg_param.invert_param = &mg_inv_param;
+  for (int i = 0; i < mg_levels; i++) mg_param.eig_param[i] = nullptr;
+  setMultigridParam(mg_param);
+  setDims(gauge_param.X);
+
+  std::vector<char> gauge_(4 * V * gauge_site_size * host_gauge_data_type_size);
+  std::array<void *, 4> gauge;
+  for (int i = 0; i < 4; i++) gauge[i] = gauge_.data() + i * V * gauge_site_size * host_gauge_data_type_size;
+  constructHostGaugeField(gauge.data(), gauge_param, argc, argv);
+  loadGaugeQuda(gauge.data(), &gauge_param);
+
+  std::vector<char> clover, clover_inv;
+  if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH) {
+    clover.resize(V * clover_site_size * host_clover_data_type_size);
+    clover_inv.resize(V * clover_site_size * host_spinor_data_type_size);
+    constructHostCloverField(clover.data(), clover_inv.data(), inv_param);
+    loadCloverQuda(clover.data(), clover_inv.data(), &inv_param);
+  }
+
+  auto setup = [&](bool batch_all) {
+    for (int i = 0; i < mg_levels - 1; i++)
+      mg_param.setup_batch_all[i] = batch_all ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+    void *mg = newMultigridQuda(&mg_param);
+    std::array<double, QUDA_MAX_MG_LEVEL> secs = {};
+    for (int i = 0; i < mg_levels - 1; i++) secs[i] = mg_param.null_space_secs[i];
+    destroyMultigridQuda(mg);
+    return secs;
+  };
+
+  // warm up
+  setup(false);
+  setup(true);
+
+  auto secs_all = setup(true);
+  auto secs_batch = setup(false);
+
+  for (int i = 0; i < mg_levels - 1; i++) {
+    printfQuda("Level %d null-space generation: %g secs in batches of %d, %g secs batched together, speedup = %6.2fx\n",
+               i, secs_batch[i], mg_param.n_vec_batch[i], secs_all[i], secs_batch[i] / secs_all[i]);
+  }
+
+  if (!clover.empty()) freeCloverQuda();
+  freeGaugeQuda();
+}
+
 const char *names[] = {"Dslash", "Mat", "Clover", "MatDag", "MatDagMat", "MatPC", "MatPCDag", "MatPCDagMatPC"};
 
 int main(int argc, char **argv)
@@ -252,6 +324,9 @@ int main(int argc, char **argv)
   if (prec_sloppy == QUDA_INVALID_PRECISION) prec_sloppy = prec;
   Ncolor = nvec[0] == 0 ? 24 : nvec[0];
 
+  // each timed setup must generate its null space rather than reuse a checkpoint of the previous one
+  if (mg_setup_batch_benchmark) unsetenv("QUDA_CHECKPOINT_PATH");
+
   initComms(argc, argv, gridsize_from_cmdline);
   display_test_info();
   initQuda(device_ordinal);
@@ -287,6 +362,15 @@ int main(int argc, char **argv)
 
   printfQuda("Ncolor = %2d, %-31s: Gflop/s = %6.1f\n", Ncolor, names[test_type], gflops);
 
+  // report the speedup of applying the operator to all sources together over one source at a time
+  if (Nsrc > 1) {
+    double secs_unbatched = benchmark_unbatched(test_type, niter);
+    printfQuda("Ncolor = %2d, %-31s: batched %d-RHS operator speedup = %6.2fx\n", Ncolor, names[test_type], Nsrc,
+               secs_unbatched / secs);
+  }
+
+  if (mg_setup_batch_benchmark) benchmark_null_space(argc, argv);
+
   delete dirac;
   delete dirac_pc;
   freeFields();
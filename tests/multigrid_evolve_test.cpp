@@ -215,6 +215,9 @@ int main(int argc, char **argv)
   void *spinorCheck = safe_malloc(V * spinor_site_size * host_spinor_data_type_size * inv_param.Ls);
   void *spinorOut = safe_malloc(V * spinor_site_size * host_spinor_data_type_size * inv_param.Ls);
 
+  // number of solves that did not converge, which fails the test
+  int n_unconverged = 0;
+
   // start the timer
   double time0 = -((double)clock());
   {
@@ -345,6 +348,7 @@ int main(int argc, char **argv)
       invertQuda(spinorOut, spinorIn, &inv_param);
 
       if (inv_multigrid && inv_param.iter == inv_param.maxiter) {
+        n_unconverged++;
         std::string vec_outfile[QUDA_MAX_MG_LEVEL];
         for (int i = 0; i < mg_param.n_level; i++) {
           vec_outfile[i] = std::string(mg_param.vec_outfile[i]);
@@ -432,6 +436,7 @@ int main(int argc, char **argv)
       invertQuda(spinorOut, spinorIn, &inv_param);
 
       if (inv_multigrid && inv_param.iter == inv_param.maxiter) {
+        n_unconverged++;
         std::string vec_outfile[QUDA_MAX_MG_LEVEL];
         for (int i = 0; i < mg_param.n_level; i++) {
           vec_outfile[i] = std::string(mg_param.vec_outfile[i]);
@@ -458,6 +463,7 @@ int main(int argc, char **argv)
   time0 += clock();
   time0 /= CLOCKS_PER_SEC;
 
+  if (n_unconverged > 0) printfQuda("%d solves failed to converge\n", n_unconverged);
   printfQuda("\nDone: %i iter / %g secs = %g Gflops, total time = %g secs\n", inv_param.iter, inv_param.secs,
              inv_param.gflops / inv_param.secs, time0);
 
@@ -481,5 +487,5 @@ int main(int argc, char **argv)
   // finalize the communications layer
   finalizeComms();
 
-  return 0;
+  return n_unconverged > 0 ? 1 : 0;
 }
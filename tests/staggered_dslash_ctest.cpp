@@ -86,7 +86,7 @@ TEST_P(StaggeredDslashTest, verify)
   dslash_test_wrapper.run_test(2);
 
   double deviation = dslash_test_wrapper.verify();
-  double tol = getTolerance(dslash_test_wrapper.inv_param.cuda_prec);
+  double tol = getTolerance(dslash_test_wrapper.inv_param.cuda_prec, dslash_test_wrapper.inv_param.halo_prec);
 
   if (dslash_test_wrapper.gauge_param.reconstruct == QUDA_RECONSTRUCT_9
       && dslash_test_wrapper.inv_param.cuda_prec >= QUDA_HALF_PRECISION)
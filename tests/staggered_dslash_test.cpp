@@ -49,7 +49,7 @@ TEST_F(StaggeredDslashTest, verify)
   dslash_test_wrapper.run_test(2);
 
   double deviation = dslash_test_wrapper.verify();
-  double tol = getTolerance(dslash_test_wrapper.inv_param.cuda_prec);
+  double tol = getTolerance(dslash_test_wrapper.inv_param.cuda_prec, dslash_test_wrapper.inv_param.halo_prec);
 
   // give it a tiny bump for fixed precision, recon 8
   if (dslash_test_wrapper.inv_param.cuda_prec <= QUDA_HALF_PRECISION
@@ -324,6 +324,9 @@ struct StaggeredDslashTestWrapper {
     host_timer_t host_timer;
     device_timer_t device_timer;
 
+    // apply the requested halo precision to the operator halos
+    pushHaloPrecision(inv_param.halo_prec);
+
     comm_barrier();
     device_timer.start();
 
@@ -374,6 +377,8 @@ struct StaggeredDslashTestWrapper {
     device_timer.stop();
     dslash_time.event_time = device_timer.last();
 
+    popHaloPrecision();
+
     return dslash_time;
   }
 
@@ -408,6 +413,17 @@ struct StaggeredDslashTestWrapper {
 
       size_t ghost_bytes = cudaSpinor[0].GhostBytes();
 
+      // rescale to the size of a compressed halo
+      auto prec = cudaSpinor[0].Precision();
+      if (inv_param.halo_prec != QUDA_INVALID_PRECISION && inv_param.halo_prec < prec) {
+        auto site_bytes = getHaloSiteBytes(cudaSpinor[0].Nspin(), cudaSpinor[0].Ncolor(), prec);
+        auto halo_site_bytes = getHaloSiteBytes(cudaSpinor[0].Nspin(), cudaSpinor[0].Ncolor(), inv_param.halo_prec);
+        ghost_bytes = (ghost_bytes * halo_site_bytes) / site_bytes;
+        printfQuda("Halo precision = %d (field precision = %d), halo compression ratio = %.2f\n", inv_param.halo_prec,
+                   prec, static_cast<double>(site_bytes) / halo_site_bytes);
+        ::testing::Test::RecordProperty("Halo_compression_ratio", static_cast<double>(site_bytes) / halo_site_bytes);
+      }
+
       ::testing::Test::RecordProperty("Halo_bidirectional_BW_GPU",
                                       1.0e-9 * 2 * ghost_bytes * niter / dslash_time.event_time);
       ::testing::Test::RecordProperty("Halo_bidirectional_BW_CPU",
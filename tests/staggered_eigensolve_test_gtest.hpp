@@ -49,6 +49,9 @@ bool skip_test(test_t test_param)
     case QUDA_EIG_BLK_TR_LANCZOS:
       if (spectrum != QUDA_SPECTRUM_LR_EIG && spectrum != QUDA_SPECTRUM_SR_EIG) return true;
       break;
+    case QUDA_EIG_CHEB_FILTERED_SUBSPACE:
+      if (spectrum != QUDA_SPECTRUM_SR_EIG) return true;
+      break;
     case QUDA_EIG_IR_ARNOLDI:
       if (spectrum == QUDA_SPECTRUM_LI_EIG || spectrum == QUDA_SPECTRUM_SI_EIG) return true;
       break;
@@ -65,6 +68,9 @@ bool skip_test(test_t test_param)
     case QUDA_EIG_BLK_TR_LANCZOS:
       if (spectrum != QUDA_SPECTRUM_LR_EIG && spectrum != QUDA_SPECTRUM_SR_EIG) return true;
       break;
+    case QUDA_EIG_CHEB_FILTERED_SUBSPACE:
+      if (spectrum != QUDA_SPECTRUM_SR_EIG) return true;
+      break;
     case QUDA_EIG_IR_ARNOLDI:
       // if (spectrum == QUDA_SPECTRUM_LI_EIG || spectrum == QUDA_SPECTRUM_SI_EIG) return true;
       return true; // we skip this because it takes an unnecessarily long time and it's covered elsewhere
@@ -94,6 +100,9 @@ bool skip_test(test_t test_param)
       case QUDA_EIG_BLK_TR_LANCZOS:
         if (spectrum != QUDA_SPECTRUM_LR_EIG && spectrum != QUDA_SPECTRUM_SR_EIG) return true;
         break;
+      case QUDA_EIG_CHEB_FILTERED_SUBSPACE:
+        if (spectrum != QUDA_SPECTRUM_SR_EIG) return true;
+        break;
       case QUDA_EIG_IR_ARNOLDI:
         if (spectrum == QUDA_SPECTRUM_LI_EIG || spectrum == QUDA_SPECTRUM_SI_EIG) return true;
         break;
@@ -144,7 +153,8 @@ using ::testing::Combine;
 using ::testing::Values;
 
 // Can solve hermitian systems
-auto hermitian_solvers = Values(QUDA_EIG_TR_LANCZOS, QUDA_EIG_BLK_TR_LANCZOS, QUDA_EIG_IR_ARNOLDI);
+auto hermitian_solvers
+  = Values(QUDA_EIG_TR_LANCZOS, QUDA_EIG_BLK_TR_LANCZOS, QUDA_EIG_IR_ARNOLDI, QUDA_EIG_CHEB_FILTERED_SUBSPACE);
 
 // Can solve non-hermitian systems
 auto non_hermitian_solvers = Values(QUDA_EIG_IR_ARNOLDI);
@@ -52,6 +52,24 @@ TEST_F(StaggeredGSmearTest, verify)
   ASSERT_LE(deviation, tol) << "reference and QUDA implementations do not agree";
 }
 
+TEST_F(StaggeredGSmearTest, multi_src)
+{
+  if (gtest_type != gsmear_test_type::GaussianSmear) GTEST_SKIP();
+
+  double deviation = gsmear_test_wrapper.verifyMultiSrc();
+  double tol = getTolerance(gsmear_test_wrapper.inv_param.cuda_prec);
+  ASSERT_LE(deviation, tol) << "batched and single source smearing do not agree";
+}
+
+TEST_F(StaggeredGSmearTest, multi_src_wuppertal)
+{
+  if (gtest_type != gsmear_test_type::GaussianSmear) GTEST_SKIP();
+
+  double deviation = gsmear_test_wrapper.verifyMultiSrcWuppertal();
+  double tol = getTolerance(gsmear_test_wrapper.inv_param.cuda_prec);
+  ASSERT_LE(deviation, tol) << "batched and single source Wuppertal smearing do not agree";
+}
+
 
 int main(int argc, char **argv)
 {
@@ -302,6 +302,95 @@ struct StaggeredGSmearTestWrapper { //
     freeGaugeQuda();
   }
 
+  QudaQuarkSmearParam quarkSmearParam()
+  {
+    QudaQuarkSmearParam qsm_param;
+    qsm_param.inv_param = &inv_param;
+
+    double omega = 2.0;
+    qsm_param.n_steps = smear_n_steps;
+    qsm_param.width = -1.0 * omega * omega / (4 * smear_n_steps);
+
+    qsm_param.compute_2link = smear_compute_two_link;
+    qsm_param.delete_2link = smear_delete_two_link;
+    qsm_param.t0 = smear_t0;
+    return qsm_param;
+  }
+
+  /**
+     @brief The number of sources used to check the batched smearing
+     interfaces: at least Nsrc, and more than, and not a multiple of,
+     the multi-RHS batch size, so that a full and a partial batch are
+     both smeared
+   */
+  int multiSrcCount()
+  {
+    int batch = get_max_multi_rhs();
+    int n_src = std::max(Nsrc, batch + 1);
+    if (batch > 1 && n_src % batch == 0) n_src++;
+    return n_src;
+  }
+
+  /**
+     @brief Check that smearing a set of sources with the batched
+     interface agrees with smearing each of them individually
+     @param[in] smear_single Smear one source in place
+     @param[in] smear_multi Smear a set of sources in place
+     @return The maximum deviation between the two
+   */
+  template <typename Single, typename Multi> double verifyMultiSrc(Single smear_single, Multi smear_multi)
+  {
+    int n_src = multiSrcCount();
+    printfQuda("Smearing %d sources in batches of %u\n", n_src, get_max_multi_rhs());
+
+    ColorSpinorParam param(spinor);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    std::vector<ColorSpinorField> src(n_src, param);
+    std::vector<ColorSpinorField> ref(n_src, param);
+    std::vector<void *> src_ptr(n_src);
+    for (int i = 0; i < n_src; i++) {
+      src[i].Source(QUDA_RANDOM_SOURCE);
+      ref[i] = src[i];
+      src_ptr[i] = src[i].data();
+    }
+
+    for (int i = 0; i < n_src; i++) smear_single(ref[i].data());
+    smear_multi(src_ptr.data(), n_src);
+
+    double deviation = 0.0;
+    for (int i = 0; i < n_src; i++)
+      deviation = std::max(deviation,
+                           compare_floats_v2(src[i].data(), ref[i].data(), spinor.Length(), 1e-3, gauge_param.cpu_prec));
+    return deviation;
+  }
+
+  /**
+     @brief Check the batched two-link Gaussian smearing against
+     per-source smearing
+     @return The maximum deviation between the two
+   */
+  double verifyMultiSrc()
+  {
+    QudaQuarkSmearParam qsm_param = quarkSmearParam();
+    return verifyMultiSrc([&](void *v) { performTwoLinkGaussianSmearNStep(v, &qsm_param); },
+                          [&](void **v, int n) { performTwoLinkGaussianSmearNStepMultiSrc(v, n, &qsm_param); });
+  }
+
+  /**
+     @brief Check the batched Wuppertal smearing against per-source
+     smearing
+     @return The maximum deviation between the two
+   */
+  double verifyMultiSrcWuppertal()
+  {
+    QudaInvertParam wuppertal_param = inv_param;
+    wuppertal_param.dslash_type = QUDA_STAGGERED_DSLASH;
+    double alpha = 0.5;
+    return verifyMultiSrc(
+      [&](void *v) { performWuppertalnStep(v, v, &wuppertal_param, smear_n_steps, alpha); },
+      [&](void **v, int n) { performWuppertalnStepMultiSrc(v, v, n, &wuppertal_param, smear_n_steps, alpha); });
+  }
+
   GSmearTime gsmearQUDA(int niter)
   {
     GSmearTime gsmear_time;
@@ -322,17 +411,7 @@ struct StaggeredGSmearTestWrapper { //
         break;
       }
       case gsmear_test_type::GaussianSmear: {
-        QudaQuarkSmearParam qsm_param;
-        qsm_param.inv_param = &inv_param;
-
-        double omega = 2.0;
-        qsm_param.n_steps = smear_n_steps;
-        qsm_param.width = -1.0 * omega * omega / (4 * smear_n_steps);
-
-        qsm_param.compute_2link = smear_compute_two_link;
-        qsm_param.delete_2link = smear_delete_two_link;
-        qsm_param.t0 = smear_t0;
-
+        QudaQuarkSmearParam qsm_param = quarkSmearParam();
         performTwoLinkGaussianSmearNStep(spinor.data(), &qsm_param);
         break;
       }
@@ -135,6 +135,7 @@ GaugeField cpuFatQDP = {};
 GaugeField cpuLongQDP = {};
 GaugeField cpuFatMILC = {};
 GaugeField cpuLongMILC = {};
+GaugeField cpuThinMILC = {};
 
 void init()
 {
@@ -214,6 +215,13 @@ void init()
   void *qdp_longlink[4] = {cpuLongQDP.data(0), cpuLongQDP.data(1), cpuLongQDP.data(2), cpuLongQDP.data(3)};
   constructStaggeredHostGaugeField(qdp_inlink, qdp_longlink, qdp_fatlink, gauge_param, 0, nullptr, true);
 
+  // thin links in MILC order, used as the smeared links of the HISQ force check
+  GaugeFieldParam thinParam(cpuIn);
+  thinParam.order = QUDA_MILC_GAUGE_ORDER;
+  thinParam.create = QUDA_NULL_FIELD_CREATE;
+  cpuThinMILC = GaugeField(thinParam);
+  cpuThinMILC = cpuIn;
+
   // Reorder gauge fields to MILC order
   cpuFatMILC = cpuFatQDP;
   cpuLongMILC = cpuLongQDP;
@@ -455,12 +463,102 @@ std::vector<std::array<double, 2>> solve(test_t param)
   return res;
 }
 
+double hisq_force_resident_test()
+{
+  // the shifts are split into several outer-product batches where possible
+  const int n_terms = std::min<int>(QUDA_MAX_MULTI_SHIFT, quda::get_max_multi_rhs() + 1);
+  const int n_naik = std::min(n_terms, 4);
+
+  QudaInvertParam param = inv_param;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.solution_type = QUDA_MATPC_SOLUTION;
+  param.solve_type = QUDA_DIRECT_PC_SOLVE;
+  param.matpc_type = QUDA_MATPC_EVEN_EVEN;
+  param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  param.cuda_prec_sloppy = param.cuda_prec;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.tol = 1e-12;
+  param.tol_hq = 0.0;
+  param.maxiter = 10000;
+  param.solution_accumulator_pipeline = 1;
+  param.eig_param = nullptr;
+  param.preconditioner = nullptr;
+  param.inv_type_precondition = QUDA_INVALID_INVERTER;
+  param.schwarz_type = QUDA_INVALID_SCHWARZ;
+  param.num_offset = n_terms;
+  for (int i = 0; i < n_terms; i++) {
+    double m = mass + 0.01 * i;
+    param.offset[i] = 4 * m * m;
+    param.tol_offset[i] = param.tol;
+    param.tol_hq_offset[i] = 0.0;
+  }
+
+  const size_t half = Vh * stag_spinor_site_size;
+  std::vector<double> b(half);
+  for (auto &v : b) v = rand() / static_cast<double>(RAND_MAX) - 0.5;
+  std::vector<std::vector<double>> x(n_terms, std::vector<double>(2 * half));
+  std::vector<void *> x_ptr(n_terms);
+  for (int i = 0; i < n_terms; i++) x_ptr[i] = x[i].data();
+
+  // host quark fields: the even-parity solutions, with the odd parity reconstructed by the dslash
+  param.make_resident_solution = 0;
+  param.use_resident_solution = 0;
+  invertMultiShiftQuda(x_ptr.data(), b.data(), &param);
+  for (int i = 0; i < n_terms; i++) dslashQuda(x[i].data() + half, x[i].data(), &param, QUDA_ODD_PARITY);
+
+  double level2_coeff[6] = {0.625000, -0.058479, -0.087719, 0.030778, -0.007200, -0.123113};
+  double fat7_coeff[6] = {0.125, 0.0, -0.0625, 0.015625, -0.002604, 0.0};
+  std::vector<std::array<double, 2>> c(n_terms + n_naik);
+  std::vector<double *> coeff(n_terms + n_naik);
+  for (int i = 0; i < n_terms + n_naik; i++) {
+    c[i] = {1.0 / (i + 1), -0.1 / (i + 1)};
+    coeff[i] = c[i].data();
+  }
+
+  QudaGaugeParam force_param = gauge_param;
+  force_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  force_param.gauge_order = QUDA_MILC_GAUGE_ORDER;
+  force_param.reconstruct = QUDA_RECONSTRUCT_NO;
+  force_param.ga_pad = 0;
+  force_param.use_resident_mom = 0;
+  force_param.make_resident_mom = 0;
+  force_param.return_result_mom = 1;
+
+  const void *link = cpuThinMILC.data();
+  double dt = 0.1;
+  std::vector<double> mom_host(4 * V * mom_site_size, 0.0);
+  computeHISQForceQuda(mom_host.data(), dt, level2_coeff, fat7_coeff, link, link, link, x_ptr.data(), n_terms, n_naik,
+                       coeff.data(), &force_param);
+
+  // the same solve, with the solutions left resident on the device
+  param.make_resident_solution = 1;
+  invertMultiShiftQuda(x_ptr.data(), b.data(), &param);
+  param.make_resident_solution = 0;
+  param.use_resident_solution = 1;
+  std::vector<double> mom_resident(4 * V * mom_site_size, 0.0);
+  computeHISQForceResidentQuda(mom_resident.data(), dt, level2_coeff, fat7_coeff, link, link, link, n_terms, n_naik,
+                               coeff.data(), &force_param, &param);
+
+  double scale = 0.0;
+  double deviation = 0.0;
+  for (auto i = 0u; i < mom_host.size(); i++) {
+    scale = std::max(scale, std::abs(mom_host[i]));
+    deviation = std::max(deviation, std::abs(mom_resident[i] - mom_host[i]));
+  }
+  quda::comm_allreduce_max(scale);
+  quda::comm_allreduce_max(deviation);
+  printfQuda("HISQ force from %d resident solutions: relative deviation %e\n", n_terms, deviation / scale);
+
+  return deviation / scale;
+}
+
 void cleanup()
 {
   cpuFatQDP = {};
   cpuLongQDP = {};
   cpuFatMILC = {};
   cpuLongMILC = {};
+  cpuThinMILC = {};
 }
 
 int main(int argc, char **argv)
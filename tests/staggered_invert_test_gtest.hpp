@@ -118,6 +118,18 @@ TEST_P(StaggeredInvertTest, verify)
   inv_param.ca_basis = ca_basis_tmp;
 }
 
+double hisq_force_resident_test();
+
+// The HISQ force from the resident multi-shift solutions must match the force from the same solutions on the host
+TEST(StaggeredHISQForce, resident)
+{
+  if (dslash_type != QUDA_ASQTAD_DSLASH || prec != QUDA_DOUBLE_PRECISION || cpu_prec != QUDA_DOUBLE_PRECISION)
+    GTEST_SKIP();
+  if (grid_partition[0] * grid_partition[1] * grid_partition[2] * grid_partition[3] > 1) GTEST_SKIP();
+
+  EXPECT_LE(hisq_force_resident_test(), 1e-8) << "HISQ force from resident and host solutions do not agree";
+}
+
 std::string gettestname(::testing::TestParamInfo<test_t> param)
 {
   std::string name;
@@ -3,6 +3,10 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 
 #include <timer.h>
 #include <util_quda.h>
@@ -55,6 +59,66 @@ void display_test_info()
   return;
 }
 
+/**
+   @brief Check the adaptive step size flow against a fixed step size
+   flow with a step a tenth of the initial adaptive one: the
+   observables at the last measurement of both flows run to the end,
+   and the flow scale, if any, found by the adaptive flow
+   @param[in] smear_param The parameters of the adaptive flow
+   @param[in] obs_param The observable parameters of the flow
+   @return The number of failed checks
+ */
+int check_adaptive_flow(const QudaGaugeSmearParam &smear_param, const QudaGaugeObservableParam *obs_param)
+{
+  constexpr int refine = 10;
+  constexpr double tol = 1e-4;
+  const int n_meas = smear_param.n_steps / smear_param.meas_interval;
+
+  auto flow = [&](QudaGaugeSmearParam param) {
+    std::vector<QudaGaugeObservableParam> obs(n_meas + 1);
+    for (auto &o : obs) o = obs_param[0];
+    performWFlowQuda(&param, obs.data());
+    return std::make_pair(param, obs.back());
+  };
+
+  QudaGaugeSmearParam fixed_param = smear_param;
+  fixed_param.flow_tol = 0.0;
+  fixed_param.epsilon = smear_param.epsilon / refine;
+  fixed_param.n_steps = smear_param.n_steps * refine;
+  fixed_param.meas_interval = smear_param.meas_interval * refine;
+
+  // the flows run to the end, so that the last measurements are at the same flow time
+  QudaGaugeSmearParam adaptive_param = smear_param;
+  adaptive_param.scale_type = QUDA_FLOW_SCALE_NONE;
+  auto adaptive = flow(adaptive_param).second;
+  fixed_param.scale_type = QUDA_FLOW_SCALE_NONE;
+  auto fixed = flow(fixed_param).second;
+
+  int fail = 0;
+  auto check = [&](const char *name, double a, double f, double tol) {
+    double dev = std::abs(a - f) / std::max(std::abs(f), 1e-12);
+    printfQuda("Adaptive flow %s = %.16e, fixed step %s = %.16e, relative deviation = %e\n", name, a, name, f, dev);
+    if (dev > tol) fail++;
+  };
+  check("plaquette", adaptive.plaquette[0], fixed.plaquette[0], tol);
+  check("energy", adaptive.energy[0], fixed.energy[0], tol);
+
+  if (smear_param.scale_type != QUDA_FLOW_SCALE_NONE) {
+    fixed_param.scale_type = smear_param.scale_type;
+    auto fixed_scale = flow(fixed_param).first.scale_t;
+    if (smear_param.scale_t == 0.0 || fixed_scale == 0.0) {
+      printfQuda("Flow scale not reached by both flows\n");
+      fail++;
+    } else {
+      // the crossing is interpolated linearly between steps, which limits the agreement for the larger adaptive steps
+      check("scale", smear_param.scale_t, fixed_scale, 1e-2);
+    }
+  }
+
+  printfQuda("Adaptive flow check %s\n", fail ? "failed" : "passed");
+  return fail;
+}
+
 int main(int argc, char **argv)
 {
 
@@ -218,6 +282,9 @@ int main(int argc, char **argv)
   smear_param.alpha2 = gauge_smear_alpha2;
   smear_param.alpha3 = gauge_smear_alpha3;
   smear_param.dir_ignore = gauge_smear_dir_ignore;
+  smear_param.flow_tol = gauge_flow_tol;
+  smear_param.scale_type = gauge_flow_scale_type;
+  smear_param.scale_target = gauge_flow_scale_target;
 
   host_timer.start(); // start the timer
   switch (smear_param.smear_type) {
@@ -237,6 +304,9 @@ int main(int argc, char **argv)
       obs_param[i].compute_plaquette = QUDA_BOOLEAN_TRUE;
     }
     performWFlowQuda(&smear_param, obs_param);
+    if (smear_param.scale_type != QUDA_FLOW_SCALE_NONE)
+      printfQuda("Flow scale %s = %.16e\n", smear_param.scale_type == QUDA_FLOW_SCALE_T0 ? "t0" : "w0^2",
+                 smear_param.scale_t);
     break;
   }
   default: errorQuda("Undefined gauge smear type %d given", smear_param.smear_type);
@@ -245,6 +315,12 @@ int main(int argc, char **argv)
   host_timer.stop(); // stop the timer
   printfQuda("Total time for gauge smearing = %g secs\n", host_timer.last());
 
+  int fail = 0;
+  if (verify_results && smear_param.flow_tol > 0.0
+      && (smear_param.smear_type == QUDA_GAUGE_SMEAR_WILSON_FLOW
+          || smear_param.smear_type == QUDA_GAUGE_SMEAR_SYMANZIK_FLOW))
+    fail += check_adaptive_flow(smear_param, obs_param);
+
   if (verify_results) check_gauge(gauge, new_gauge, 1e-3, gauge_param.cpu_prec);
 
   for (int dir = 0; dir < 4; dir++) {
@@ -256,5 +332,5 @@ int main(int argc, char **argv)
   endQuda();
 
   finalizeComms();
-  return 0;
+  return fail > 0 ? 1 : 0;
 }
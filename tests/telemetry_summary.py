@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Summarize the telemetry stream written with QUDA_ENABLE_TELEMETRY=1.
+
+Reads one or more telemetry_n<rank>.jsonl files and, for each rank,
+prints the scope tree (output-prefix scopes, including the multigrid
+levels, and solves) with the kernel time, flops and bytes attributed
+to every scope, both
+exclusive and inclusive of the scopes nested in it, the iteration
+count, reliable updates, restarts and final residual of every solve,
+and the most expensive kernels of every scope.
+
+Kernel times are the tuned times cached by the autotuner, not times
+measured for each launch, so they exclude launch overhead and host
+time and are estimates of the device time.
+
+usage: telemetry_summary.py [--top N] [--iterations] telemetry_n*.jsonl
+"""
+
+import argparse
+import json
+import math
+from collections import defaultdict
+
+
+class Scope:
+    def __init__(self, id, parent, label, solve):
+        self.id = id
+        self.parent = parent
+        self.label = label
+        self.solve = solve
+        self.children = []
+        self.time = 0.0
+        self.flops = 0
+        self.bytes = 0
+        self.kernels = defaultdict(lambda: [0, 0.0, 0, 0])  # calls, time, flops, bytes
+        self.iter = 0
+        self.reliable = 0
+        self.restart = 0
+        self.r2 = []
+        self.b2 = []
+        self.iter_time = defaultdict(float)  # kernel time per iteration
+        self.last_iter = 0
+
+    def inclusive(self, scopes):
+        time, flops, bytes = self.time, self.flops, self.bytes
+        for c in self.children:
+            t, f, b = scopes[c].inclusive(scopes)
+            time += t
+            flops += f
+            bytes += b
+        return time, flops, bytes
+
+
+def parse(filename):
+    header = {}
+    scopes = {0: Scope(0, None, "run", False)}
+    with open(filename) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            e = json.loads(line)
+            ev = e["ev"]
+            if ev == "header":
+                header = e
+                continue
+
+            id = e["scope"]
+            if ev in ("scope_begin", "solve_begin"):
+                scopes[id] = Scope(id, e["parent"], e["label"], ev == "solve_begin")
+                scopes[e["parent"]].children.append(id)
+                continue
+
+            s = scopes[id]
+            if ev == "kernel":
+                s.time += e["time"]
+                s.flops += e["flops"]
+                s.bytes += e["bytes"]
+                k = s.kernels[e["name"] + " " + e["aux"]]
+                k[0] += 1
+                k[1] += e["time"]
+                k[2] += e["flops"]
+                k[3] += e["bytes"]
+                # kernels following an iteration report are attributed to the next iteration
+                if s.solve:
+                    s.iter_time[s.last_iter + 1] += e["time"]
+            elif ev == "iter":
+                s.last_iter = e["iter"]
+                s.iter = e["iter"]
+                s.r2, s.b2 = e["r2"], e["b2"]
+            elif ev == "solve_end":
+                if "iter" in e:
+                    s.iter = e["iter"]
+                    s.r2, s.b2 = e["r2"], e["b2"]
+            elif ev == "reliable":
+                s.reliable += 1
+            elif ev == "restart":
+                s.restart += 1
+    return header, scopes
+
+
+def residual(s):
+    res = [math.sqrt(r / b) if b > 0 else 0.0 for r, b in zip(s.r2, s.b2)]
+    return max(res) if res else float("nan")
+
+
+def report(header, scopes, top, iterations):
+    run_time = scopes[0].inclusive(scopes)[0]
+    print("rank %s: version %s, hash %s" % (header.get("rank"), header.get("version"), header.get("hash")))
+    print("%-48s %12s %12s %7s %10s %10s  %s" % ("scope", "excl (s)", "incl (s)", "%", "Gflop/s", "GB/s", "solve"))
+
+    def visit(id, depth):
+        s = scopes[id]
+        time, flops, bytes = s.inclusive(scopes)
+        name = "  " * depth + s.label
+        gflops = flops / time * 1e-9 if time > 0 else 0.0
+        gbytes = bytes / time * 1e-9 if time > 0 else 0.0
+        pct = 100 * time / run_time if run_time > 0 else 0.0
+        solve = ""
+        if s.solve:
+            solve = "iter = %d, reliable = %d, restart = %d, |r|/|b| = %e" % (s.iter, s.reliable, s.restart,
+                                                                             residual(s))
+        print("%-48s %12.6f %12.6f %7.2f %10.1f %10.1f  %s" % (name[:48], s.time, time, pct, gflops, gbytes, solve))
+
+        if top > 0 and s.kernels:
+            for k, (calls, t, f, b) in sorted(s.kernels.items(), key=lambda x: -x[1][1])[:top]:
+                print("%s  - %-60s %8d calls %12.6f s" % ("  " * depth, k[:60], calls, t))
+
+        if iterations and s.solve and s.iter_time:
+            n = len(s.iter_time)
+            mean = sum(s.iter_time.values()) / n
+            print("%s  per iteration: %d iterations, mean %e s, max %e s" % ("  " * depth, n, mean,
+                                                                             max(s.iter_time.values())))
+
+        for c in s.children:
+            visit(c, depth + 1)
+
+    visit(0, 0)
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Summarize QUDA telemetry streams")
+    parser.add_argument("files", nargs="+", help="telemetry_n<rank>.jsonl files")
+    parser.add_argument("--top", type=int, default=5, help="number of kernels listed per scope")
+    parser.add_argument("--iterations", action="store_true", help="report the kernel time per solver iteration")
+    args = parser.parse_args()
+
+    for filename in args.files:
+        header, scopes = parse(filename)
+        report(header, scopes, args.top, args.iterations)
+
+
+if __name__ == "__main__":
+    main()
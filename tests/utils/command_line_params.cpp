@@ -30,6 +30,10 @@ QudaPrecision prec_precondition = QUDA_INVALID_PRECISION;
 QudaPrecision prec_eigensolver = QUDA_INVALID_PRECISION;
 QudaPrecision prec_null = QUDA_INVALID_PRECISION;
 QudaPrecision prec_ritz = QUDA_INVALID_PRECISION;
+QudaPrecision chrono_storage_prec = QUDA_INVALID_PRECISION;
+QudaPrecision halo_prec = QUDA_INVALID_PRECISION;
+QudaPrecision halo_prec_sloppy = QUDA_INVALID_PRECISION;
+QudaPrecision halo_prec_precondition = QUDA_INVALID_PRECISION;
 QudaVerbosity verbosity = QUDA_SUMMARIZE;
 
 std::array<int, 4> dim = {24, 24, 24, 24};
@@ -121,6 +125,7 @@ double tol_precondition = 1e-1;
 double tol_hq = 0.;
 double reliable_delta = 0.1;
 bool alternative_reliable = false;
+bool adaptive_reliable = false;
 QudaTwistFlavorType twist_flavor = QUDA_TWIST_SINGLET;
 QudaMassNormalization normalization = QUDA_KAPPA_NORMALIZATION;
 QudaMatPCType matpc_type = QUDA_MATPC_EVEN_EVEN;
@@ -155,6 +160,10 @@ quda::mgarray<int> num_setup_iter = {};
 quda::mgarray<double> setup_tol = {};
 quda::mgarray<int> setup_maxiter = {};
 quda::mgarray<int> setup_maxiter_refresh = {};
+quda::mgarray<double> setup_refresh_threshold = {};
+quda::mgarray<bool> setup_batch_all = {};
+quda::mgarray<double> setup_mask_tol = {};
+bool mg_setup_batch_benchmark = false;
 quda::mgarray<QudaCABasis> setup_ca_basis = {};
 quda::mgarray<int> setup_ca_basis_size = {};
 quda::mgarray<double> setup_ca_lambda_min = {};
@@ -180,6 +189,7 @@ bool generate_nullspace = true;
 bool generate_all_levels = true;
 quda::mgarray<QudaSchwarzType> mg_schwarz_type = {};
 quda::mgarray<int> mg_schwarz_cycle = {};
+quda::mgarray<QudaMultigridCycleType> mg_cycle_type = {};
 bool mg_evolve_thin_updates = false;
 
 // Aggregation type for the top level of staggered
@@ -221,6 +231,7 @@ int eig_n_kr = 32;
 int eig_n_conv = -1;        // If unchanged, will be set to n_ev
 int eig_n_ev_deflate = -1;  // If unchanged, will be set to n_conv
 int eig_batched_rotate = 0; // If unchanged, will be set to maximum
+bool eig_use_gemm_rotate = false;
 bool eig_require_convergence = true;
 int eig_check_interval = 10;
 int eig_max_restarts = 1000;
@@ -230,6 +241,7 @@ double eig_qr_tol = 1e-11;
 bool eig_use_eigen_qr = true;
 bool eig_use_poly_acc = true;
 int eig_poly_deg = 100;
+int eig_poly_halo_depth = 0;
 double eig_amin = 0.1;
 double eig_amax = 0.0; // If zero is passed to the solver, an estimate will be computed
 bool eig_use_normop = true;
@@ -246,6 +258,11 @@ std::string eig_vec_outfile;
 bool eig_io_parity_inflate = false;
 QudaPrecision eig_save_prec = QUDA_DOUBLE_PRECISION;
 bool eig_partfile = false;
+QudaPrecision eig_deflation_prec = QUDA_INVALID_PRECISION;
+int eig_coherence_n_vec = 0;
+std::array<int, 4> eig_coherence_block_size = {4, 4, 4, 4};
+QudaFieldLocation eig_deflation_location = QUDA_CUDA_FIELD_LOCATION;
+int eig_deflation_tile_size = 16;
 
 // Parameters for the MG eigensolver.
 // The coarsest grid params are for deflation,
@@ -315,6 +332,9 @@ int gauge_smear_steps = 5;
 int gauge_smear_dir_ignore = -1;
 int measurement_interval = 5;
 bool su_project = true;
+double gauge_flow_tol = 0.0;
+QudaFlowScaleType gauge_flow_scale_type = QUDA_FLOW_SCALE_NONE;
+double gauge_flow_scale_target = 0.3;
 
 // contract options
 QudaContractType contract_type = QUDA_CONTRACT_TYPE_STAGGERED_FT_T;
@@ -405,6 +425,10 @@ namespace
                                                          {"additive", QUDA_ADDITIVE_SCHWARZ},
                                                          {"multiplicative", QUDA_MULTIPLICATIVE_SCHWARZ}};
 
+  CLI::TransformPairs<QudaMultigridCycleType> mg_cycle_type_map {{"vcycle", QUDA_MG_CYCLE_VCYCLE},
+                                                                 {"recursive", QUDA_MG_CYCLE_RECURSIVE},
+                                                                 {"kcycle", QUDA_MG_CYCLE_KCYCLE}};
+
   CLI::TransformPairs<QudaAcceleratorType> accelerator_type_map {{"invalid", QUDA_INVALID_ACCELERATOR},
                                                                  {"madwf", QUDA_MADWF_ACCELERATOR}};
 
@@ -418,7 +442,8 @@ namespace
                                                  {"blktrlm", QUDA_EIG_BLK_TR_LANCZOS},
                                                  {"trlm-3d", QUDA_EIG_TR_LANCZOS_3D},
                                                  {"iram", QUDA_EIG_IR_ARNOLDI},
-                                                 {"blkiram", QUDA_EIG_BLK_IR_ARNOLDI}};
+                                                 {"blkiram", QUDA_EIG_BLK_IR_ARNOLDI},
+                                                 {"chfsi", QUDA_EIG_CHEB_FILTERED_SUBSPACE}};
 
   CLI::TransformPairs<QudaTransferType> transfer_type_map {
     {"aggregate", QUDA_TRANSFER_AGGREGATE},
@@ -467,6 +492,9 @@ namespace
                                                                 {"wilson", QUDA_GAUGE_SMEAR_WILSON_FLOW},
                                                                 {"symanzik", QUDA_GAUGE_SMEAR_SYMANZIK_FLOW}};
 
+  CLI::TransformPairs<QudaFlowScaleType> flow_scale_type_map {
+    {"none", QUDA_FLOW_SCALE_NONE}, {"t0", QUDA_FLOW_SCALE_T0}, {"w0", QUDA_FLOW_SCALE_W0}};
+
   CLI::TransformPairs<QudaSetupType> setup_type_map {{"test", QUDA_TEST_VECTOR_SETUP}, {"null", QUDA_TEST_VECTOR_SETUP}};
 
   CLI::TransformPairs<QudaExtLibType> extlib_map {{"eigen", QUDA_EIGEN_EXTLIB}};
@@ -483,6 +511,8 @@ std::shared_ptr<QUDAApp> make_app(std::string app_description, std::string app_n
   quda_app->option_defaults()->always_capture_default();
 
   quda_app->add_option("--alternative-reliable", alternative_reliable, "use alternative reliable updates");
+  quda_app->add_option("--adaptive-reliable", adaptive_reliable,
+                       "adapt the reliable update tolerance and sloppy operator precision during the solve (CG only)");
   quda_app->add_option("--anisotropy", anisotropy, "Temporal anisotropy factor (default 1.0)");
 
   quda_app->add_option("--ca-basis-type", ca_basis, "The basis to use for CA solvers (default chebyshev)")
@@ -630,6 +660,10 @@ std::shared_ptr<QUDAApp> make_app(std::string app_description, std::string app_n
 
   CLI::QUDACheckedTransformer prec_transform(precision_map);
   quda_app->add_option("--prec", prec, "Precision in GPU")->transform(prec_transform);
+  quda_app
+    ->add_option("--chrono-storage-prec", chrono_storage_prec,
+                 "Precision the chronological solution history is stored in (default chrono precision)")
+    ->transform(prec_transform);
   quda_app->add_option("--prec-precondition", prec_precondition, "Preconditioner precision in GPU")->transform(prec_transform);
 
   quda_app->add_option("--prec-eigensolver", prec_eigensolver, "Eigensolver precision in GPU")->transform(prec_transform);
@@ -643,6 +677,20 @@ std::shared_ptr<QUDAApp> make_app(std::string app_description, std::string app_n
 
   quda_app->add_option("--prec-null", prec_null, "Precison TODO")->transform(prec_transform);
 
+  quda_app
+    ->add_option("--halo-prec", halo_prec,
+                 "Precision of the operator halo exchange; half and quarter use a block-floating-point format (default "
+                 "is the field precision)")
+    ->transform(prec_transform);
+  quda_app
+    ->add_option("--halo-prec-sloppy", halo_prec_sloppy,
+                 "Precision of the sloppy operator halo exchange (default is the field precision)")
+    ->transform(prec_transform);
+  quda_app
+    ->add_option("--halo-prec-precondition", halo_prec_precondition,
+                 "Precision of the preconditioner halo exchange (default is the field precision)")
+    ->transform(prec_transform);
+
   quda_app->add_option("--precon-type", precon_type, "The type of solver to use (default none (=unspecified)).")
     ->transform(CLI::QUDACheckedTransformer(inverter_type_map));
   quda_app
@@ -810,7 +858,11 @@ void add_eigen_option_group(std::shared_ptr<QUDAApp> quda_app)
   opgroup->add_option("--eig-n-kr", eig_n_kr, "The size of the Krylov subspace to use in the eigensolver");
   opgroup->add_option("--eig-batched-rotate", eig_batched_rotate,
                       "The maximum number of extra eigenvectors the solver may allocate to perform a Ritz rotation.");
+  opgroup->add_option("--eig-use-gemm-rotate", eig_use_gemm_rotate,
+                      "Apply the Ritz rotation as a site-blocked GEMM (default false)");
   opgroup->add_option("--eig-poly-deg", eig_poly_deg, "TODO");
+  opgroup->add_option("--eig-poly-halo-depth", eig_poly_halo_depth,
+                      "Number of polynomial operator applications sharing one deep halo exchange (default 0, disabled)");
   opgroup->add_option(
     "--eig-require-convergence",
     eig_require_convergence, "If true, the solver will error out if convergence is not attained. If false, a warning will be given (default true)");
@@ -823,6 +875,22 @@ void add_eigen_option_group(std::shared_ptr<QUDAApp> quda_app)
     ->transform(prec_transform);
   opgroup->add_option("--eig-save-partfile", eig_partfile,
                       "If saving eigenvectors, save in partfile format instead of singlefile (default false)");
+  opgroup
+    ->add_option("--eig-deflation-prec", eig_deflation_prec,
+                 "The precision in which solvers store the deflation space (default = eigensolver precision)")
+    ->transform(prec_transform);
+  opgroup->add_option("--eig-coherence-n-vec", eig_coherence_n_vec,
+                      "Compress the deflation space onto this many block-local basis vectors (default 0, disabled)");
+  opgroup
+    ->add_option("--eig-coherence-block-size", eig_coherence_block_size,
+                 "The geometric block size used for deflation space compression (default 4 4 4 4)")
+    ->expected(4);
+  opgroup
+    ->add_option("--eig-deflation-location", eig_deflation_location,
+                 "Where solvers keep the deflation space, cpu streams it from host memory (default cuda)")
+    ->transform(CLI::QUDACheckedTransformer(field_location_map));
+  opgroup->add_option("--eig-deflation-tile-size", eig_deflation_tile_size,
+                      "The number of vectors per transfer when streaming the deflation space (default 16)");
 
   opgroup->add_option(
     "--eig-io-parity-inflate", eig_io_parity_inflate,
@@ -1026,6 +1094,15 @@ void add_multigrid_option_group(std::shared_ptr<QUDAApp> quda_app)
   quda_app->add_mgoption(
     opgroup, "--mg-nvec-batch", nvec_batch,
     CLI::PositiveNumber, "Batch size to use when computing the null-space vectors to define the multigrid transfer operator on a given level");
+  quda_app->add_mgoption(opgroup, "--mg-setup-batch-all", setup_batch_all, CLI::Validator(),
+                         "Relax all null-space vectors on a given level in a single multi-RHS solve, overriding "
+                         "--mg-nvec-batch (default false)");
+  quda_app->add_mgoption(opgroup, "--mg-setup-mask-tol", setup_mask_tol, CLI::Validator(),
+                         "With --mg-setup-batch-all, mask out of subsequent setup iterations the null space vectors "
+                         "whose near-null residual |Dv|/|v| is below this value (default 0 = no masking)");
+  opgroup->add_option("--mg-setup-batch-benchmark", mg_setup_batch_benchmark,
+                      "multigrid_benchmark_test: time the null space generation with and without "
+                      "--mg-setup-batch-all (default false)");
   opgroup->add_option("--mg-oblique-proj-check", oblique_proj_check,
                       "Measure how well the null vector subspace adjusts the low eigenmode subspace (default false)");
   opgroup->add_option("--mg-omega", omega,
@@ -1041,6 +1118,10 @@ void add_multigrid_option_group(std::shared_ptr<QUDAApp> quda_app)
     ->transform(CLI::QUDACheckedTransformer(schwarz_type_map));
   quda_app->add_mgoption(opgroup, "--mg-schwarz-cycle", mg_schwarz_cycle, CLI::PositiveNumber,
                          "The number of Schwarz cycles to apply per smoother application (default=1)");
+  quda_app
+    ->add_mgoption(opgroup, "--mg-cycle-type", mg_cycle_type, CLI::Validator(),
+                   "The multigrid cycle to use on each level (vcycle, recursive, kcycle) (default=recursive)")
+    ->transform(CLI::QUDACheckedTransformer(mg_cycle_type_map));
   quda_app->add_mgoption(opgroup, "--mg-setup-ca-basis-size", setup_ca_basis_size, CLI::PositiveNumber,
                          "The basis size to use for CA solver setup of multigrid (default 4)");
   quda_app->add_mgoption(opgroup, "--mg-setup-ca-basis-type", setup_ca_basis, CLI::QUDACheckedTransformer(ca_basis_map),
@@ -1065,6 +1146,9 @@ void add_multigrid_option_group(std::shared_ptr<QUDAApp> quda_app)
   quda_app->add_mgoption(
     opgroup, "--mg-setup-maxiter-refresh", setup_maxiter_refresh, CLI::Validator(),
     "The maximum number of solver iterations to use when refreshing the pre-existing null space vectors (default 100)");
+  quda_app->add_mgoption(opgroup, "--mg-setup-refresh-threshold", setup_refresh_threshold, CLI::Validator(),
+                         "Only refresh null space vectors whose near-null residual has grown by more than this "
+                         "relative amount since they were generated (default 0 = always refresh all vectors)");
   quda_app->add_mgoption(opgroup, "--mg-setup-tol", setup_tol, CLI::Validator(),
                          "The tolerance to use for the setup of multigrid (default 5e-6)");
 
@@ -1162,6 +1246,18 @@ void add_su3_option_group(std::shared_ptr<QUDAApp> quda_app)
 
   opgroup->add_option("--su3-project", su_project,
                       "Project smeared gauge onto su3 manifold at measurement interval (default true)");
+
+  opgroup->add_option("--su3-flow-tol", gauge_flow_tol,
+                      "Local error tolerance for adaptive step size Wilson/Symanzik flow, 0 for a fixed step size "
+                      "(default 0)");
+
+  opgroup
+    ->add_option("--su3-flow-scale", gauge_flow_scale_type,
+                 "Stop the Wilson/Symanzik flow once the given scale is reached. Options: none, t0, w0 (default none)")
+    ->transform(CLI::QUDACheckedTransformer(flow_scale_type_map));
+
+  opgroup->add_option("--su3-flow-scale-target", gauge_flow_scale_target,
+                      "Target value of t^2 <E> (t0) or t d/dt t^2 <E> (w0) for the flow scale (default 0.3)");
 }
 
 void add_madwf_option_group(std::shared_ptr<QUDAApp> quda_app)
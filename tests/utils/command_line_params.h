@@ -293,6 +293,10 @@ extern QudaPrecision prec_precondition;
 extern QudaPrecision prec_eigensolver;
 extern QudaPrecision prec_null;
 extern QudaPrecision prec_ritz;
+extern QudaPrecision chrono_storage_prec;
+extern QudaPrecision halo_prec;
+extern QudaPrecision halo_prec_sloppy;
+extern QudaPrecision halo_prec_precondition;
 extern QudaVerbosity verbosity;
 extern std::array<int, 4> dim;
 extern int &xdim;
@@ -380,6 +384,7 @@ extern double tol_precondition;
 extern double tol_hq;
 extern double reliable_delta;
 extern bool alternative_reliable;
+extern bool adaptive_reliable;
 extern QudaTwistFlavorType twist_flavor;
 extern QudaMassNormalization normalization;
 extern QudaMatPCType matpc_type;
@@ -413,6 +418,10 @@ extern quda::mgarray<int> num_setup_iter;
 extern quda::mgarray<double> setup_tol;
 extern quda::mgarray<int> setup_maxiter;
 extern quda::mgarray<int> setup_maxiter_refresh;
+extern quda::mgarray<double> setup_refresh_threshold;
+extern quda::mgarray<bool> setup_batch_all;
+extern quda::mgarray<double> setup_mask_tol;
+extern bool mg_setup_batch_benchmark;
 extern quda::mgarray<QudaCABasis> setup_ca_basis;
 extern quda::mgarray<int> setup_ca_basis_size;
 extern quda::mgarray<double> setup_ca_lambda_min;
@@ -438,6 +447,7 @@ extern bool generate_nullspace;
 extern bool generate_all_levels;
 extern quda::mgarray<QudaSchwarzType> mg_schwarz_type;
 extern quda::mgarray<int> mg_schwarz_cycle;
+extern quda::mgarray<QudaMultigridCycleType> mg_cycle_type;
 extern bool mg_evolve_thin_updates;
 extern QudaTransferType staggered_transfer_type;
 
@@ -471,6 +481,7 @@ extern int eig_n_kr;
 extern int eig_n_conv;         // If unchanged, will be set to n_ev
 extern int eig_n_ev_deflate;   // If unchanged, will be set to n_conv
 extern int eig_batched_rotate; // If unchanged, will be set to maximum
+extern bool eig_use_gemm_rotate;
 extern bool eig_require_convergence;
 extern int eig_check_interval;
 extern int eig_max_restarts;
@@ -480,6 +491,7 @@ extern double eig_qr_tol;
 extern bool eig_use_eigen_qr;
 extern bool eig_use_poly_acc;
 extern int eig_poly_deg;
+extern int eig_poly_halo_depth;
 extern double eig_amin;
 extern double eig_amax;
 extern bool eig_use_normop;
@@ -496,6 +508,11 @@ extern std::string eig_vec_outfile;
 extern bool eig_io_parity_inflate;
 extern QudaPrecision eig_save_prec;
 extern bool eig_partfile;
+extern QudaPrecision eig_deflation_prec;
+extern int eig_coherence_n_vec;
+extern std::array<int, 4> eig_coherence_block_size;
+extern QudaFieldLocation eig_deflation_location;
+extern int eig_deflation_tile_size;
 
 // Parameters for the MG eigensolver.
 // The coarsest grid params are for deflation,
@@ -564,6 +581,9 @@ extern int gauge_smear_dir_ignore;
 extern int measurement_interval;
 extern QudaGaugeSmearType gauge_smear_type;
 extern bool su_project;
+extern double gauge_flow_tol;
+extern QudaFlowScaleType gauge_flow_scale_type;
+extern double gauge_flow_scale_target;
 
 extern double smear_coeff;
 extern int    smear_n_steps;
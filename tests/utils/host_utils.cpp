@@ -100,11 +100,14 @@ void setQudaDefaultMgTestParams()
     setup_tol[i] = 5e-6;
     setup_maxiter[i] = 500;
     setup_maxiter_refresh[i] = 20;
+    setup_refresh_threshold[i] = 0.0;
+    setup_mask_tol[i] = 0.0;
     mu_factor[i] = 1.;
     coarse_solve_type[i] = QUDA_INVALID_SOLVE;
     smoother_solve_type[i] = QUDA_INVALID_SOLVE;
     mg_schwarz_type[i] = QUDA_INVALID_SCHWARZ;
     mg_schwarz_cycle[i] = 1;
+    mg_cycle_type[i] = QUDA_MG_CYCLE_RECURSIVE;
     smoother_type[i] = QUDA_MR_INVERTER;
     smoother_tol[i] = 0.25;
     coarse_solver[i] = QUDA_GCR_INVERTER;
@@ -407,7 +410,9 @@ void initComms(int, char **, int *const commDims)
   }
 #elif defined(MPI_COMMS)
   int provided = 0;
-  int required = MPI_THREAD_FUNNELED;
+  // the communication progress thread makes MPI calls concurrently with the host thread
+  auto progress_env = getenv("QUDA_ENABLE_COMMS_PROGRESS");
+  int required = progress_env && strcmp(progress_env, "1") == 0 ? MPI_THREAD_MULTIPLE : MPI_THREAD_FUNNELED;
   int flag = MPI_Init_thread(&argc, &argv, required, &provided);
 
   if (provided != required) {
@@ -309,6 +309,33 @@ inline int getNegLog10Tolerance(QudaPrecision prec)
 */
 inline double getTolerance(QudaPrecision prec) { return pow(10, -getNegLog10Tolerance(prec)); }
 
+/**
+  @brief Return the expected tolerance for an operator applied in a
+    given precision whose halo is exchanged in a possibly lower precision.
+  @param[in] prec Precision
+  @param[in] halo_prec Halo precision (QUDA_INVALID_PRECISION means the field precision)
+  @return Reasonable expected tolerance
+*/
+inline double getTolerance(QudaPrecision prec, QudaPrecision halo_prec)
+{
+  return getTolerance(halo_prec != QUDA_INVALID_PRECISION ? std::min(prec, halo_prec) : prec);
+}
+
+/**
+  @brief Return the size of a halo site: the (spin-projected) spinor
+    elements are stored in the halo precision, with an additional float
+    scale factor per site for half and quarter precision.
+  @param[in] nSpin Number of spins of the field
+  @param[in] nColor Number of colors of the field
+  @param[in] prec Halo precision
+  @return Bytes per halo site
+*/
+inline size_t getHaloSiteBytes(int nSpin, int nColor, QudaPrecision prec)
+{
+  int nSpinGhost = nSpin == 4 ? 2 : nSpin;
+  return nSpinGhost * nColor * 2 * prec + (prec <= QUDA_HALF_PRECISION ? sizeof(float) : 0);
+}
+
 /**
   @brief Check if the std::string has a size smaller than the limit: if yes, copy it to a C-string;
     if no, give an error based on the given name. The 256 is the C-string length for parameters in
@@ -224,6 +224,7 @@ const char *get_eig_type_str(QudaEigType type)
   case QUDA_EIG_TR_LANCZOS_3D: ret = "trlm_3d"; break;
   case QUDA_EIG_IR_ARNOLDI: ret = "iram"; break;
   case QUDA_EIG_BLK_IR_ARNOLDI: ret = "blkiram"; break;
+  case QUDA_EIG_CHEB_FILTERED_SUBSPACE: ret = "chfsi"; break;
   default: ret = "unknown eigensolver"; break;
   }
 
@@ -15,6 +15,9 @@ void setGaugeSmearParam(QudaGaugeSmearParam &smear_param)
   smear_param.alpha2 = gauge_smear_alpha2;
   smear_param.alpha3 = gauge_smear_alpha3;
   smear_param.dir_ignore = gauge_smear_dir_ignore;
+  smear_param.flow_tol = gauge_flow_tol;
+  smear_param.scale_type = gauge_flow_scale_type;
+  smear_param.scale_target = gauge_flow_scale_target;
   smear_param.struct_size = sizeof(smear_param);
 }
 
@@ -238,6 +241,7 @@ void setInvertParam(QudaInvertParam &inv_param)
   inv_param.maxiter = niter;
   inv_param.reliable_delta = reliable_delta;
   inv_param.use_alternative_reliable = alternative_reliable;
+  inv_param.use_adaptive_reliable = adaptive_reliable;
   inv_param.use_sloppy_partial_accumulator = 0;
   inv_param.solution_accumulator_pipeline = solution_accumulator_pipeline;
   inv_param.max_res_increase = max_res_increase;
@@ -277,6 +281,10 @@ void setInvertParam(QudaInvertParam &inv_param)
   inv_param.cuda_prec = cuda_prec;
   inv_param.cuda_prec_sloppy = cuda_prec_sloppy;
   inv_param.cuda_prec_refinement_sloppy = cuda_prec_refinement_sloppy;
+  inv_param.halo_prec = halo_prec;
+  inv_param.halo_prec_sloppy = halo_prec_sloppy;
+  inv_param.halo_prec_precondition = halo_prec_precondition;
+  inv_param.chrono_storage_precision = chrono_storage_prec;
   inv_param.gamma_basis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
   inv_param.dirac_order = QUDA_DIRAC_ORDER;
 
@@ -348,6 +356,7 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.tol = eig_tol;
   eig_param.qr_tol = eig_qr_tol;
   eig_param.batched_rotate = eig_batched_rotate;
+  eig_param.use_gemm_rotate = eig_use_gemm_rotate ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
   eig_param.require_convergence = eig_require_convergence ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
   eig_param.check_interval = eig_check_interval;
   eig_param.max_restarts = eig_max_restarts;
@@ -366,6 +375,7 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.use_eigen_qr = eig_use_eigen_qr ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
   eig_param.use_poly_acc = eig_use_poly_acc ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
   eig_param.poly_deg = eig_poly_deg;
+  eig_param.poly_halo_depth = eig_poly_halo_depth;
   eig_param.a_min = eig_amin;
   eig_param.a_max = eig_amax;
 
@@ -378,6 +388,12 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.io_parity_inflate = eig_io_parity_inflate ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
   eig_param.partfile = eig_partfile ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
 
+  eig_param.deflation_prec = eig_deflation_prec;
+  eig_param.deflation_coherence_n_vec = eig_coherence_n_vec;
+  for (int i = 0; i < 4; i++) eig_param.deflation_coherence_geo_block_size[i] = eig_coherence_block_size[i];
+  eig_param.deflation_location = eig_deflation_location;
+  eig_param.deflation_tile_size = eig_deflation_tile_size;
+
   eig_param.struct_size = sizeof(eig_param);
 }
 
@@ -468,6 +484,7 @@ void setMultigridParam(QudaMultigridParam &mg_param)
     mg_param.setup_tol[i] = setup_tol[i];
     mg_param.setup_maxiter[i] = setup_maxiter[i];
     mg_param.setup_maxiter_refresh[i] = setup_maxiter_refresh[i];
+    mg_param.setup_refresh_threshold[i] = setup_refresh_threshold[i];
 
     // Basis to use for CA solver setups
     mg_param.setup_ca_basis[i] = setup_ca_basis[i];
@@ -482,6 +499,8 @@ void setMultigridParam(QudaMultigridParam &mg_param)
     mg_param.spin_block_size[i] = 1;
     mg_param.n_vec[i] = nvec[i] == 0 ? 24 : nvec[i]; // default to 24 vectors if not set
     mg_param.n_vec_batch[i] = nvec_batch[i] == 0 ? 1 : nvec_batch[i]; // default to batch size 1 if not set
+    mg_param.setup_batch_all[i] = setup_batch_all[i] ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+    mg_param.setup_mask_tol[i] = setup_mask_tol[i];
     mg_param.n_block_ortho[i] = n_block_ortho[i];    // number of times to Gram-Schmidt
     mg_param.block_ortho_two_pass[i]
       = block_ortho_two_pass[i] ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE; // whether to use a two-pass block ortho
@@ -491,7 +510,7 @@ void setMultigridParam(QudaMultigridParam &mg_param)
     mg_param.nu_post[i] = nu_post[i];
     mg_param.mu_factor[i] = mu_factor[i];
 
-    mg_param.cycle_type[i] = QUDA_MG_CYCLE_RECURSIVE;
+    mg_param.cycle_type[i] = mg_cycle_type[i];
 
     // Is not a staggered solve, always aggregate
     mg_param.transfer_type[i] = QUDA_TRANSFER_AGGREGATE;
@@ -952,6 +971,7 @@ void setStaggeredInvertParam(QudaInvertParam &inv_param)
   inv_param.maxiter = niter;
   inv_param.reliable_delta = reliable_delta;
   inv_param.use_alternative_reliable = alternative_reliable;
+  inv_param.use_adaptive_reliable = adaptive_reliable;
   inv_param.use_sloppy_partial_accumulator = false;
   inv_param.solution_accumulator_pipeline = solution_accumulator_pipeline;
   inv_param.pipeline = pipeline;
@@ -1012,6 +1032,9 @@ void setStaggeredInvertParam(QudaInvertParam &inv_param)
   inv_param.cuda_prec = prec;
   inv_param.cuda_prec_sloppy = prec_sloppy;
   inv_param.cuda_prec_refinement_sloppy = prec_refinement_sloppy;
+  inv_param.halo_prec = halo_prec;
+  inv_param.halo_prec_sloppy = halo_prec_sloppy;
+  inv_param.halo_prec_precondition = halo_prec_precondition;
   inv_param.gamma_basis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS; // this is meaningless, but must be thus set
   inv_param.dirac_order = QUDA_DIRAC_ORDER;
 
@@ -1096,6 +1119,8 @@ void setStaggeredMultigridParam(QudaMultigridParam &mg_param)
     mg_param.spin_block_size[i] = 1;
     mg_param.n_vec[i] = nvec[i] == 0 ? 64 : nvec[i]; // default to 64 vectors if not set
     mg_param.n_vec_batch[i] = nvec_batch[i] == 0 ? 1 : nvec_batch[i]; // default to batch size 1 if not set
+    mg_param.setup_batch_all[i] = setup_batch_all[i] ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+    mg_param.setup_mask_tol[i] = setup_mask_tol[i];
     mg_param.n_block_ortho[i] = n_block_ortho[i];    // number of times to Gram-Schmidt
     mg_param.block_ortho_two_pass[i]
       = block_ortho_two_pass[i] ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE; // whether to use a two-pass block ortho
@@ -1107,7 +1132,7 @@ void setStaggeredMultigridParam(QudaMultigridParam &mg_param)
 
     mg_param.transfer_type[i] = (i == 0) ? staggered_transfer_type : QUDA_TRANSFER_AGGREGATE;
 
-    mg_param.cycle_type[i] = QUDA_MG_CYCLE_RECURSIVE;
+    mg_param.cycle_type[i] = mg_cycle_type[i];
 
     // set the coarse solver wrappers including bottom solver
     mg_param.coarse_solver[i] = coarse_solver[i];